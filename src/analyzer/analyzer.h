@@ -4,6 +4,7 @@
 #include "audio/signalinfo.h"
 #include "audio/types.h"
 #include "util/assert.h"
+#include "util/indexrange.h"
 #include "util/types.h"
 
 /*
@@ -16,6 +17,25 @@
 
 #include "track/track_decl.h"
 
+// The analysis of a time segment of a track, see Analyzer::newSegment().
+class AnalyzerSegment {
+  public:
+    virtual ~AnalyzerSegment() = default;
+
+    // Some samples right before the segment, e.g. for settling filters.
+    // Invoked before processSamples().
+    virtual void prerollSamples(const CSAMPLE* pIn, SINT count) {
+        Q_UNUSED(pIn);
+        Q_UNUSED(count);
+    }
+
+    // Analyze the next chunk of audio samples of the segment like
+    // Analyzer::processSamples().
+    virtual bool processSamples(const CSAMPLE* pIn, SINT count) = 0;
+};
+
+typedef std::unique_ptr<AnalyzerSegment> AnalyzerSegmentPtr;
+
 class Analyzer {
   public:
     virtual ~Analyzer() = default;
@@ -35,6 +55,27 @@ class Analyzer {
     // but not finalize()!
     virtual bool processSamples(const CSAMPLE* pIn, SINT count) = 0;
 
+    // Long tracks are split into time segments that are analyzed in
+    // parallel on separate threads by the analyzers that support it. This
+    // analyzer still processes the samples of the first segment.
+    //
+    // Returns an analyzer for the given frames after initialize(), or
+    // nullptr if all samples need to be processed in order (default).
+    // The segment is processed on another thread and must not access
+    // this analyzer.
+    virtual AnalyzerSegmentPtr newSegment(mixxx::IndexRange frameRange) {
+        Q_UNUSED(frameRange);
+        return nullptr;
+    }
+
+    // Merge the results of a segment after all samples of the preceding
+    // segments have been processed or merged. Segments are merged in order
+    // and before storeResults(). Returns false if the analysis failed.
+    virtual bool mergeSegment(AnalyzerSegmentPtr pSegment) {
+        Q_UNUSED(pSegment);
+        return false;
+    }
+
     // Update the track object with the analysis results after
     // processing finished successfully, i.e. all available audio
     // samples have been processed.
@@ -86,6 +127,25 @@ class AnalyzerWithState final {
         }
     }
 
+    AnalyzerSegmentPtr newSegment(mixxx::IndexRange frameRange) {
+        if (!m_active) {
+            return nullptr;
+        }
+        return m_analyzer->newSegment(frameRange);
+    }
+
+    // A nullptr is passed if processing of the segment failed
+    void mergeSegment(AnalyzerSegmentPtr pSegment) {
+        if (m_active) {
+            m_active = pSegment && m_analyzer->mergeSegment(std::move(pSegment));
+            if (!m_active) {
+                // Ensure that cleanup() is invoked after merging
+                // failed and the analyzer became inactive!
+                m_analyzer->cleanup();
+            }
+        }
+    }
+
     void finish(const AnalyzerTrack& track) {
         if (m_active) {
             m_analyzer->storeResults(track.getTrack());
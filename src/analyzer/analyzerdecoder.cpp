@@ -0,0 +1,190 @@
+#include "analyzer/analyzerdecoder.h"
+
+#include "analyzer/constants.h"
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/math.h"
+
+namespace {
+
+mixxx::Logger kLogger("AnalyzerDecoder");
+
+} // anonymous namespace
+
+AnalyzerDecoder::AnalyzerDecoder(const QString& name)
+        : m_writeIndex(0),
+          m_readIndex(0),
+          m_freeChunks(mixxx::kAnalysisChunksDecodedAhead),
+          m_decoding(false),
+          m_abort(false),
+          m_quit(false) {
+    setObjectName(name);
+    m_chunks.resize(mixxx::kAnalysisChunksDecodedAhead);
+    for (auto& chunk : m_chunks) {
+        chunk.buffer = mixxx::SampleBuffer(mixxx::kAnalysisSamplesPerChunk);
+    }
+}
+
+AnalyzerDecoder::~AnalyzerDecoder() {
+    if (m_decoding) {
+        stopDecoding(true);
+    }
+    m_quit.store(true);
+    m_semaStart.release();
+    wait();
+}
+
+void AnalyzerDecoder::startDecoding(mixxx::AudioSourcePointer pAudioSource) {
+    DEBUG_ASSERT(pAudioSource);
+    VERIFY_OR_DEBUG_ASSERT(!m_decoding) {
+        stopDecoding(true);
+    }
+    // Reset the ring, the decoding thread is idle
+    m_freeChunks.tryAcquire(m_freeChunks.available());
+    m_freeChunks.release(mixxx::kAnalysisChunksDecodedAhead);
+    m_readyChunks.tryAcquire(m_readyChunks.available());
+    m_writeIndex = 0;
+    m_readIndex = 0;
+    m_abort.store(false);
+
+    m_pAudioSource = std::move(pAudioSource);
+    m_decoding = true;
+    if (!isRunning()) {
+        // Inherits the priority of the analyzer thread
+        start();
+    }
+    m_semaStart.release();
+}
+
+void AnalyzerDecoder::stopDecoding(bool abort) {
+    if (!m_decoding) {
+        return;
+    }
+    if (abort) {
+        m_abort.store(true);
+        // Wake up the decoding thread if it is waiting for a free chunk
+        m_freeChunks.release();
+    }
+    m_semaStopped.acquire();
+    m_decoding = false;
+}
+
+int AnalyzerDecoder::acquireChunks() {
+    DEBUG_ASSERT(m_decoding);
+    m_readyChunks.acquire();
+    const int count = 1 + m_readyChunks.available();
+    m_readyChunks.acquire(count - 1);
+    return count;
+}
+
+const AnalyzerDecoder::Chunk& AnalyzerDecoder::chunk(int i) const {
+    DEBUG_ASSERT(i >= 0 && i < mixxx::kAnalysisChunksDecodedAhead);
+    return m_chunks[(m_readIndex + i) % mixxx::kAnalysisChunksDecodedAhead];
+}
+
+void AnalyzerDecoder::releaseChunks(int count) {
+    DEBUG_ASSERT(count > 0 && count <= mixxx::kAnalysisChunksDecodedAhead);
+    m_readIndex = (m_readIndex + count) % mixxx::kAnalysisChunksDecodedAhead;
+    m_freeChunks.release(count);
+}
+
+void AnalyzerDecoder::run() {
+    while (true) {
+        m_semaStart.acquire();
+        if (m_quit.load()) {
+            break;
+        }
+        decodeAudioSource();
+        // Don't keep the file open while idle
+        m_pAudioSource.reset();
+        m_semaStopped.release();
+    }
+}
+
+bool AnalyzerDecoder::acquireFreeChunk() {
+    m_freeChunks.acquire();
+    return !m_abort.load();
+}
+
+void AnalyzerDecoder::publishChunk() {
+    m_writeIndex = (m_writeIndex + 1) % mixxx::kAnalysisChunksDecodedAhead;
+    m_readyChunks.release();
+}
+
+void AnalyzerDecoder::decodeAudioSource() {
+    const auto& audioSource = m_pAudioSource;
+    DEBUG_ASSERT(
+            0 == audioSource->getSignalInfo().getChannelCount() % mixxx::kAnalysisChannels);
+
+    mixxx::IndexRange remainingFrameRange = audioSource->frameIndexRange();
+    while (true) {
+        if (!acquireFreeChunk()) {
+            return;
+        }
+        Chunk& chunk = m_chunks[m_writeIndex];
+        if (remainingFrameRange.empty()) {
+            chunk.readableSampleFrames = mixxx::ReadableSampleFrames();
+            chunk.frameLength = audioSource->frameLength();
+            chunk.remainingFrames = 0;
+            chunk.endOfTrack = true;
+            publishChunk();
+            return;
+        }
+
+        // Split the range for the next chunk from the remaining (= to-be-analyzed) frames
+        auto chunkFrameRange =
+                remainingFrameRange.splitAndShrinkFront(
+                        math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
+        DEBUG_ASSERT(!chunkFrameRange.empty());
+
+        // Request the next chunk of audio data
+        const auto readableSampleFrames =
+                audioSource->readSampleFrames(
+                        mixxx::WritableSampleFrames(
+                                chunkFrameRange,
+                                mixxx::SampleBuffer::WritableSlice(chunk.buffer)));
+        // The returned range fits into the requested range
+        DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
+
+        // Sometimes the duration of the audio source is inaccurate and adjusted
+        // while reading. We need to adjust all frame ranges to reflect this new
+        // situation by restoring all invariants and consistency requirements!
+
+        // Shrink the original range of the current chunks to the actual available
+        // range.
+        chunkFrameRange = intersect(chunkFrameRange, audioSource->frameIndexRange());
+        // The audio data that has just been read should still fit into the adjusted
+        // chunk range.
+        DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
+
+        // We also need to adjust the remaining frame range for the next requests.
+        remainingFrameRange = intersect(remainingFrameRange, audioSource->frameIndexRange());
+        // Currently the range will never grow, but lets also account for this case
+        // that might become relevant in the future.
+        VERIFY_OR_DEBUG_ASSERT(remainingFrameRange.empty() ||
+                remainingFrameRange.end() == audioSource->frameIndexRange().end()) {
+            if (chunkFrameRange.length() < mixxx::kAnalysisFramesPerChunk) {
+                // If we have read an incomplete chunk while the range has grown
+                // we need to discard the read results and re-read the current
+                // chunk!
+                remainingFrameRange.growFront(chunkFrameRange.length());
+                // The chunk has not been published and is still free
+                m_freeChunks.release();
+                continue;
+            }
+            DEBUG_ASSERT(remainingFrameRange.end() < audioSource->frameIndexRange().end());
+            kLogger.warning()
+                    << "Unexpected growth of the audio source while reading"
+                    << mixxx::IndexRange::forward(
+                               remainingFrameRange.end(), audioSource->frameIndexRange().end());
+            remainingFrameRange.growBack(
+                    audioSource->frameIndexRange().end() - remainingFrameRange.end());
+        }
+
+        chunk.readableSampleFrames = readableSampleFrames;
+        chunk.frameLength = audioSource->frameLength();
+        chunk.remainingFrames = remainingFrameRange.length();
+        chunk.endOfTrack = false;
+        publishChunk();
+    }
+}
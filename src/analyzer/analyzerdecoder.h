@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <vector>
+
+#include "sources/audiosource.h"
+#include "util/samplebuffer.h"
+
+/// Decodes the audio source of the track that is currently analyzed on a
+/// separate thread, ahead of the analyzers.
+///
+/// Decoded chunks of kAnalysisFramesPerChunk frames are passed to the
+/// analyzer thread through a bounded ring of kAnalysisChunksDecodedAhead
+/// buffers. Decoding and analysis of a track overlap while the memory
+/// footprint stays constant, independent of the track length.
+///
+/// There is exactly one consumer, namely the AnalyzerThread that owns
+/// the decoder.
+class AnalyzerDecoder : public QThread {
+  public:
+    struct Chunk {
+        mixxx::SampleBuffer buffer;
+        /// The decoded frames, which might be empty if decoding failed.
+        /// The data is located in buffer.
+        mixxx::ReadableSampleFrames readableSampleFrames;
+        /// The length of the audio source and the number of frames that
+        /// still need to be decoded after this chunk. Both might change
+        /// while decoding and are needed for progress updates.
+        SINT frameLength = 0;
+        SINT remainingFrames = 0;
+        /// The last chunk of a track, contains no frames.
+        bool endOfTrack = false;
+    };
+
+    explicit AnalyzerDecoder(const QString& name);
+    ~AnalyzerDecoder() override;
+
+    /// Starts decoding the given audio source from the beginning.
+    /// The decoder must be idle.
+    void startDecoding(mixxx::AudioSourcePointer pAudioSource);
+
+    /// Waits until the decoder has finished or aborted decoding the
+    /// current track, i.e. until the audio source is no longer accessed.
+    /// If abort is true the decoder stops as soon as possible.
+    void stopDecoding(bool abort);
+
+    /// Blocks until at least one chunk is available and returns the
+    /// number of decoded chunks that are ready. The chunks are accessed
+    /// with chunk(i) until they are handed back with releaseChunks().
+    int acquireChunks();
+    const Chunk& chunk(int i) const;
+    void releaseChunks(int count);
+
+  protected:
+    void run() override;
+
+  private:
+    void decodeAudioSource();
+
+    // Returns false if decoding should be aborted
+    bool acquireFreeChunk();
+    void publishChunk();
+
+    std::vector<Chunk> m_chunks;
+    // Only accessed by the decoding thread
+    int m_writeIndex;
+    // Only accessed by the consumer
+    int m_readIndex;
+
+    QSemaphore m_freeChunks;
+    QSemaphore m_readyChunks;
+
+    QSemaphore m_semaStart;
+    QSemaphore m_semaStopped;
+    bool m_decoding;
+    std::atomic<bool> m_abort;
+    std::atomic<bool> m_quit;
+
+    // Passed to the decoding thread by startDecoding()
+    mixxx::AudioSourcePointer m_pAudioSource;
+};
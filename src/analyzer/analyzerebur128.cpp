@@ -9,7 +9,47 @@
 #include "util/timer.h"
 
 namespace {
+
 constexpr double kReplayGain2ReferenceLUFS = -18;
+
+bool addFrames(ebur128_state* pState, const CSAMPLE* pIn, SINT count) {
+    size_t frames = count / pState->channels;
+    int e = ebur128_add_frames_float(pState, pIn, frames);
+    VERIFY_OR_DEBUG_ASSERT(e == EBUR128_SUCCESS) {
+        qWarning() << "AnalyzerEbur128::processSamples() failed with" << e;
+        return false;
+    }
+    return true;
+}
+
+// The gating blocks of 400 ms that span the start of the segment are
+// missing, which is negligible for the integrated loudness of the long
+// tracks that are split into segments.
+class AnalyzerEbur128Segment : public AnalyzerSegment {
+  public:
+    explicit AnalyzerEbur128Segment(ebur128_state* pState)
+            : m_pState(pState) {
+    }
+    ~AnalyzerEbur128Segment() override {
+        if (m_pState) {
+            ebur128_destroy(&m_pState);
+        }
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        return addFrames(m_pState, pIn, count);
+    }
+
+    ebur128_state* releaseState() {
+        ebur128_state* pState = m_pState;
+        m_pState = nullptr;
+        return pState;
+    }
+
+  private:
+    ebur128_state* m_pState;
+};
+
 } // anonymous namespace
 
 AnalyzerEbur128::AnalyzerEbur128(UserSettingsPointer pConfig)
@@ -39,6 +79,10 @@ bool AnalyzerEbur128::initialize(
 }
 
 void AnalyzerEbur128::cleanup() {
+    for (ebur128_state* pState : m_segmentStates) {
+        ebur128_destroy(&pState);
+    }
+    m_segmentStates.clear();
     if (m_pState) {
         ebur128_destroy(&m_pState);
         // ebur128_destroy clears the pointer but let's not rely on that.
@@ -51,12 +95,27 @@ bool AnalyzerEbur128::processSamples(const CSAMPLE* pIn, SINT count) {
         return false;
     }
     ScopedTimer t(QStringLiteral("AnalyzerEbur128::processSamples()"));
-    size_t frames = count / m_pState->channels;
-    int e = ebur128_add_frames_float(m_pState, pIn, frames);
-    VERIFY_OR_DEBUG_ASSERT(e == EBUR128_SUCCESS) {
-        qWarning() << "AnalyzerEbur128::processSamples() failed with" << e;
-        return false;
+    return addFrames(m_pState, pIn, count);
+}
+
+AnalyzerSegmentPtr AnalyzerEbur128::newSegment(mixxx::IndexRange frameRange) {
+    Q_UNUSED(frameRange);
+    VERIFY_OR_DEBUG_ASSERT(m_pState) {
+        return nullptr;
+    }
+    ebur128_state* pState = ebur128_init(
+            m_pState->channels,
+            m_pState->samplerate,
+            m_pState->mode);
+    if (!pState) {
+        return nullptr;
     }
+    return std::make_unique<AnalyzerEbur128Segment>(pState);
+}
+
+bool AnalyzerEbur128::mergeSegment(AnalyzerSegmentPtr pSegment) {
+    m_segmentStates.push_back(
+            static_cast<AnalyzerEbur128Segment&>(*pSegment).releaseState());
     return true;
 }
 
@@ -65,7 +124,14 @@ void AnalyzerEbur128::storeResults(TrackPointer pTrack) {
         return;
     }
     double averageLufs;
-    int e = ebur128_loudness_global(m_pState, &averageLufs);
+    int e;
+    if (m_segmentStates.empty()) {
+        e = ebur128_loudness_global(m_pState, &averageLufs);
+    } else {
+        std::vector<ebur128_state*> states{m_pState};
+        states.insert(states.end(), m_segmentStates.begin(), m_segmentStates.end());
+        e = ebur128_loudness_global_multiple(states.data(), states.size(), &averageLufs);
+    }
     VERIFY_OR_DEBUG_ASSERT(e == EBUR128_SUCCESS) {
         qWarning() << "AnalyzerEbur128::storeResults() failed with" << e;
         return;
@@ -2,6 +2,8 @@
 
 #include <ebur128.h>
 
+#include <vector>
+
 #include "analyzer/analyzer.h"
 #include "preferences/replaygainsettings.h"
 
@@ -19,10 +21,15 @@ class AnalyzerEbur128 : public Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    AnalyzerSegmentPtr newSegment(mixxx::IndexRange frameRange) override;
+    bool mergeSegment(AnalyzerSegmentPtr pSegment) override;
     void storeResults(TrackPointer pTrack) override;
     void cleanup() override;
 
   private:
     ReplayGainSettings m_rgSettings;
     ebur128_state* m_pState;
+    // The states of merged segments, the integrated loudness is computed
+    // from the blocks of all states.
+    std::vector<ebur128_state*> m_segmentStates;
 };
@@ -0,0 +1,222 @@
+#include "analyzer/analyzersegments.h"
+
+#include <QThreadPool>
+#include <algorithm>
+
+#include "analyzer/constants.h"
+#include "util/logger.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("AnalyzerSegments");
+
+// Each segment needs its own audio source and results in small deviations
+// at its boundaries. Splitting is only worth it for long tracks like mixes
+// or recorded radio shows.
+constexpr SINT kMinSegmentSeconds = 120;
+
+} // anonymous namespace
+
+AnalyzerSegments::AnalyzerSegments(QThreadPool* pThreadPool)
+        : m_pThreadPool(pThreadPool),
+          m_firstSegmentEnd(0),
+          m_segmentedFrames(0),
+          m_abort(false),
+          m_processedFrames(0) {
+}
+
+AnalyzerSegments::~AnalyzerSegments() {
+    cancel();
+}
+
+SINT AnalyzerSegments::start(
+        const std::vector<AnalyzerWithState*>& analyzers,
+        mixxx::IndexRange frameRange,
+        mixxx::audio::SignalInfo signalInfo,
+        std::function<mixxx::AudioSourcePointer()> openAudioSource) {
+    DEBUG_ASSERT(!isStarted());
+    m_segmentedAnalyzers.clear();
+    m_firstSegmentEnd = frameRange.end();
+
+    // The pool threads process the following segments while this thread
+    // processes the first one
+    const SINT minSegmentFrames = kMinSegmentSeconds * signalInfo.getSampleRate();
+    const SINT segmentCount = std::min(
+            frameRange.length() / minSegmentFrames,
+            static_cast<SINT>(m_pThreadPool->maxThreadCount()) + 1);
+    if (segmentCount < 2) {
+        return m_firstSegmentEnd;
+    }
+    // All segments except the last one start at the beginning of a chunk of
+    // the main analysis
+    const SINT segmentFrames = (frameRange.length() / segmentCount /
+                                       mixxx::kAnalysisFramesPerChunk) *
+            mixxx::kAnalysisFramesPerChunk;
+
+    std::vector<Segment> segments(segmentCount - 1);
+    for (SINT i = 1; i < segmentCount; ++i) {
+        const SINT start = frameRange.start() + i * segmentFrames;
+        const SINT end = i + 1 < segmentCount ? start + segmentFrames : frameRange.end();
+        segments[i - 1].frameRange = mixxx::IndexRange::between(start, end);
+    }
+    for (auto* pAnalyzer : analyzers) {
+        std::vector<AnalyzerSegmentPtr> analyzerSegments;
+        for (const auto& segment : segments) {
+            auto pAnalyzerSegment = pAnalyzer->newSegment(segment.frameRange);
+            if (!pAnalyzerSegment) {
+                break;
+            }
+            analyzerSegments.push_back(std::move(pAnalyzerSegment));
+        }
+        if (analyzerSegments.size() != segments.size()) {
+            // Processed sequentially
+            continue;
+        }
+        m_segmentedAnalyzers.push_back(pAnalyzer);
+        for (size_t i = 0; i < segments.size(); ++i) {
+            segments[i].analyzerSegments.push_back(std::move(analyzerSegments[i]));
+        }
+    }
+    if (m_segmentedAnalyzers.empty()) {
+        return m_firstSegmentEnd;
+    }
+
+    m_signalInfo = signalInfo;
+    m_openAudioSource = std::move(openAudioSource);
+    m_segments = std::move(segments);
+    m_firstSegmentEnd = m_segments.front().frameRange.start();
+    m_segmentedFrames = frameRange.end() - m_firstSegmentEnd;
+    m_abort = false;
+    m_processedFrames = 0;
+    for (auto& segment : m_segments) {
+        Segment* pSegment = &segment;
+        m_pThreadPool->start([this, pSegment] {
+            processSegment(pSegment);
+            m_segmentsDone.release();
+        });
+    }
+    kLogger.debug()
+            << "Analyzing"
+            << m_segments.size()
+            << "segments after frame"
+            << m_firstSegmentEnd
+            << "with"
+            << m_segmentedAnalyzers.size()
+            << "analyzers";
+    return m_firstSegmentEnd;
+}
+
+bool AnalyzerSegments::isSegmented(const AnalyzerWithState* pAnalyzer) const {
+    return std::find(m_segmentedAnalyzers.cbegin(),
+                   m_segmentedAnalyzers.cend(),
+                   pAnalyzer) != m_segmentedAnalyzers.cend();
+}
+
+double AnalyzerSegments::progress() const {
+    if (m_segmentedFrames <= 0) {
+        return 1.0;
+    }
+    return static_cast<double>(m_processedFrames.load()) / m_segmentedFrames;
+}
+
+void AnalyzerSegments::processSegment(Segment* pSegment) {
+    const auto failed = [pSegment] {
+        for (auto& pAnalyzerSegment : pSegment->analyzerSegments) {
+            pAnalyzerSegment.reset();
+        }
+    };
+    const mixxx::AudioSourcePointer pAudioSource = m_openAudioSource();
+    if (!pAudioSource || pAudioSource->getSignalInfo() != m_signalInfo) {
+        kLogger.warning()
+                << "Failed to open audio source for segment"
+                << pSegment->frameRange;
+        failed();
+        return;
+    }
+    auto buffer = mixxx::SampleBuffer(
+            m_signalInfo.frames2samples(mixxx::kAnalysisFramesPerChunk));
+
+    // Settle the analyzers with the chunk before the segment, which is
+    // also processed by the preceding segment
+    const auto prerollFrameRange = intersect(
+            mixxx::IndexRange::between(
+                    pSegment->frameRange.start() - mixxx::kAnalysisFramesPerChunk,
+                    pSegment->frameRange.start()),
+            pAudioSource->frameIndexRange());
+    if (!prerollFrameRange.empty()) {
+        const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        prerollFrameRange,
+                        mixxx::SampleBuffer::WritableSlice(buffer)));
+        if (!readableSampleFrames.frameIndexRange().empty()) {
+            for (const auto& pAnalyzerSegment : pSegment->analyzerSegments) {
+                pAnalyzerSegment->prerollSamples(
+                        readableSampleFrames.readableData(),
+                        readableSampleFrames.readableLength());
+            }
+        }
+    }
+
+    mixxx::IndexRange remainingFrameRange = pSegment->frameRange;
+    while (!remainingFrameRange.empty()) {
+        if (m_abort.load()) {
+            failed();
+            return;
+        }
+        const auto chunkFrameRange = remainingFrameRange.splitAndShrinkFront(
+                std::min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
+        const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        chunkFrameRange,
+                        mixxx::SampleBuffer::WritableSlice(buffer)));
+        // Like the main analysis only the frames that could be read are
+        // processed
+        if (!readableSampleFrames.frameIndexRange().empty()) {
+            for (auto& pAnalyzerSegment : pSegment->analyzerSegments) {
+                if (pAnalyzerSegment &&
+                        !pAnalyzerSegment->processSamples(
+                                readableSampleFrames.readableData(),
+                                readableSampleFrames.readableLength())) {
+                    pAnalyzerSegment.reset();
+                }
+            }
+        }
+        m_processedFrames += chunkFrameRange.length();
+        remainingFrameRange = intersect(remainingFrameRange, pAudioSource->frameIndexRange());
+    }
+}
+
+bool AnalyzerSegments::tryFinish(int timeoutMillis) {
+    if (!isStarted()) {
+        return true;
+    }
+    const int segmentCount = static_cast<int>(m_segments.size());
+    if (!m_segmentsDone.tryAcquire(segmentCount, timeoutMillis)) {
+        return false;
+    }
+    for (auto& segment : m_segments) {
+        for (size_t i = 0; i < m_segmentedAnalyzers.size(); ++i) {
+            m_segmentedAnalyzers[i]->mergeSegment(
+                    std::move(segment.analyzerSegments[i]));
+        }
+    }
+    reset();
+    return true;
+}
+
+void AnalyzerSegments::cancel() {
+    if (!isStarted()) {
+        return;
+    }
+    m_abort = true;
+    m_segmentsDone.acquire(static_cast<int>(m_segments.size()));
+    reset();
+}
+
+void AnalyzerSegments::reset() {
+    // The segmented analyzers are kept until the next track, because
+    // they must not process the frames after the first segment again
+    m_segments.clear();
+    m_openAudioSource = nullptr;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <QSemaphore>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "sources/audiosource.h"
+#include "util/indexrange.h"
+
+class QThreadPool;
+
+/// Splits a long track into time segments that are analyzed in parallel by
+/// the analyzers that support it, see Analyzer::newSegment().
+///
+/// The AnalyzerThread still processes the first segment with all analyzers.
+/// Each of the following segments is decoded from its own audio source and
+/// analyzed on a thread of the pool. The results are merged in order of the
+/// segments after the first segment has been processed.
+///
+/// All functions must be invoked from the thread that owns the analyzers.
+class AnalyzerSegments {
+  public:
+    explicit AnalyzerSegments(QThreadPool* pThreadPool);
+    ~AnalyzerSegments();
+
+    /// Starts the analysis of the segments after the first one if the
+    /// frame range is long enough, and returns the end of the first
+    /// segment. Returns the end of the frame range if the track is not
+    /// split. The audio sources are opened on the threads of the pool and
+    /// must provide the same signal as the one of the main analysis.
+    SINT start(
+            const std::vector<AnalyzerWithState*>& analyzers,
+            mixxx::IndexRange frameRange,
+            mixxx::audio::SignalInfo signalInfo,
+            std::function<mixxx::AudioSourcePointer()> openAudioSource);
+
+    bool isStarted() const {
+        return !m_segments.empty();
+    }
+
+    /// Returns true if the analyzer only needs to process the frames
+    /// of the first segment of the current track.
+    bool isSegmented(const AnalyzerWithState* pAnalyzer) const;
+
+    SINT firstSegmentEnd() const {
+        return m_firstSegmentEnd;
+    }
+
+    /// The fraction of the frames after the first segment that have been
+    /// analyzed.
+    double progress() const;
+
+    /// Waits up to timeoutMillis until all segments have been analyzed and
+    /// merges them into the analyzers. Must not be invoked before the
+    /// analyzers have processed the first segment. Returns false on timeout.
+    /// Returns true immediately if no segments have been started.
+    bool tryFinish(int timeoutMillis);
+
+    /// Aborts the analysis of the segments and waits until the threads of
+    /// the pool don't access them anymore. Nothing is merged.
+    void cancel();
+
+  private:
+    struct Segment {
+        mixxx::IndexRange frameRange;
+        // One per segmented analyzer, reset if processing failed
+        std::vector<AnalyzerSegmentPtr> analyzerSegments;
+    };
+
+    void processSegment(Segment* pSegment);
+    void reset();
+
+    QThreadPool* const m_pThreadPool;
+
+    mixxx::audio::SignalInfo m_signalInfo;
+    std::function<mixxx::AudioSourcePointer()> m_openAudioSource;
+
+    std::vector<AnalyzerWithState*> m_segmentedAnalyzers;
+    std::vector<Segment> m_segments;
+    SINT m_firstSegmentEnd;
+    SINT m_segmentedFrames;
+
+    QSemaphore m_segmentsDone;
+    std::atomic<bool> m_abort;
+    std::atomic<SINT> m_processedFrames;
+};
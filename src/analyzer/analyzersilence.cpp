@@ -30,13 +30,31 @@ Iterator first_sound(Iterator begin, Iterator end) {
     });
 }
 
+class AnalyzerSilenceSegment : public AnalyzerSegment {
+  public:
+    explicit AnalyzerSilenceSegment(mixxx::audio::ChannelCount channelCount)
+            : m_channelCount(channelCount) {
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        m_soundRange.processSamples(
+                mixxx::spanutil::spanFromPtrLen(pIn, count), m_channelCount);
+        return true;
+    }
+
+    const AnalyzerSilence::SoundRange& soundRange() const {
+        return m_soundRange;
+    }
+
+  private:
+    const mixxx::audio::ChannelCount m_channelCount;
+    AnalyzerSilence::SoundRange m_soundRange;
+};
+
 } // anonymous namespace
 
 AnalyzerSilence::AnalyzerSilence(UserSettingsPointer pConfig)
-        : m_pConfig(pConfig),
-          m_framesProcessed(0),
-          m_signalStart(-1),
-          m_signalEnd(-1) {
+        : m_pConfig(pConfig) {
 }
 
 bool AnalyzerSilence::initialize(const AnalyzerTrack& track,
@@ -50,9 +68,7 @@ bool AnalyzerSilence::initialize(const AnalyzerTrack& track,
         return false;
     }
 
-    m_framesProcessed = 0;
-    m_signalStart = -1;
-    m_signalEnd = -1;
+    m_soundRange = SoundRange();
     m_channelCount = channelCount;
 
     return true;
@@ -83,24 +99,49 @@ bool AnalyzerSilence::verifyFirstSound(
     return false;
 }
 
-bool AnalyzerSilence::processSamples(const CSAMPLE* pIn, SINT count) {
-    SINT numFrames = count / m_channelCount;
+void AnalyzerSilence::SoundRange::processSamples(
+        std::span<const CSAMPLE> samples,
+        mixxx::audio::ChannelCount channelCount) {
+    const SINT count = static_cast<SINT>(samples.size());
+    SINT numFrames = count / channelCount;
 
-    std::span<const CSAMPLE> samples = mixxx::spanutil::spanFromPtrLen(pIn, count);
-    if (m_signalStart < 0) {
+    if (signalStart < 0) {
         const SINT firstSoundSample = findFirstSoundInChunk(samples);
         if (firstSoundSample < count) {
-            m_signalStart = m_framesProcessed + firstSoundSample / m_channelCount;
+            signalStart = framesProcessed + firstSoundSample / channelCount;
         }
     }
-    if (m_signalStart >= 0) {
+    if (signalStart >= 0) {
         const SINT lastSoundSample = findLastSoundInChunk(samples);
         if (lastSoundSample >= 0) {
-            m_signalEnd = m_framesProcessed + lastSoundSample / m_channelCount + 1;
+            signalEnd = framesProcessed + lastSoundSample / channelCount + 1;
         }
     }
 
-    m_framesProcessed += numFrames;
+    framesProcessed += numFrames;
+}
+
+bool AnalyzerSilence::processSamples(const CSAMPLE* pIn, SINT count) {
+    m_soundRange.processSamples(mixxx::spanutil::spanFromPtrLen(pIn, count), m_channelCount);
+    return true;
+}
+
+AnalyzerSegmentPtr AnalyzerSilence::newSegment(mixxx::IndexRange frameRange) {
+    Q_UNUSED(frameRange);
+    return std::make_unique<AnalyzerSilenceSegment>(m_channelCount);
+}
+
+bool AnalyzerSilence::mergeSegment(AnalyzerSegmentPtr pSegment) {
+    // The segment continues at the frame after the processed frames
+    const SoundRange& segment =
+            static_cast<const AnalyzerSilenceSegment&>(*pSegment).soundRange();
+    if (m_soundRange.signalStart < 0 && segment.signalStart >= 0) {
+        m_soundRange.signalStart = m_soundRange.framesProcessed + segment.signalStart;
+    }
+    if (segment.signalEnd >= 0) {
+        m_soundRange.signalEnd = m_soundRange.framesProcessed + segment.signalEnd;
+    }
+    m_soundRange.framesProcessed += segment.framesProcessed;
     return true;
 }
 
@@ -108,15 +149,15 @@ void AnalyzerSilence::cleanup() {
 }
 
 void AnalyzerSilence::storeResults(TrackPointer pTrack) {
-    if (m_signalStart < 0) {
-        m_signalStart = 0;
+    if (m_soundRange.signalStart < 0) {
+        m_soundRange.signalStart = 0;
     }
-    if (m_signalEnd < 0) {
-        m_signalEnd = m_framesProcessed;
+    if (m_soundRange.signalEnd < 0) {
+        m_soundRange.signalEnd = m_soundRange.framesProcessed;
     }
 
-    const auto firstSoundPosition = mixxx::audio::FramePos(m_signalStart);
-    const auto lastSoundPosition = mixxx::audio::FramePos(m_signalEnd);
+    const auto firstSoundPosition = mixxx::audio::FramePos(m_soundRange.signalStart);
+    const auto lastSoundPosition = mixxx::audio::FramePos(m_soundRange.signalEnd);
 
     CuePointer pN60dBSound = pTrack->findCueByType(mixxx::CueType::N60dBSound);
     if (pN60dBSound == nullptr) {
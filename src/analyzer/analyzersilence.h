@@ -26,6 +26,8 @@ class AnalyzerSilence : public Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    AnalyzerSegmentPtr newSegment(mixxx::IndexRange frameRange) override;
+    bool mergeSegment(AnalyzerSegmentPtr pSegment) override;
     void storeResults(TrackPointer pTrack) override;
     void cleanup() override;
 
@@ -50,10 +52,19 @@ class AnalyzerSilence : public Analyzer {
             mixxx::audio::FramePos firstSoundFrame,
             mixxx::audio::ChannelCount channelCount);
 
+    /// The frames with sound in the processed samples, relative to the
+    /// first processed frame.
+    struct SoundRange {
+        SINT framesProcessed = 0;
+        SINT signalStart = -1;
+        SINT signalEnd = -1;
+
+        void processSamples(std::span<const CSAMPLE> samples,
+                mixxx::audio::ChannelCount channelCount);
+    };
+
   private:
     UserSettingsPointer m_pConfig;
     mixxx::audio::ChannelCount m_channelCount;
-    SINT m_framesProcessed;
-    SINT m_signalStart;
-    SINT m_signalEnd;
+    SoundRange m_soundRange;
 };
@@ -1,11 +1,17 @@
 #include "analyzer/analyzerthread.h"
 
+#include <QSemaphore>
+#include <QThreadPool>
+#include <algorithm>
+#include <limits>
 #include <mutex>
 
 #include "analyzer/analyzerbeats.h"
+#include "analyzer/analyzerdecoder.h"
 #include "analyzer/analyzerebur128.h"
 #include "analyzer/analyzergain.h"
 #include "analyzer/analyzerkey.h"
+#include "analyzer/analyzersegments.h"
 #include "analyzer/analyzersilence.h"
 #include "analyzer/analyzerwaveform.h"
 #include "analyzer/constants.h"
@@ -34,6 +40,40 @@ mixxx::Logger kLogger("AnalyzerThread");
 // continuous feedback.
 const mixxx::Duration kBusyProgressInhibitDuration = mixxx::Duration::fromMillis(60);
 
+// How long to wait for the segments of a long track before emitting the
+// next progress update
+constexpr int kSegmentsProgressIntervalMillis = 60;
+
+// Shared by all analyzer threads for running the analyzers of a track in
+// parallel. The pool bounds the number of additional threads independent
+// of how many analyzer threads are running.
+QThreadPool* analyzerThreadPool() {
+    static QThreadPool s_threadPool;
+    return &s_threadPool;
+}
+
+// Shared by all analyzer threads for analyzing the time segments of long
+// tracks. The tasks run for the whole track and would otherwise block the
+// short tasks of processChunks().
+QThreadPool* analyzerSegmentThreadPool() {
+    static QThreadPool s_threadPool;
+    return &s_threadPool;
+}
+
+mixxx::AudioSourcePointer openAudioSourceForAnalysis(const TrackPointer& pTrack) {
+    mixxx::AudioSource::OpenParams openParams;
+    openParams.setChannelCount(mixxx::kAnalysisMaxChannels);
+    auto audioSource = SoundSourceProxy(pTrack).openAudioSource(openParams);
+    // If we have a non-even multi channel audio source (mono or )
+    if (audioSource &&
+            audioSource->getSignalInfo().getChannelCount() % mixxx::kAnalysisChannels) {
+        audioSource = std::make_shared<mixxx::AudioSourceStereoProxy>(
+                audioSource,
+                mixxx::kAnalysisFramesPerChunk);
+    }
+    return audioSource;
+}
+
 void deleteAnalyzerThread(AnalyzerThread* plainPtr) {
     if (plainPtr) {
         plainPtr->deleteAfterFinished();
@@ -82,11 +122,15 @@ AnalyzerThread::AnalyzerThread(
           m_pConfig(pConfig),
           m_modeFlags(modeFlags),
           m_nextTrack(2), // minimum capacity
-          m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk),
           m_emittedState(AnalyzerThreadState::Void) {
     std::call_once(registerMetaTypesOnceFlag, registerMetaTypesOnce);
 }
 
+AnalyzerThread::~AnalyzerThread() {
+    // Required to allow forward declarations of (managed pointer) members
+    // in header file
+}
+
 void AnalyzerThread::doRun() {
     std::unique_ptr<AnalysisDao> pAnalysisDao;
     // The thread-local database connection  must not be closed
@@ -117,19 +161,21 @@ void AnalyzerThread::doRun() {
     m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerSilence>(m_pConfig)));
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
+    m_activeAnalyzers.reserve(m_analyzers.size());
 
-    m_lastBusyProgressEmittedTimer.start();
+    m_pDecoder = std::make_unique<AnalyzerDecoder>(
+            QStringLiteral("AnalyzerDecoder %1").arg(m_id));
+    m_pSegments = std::make_unique<AnalyzerSegments>(analyzerSegmentThreadPool());
 
-    mixxx::AudioSource::OpenParams openParams;
-    openParams.setChannelCount(mixxx::kAnalysisMaxChannels);
+    m_lastBusyProgressEmittedTimer.start();
 
     while (awaitWorkItemsFetched()) {
         DEBUG_ASSERT(m_currentTrack.has_value());
         kLogger.debug() << "Analyzing" << m_currentTrack->getTrack()->getLocation();
 
         // Get the audio
-        mixxx::AudioSourcePointer audioSource =
-                SoundSourceProxy(m_currentTrack->getTrack()).openAudioSource(openParams);
+        const mixxx::AudioSourcePointer audioSource =
+                openAudioSourceForAnalysis(m_currentTrack->getTrack());
         if (!audioSource) {
             kLogger.warning()
                     << "Failed to open file for analyzing:"
@@ -138,13 +184,6 @@ void AnalyzerThread::doRun() {
             continue;
         }
 
-        // If we have a non-even multi channel audio source (mono or )
-        if (audioSource->getSignalInfo().getChannelCount() % mixxx::kAnalysisChannels) {
-            audioSource = std::make_shared<mixxx::AudioSourceStereoProxy>(
-                    audioSource,
-                    mixxx::kAnalysisFramesPerChunk);
-        }
-
         bool processTrack = false;
         for (auto&& analyzer : m_analyzers) {
             // Make sure not to short-circuit initialize(...)
@@ -187,6 +226,9 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    m_pSegments.reset();
+    m_pDecoder.reset();
+    m_activeAnalyzers.clear();
     m_analyzers.clear();
 
     kLogger.debug() << "Exiting worker thread";
@@ -234,86 +276,80 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     // Analysis starts now
     emitBusyProgress(kAnalyzerProgressNone);
 
-    mixxx::IndexRange remainingFrameRange = audioSource->frameIndexRange();
-    while (!remainingFrameRange.empty()) {
+    // 1st stage: The decoder reads chunks of audio data ahead on its
+    // own thread until all chunks in its ring are filled.
+    m_pDecoder->startDecoding(audioSource);
+
+    // The segments of long tracks are decoded and analyzed on the pool
+    // while the analyzers process the first segment on the main pass.
+    m_activeAnalyzers.clear();
+    for (auto&& analyzer : m_analyzers) {
+        if (analyzer.isActive()) {
+            m_activeAnalyzers.push_back(&analyzer);
+        }
+    }
+    const SINT firstSegmentEnd = m_pSegments->start(
+            m_activeAnalyzers,
+            audioSource->frameIndexRange(),
+            audioSource->getSignalInfo(),
+            [pTrack = m_currentTrack->getTrack()] {
+                return openAudioSourceForAnalysis(pTrack);
+            });
+
+    bool decoding = true;
+    while (true) {
         sleepWhileSuspended();
         if (isStopping()) {
+            m_pSegments->cancel();
+            m_pDecoder->stopDecoding(true);
             return AnalysisResult::Cancelled;
         }
 
-        // 1st step: Decode next chunk of audio data
-
-        // Split the range for the next chunk from the remaining (= to-be-analyzed) frames
-        auto chunkFrameRange =
-                remainingFrameRange.splitAndShrinkFront(
-                        math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
-        DEBUG_ASSERT(!chunkFrameRange.empty());
-
-        // Request the next chunk of audio data
-        const auto readableSampleFrames =
-                audioSource->readSampleFrames(
-                        mixxx::WritableSampleFrames(
-                                chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
-        // The returned range fits into the requested range
-        DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
-
-        // Sometimes the duration of the audio source is inaccurate and adjusted
-        // while reading. We need to adjust all frame ranges to reflect this new
-        // situation by restoring all invariants and consistency requirements!
-
-        // Shrink the original range of the current chunks to the actual available
-        // range.
-        chunkFrameRange = intersect(chunkFrameRange, audioSource->frameIndexRange());
-        // The audio data that has just been read should still fit into the adjusted
-        // chunk range.
-        DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
-
-        // We also need to adjust the remaining frame range for the next requests.
-        remainingFrameRange = intersect(remainingFrameRange, audioSource->frameIndexRange());
-        // Currently the range will never grow, but lets also account for this case
-        // that might become relevant in the future.
-        VERIFY_OR_DEBUG_ASSERT(remainingFrameRange.empty() ||
-                remainingFrameRange.end() == audioSource->frameIndexRange().end()) {
-            if (chunkFrameRange.length() < mixxx::kAnalysisFramesPerChunk) {
-                // If we have read an incomplete chunk while the range has grown
-                // we need to discard the read results and re-read the current
-                // chunk!
-
-                remainingFrameRange.growFront(chunkFrameRange.length());
-                continue;
-            }
-            DEBUG_ASSERT(remainingFrameRange.end() < audioSource->frameIndexRange().end());
-            kLogger.warning()
-                    << "Unexpected growth of the audio source while reading"
-                    << mixxx::IndexRange::forward(
-                               remainingFrameRange.end(), audioSource->frameIndexRange().end());
-            remainingFrameRange.growBack(
-                    audioSource->frameIndexRange().end() - remainingFrameRange.end());
+        // Consume all chunks that have been decoded in the meantime at
+        // once to reduce the synchronization overhead between the stages.
+        int numChunks = m_pDecoder->acquireChunks();
+        const AnalyzerDecoder::Chunk& lastChunk = m_pDecoder->chunk(numChunks - 1);
+        const bool endOfTrack = lastChunk.endOfTrack;
+        const SINT frameLength = lastChunk.frameLength;
+        const SINT remainingFrames = lastChunk.remainingFrames;
+
+        // 2nd stage: Analyze the decoded chunks
+        if (endOfTrack) {
+            // The end marker contains no audio data
+            --numChunks;
+        }
+        if (numChunks > 0) {
+            processChunks(numChunks);
         }
+        m_pDecoder->releaseChunks(endOfTrack ? numChunks + 1 : numChunks);
 
-        sleepWhileSuspended();
-        if (isStopping()) {
-            return AnalysisResult::Cancelled;
+        if (endOfTrack) {
+            break;
         }
 
-        // 2nd: step: Analyze chunk of decoded audio data
-        if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
-                        readableSampleFrames.readableData(),
-                        readableSampleFrames.readableLength());
+        const SINT decodedFrameEnd = audioSource->frameIndexRange().end() - remainingFrames;
+        if (m_pSegments->isStarted() && decodedFrameEnd >= firstSegmentEnd) {
+            if (!needsFramesAfterFirstSegment()) {
+                // Only the segments are left
+                m_pDecoder->stopDecoding(true);
+                decoding = false;
+                break;
             }
+            // Merge the segments early to show the complete waveform
+            m_pSegments->tryFinish(0);
         }
 
         // Don't check again for paused/stopped again and simply finish
         // the current iteration by emitting progress.
 
         // 3rd step: Update & emit progress
-        if (audioSource->frameLength() > 0) {
-            const double frameProgress =
-                    static_cast<double>(audioSource->frameLength() - remainingFrameRange.length()) /
-                    audioSource->frameLength();
+        if (frameLength > 0) {
+            double frameProgress =
+                    static_cast<double>(frameLength - remainingFrames) /
+                    frameLength;
+            if (m_pSegments->isStarted()) {
+                frameProgress = std::min(frameProgress, m_pSegments->progress());
+            }
             // math_min is required to compensate rounding errors
             const AnalyzerProgress progress =
                     math_min(kAnalyzerProgressFinalizing,
@@ -323,14 +359,86 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
             emitBusyProgress(progress);
         } else {
             // Unreadable audio source
-            DEBUG_ASSERT(remainingFrameRange.empty());
+            DEBUG_ASSERT(remainingFrames == 0);
             emitBusyProgress(kAnalyzerProgressUnknown);
         }
     }
 
+    while (!m_pSegments->tryFinish(kSegmentsProgressIntervalMillis)) {
+        if (isStopping()) {
+            m_pSegments->cancel();
+            if (decoding) {
+                m_pDecoder->stopDecoding(true);
+            }
+            return AnalysisResult::Cancelled;
+        }
+        emitBusyProgress(math_min(kAnalyzerProgressFinalizing,
+                m_pSegments->progress() *
+                        (kAnalyzerProgressFinalizing - kAnalyzerProgressNone)));
+    }
+
+    if (decoding) {
+        m_pDecoder->stopDecoding(false);
+    }
     return AnalysisResult::Finished;
 }
 
+bool AnalyzerThread::needsFramesAfterFirstSegment() const {
+    return std::any_of(m_analyzers.cbegin(),
+            m_analyzers.cend(),
+            [this](const auto& analyzer) {
+                return analyzer.isActive() && !m_pSegments->isSegmented(&analyzer);
+            });
+}
+
+void AnalyzerThread::processChunks(int numChunks) {
+    m_activeAnalyzers.clear();
+    for (auto&& analyzer : m_analyzers) {
+        if (analyzer.isActive()) {
+            m_activeAnalyzers.push_back(&analyzer);
+        }
+    }
+    if (m_activeAnalyzers.empty()) {
+        return;
+    }
+
+    // The analyzers are independent of each other. Each of them processes
+    // all chunks in order on one thread.
+    const auto analyzeChunks = [this, numChunks](AnalyzerWithState* pAnalyzer) {
+        // Segmented analyzers only process the first segment
+        const SINT frameEnd = m_pSegments->isSegmented(pAnalyzer)
+                ? m_pSegments->firstSegmentEnd()
+                : std::numeric_limits<SINT>::max();
+        for (int i = 0; i < numChunks; ++i) {
+            const auto& readableSampleFrames =
+                    m_pDecoder->chunk(i).readableSampleFrames;
+            const auto frameIndexRange = readableSampleFrames.frameIndexRange();
+            if (frameIndexRange.empty() || frameIndexRange.start() >= frameEnd) {
+                continue;
+            }
+            SINT count = readableSampleFrames.readableLength();
+            if (frameIndexRange.end() > frameEnd) {
+                count = count / frameIndexRange.length() *
+                        (frameEnd - frameIndexRange.start());
+            }
+            pAnalyzer->processSamples(readableSampleFrames.readableData(), count);
+        }
+    };
+
+    QSemaphore analyzersDone;
+    const int numPooledAnalyzers = static_cast<int>(m_activeAnalyzers.size()) - 1;
+    for (int i = 1; i <= numPooledAnalyzers; ++i) {
+        AnalyzerWithState* pAnalyzer = m_activeAnalyzers[i];
+        analyzerThreadPool()->start([&analyzeChunks, &analyzersDone, pAnalyzer] {
+            analyzeChunks(pAnalyzer);
+            analyzersDone.release();
+        });
+    }
+    // This thread takes part instead of waiting idle
+    analyzeChunks(m_activeAnalyzers.front());
+    analyzersDone.acquire(numPooledAnalyzers);
+}
+
 void AnalyzerThread::emitBusyProgress(AnalyzerProgress busyProgress) {
     DEBUG_ASSERT(m_currentTrack.has_value());
     if ((m_emittedState == AnalyzerThreadState::Busy) &&
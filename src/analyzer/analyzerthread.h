@@ -14,9 +14,11 @@
 #include "track/trackid.h"
 #include "util/db/dbconnectionpool.h"
 #include "util/performancetimer.h"
-#include "util/samplebuffer.h"
 #include "util/workerthread.h"
 
+class AnalyzerDecoder;
+class AnalyzerSegments;
+
 enum AnalyzerModeFlags {
     None = 0x00,
     WithBeats = 0x01,
@@ -66,7 +68,7 @@ class AnalyzerThread : public WorkerThread {
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
             AnalyzerModeFlags modeFlags);
-    ~AnalyzerThread() override = default;
+    ~AnalyzerThread() override;
 
     int id() const {
         return m_id;
@@ -117,8 +119,13 @@ class AnalyzerThread : public WorkerThread {
     // run() by the worker thread.
 
     std::vector<AnalyzerWithState> m_analyzers;
+    std::vector<AnalyzerWithState*> m_activeAnalyzers;
+
+    // Decodes the current track ahead of the analyzers
+    std::unique_ptr<AnalyzerDecoder> m_pDecoder;
 
-    mixxx::SampleBuffer m_sampleBuffer;
+    // Analyzes the time segments of long tracks in parallel
+    std::unique_ptr<AnalyzerSegments> m_pSegments;
 
     std::optional<AnalyzerTrack> m_currentTrack;
 
@@ -134,6 +141,13 @@ class AnalyzerThread : public WorkerThread {
     AnalysisResult analyzeAudioSource(
             const mixxx::AudioSourcePointer& audioSource);
 
+    // Runs all active analyzers in parallel on the decoded chunks
+    void processChunks(int numChunks);
+
+    // Returns true if any active analyzer needs the frames after the
+    // first segment from the decoder
+    bool needsFramesAfterFirstSegment() const;
+
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
 
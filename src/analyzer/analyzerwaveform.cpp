@@ -1,5 +1,8 @@
 #include "analyzer/analyzerwaveform.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -19,23 +22,316 @@ constexpr double kLowMidFreqHz = 600.0;
 
 constexpr double kMidHighFreqHz = 4000.0;
 
+int stemCountForChannelCount(mixxx::audio::ChannelCount channelCount) {
+    return channelCount == mixxx::kAnalysisChannels
+            ? 0
+            : channelCount / mixxx::kAnalysisChannels;
+}
+
+// The position at which the last stride up to the given frame is stored
+// by WaveformAnalysis::process(), i.e. the first frame of the following
+// stride. A stride is stored at each position with
+// fmod(position, strideLength) < 1.
+int lastStoredStridePosition(SINT frame, double strideLength) {
+    for (int position = static_cast<int>(frame); position > 0; --position) {
+        if (std::fmod(position, strideLength) < 1) {
+            return position;
+        }
+    }
+    return 0;
+}
+
+// The number of strides that are stored while processing the frames before
+// the given position, i.e. once after each multiple of strideLength >= 1.
+int storedStrideCount(int position, double strideLength) {
+    // fmod() is exact and the quotient is an integer
+    return static_cast<int>(std::llround(
+            (position - std::fmod(position, strideLength)) / strideLength));
+}
+
+class AnalyzerWaveformSegment : public AnalyzerSegment {
+  public:
+    AnalyzerWaveformSegment(
+            const WaveformPointer& pWaveform,
+            const WaveformPointer& pWaveformSummary,
+            mixxx::audio::SampleRate sampleRate,
+            mixxx::audio::ChannelCount channelCount,
+            SINT startFrame)
+            : m_analysis(pWaveform,
+                      pWaveformSummary,
+                      sampleRate,
+                      channelCount,
+                      startFrame) {
+    }
+
+    void prerollSamples(const CSAMPLE* pIn, SINT count) override {
+        m_analysis.preroll(pIn, count);
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        return m_analysis.process(pIn, count);
+    }
+
+    void stopAtFrame(SINT frame) {
+        m_analysis.stopAtFrame(frame);
+    }
+
+    const WaveformAnalysis& analysis() const {
+        return m_analysis;
+    }
+
+  private:
+    WaveformAnalysis m_analysis;
+};
+
 } // namespace
 
+WaveformAnalysis::WaveformAnalysis(
+        const WaveformPointer& pWaveform,
+        const WaveformPointer& pWaveformSummary,
+        mixxx::audio::SampleRate sampleRate,
+        mixxx::audio::ChannelCount channelCount,
+        SINT startFrame)
+        : m_waveform(pWaveform),
+          m_waveformSummary(pWaveformSummary),
+          m_waveformData(pWaveform->data()),
+          m_waveformSummaryData(pWaveformSummary->data()),
+          m_stride(pWaveform->getAudioVisualRatio(),
+                  pWaveformSummary->getAudioVisualRatio(),
+                  stemCountForChannelCount(channelCount)),
+          m_channelCount(channelCount),
+          m_startPosition(lastStoredStridePosition(startFrame, m_stride.m_length)),
+          m_leadFrames(startFrame - m_startPosition),
+          m_endPosition(std::numeric_limits<int>::max()),
+          m_currentStride(ChannelCount *
+                  storedStrideCount(m_startPosition, m_stride.m_length)),
+          m_currentSummaryStride(ChannelCount *
+                  storedStrideCount(m_startPosition, m_stride.m_averageLength)),
+          m_firstStride(m_currentStride),
+          m_firstSummaryStride(m_currentSummaryStride) {
+    m_stride.m_position = m_startPosition;
+
+    // m_filter[Low] = new EngineFilterButterworth8Low(sampleRate, kLowMidFreqHz);
+    // m_filter[Mid] = new EngineFilterButterworth8Band(sampleRate, kLowMidFreqHz, kMidHighFreqHz);
+    // m_filter[High] = new EngineFilterButterworth8High(sampleRate, kMidHighFreqHz);
+    m_filters = {
+            std::make_unique<EngineFilterBessel4Low>(sampleRate, kLowMidFreqHz),
+            std::make_unique<EngineFilterBessel4Band>(sampleRate, kLowMidFreqHz, kMidHighFreqHz),
+            std::make_unique<EngineFilterBessel4High>(sampleRate, kMidHighFreqHz)};
+
+    // settle filters for silence in preroll to avoids ramping (Issue #7776)
+    m_filters.low->assumeSettled();
+    m_filters.mid->assumeSettled();
+    m_filters.high->assumeSettled();
+}
+
+WaveformAnalysis::~WaveformAnalysis() = default;
+
+const CSAMPLE* WaveformAnalysis::filter(const CSAMPLE* pIn, SINT numFrames) {
+    const SINT count = numFrames * mixxx::audio::ChannelCount::stereo();
+
+    // This should only append once if count is constant
+    if (count > m_buffers.size) {
+        m_buffers.low.resize(count);
+        m_buffers.mid.resize(count);
+        m_buffers.high.resize(count);
+        if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
+            m_buffers.mixed = mixxx::SampleBuffer(count);
+        }
+        m_buffers.size = count;
+    }
+
+    const CSAMPLE* pWaveformInput = pIn;
+    if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
+        DEBUG_ASSERT(0 == m_channelCount % mixxx::audio::ChannelCount::stereo());
+        VERIFY_OR_DEBUG_ASSERT(m_buffers.mixed.data()) {
+            return nullptr;
+        }
+        SampleUtil::mixMultichannelToStereo(
+                m_buffers.mixed.data(), pIn, numFrames, m_channelCount);
+        pWaveformInput = m_buffers.mixed.data();
+    }
+
+    m_filters.low->process(pWaveformInput, &m_buffers.low[0], count);
+    m_filters.mid->process(pWaveformInput, &m_buffers.mid[0], count);
+    m_filters.high->process(pWaveformInput, &m_buffers.high[0], count);
+    return pWaveformInput;
+}
+
+void WaveformAnalysis::preroll(const CSAMPLE* pIn, SINT count) {
+    const SINT numFrames = count / m_channelCount;
+    if (numFrames < m_leadFrames) {
+        // The first stride misses the frames before the start frame
+        filter(pIn, numFrames);
+        return;
+    }
+    const SINT prerollFrames = numFrames - m_leadFrames;
+    if (prerollFrames > 0) {
+        filter(pIn, prerollFrames);
+    }
+    m_leadFrames = 0;
+    process(pIn + prerollFrames * m_channelCount,
+            count - prerollFrames * m_channelCount);
+}
+
+void WaveformAnalysis::stopAtFrame(SINT frame) {
+    m_endPosition = std::min(m_endPosition,
+            lastStoredStridePosition(frame, m_stride.m_length));
+}
+
+bool WaveformAnalysis::process(const CSAMPLE* pIn, SINT count) {
+    if (m_leadFrames > 0) {
+        // Not preceded by preroll()
+        m_stride.m_position += static_cast<int>(m_leadFrames);
+        m_leadFrames = 0;
+    }
+    SINT numFrames = std::min<SINT>(count / m_channelCount,
+            static_cast<SINT>(m_endPosition) - m_stride.m_position);
+    if (numFrames <= 0) {
+        return true;
+    }
+    count = numFrames * mixxx::audio::ChannelCount::stereo();
+    int stemCount = 0;
+    if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
+        stemCount = m_channelCount / mixxx::audio::ChannelCount::stereo();
+    }
+
+    const CSAMPLE* pWaveformInput = filter(pIn, numFrames);
+    if (!pWaveformInput) {
+        return false;
+    }
+
+    for (SINT i = 0; i < count; i += 2) {
+        // Take max value, not average of data
+        CSAMPLE cover[2] = {fabs(pWaveformInput[i]), fabs(pWaveformInput[i + 1])};
+        CSAMPLE clow[2] = {fabs(m_buffers.low[i]), fabs(m_buffers.low[i + 1])};
+        CSAMPLE cmid[2] = {fabs(m_buffers.mid[i]), fabs(m_buffers.mid[i + 1])};
+        CSAMPLE chigh[2] = {fabs(m_buffers.high[i]), fabs(m_buffers.high[i + 1])};
+
+        // This is for if you want to experiment with averaging instead of
+        // maxing.
+        // m_stride.m_overallData[Right] += buffer[i]*buffer[i];
+        // m_stride.m_overallData[Left] += buffer[i + 1]*buffer[i + 1];
+        // m_stride.m_filteredData[Right][Low] += m_buffers.low[i]*m_buffers.low[i];
+        // m_stride.m_filteredData[Left][Low] += m_buffers.low[i + 1]*m_buffers.low[i + 1];
+        // m_stride.m_filteredData[Right][Mid] += m_buffers.mid[i]*m_buffers.mid[i];
+        // m_stride.m_filteredData[Left][Mid] += m_buffers.mid[i + 1]*m_buffers.mid[i + 1];
+        // m_stride.m_filteredData[Right][High] += m_buffers.high[i]*m_buffers.high[i];
+        // m_stride.m_filteredData[Left][High] += m_buffers.high[i + 1]*m_buffers.high[i + 1];
+
+        // Record the max across this stride.
+        storeIfGreater(&m_stride.m_overallData[Left], cover[Left]);
+        storeIfGreater(&m_stride.m_overallData[Right], cover[Right]);
+        storeIfGreater(&m_stride.m_filteredData[Left][Low], clow[Left]);
+        storeIfGreater(&m_stride.m_filteredData[Right][Low], clow[Right]);
+        storeIfGreater(&m_stride.m_filteredData[Left][Mid], cmid[Left]);
+        storeIfGreater(&m_stride.m_filteredData[Right][Mid], cmid[Right]);
+        storeIfGreater(&m_stride.m_filteredData[Left][High], chigh[Left]);
+        storeIfGreater(&m_stride.m_filteredData[Right][High], chigh[Right]);
+
+        for (int s = 0; s < stemCount; s++) {
+            CSAMPLE cstem[2] = {
+                    fabs(pIn[i * stemCount + s * mixxx::kAnalysisChannels]),
+                    fabs(pIn[i * stemCount + s * mixxx::kAnalysisChannels +
+                            1])};
+            storeIfGreater(&m_stride.m_stemData[Left][s], cstem[Left]);
+            storeIfGreater(&m_stride.m_stemData[Right][s], cstem[Right]);
+        }
+
+        m_stride.m_position++;
+
+        if (fmod(m_stride.m_position, m_stride.m_length) < 1) {
+            VERIFY_OR_DEBUG_ASSERT(m_currentStride + ChannelCount <= m_waveform->getDataSize()) {
+                qWarning() << "AnalyzerWaveform::process - currentStride > waveform size";
+                return false;
+            }
+            m_stride.store(m_waveformData + m_currentStride);
+            m_currentStride += ChannelCount;
+        }
+
+        if (fmod(m_stride.m_position, m_stride.m_averageLength) < 1) {
+            VERIFY_OR_DEBUG_ASSERT(m_currentSummaryStride + ChannelCount <= m_waveformSummary->getDataSize()) {
+                qWarning() << "AnalyzerWaveform::process - current summary stride > waveform summary size";
+                return false;
+            }
+            if (!m_firstSummaryStrideHead) {
+                // The preceding segment holds the rest of this stride
+                m_firstSummaryStrideHead = m_stride;
+            }
+            m_stride.averageStore(m_waveformSummaryData + m_currentSummaryStride);
+            m_currentSummaryStride += ChannelCount;
+
+#ifdef TEST_HEAT_MAP
+            QPointF point(m_stride.m_filteredData[Right][High],
+                    m_stride.m_filteredData[Right][Mid]);
+
+            float norm = sqrt(point.x() * point.x() + point.y() * point.y());
+            point /= norm;
+
+            point *= m_stride.m_filteredData[Right][Low];
+            test_heatMap->setPixel(point.toPoint(), 0xFF0000FF);
+#endif
+        }
+    }
+    return true;
+}
+
+void WaveformAnalysis::append(const WaveformAnalysis& next) {
+    DEBUG_ASSERT(m_waveform == next.m_waveform);
+    // Might be less if reading the track failed
+    DEBUG_ASSERT(m_currentStride <= next.m_firstStride);
+    DEBUG_ASSERT(m_currentSummaryStride <= next.m_firstSummaryStride);
+
+    const WaveformStride tail = m_stride;
+    if (next.m_firstSummaryStrideHead) {
+        // Store the first summary stride of next again, including the
+        // strides that have been stored by this analysis
+        WaveformStride stride = tail;
+        const WaveformStride& head = *next.m_firstSummaryStrideHead;
+        stride.m_averageDivisor += head.m_averageDivisor;
+        for (int i = 0; i < ChannelCount; ++i) {
+            stride.m_averageOverallData[i] += head.m_averageOverallData[i];
+            storeIfGreater(&stride.m_overallData[i], head.m_overallData[i]);
+            for (int f = 0; f < BandCount; ++f) {
+                stride.m_averageFilteredData[i][f] += head.m_averageFilteredData[i][f];
+                storeIfGreater(&stride.m_filteredData[i][f], head.m_filteredData[i][f]);
+            }
+        }
+        stride.averageStore(m_waveformSummaryData + next.m_firstSummaryStride);
+    }
+
+    // Continue with the partial strides at the end of next
+    m_stride = next.m_stride;
+    if (!next.m_firstSummaryStrideHead) {
+        m_stride.m_averageDivisor += tail.m_averageDivisor;
+        for (int i = 0; i < ChannelCount; ++i) {
+            m_stride.m_averageOverallData[i] += tail.m_averageOverallData[i];
+            for (int f = 0; f < BandCount; ++f) {
+                m_stride.m_averageFilteredData[i][f] += tail.m_averageFilteredData[i][f];
+            }
+        }
+    }
+    m_endPosition = next.m_endPosition;
+    m_currentStride = next.m_currentStride;
+    m_currentSummaryStride = next.m_currentSummaryStride;
+}
+
+void WaveformAnalysis::storeIfGreater(float* pDest, float source) {
+    if (*pDest < source) {
+        *pDest = source;
+    }
+}
+
 AnalyzerWaveform::AnalyzerWaveform(
         UserSettingsPointer pConfig,
         const QSqlDatabase& dbConnection)
         : m_analysisDao(pConfig),
-          m_waveformData(nullptr),
-          m_waveformSummaryData(nullptr),
-          m_stride(0, 0, 0),
-          m_currentStride(0),
-          m_currentSummaryStride(0) {
+          m_frameLength(0) {
     m_analysisDao.initialize(dbConnection);
 }
 
 AnalyzerWaveform::~AnalyzerWaveform() {
     kLogger.debug() << "~AnalyzerWaveform():";
-    destroyFilters();
 }
 
 bool AnalyzerWaveform::initialize(const AnalyzerTrack& track,
@@ -54,18 +350,12 @@ bool AnalyzerWaveform::initialize(const AnalyzerTrack& track,
 
     m_timer.start();
 
-    // Now actually initialize the AnalyzerWaveform:
-    destroyFilters();
-    createFilters(sampleRate);
-
     //TODO (vrince) Do we want to expose this as settings or whatever ?
     constexpr int mainWaveformSampleRate = 441;
     // two visual sample per pixel in full width overview in full hd
     constexpr int summaryWaveformSamples = 2 * 1920;
 
-    int stemCount = channelCount == mixxx::kAnalysisChannels
-            ? 0
-            : channelCount / mixxx::kAnalysisChannels;
+    int stemCount = stemCountForChannelCount(channelCount);
     m_waveform = WaveformPointer(new Waveform(
             sampleRate, frameLength, mainWaveformSampleRate, -1, stemCount));
     m_waveformSummary = WaveformPointer(new Waveform(
@@ -77,16 +367,12 @@ bool AnalyzerWaveform::initialize(const AnalyzerTrack& track,
     track.getTrack()->setWaveform(m_waveform);
     track.getTrack()->setWaveformSummary(m_waveformSummary);
 
-    m_waveformData = m_waveform->data();
-    m_waveformSummaryData = m_waveformSummary->data();
-
-    m_stride = WaveformStride(m_waveform->getAudioVisualRatio(),
-            m_waveformSummary->getAudioVisualRatio(),
-            stemCount);
-
-    m_currentStride = 0;
-    m_currentSummaryStride = 0;
+    // Now actually initialize the AnalyzerWaveform:
+    m_pAnalysis = std::make_unique<WaveformAnalysis>(
+            m_waveform, m_waveformSummary, sampleRate, channelCount, 0);
+    m_sampleRate = sampleRate;
     m_channelCount = channelCount;
+    m_frameLength = frameLength;
 
     //debug
     //m_waveform->dump();
@@ -95,6 +381,7 @@ bool AnalyzerWaveform::initialize(const AnalyzerTrack& track,
 #ifdef TEST_HEAT_MAP
     test_heatMap = new QImage(256, 256, QImage::Format_RGB32);
     test_heatMap->fill(0xFFFFFFFF);
+    m_pAnalysis->test_heatMap = test_heatMap;
 #endif
     return true;
 }
@@ -172,151 +459,54 @@ bool AnalyzerWaveform::shouldAnalyze(TrackPointer pTrack) const {
     return true;
 }
 
-void AnalyzerWaveform::createFilters(mixxx::audio::SampleRate sampleRate) {
-    // m_filter[Low] = new EngineFilterButterworth8Low(sampleRate, kLowMidFreqHz);
-    // m_filter[Mid] = new EngineFilterButterworth8Band(sampleRate, kLowMidFreqHz, kMidHighFreqHz);
-    // m_filter[High] = new EngineFilterButterworth8High(sampleRate, kMidHighFreqHz);
-    m_filters = {
-            std::make_unique<EngineFilterBessel4Low>(sampleRate, kLowMidFreqHz),
-            std::make_unique<EngineFilterBessel4Band>(sampleRate, kLowMidFreqHz, kMidHighFreqHz),
-            std::make_unique<EngineFilterBessel4High>(sampleRate, kMidHighFreqHz)};
-
-    // settle filters for silence in preroll to avoids ramping (Issue #7776)
-    m_filters.low->assumeSettled();
-    m_filters.mid->assumeSettled();
-    m_filters.high->assumeSettled();
-}
-
-void AnalyzerWaveform::destroyFilters() {
-    m_filters = {};
-}
-
 bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
-    VERIFY_OR_DEBUG_ASSERT(m_waveform) {
+    VERIFY_OR_DEBUG_ASSERT(m_pAnalysis) {
         return false;
     }
-    VERIFY_OR_DEBUG_ASSERT(m_waveformSummary) {
-        return false;
-    }
-
-    SINT numFrames = count / m_channelCount;
-    count = numFrames * mixxx::audio::ChannelCount::stereo();
-    int stemCount = 0;
-
-    const CSAMPLE* pWaveformInput = pIn;
-    CSAMPLE* pMixedChannel = nullptr;
-
-    if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
-        DEBUG_ASSERT(0 == m_channelCount % mixxx::audio::ChannelCount::stereo());
-
-        pMixedChannel = SampleUtil::alloc(count);
-        VERIFY_OR_DEBUG_ASSERT(pMixedChannel) {
-            return false;
-        }
-        SampleUtil::mixMultichannelToStereo(pMixedChannel, pIn, numFrames, m_channelCount);
-        stemCount = m_channelCount / mixxx::audio::ChannelCount::stereo();
-        pWaveformInput = pMixedChannel;
-    }
-
-    // This should only append once if count is constant
-    if (count > m_buffers.size) {
-        m_buffers.low.resize(count);
-        m_buffers.mid.resize(count);
-        m_buffers.high.resize(count);
-        m_buffers.size = count;
-    }
-
-    m_filters.low->process(pWaveformInput, &m_buffers.low[0], count);
-    m_filters.mid->process(pWaveformInput, &m_buffers.mid[0], count);
-    m_filters.high->process(pWaveformInput, &m_buffers.high[0], count);
 
     m_waveform->setSaveState(Waveform::SaveState::NotSaved);
     m_waveformSummary->setSaveState(Waveform::SaveState::NotSaved);
 
-    for (SINT i = 0; i < count; i += 2) {
-        // Take max value, not average of data
-        CSAMPLE cover[2] = {fabs(pWaveformInput[i]), fabs(pWaveformInput[i + 1])};
-        CSAMPLE clow[2] = {fabs(m_buffers.low[i]), fabs(m_buffers.low[i + 1])};
-        CSAMPLE cmid[2] = {fabs(m_buffers.mid[i]), fabs(m_buffers.mid[i + 1])};
-        CSAMPLE chigh[2] = {fabs(m_buffers.high[i]), fabs(m_buffers.high[i + 1])};
+    const bool result = m_pAnalysis->process(pIn, count);
 
-        // This is for if you want to experiment with averaging instead of
-        // maxing.
-        // m_stride.m_overallData[Right] += buffer[i]*buffer[i];
-        // m_stride.m_overallData[Left] += buffer[i + 1]*buffer[i + 1];
-        // m_stride.m_filteredData[Right][Low] += m_buffers.low[i]*m_buffers.low[i];
-        // m_stride.m_filteredData[Left][Low] += m_buffers.low[i + 1]*m_buffers.low[i + 1];
-        // m_stride.m_filteredData[Right][Mid] += m_buffers.mid[i]*m_buffers.mid[i];
-        // m_stride.m_filteredData[Left][Mid] += m_buffers.mid[i + 1]*m_buffers.mid[i + 1];
-        // m_stride.m_filteredData[Right][High] += m_buffers.high[i]*m_buffers.high[i];
-        // m_stride.m_filteredData[Left][High] += m_buffers.high[i + 1]*m_buffers.high[i + 1];
-
-        // Record the max across this stride.
-        storeIfGreater(&m_stride.m_overallData[Left], cover[Left]);
-        storeIfGreater(&m_stride.m_overallData[Right], cover[Right]);
-        storeIfGreater(&m_stride.m_filteredData[Left][Low], clow[Left]);
-        storeIfGreater(&m_stride.m_filteredData[Right][Low], clow[Right]);
-        storeIfGreater(&m_stride.m_filteredData[Left][Mid], cmid[Left]);
-        storeIfGreater(&m_stride.m_filteredData[Right][Mid], cmid[Right]);
-        storeIfGreater(&m_stride.m_filteredData[Left][High], chigh[Left]);
-        storeIfGreater(&m_stride.m_filteredData[Right][High], chigh[Right]);
-
-        for (int s = 0; s < stemCount; s++) {
-            CSAMPLE cstem[2] = {
-                    fabs(pIn[i * stemCount + s * mixxx::kAnalysisChannels]),
-                    fabs(pIn[i * stemCount + s * mixxx::kAnalysisChannels +
-                            1])};
-            storeIfGreater(&m_stride.m_stemData[Left][s], cstem[Left]);
-            storeIfGreater(&m_stride.m_stemData[Right][s], cstem[Right]);
-        }
-
-        m_stride.m_position++;
-
-        if (fmod(m_stride.m_position, m_stride.m_length) < 1) {
-            VERIFY_OR_DEBUG_ASSERT(m_currentStride + ChannelCount <= m_waveform->getDataSize()) {
-                qWarning() << "AnalyzerWaveform::process - currentStride > waveform size";
-                return false;
-            }
-            m_stride.store(m_waveformData + m_currentStride);
-            m_currentStride += ChannelCount;
-            m_waveform->setCompletion(m_currentStride);
-        }
-
-        if (fmod(m_stride.m_position, m_stride.m_averageLength) < 1) {
-            VERIFY_OR_DEBUG_ASSERT(m_currentSummaryStride + ChannelCount <= m_waveformSummary->getDataSize()) {
-                qWarning() << "AnalyzerWaveform::process - current summary stride > waveform summary size";
-                return false;
-            }
-            m_stride.averageStore(m_waveformSummaryData + m_currentSummaryStride);
-            m_currentSummaryStride += ChannelCount;
-            m_waveformSummary->setCompletion(m_currentSummaryStride);
-
-#ifdef TEST_HEAT_MAP
-            QPointF point(m_stride.m_filteredData[Right][High],
-                    m_stride.m_filteredData[Right][Mid]);
-
-            float norm = sqrt(point.x() * point.x() + point.y() * point.y());
-            point /= norm;
+    m_waveform->setCompletion(m_pAnalysis->currentStride());
+    m_waveformSummary->setCompletion(m_pAnalysis->currentSummaryStride());
+    //kLogger.debug() << "process - m_waveform->getCompletion()" << m_waveform->getCompletion() << "off" << m_waveform->getDataSize();
+    //kLogger.debug() << "process - m_waveformSummary->getCompletion()" << m_waveformSummary->getCompletion() << "off" << m_waveformSummary->getDataSize();
+    return result;
+}
 
-            point *= m_stride.m_filteredData[Right][Low];
-            test_heatMap->setPixel(point.toPoint(), 0xFF0000FF);
-#endif
-        }
+AnalyzerSegmentPtr AnalyzerWaveform::newSegment(mixxx::IndexRange frameRange) {
+    VERIFY_OR_DEBUG_ASSERT(m_pAnalysis) {
+        return nullptr;
+    }
+    auto pSegment = std::make_unique<AnalyzerWaveformSegment>(m_waveform,
+            m_waveformSummary,
+            m_sampleRate,
+            m_channelCount,
+            frameRange.start());
+    if (frameRange.end() < m_frameLength) {
+        pSegment->stopAtFrame(frameRange.end());
     }
+    m_pAnalysis->stopAtFrame(frameRange.start());
+    return pSegment;
+}
 
-    //kLogger.debug() << "process - m_waveform->getCompletion()" << m_waveform->getCompletion() << "off" << m_waveform->getDataSize();
-    //kLogger.debug() << "process - m_waveformSummary->getCompletion()" << m_waveformSummary->getCompletion() << "off" << m_waveformSummary->getDataSize();
-    if (pMixedChannel) {
-        SampleUtil::free(pMixedChannel);
+bool AnalyzerWaveform::mergeSegment(AnalyzerSegmentPtr pSegment) {
+    VERIFY_OR_DEBUG_ASSERT(m_pAnalysis) {
+        return false;
     }
+    m_pAnalysis->append(
+            static_cast<const AnalyzerWaveformSegment&>(*pSegment).analysis());
+    m_waveform->setCompletion(m_pAnalysis->currentStride());
+    m_waveformSummary->setCompletion(m_pAnalysis->currentSummaryStride());
     return true;
 }
 
 void AnalyzerWaveform::cleanup() {
+    m_pAnalysis.reset();
     m_waveform.clear();
-    m_waveformData = nullptr;
     m_waveformSummary.clear();
-    m_waveformSummaryData = nullptr;
 }
 
 void AnalyzerWaveform::storeResults(TrackPointer pTrack) {
@@ -357,9 +547,3 @@ void AnalyzerWaveform::storeResults(TrackPointer pTrack) {
     kLogger.debug() << "Waveform generation for track" << pTrack->getId() << "done"
                     << m_timer.elapsed().debugSecondsWithUnit();
 }
-
-void AnalyzerWaveform::storeIfGreater(float* pDest, float source) {
-    if (*pDest < source) {
-        *pDest = source;
-    }
-}
@@ -2,11 +2,15 @@
 
 #include <cmath>
 #include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
 
 #include "analyzer/analyzer.h"
 #include "library/dao/analysisdao.h"
 #include "util/performancetimer.h"
 #include "util/sample.h"
+#include "util/samplebuffer.h"
 #include "waveform/waveform.h"
 
 //NOTS vrince some test to segment sound, to apply color in the waveform
@@ -134,32 +138,57 @@ struct WaveformStride {
     float m_postScaleConversion;
 };
 
-class AnalyzerWaveform : public Analyzer {
+/// Computes the waveform and the waveform summary from consecutive samples
+/// of a track, starting at a given frame. This is either the whole track or
+/// a time segment (see AnalyzerWaveform::newSegment()). The data is written
+/// into the waveforms at the position of the samples.
+///
+/// The analysis of a segment starts at the first frame of the stride that
+/// contains the start frame, and the preceding analysis stops right before.
+/// This way all strides are stored from the same frames as by a single
+/// analysis.
+class WaveformAnalysis {
   public:
-    AnalyzerWaveform(
-            UserSettingsPointer pConfig,
-            const QSqlDatabase& dbConnection);
-    ~AnalyzerWaveform() override;
-
-    bool initialize(const AnalyzerTrack& track,
+    WaveformAnalysis(
+            const WaveformPointer& pWaveform,
+            const WaveformPointer& pWaveformSummary,
             mixxx::audio::SampleRate sampleRate,
             mixxx::audio::ChannelCount channelCount,
-            SINT frameLength) override;
-    bool processSamples(const CSAMPLE* buffer, SINT count) override;
-    void storeResults(TrackPointer tio) override;
-    void cleanup() override;
+            SINT startFrame);
+    ~WaveformAnalysis();
 
-  private:
-    bool shouldAnalyze(TrackPointer tio) const;
+    /// Settles the filters with the samples right before the start frame.
+    /// The last of them are processed if the first stride starts before
+    /// the start frame.
+    void preroll(const CSAMPLE* pIn, SINT count);
 
-    void storeCurrentStridePower();
-    void resetCurrentStride();
+    bool process(const CSAMPLE* pIn, SINT count);
 
-    void createFilters(mixxx::audio::SampleRate sampleRate);
-    void destroyFilters();
-    void storeIfGreater(float* pDest, float source);
+    /// Ignores all samples from the stride that contains the given frame
+    /// on, which are processed by the analysis of the next segment.
+    void stopAtFrame(SINT frame);
 
-    mutable AnalysisDao m_analysisDao;
+    /// Continues this analysis with the results of the analysis of the
+    /// next segment.
+    void append(const WaveformAnalysis& next);
+
+    int currentStride() const {
+        return m_currentStride;
+    }
+    int currentSummaryStride() const {
+        return m_currentSummaryStride;
+    }
+
+#ifdef TEST_HEAT_MAP
+    QImage* test_heatMap = nullptr;
+#endif
+
+  private:
+    // Mixes stems down to stereo and filters the samples into m_buffers.
+    // Returns the stereo samples or nullptr on failure.
+    const CSAMPLE* filter(const CSAMPLE* pIn, SINT numFrames);
+
+    void storeIfGreater(float* pDest, float source);
 
     WaveformPointer m_waveform;
     WaveformPointer m_waveformSummary;
@@ -168,9 +197,22 @@ class AnalyzerWaveform : public Analyzer {
 
     WaveformStride m_stride;
 
+    const mixxx::audio::ChannelCount m_channelCount;
+
+    // The position of the first frame, and the number of frames before
+    // the start frame that are processed from the preroll samples
+    const int m_startPosition;
+    SINT m_leadFrames;
+    int m_endPosition;
+
     int m_currentStride;
     int m_currentSummaryStride;
-    mixxx::audio::ChannelCount m_channelCount;
+
+    // The first strides written by this analysis. The first summary stride
+    // is completed by append() with the stride accumulated before it.
+    const int m_firstStride;
+    const int m_firstSummaryStride;
+    std::optional<WaveformStride> m_firstSummaryStrideHead;
 
     struct Filters {
         std::unique_ptr<EngineFilterIIRBase> low;
@@ -184,6 +226,8 @@ class AnalyzerWaveform : public Analyzer {
         std::vector<float> low;
         std::vector<float> mid;
         std::vector<float> high;
+        // The stereo mix of stems
+        mixxx::SampleBuffer mixed;
 
         SINT size;
 
@@ -196,6 +240,38 @@ class AnalyzerWaveform : public Analyzer {
     };
 
     Buffers m_buffers;
+};
+
+class AnalyzerWaveform : public Analyzer {
+  public:
+    AnalyzerWaveform(
+            UserSettingsPointer pConfig,
+            const QSqlDatabase& dbConnection);
+    ~AnalyzerWaveform() override;
+
+    bool initialize(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            mixxx::audio::ChannelCount channelCount,
+            SINT frameLength) override;
+    bool processSamples(const CSAMPLE* buffer, SINT count) override;
+    AnalyzerSegmentPtr newSegment(mixxx::IndexRange frameRange) override;
+    bool mergeSegment(AnalyzerSegmentPtr pSegment) override;
+    void storeResults(TrackPointer tio) override;
+    void cleanup() override;
+
+  private:
+    bool shouldAnalyze(TrackPointer tio) const;
+
+    mutable AnalysisDao m_analysisDao;
+
+    WaveformPointer m_waveform;
+    WaveformPointer m_waveformSummary;
+
+    mixxx::audio::SampleRate m_sampleRate;
+    mixxx::audio::ChannelCount m_channelCount;
+    SINT m_frameLength;
+
+    std::unique_ptr<WaveformAnalysis> m_pAnalysis;
 
     PerformanceTimer m_timer;
 
@@ -14,6 +14,10 @@ constexpr SINT kAnalysisFramesPerChunk = 4096;
 constexpr SINT kAnalysisSamplesPerChunk =
         kAnalysisFramesPerChunk * kAnalysisMaxChannels;
 
+// Number of chunks that are decoded ahead of the analyzers. This bounds
+// the memory needed for decoding and analysis running in parallel.
+constexpr int kAnalysisChunksDecodedAhead = 4;
+
 // Only analyze the first minute in fast-analysis mode.
 constexpr SINT kFastAnalysisSecondsToAnalyze = 60;
 
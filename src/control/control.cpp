@@ -1,5 +1,6 @@
 #include "control/control.h"
 
+#include "control/controlnotifier.h"
 #include "control/controlobject.h"
 #include "moc_control.cpp"
 #include "util/mutex.h"
@@ -60,6 +61,8 @@ ControlDoublePrivate::ControlDoublePrivate(
           m_value(defaultValue),
           m_defaultValue(defaultValue),
           m_pCreatorCO(pCreatorCO),
+          m_notifierSlot(ControlNotifier::kInvalidSlot),
+          m_pCoalescedSender(nullptr),
           m_trackingKey(bTrack ? statTrackingKey.arg(key.group, key.item) : QString()),
           m_confirmRequired(confirmRequired),
           m_bPersistInConfiguration(bPersist),
@@ -80,6 +83,8 @@ ControlDoublePrivate::ControlDoublePrivate(
 }
 
 ControlDoublePrivate::~ControlDoublePrivate() {
+    ControlNotifier::unregisterControl(m_notifierSlot.load(std::memory_order_relaxed));
+
     s_qCOHashMutex.lock();
     //qDebug() << "ControlDoublePrivate::s_qCOHash.remove(" << m_key.group << "," << m_key.item << ")";
     s_qCOHash.remove(m_key);
@@ -288,13 +293,30 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
         return;
     }
     m_value.setValue(value);
-    emit valueChanged(value, pSender);
+    const int notifierSlot = m_notifierSlot.load(std::memory_order_relaxed);
+    if (notifierSlot != ControlNotifier::kInvalidSlot && ControlNotifier::isEngineThread()) {
+        // Don't allocate queued events for the listeners in other threads
+        // on the realtime thread, they are notified once per GUI frame.
+        m_pCoalescedSender.store(pSender, std::memory_order_relaxed);
+        ControlNotifier::markDirty(notifierSlot);
+    } else {
+        emit valueChanged(value, pSender);
+    }
 
     if (!m_trackingKey.isNull()) {
         Stat::track(m_trackingKey, kStatType, kComputeFlags, value);
     }
 }
 
+void ControlDoublePrivate::enableCoalescedNotifications(
+        const QSharedPointer<ControlDoublePrivate>& pThis) {
+    DEBUG_ASSERT(pThis.data() == this);
+    if (m_notifierSlot.load(std::memory_order_relaxed) != ControlNotifier::kInvalidSlot) {
+        return;
+    }
+    m_notifierSlot.store(ControlNotifier::registerControl(pThis), std::memory_order_relaxed);
+}
+
 void ControlDoublePrivate::setBehavior(ControlNumericBehavior* pBehavior) {
     // This marks the old mpBehavior for deletion. It is deleted once it is not
     // used in any other function
@@ -5,6 +5,7 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
+#include <atomic>
 
 #include "control/controlbehavior.h"
 #include "control/controlvalue.h"
@@ -143,6 +144,16 @@ class ControlDoublePrivate : public QObject {
         return m_key;
     }
 
+    // Registers the control with ControlNotifier, which defers the
+    // notifications about sets from engine threads to the next GUI frame.
+    void enableCoalescedNotifications(const QSharedPointer<ControlDoublePrivate>& pThis);
+
+    // Emits valueChanged() for the current value and the sender of the most
+    // recent coalesced set. Only called by ControlNotifier::drain().
+    void emitCoalescedValueChanged() {
+        emit valueChanged(get(), m_pCoalescedSender.load(std::memory_order_relaxed));
+    }
+
     // Connects a slot to the ValueChange request for CO validation. All change
     // requests issued by set are routed though the connected slot. This can
     // decide with its own thread safe solution if the requested value can be
@@ -201,6 +212,12 @@ class ControlDoublePrivate : public QObject {
 
     QAtomicPointer<ControlObject> m_pCreatorCO;
 
+    // The slot in ControlNotifier if notifications are coalesced
+    std::atomic<int> m_notifierSlot;
+    // The sender of the most recent set that has not been notified yet.
+    // Only compared by the listeners, never dereferenced.
+    std::atomic<QObject*> m_pCoalescedSender;
+
     // name of the key to track using stats framework, unless the m_trackingKey isNull().
     QString m_trackingKey;
 
@@ -0,0 +1,126 @@
+#include "control/controlnotifier.h"
+
+#include <QVarLengthArray>
+#include <array>
+#include <atomic>
+#include <bit>
+
+#include "control/control.h"
+#include "util/assert.h"
+#include "util/logger.h"
+#include "util/mutex.h"
+
+namespace {
+
+const mixxx::Logger kLogger("ControlNotifier");
+
+constexpr int kBitsPerWord = 64;
+constexpr int kDirtyWords = ControlNotifier::kMaxControls / kBitsPerWord;
+
+struct NotifierState {
+    MMutex mutex;
+    // Written and read by the main thread
+    std::array<QWeakPointer<ControlDoublePrivate>, ControlNotifier::kMaxControls>
+            controls GUARDED_BY(mutex);
+    // One past the highest slot that has ever been used, limits the
+    // number of words that are scanned in drain().
+    std::atomic<int> slotCount{0};
+    // Set by the engine threads, cleared by drain()
+    std::array<std::atomic<quint64>, kDirtyWords> dirty{};
+};
+
+NotifierState& state() {
+    static NotifierState s_state;
+    return s_state;
+}
+
+thread_local bool t_engineThread = false;
+
+} // anonymous namespace
+
+// static
+int ControlNotifier::registerControl(const QSharedPointer<ControlDoublePrivate>& pControl) {
+    VERIFY_OR_DEBUG_ASSERT(pControl) {
+        return kInvalidSlot;
+    }
+    NotifierState& s = state();
+    const MMutexLocker locker(&s.mutex);
+    for (int slot = 0; slot < kMaxControls; ++slot) {
+        if (s.controls[slot].isNull()) {
+            s.controls[slot] = pControl;
+            if (slot >= s.slotCount.load(std::memory_order_relaxed)) {
+                s.slotCount.store(slot + 1, std::memory_order_release);
+            }
+            return slot;
+        }
+    }
+    kLogger.warning() << "Too many controls, notifying immediately for"
+                      << pControl->getKey();
+    return kInvalidSlot;
+}
+
+// static
+void ControlNotifier::unregisterControl(int slot) {
+    if (slot == kInvalidSlot) {
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(slot >= 0 && slot < kMaxControls) {
+        return;
+    }
+    NotifierState& s = state();
+    const MMutexLocker locker(&s.mutex);
+    s.controls[slot].clear();
+    // A pending notification would be delivered to the next control that
+    // is registered in this slot. This is harmless, since listeners always
+    // receive the current value.
+}
+
+// static
+void ControlNotifier::markDirty(int slot) {
+    DEBUG_ASSERT(slot >= 0 && slot < kMaxControls);
+    state().dirty[slot / kBitsPerWord].fetch_or(
+            quint64{1} << (slot % kBitsPerWord), std::memory_order_release);
+}
+
+// static
+int ControlNotifier::drain() {
+    NotifierState& s = state();
+    QVarLengthArray<QSharedPointer<ControlDoublePrivate>, 256> changedControls;
+    {
+        const MMutexLocker locker(&s.mutex);
+        const int words = (s.slotCount.load(std::memory_order_acquire) +
+                                  kBitsPerWord - 1) /
+                kBitsPerWord;
+        for (int word = 0; word < words; ++word) {
+            quint64 bits = s.dirty[word].exchange(0, std::memory_order_acquire);
+            while (bits != 0) {
+                const int slot = word * kBitsPerWord + std::countr_zero(bits);
+                bits &= bits - 1;
+                auto pControl = s.controls[slot].toStrongRef();
+                if (pControl) {
+                    changedControls.append(std::move(pControl));
+                }
+            }
+        }
+    }
+    // Emit without holding the lock, the listeners might create or
+    // destroy controls.
+    for (const auto& pControl : std::as_const(changedControls)) {
+        pControl->emitCoalescedValueChanged();
+    }
+    return static_cast<int>(changedControls.size());
+}
+
+// static
+bool ControlNotifier::isEngineThread() {
+    return t_engineThread;
+}
+
+ControlNotifier::ScopedEngineThread::ScopedEngineThread()
+        : m_wasEngineThread(t_engineThread) {
+    t_engineThread = true;
+}
+
+ControlNotifier::ScopedEngineThread::~ScopedEngineThread() {
+    t_engineThread = m_wasEngineThread;
+}
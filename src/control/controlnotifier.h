@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QSharedPointer>
+
+class ControlDoublePrivate;
+
+/// Coalesces the change notifications of controls that are set by the engine.
+///
+/// Every set of a control emits ControlDoublePrivate::valueChanged(). If the
+/// engine sets a control that has listeners in other threads, e.g. the play
+/// position or the VU meters, Qt allocates a queued event for every listener
+/// and every set on the realtime thread and the GUI and controllers have to
+/// process all of them.
+///
+/// Controls that are registered here only store their value when they are
+/// set from an engine thread and mark themselves as dirty in a lock-free
+/// bitset. drain() emits a single valueChanged() with the latest value for
+/// every dirty control from the main thread, once per GUI frame. Sets from
+/// other threads still notify immediately.
+///
+/// Only register controls whose listeners on the engine thread do not
+/// depend on being notified synchronously about changes made by the engine.
+class ControlNotifier {
+  public:
+    static constexpr int kInvalidSlot = -1;
+    static constexpr int kMaxControls = 4096;
+
+    /// Registers the control and returns its slot, or kInvalidSlot if all
+    /// slots are taken. The control then notifies about sets from engine
+    /// threads only on drain(). Must not be called from a realtime thread.
+    static int registerControl(const QSharedPointer<ControlDoublePrivate>& pControl);
+
+    /// Releases the slot. Must not be called from a realtime thread.
+    static void unregisterControl(int slot);
+
+    /// Marks the control in the slot as changed. Realtime safe.
+    static void markDirty(int slot);
+
+    /// Emits valueChanged() for all controls that have been changed since
+    /// the last call and returns how many. Called from the main thread.
+    static int drain();
+
+    /// Whether the calling thread processes the engine, i.e. if sets of
+    /// registered controls are coalesced.
+    static bool isEngineThread();
+
+    /// Marks the calling thread as engine thread for the lifetime of the
+    /// object.
+    class ScopedEngineThread final {
+      public:
+        ScopedEngineThread();
+        ~ScopedEngineThread();
+
+      private:
+        const bool m_wasEngineThread;
+    };
+};
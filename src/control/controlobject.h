@@ -167,6 +167,15 @@ class ControlObject : public QObject {
     // Installs a value-change request handler that ignores all sets.
     void setReadOnly();
 
+    // Notifies the listeners about sets from the engine only once per GUI
+    // frame, see ControlNotifier. Must not be used if engine code relies on
+    // being notified about sets from the engine thread.
+    void enableCoalescedNotifications() {
+        if (m_pControl) {
+            m_pControl->enableCoalescedNotifications(m_pControl);
+        }
+    }
+
   signals:
     void valueChanged(double);
 
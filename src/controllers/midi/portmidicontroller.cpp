@@ -80,6 +80,10 @@ int PortMidiController::open(const QString& resourcePath) {
     }
     startEngine();
     applyMapping(resourcePath);
+    if (readsInputOnThread() && m_pInputDevice && m_pInputDevice->isOpen()) {
+        m_pInputThread = PortMidiInputThread::instance();
+        m_pInputThread->addInput(m_pInputDevice.data(), this);
+    }
     setOpen(true);
     return 0;
 }
@@ -90,6 +94,12 @@ int PortMidiController::close() {
         return -1;
     }
 
+    if (m_pInputThread) {
+        // Must be removed before the input device is closed
+        m_pInputThread->removeInput(m_pInputDevice.data());
+        m_pInputThread.reset();
+    }
+
     stopEngine();
     MidiController::close();
 
@@ -130,9 +140,23 @@ bool PortMidiController::poll() {
         return false;
     }
 
+    processEvents(m_midiBuffer, numEvents);
+    return numEvents > 0;
+}
+
+void PortMidiController::slotReceivedEvents(const QVector<PmEvent>& events) {
+    if (!isOpen()) {
+        // Queued before closing
+        return;
+    }
+    processEvents(events.constData(), static_cast<int>(events.size()));
+}
+
+void PortMidiController::processEvents(const PmEvent* pEvents, int numEvents) {
     for (int i = 0; i < numEvents; i++) {
-        unsigned char status = Pm_MessageStatus(m_midiBuffer[i].message);
-        mixxx::Duration timestamp = mixxx::Duration::fromMillis(m_midiBuffer[i].timestamp);
+        unsigned char status = Pm_MessageStatus(pEvents[i].message);
+        // The timestamp of the device, not the time of reading
+        mixxx::Duration timestamp = mixxx::Duration::fromMillis(pEvents[i].timestamp);
 
         if ((status & 0xF8) == 0xF8) {
             // Handle real-time MIDI messages at any time
@@ -148,8 +172,8 @@ bool PortMidiController::poll() {
                 status = 0;
             } else {
                 //unsigned char channel = status & 0x0F;
-                unsigned char note = Pm_MessageData1(m_midiBuffer[i].message);
-                unsigned char velocity = Pm_MessageData2(m_midiBuffer[i].message);
+                unsigned char note = Pm_MessageData1(pEvents[i].message);
+                unsigned char velocity = Pm_MessageData2(pEvents[i].message);
                 receivedShortMessage(status, note, velocity, timestamp);
             }
         }
@@ -172,7 +196,7 @@ bool PortMidiController::poll() {
                 // TODO(rryan): This prevents buffer overflow if the sysex is
                 // larger than 1024 bytes. I don't want to radically change
                 // anything before the 2.0 release so this will do for now.
-                data = (m_midiBuffer[i].message >> shift) & 0xFF;
+                data = (pEvents[i].message >> shift) & 0xFF;
                 if (m_cReceiveMsg_index < MIXXX_SYSEX_BUFFER_LEN) {
                     m_cReceiveMsg[m_cReceiveMsg_index++] = data;
                 }
@@ -188,7 +212,6 @@ bool PortMidiController::poll() {
             }
         }
     }
-    return numEvents > 0;
 }
 
 void PortMidiController::sendShortMsg(unsigned char status, unsigned char byte1,
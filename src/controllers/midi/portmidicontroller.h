@@ -3,9 +3,12 @@
 #include <portmidi.h>
 
 #include <QScopedPointer>
+#include <QVector>
+#include <memory>
 
 #include "controllers/midi/midicontroller.h"
 #include "controllers/midi/portmididevice.h"
+#include "controllers/midi/portmidiinputthread.h"
 
 // Note:
 // A standard Midi device runs at 31.25 kbps, with 10 bits / byte
@@ -87,12 +90,20 @@ class PortMidiController : public MidiController {
 
   private slots:
     bool poll() override;
+    void slotReceivedEvents(const QVector<PmEvent>& events);
 
   protected:
     // MockPortMidiController needs this to not be private.
     void sendShortMsg(unsigned char status, unsigned char byte1,
                       unsigned char byte2) override;
 
+    /// Whether the input is read by a PortMidiInputThread instead of
+    /// being polled by the ControllerManager. The tests poll the mock
+    /// devices.
+    virtual bool readsInputOnThread() const {
+        return true;
+    }
+
   private:
     int open(const QString& resourcePath) override;
     int close() override;
@@ -101,10 +112,13 @@ class PortMidiController : public MidiController {
     // 0xf7.
     bool sendBytes(const QByteArray& data) override;
 
+    // Polling is the fallback if the input is not read on a thread
     bool isPolling() const override {
-        return true;
+        return !m_pInputThread;
     }
 
+    void processEvents(const PmEvent* pEvents, int numEvents);
+
     // For testing only so that test fixtures can install mock PortMidiDevices.
     void setPortMidiInputDevice(PortMidiDevice* device) {
         m_pInputDevice.reset(device);
@@ -116,6 +130,8 @@ class PortMidiController : public MidiController {
     QScopedPointer<PortMidiDevice> m_pInputDevice;
     QScopedPointer<PortMidiDevice> m_pOutputDevice;
 
+    std::shared_ptr<PortMidiInputThread> m_pInputThread;
+
     PmEvent m_midiBuffer[MIXXX_PORTMIDI_BUFFER_LEN];
 
     // Storage for SysEx messages
@@ -124,4 +140,5 @@ class PortMidiController : public MidiController {
     bool m_bInSysex;
 
     friend class PortMidiControllerTest;
+    friend class PortMidiInputThread;
 };
@@ -2,6 +2,9 @@
 
 #include <portmidi.h>
 
+/// Wraps a PortMidi stream. PortMidi is not thread-safe. The inputs are
+/// only read on the PortMidiInputThread, which stops reading a device
+/// before it is closed. All other calls happen on the controller thread.
 class PortMidiDevice {
   public:
     PortMidiDevice(const PmDeviceInfo* deviceInfo,
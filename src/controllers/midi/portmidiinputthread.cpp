@@ -0,0 +1,135 @@
+#include "controllers/midi/portmidiinputthread.h"
+
+#include <algorithm>
+
+#include "controllers/midi/portmidicontroller.h"
+#include "controllers/midi/portmididevice.h"
+#include "moc_portmidiinputthread.cpp"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/performancetimer.h"
+
+namespace {
+
+// About the time that a classic MIDI connection at 31.25 kbaud needs to
+// transfer a single message of 3 bytes. Used while events arrive, e.g.
+// when a jog wheel or a fader is moved. Events that arrive in between are
+// buffered by PortMidi.
+constexpr unsigned long kMinSleepTimeMicros = 1000;
+
+// The sleep time is doubled after the active period until it reaches this
+// limit, which is the poll interval of the ControllerManager.
+constexpr unsigned long kSleepTimeWhenIdleMicros = 5000;
+
+// No events for this duration are considered as idle
+constexpr mixxx::Duration kActivePeriod = mixxx::Duration::fromMillis(500);
+
+// Read in small batches to pass bursts to the controller early
+constexpr int kReadBufferLen = 64;
+
+std::weak_ptr<PortMidiInputThread> s_pInstance;
+
+} // anonymous namespace
+
+//static
+std::shared_ptr<PortMidiInputThread> PortMidiInputThread::instance() {
+    auto pInstance = s_pInstance.lock();
+    if (!pInstance) {
+        // The constructor is private
+        pInstance = std::shared_ptr<PortMidiInputThread>(new PortMidiInputThread());
+        s_pInstance = pInstance;
+    }
+    return pInstance;
+}
+
+PortMidiInputThread::PortMidiInputThread()
+        : QThread(),
+          m_stopRequested(0) {
+    setObjectName(QStringLiteral("PortMidiInputThread"));
+}
+
+PortMidiInputThread::~PortMidiInputThread() {
+    stop();
+    DEBUG_ASSERT(m_inputs.isEmpty());
+}
+
+void PortMidiInputThread::addInput(PortMidiDevice* pDevice, PortMidiController* pController) {
+    {
+        const auto locker = lockMutex(&m_inputsMutex);
+        m_inputs.append(Input{pDevice, pController, false});
+    }
+    if (!isRunning()) {
+        start(QThread::HighPriority);
+    }
+}
+
+void PortMidiInputThread::removeInput(PortMidiDevice* pDevice) {
+    const auto locker = lockMutex(&m_inputsMutex);
+    m_inputs.erase(std::remove_if(m_inputs.begin(),
+                           m_inputs.end(),
+                           [pDevice](const Input& input) {
+                               return input.pDevice == pDevice;
+                           }),
+            m_inputs.end());
+}
+
+void PortMidiInputThread::stop() {
+    m_stopRequested.storeRelease(1);
+    wait();
+}
+
+void PortMidiInputThread::run() {
+    PmEvent buffer[kReadBufferLen];
+    unsigned long sleepTimeMicros = kMinSleepTimeMicros;
+    PerformanceTimer idleTimer;
+    idleTimer.start();
+    while (!m_stopRequested.loadAcquire()) {
+        bool received = false;
+        bool pending = false;
+        {
+            const auto locker = lockMutex(&m_inputsMutex);
+            for (auto& input : m_inputs) {
+                const int numEvents = input.pDevice->read(buffer, kReadBufferLen);
+                if (numEvents < 0) {
+                    if (!input.readErrorLogged) {
+                        // Logged only once until the next successful read to
+                        // avoid large log files
+                        qCWarning(input.pController->m_logInput)
+                                << "PortMidi error:"
+                                << Pm_GetErrorText(static_cast<PmError>(numEvents));
+                        input.readErrorLogged = true;
+                    }
+                    continue;
+                }
+                input.readErrorLogged = false;
+                if (numEvents == 0) {
+                    continue;
+                }
+                received = true;
+                // More events might be pending
+                pending = pending || numEvents == kReadBufferLen;
+                // The controller is not deleted before its input has been
+                // removed, which waits for this loop to release the mutex.
+                PortMidiController* pController = input.pController;
+                const QVector<PmEvent> events(buffer, buffer + numEvents);
+                QMetaObject::invokeMethod(
+                        pController,
+                        [pController, events] {
+                            pController->slotReceivedEvents(events);
+                        },
+                        Qt::QueuedConnection);
+            }
+        }
+        if (received) {
+            idleTimer.restart();
+            sleepTimeMicros = kMinSleepTimeMicros;
+            if (pending) {
+                continue;
+            }
+        } else if (idleTimer.elapsed() >= kActivePeriod) {
+            // Back off while idle to not wake up the CPU every millisecond
+            sleepTimeMicros = std::min(sleepTimeMicros * 2, kSleepTimeWhenIdleMicros);
+        }
+        usleep(sleepTimeMicros);
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <portmidi.h>
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <memory>
+
+class PortMidiController;
+class PortMidiDevice;
+
+/// Reads the inputs of all opened PortMidi devices on a dedicated thread,
+/// independent of the poll timer of the ControllerManager and of the time
+/// that the controller scripts take.
+///
+/// PortMidi is not thread-safe. On Linux all streams share a single ALSA
+/// sequencer client that is drained by every Pm_Read(), so the inputs of
+/// the devices are read one after another on this single thread. PortMidi
+/// offers no handle to wait for input, so the inputs are read in a sleep
+/// loop that backs off while no events arrive. The events are passed to
+/// the controller thread with the timestamps of the device.
+class PortMidiInputThread : public QThread {
+    Q_OBJECT
+  public:
+    ~PortMidiInputThread() override;
+
+    /// Returns the thread that is shared by all controllers. It is
+    /// started with the first input and stopped when the last reference
+    /// has been released. Must be called on the controller thread.
+    static std::shared_ptr<PortMidiInputThread> instance();
+
+    /// Starts reading the opened input device of the controller. The events
+    /// are passed to the controller on its own thread.
+    void addInput(PortMidiDevice* pDevice, PortMidiController* pController);
+
+    /// Stops reading the input device. The device is not read anymore when
+    /// this returns and can be closed.
+    void removeInput(PortMidiDevice* pDevice);
+
+    void run() override;
+
+  private:
+    struct Input {
+        PortMidiDevice* pDevice;
+        PortMidiController* pController;
+        bool readErrorLogged;
+    };
+
+    PortMidiInputThread();
+
+    void stop();
+
+    // Guards the list of inputs against the controller thread. It is only
+    // contended while inputs are added or removed.
+    QMutex m_inputsMutex;
+    QVector<Input> m_inputs;
+
+    QAtomicInt m_stopRequested;
+};
@@ -17,6 +17,7 @@
 #include "controllers/scripting/controllerscriptenginebase.h"
 #include "database/mixxxdb.h"
 #include "effects/effectsmanager.h"
+#include "engine/cachingreader/cachingreaderpreloader.h"
 #include "engine/enginemixer.h"
 #ifdef __RUBBERBAND__
 #include "engine/bufferscalers/rubberbandworkerpool.h"
@@ -50,6 +51,9 @@
 #include "qml/qmlsoundmanagerproxy.h"
 #endif
 #include "soundio/soundmanager.h"
+#ifdef __MAD__
+#include "sources/soundsourcemp3.h"
+#endif
 #include "sources/soundsourceproxy.h"
 #include "util/clipboard.h"
 #include "util/db/dbconnectionpooled.h"
@@ -509,6 +513,11 @@ void CoreServices::initialize(QApplication* pApp) {
 
     Sandbox::setPermissionsFilePath(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
 
+#ifdef __MAD__
+    mixxx::SoundSourceMp3::setSeekIndexCacheDir(
+            QDir(pConfig->getSettingsPath()).filePath(QStringLiteral("seekindex")));
+#endif
+
     QString resourcePath = pConfig->getResourcePath();
 
     emit initializationProgressUpdate(0, tr("fonts"));
@@ -525,6 +534,10 @@ void CoreServices::initialize(QApplication* pApp) {
     if (!initializeDatabase()) {
         exit(-1);
     }
+    if (m_cmdlineArgs.getMaintainDatabase()) {
+        // No other connections have been opened yet
+        MixxxDb::maintainDatabase(mixxx::DbConnectionPooled(m_pDbConnectionPool));
+    }
 
     m_pControlIndicatorTimer = std::make_shared<mixxx::ControlIndicatorTimer>(this);
 
@@ -542,6 +555,12 @@ void CoreServices::initialize(QApplication* pApp) {
 #ifdef __RUBBERBAND__
     RubberBandWorkerPool::createInstance(pConfig);
 #endif
+    // Tracks are preloaded for the primary decks, see EngineDeck
+#ifdef __STEM__
+    CachingReaderPreloader::createInstance(mixxx::audio::ChannelCount::stem());
+#else
+    CachingReaderPreloader::createInstance(mixxx::audio::ChannelCount::stereo());
+#endif
 
     emit initializationProgressUpdate(30, tr("audio interface"));
     // Although m_pSoundManager is created here, m_pSoundManager->setupDevices()
@@ -610,7 +629,8 @@ void CoreServices::initialize(QApplication* pApp) {
             &ScreensaverManager::slotCurrentPlayingDeckChanged);
 
     emit initializationProgressUpdate(50, tr("library"));
-    CoverArtCache::createInstance();
+    CoverArtCache::createInstance(
+            QDir(pConfig->getSettingsPath()).filePath(QStringLiteral("coverart")));
     Clipboard::createInstance();
 
     m_pTrackCollectionManager = std::make_shared<TrackCollectionManager>(
@@ -720,8 +740,7 @@ void CoreServices::initialize(QApplication* pApp) {
     m_pControllerManager = std::make_shared<ControllerManager>(pConfig);
 
     // Scan the library for new files and directories
-    bool rescan = m_cmdlineArgs.getRescanLibrary() ||
-            pConfig->getValue<bool>(library::prefs::kRescanOnStartupConfigKey);
+    bool rescan = m_cmdlineArgs.getRescanLibrary();
     // rescan the library if we get a new plugin
     QList<QString> prev_plugins_list =
             pConfig->getValueString(
@@ -767,6 +786,10 @@ void CoreServices::initialize(QApplication* pApp) {
     // loaded a skin, see issue #6625
     if (rescan || musicDirAdded || m_pSettingsManager->shouldRescanLibrary()) {
         m_pTrackCollectionManager->startLibraryAutoScan();
+    } else if (pConfig->getValue<bool>(library::prefs::kRescanOnStartupConfigKey)) {
+        // Walks the whole library only if the changes since the last run
+        // are unknown
+        m_pTrackCollectionManager->startLibraryStartupScan();
     }
 
     // This has to be done before m_pSoundManager->setupDevices()
@@ -951,6 +974,10 @@ void CoreServices::finalize() {
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "deleting PlayerManager";
     CLEAR_AND_CHECK_DELETED(m_pPlayerManager);
 
+    // Release the preloaded tracks before the library is deleted. The
+    // preloader itself is destroyed after the engine that uses it.
+    CachingReaderPreloader::instance()->preloadTracks({});
+
     // Delete the library after the view so there are no dangling pointers to
     // the data models.
     // Depends on RecordingManager and PlayerManager
@@ -973,6 +1000,7 @@ void CoreServices::finalize() {
 #ifdef __RUBBERBAND__
     RubberBandWorkerPool::destroy();
 #endif
+    CachingReaderPreloader::destroy();
 
     // Destroy PlayerInfo explicitly to release the track
     // pointers of tracks that were still loaded in decks
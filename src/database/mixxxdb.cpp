@@ -1,20 +1,23 @@
 #include "database/mixxxdb.h"
 
 #include <QDir>
+#include <QSqlError>
 #include <QSqlQuery>
 #include <QVariant>
 
 #include "database/schemamanager.h"
+#include "library/library_prefs.h"
 #include "moc_mixxxdb.cpp"
 #include "util/assert.h"
 #include "util/logger.h"
+#include "util/performancetimer.h"
 
 // The schema XML is baked into the binary via Qt resources.
 //static
 const QString MixxxDb::kDefaultSchemaFile(":/schema.xml");
 
 //static
-const int MixxxDb::kRequiredSchemaVersion = 40;
+const int MixxxDb::kRequiredSchemaVersion = 42;
 
 namespace {
 
@@ -60,9 +63,44 @@ mixxx::DbConnection::Params dbConnectionParams(
     }
     params.userName = kUserName;
     params.password = kPassword;
+    const qint64 mmapSizeMiB = pConfig->getValue(
+            mixxx::library::prefs::kDatabaseMmapSizeMiBConfigKey,
+            mixxx::library::prefs::kDatabaseMmapSizeMiBDefault);
+    const qint64 cacheSizeMiB = pConfig->getValue(
+            mixxx::library::prefs::kDatabaseCacheSizeMiBConfigKey,
+            mixxx::library::prefs::kDatabaseCacheSizeMiBDefault);
+    params.sqliteProfile.writeAheadLog = pConfig->getValue(
+            mixxx::library::prefs::kDatabaseWriteAheadLogConfigKey,
+            mixxx::library::prefs::kDatabaseWriteAheadLogDefault);
+    params.sqliteProfile.mmapSizeBytes = mmapSizeMiB * 1024 * 1024;
+    params.sqliteProfile.cacheSizeKiB = cacheSizeMiB * 1024;
+    params.sqliteProfile.tempStoreInMemory = true;
     return params;
 }
 
+bool execMaintenanceStatement(
+        const QSqlDatabase& database,
+        const QString& statement) {
+    kLogger.info()
+            << "Executing"
+            << statement;
+    PerformanceTimer timer;
+    timer.start();
+    QSqlQuery query(database);
+    if (!query.exec(statement)) {
+        kLogger.warning()
+                << "Failed to execute"
+                << statement
+                << query.lastError();
+        return false;
+    }
+    kLogger.info()
+            << "Finished"
+            << statement
+            << timer.elapsed().debugMillisWithUnit();
+    return true;
+}
+
 } // anonymous namespace
 
 MixxxDb::MixxxDb(
@@ -119,3 +157,15 @@ bool MixxxDb::initDatabaseSchema(
     DEBUG_ASSERT(!"unhandled switch/case");
     return false;
 }
+
+//static
+bool MixxxDb::maintainDatabase(
+        const QSqlDatabase& database) {
+    // Rebuilds the database file without unused pages and fragmentation.
+    // Needs exclusive access and temporarily up to twice the disk space.
+    if (!execMaintenanceStatement(database, QStringLiteral("VACUUM"))) {
+        return false;
+    }
+    // Statistics for the query planner of all tables and indices
+    return execMaintenanceStatement(database, QStringLiteral("ANALYZE"));
+}
@@ -18,6 +18,11 @@ class MixxxDb : public QObject {
             int schemaVersion = kRequiredSchemaVersion,
             const QString& schemaFile = kDefaultSchemaFile);
 
+    /// Offline maintenance of the database that must not be used
+    /// by any other connection at the same time.
+    static bool maintainDatabase(
+            const QSqlDatabase& database);
+
     explicit MixxxDb(
             const UserSettingsPointer& pConfig,
             bool inMemoryConnection = false);
@@ -2,9 +2,11 @@
 
 #include <QDateTime>
 #include <QDir>
+#include <QHeaderView>
 #include <QKeyEvent>
 
 #include "control/control.h"
+#include "engine/engineprofiler.h"
 #include "moc_dlgdevelopertools.cpp"
 #include "util/logging.h"
 #include "util/statsmanager.h"
@@ -62,6 +64,24 @@ DlgDeveloperTools::DlgDeveloperTools(QWidget* pParent,
 
     m_logCursor = logTextView->textCursor();
 
+    // Set up the engine profile
+    engineProfileTable->setColumnCount(5);
+    engineProfileTable->setHorizontalHeaderLabels({tr("Stage"),
+            tr("Count"),
+            tr("Mean (µs)"),
+            tr("99% below (µs)"),
+            tr("Max (µs)")});
+    engineProfileTable->horizontalHeader()->setSectionResizeMode(
+            0, QHeaderView::Stretch);
+    connect(engineProfileReset,
+            &QPushButton::clicked,
+            this,
+            &DlgDeveloperTools::slotEngineProfileReset);
+    connect(engineProfileDump,
+            &QPushButton::clicked,
+            this,
+            &DlgDeveloperTools::slotEngineProfileDump);
+
     // Update at 2FPS.
     startTimer(500);
 
@@ -104,6 +124,47 @@ void DlgDeveloperTools::timerEvent(QTimerEvent* pEvent) {
         if (pManager) {
             pManager->updateStats();
         }
+    } else if (toolTabWidget->currentWidget() == engineTab) {
+        updateEngineProfile();
+    }
+}
+
+void DlgDeveloperTools::updateEngineProfile() {
+    const auto stats = EngineProfiler::stats();
+    engineProfileTable->setSortingEnabled(false);
+    engineProfileTable->setRowCount(static_cast<int>(stats.size()));
+    int row = 0;
+    for (const auto& probeStats : stats) {
+        const auto setItem = [this, row](int column, const QVariant& value) {
+            auto* pItem = engineProfileTable->item(row, column);
+            if (!pItem) {
+                pItem = new QTableWidgetItem();
+                engineProfileTable->setItem(row, column, pItem);
+            }
+            pItem->setData(Qt::DisplayRole, value);
+        };
+        setItem(0, probeStats.name);
+        setItem(1, probeStats.count);
+        setItem(2, qRound(probeStats.meanMicros * 10) / 10.0);
+        setItem(3, qRound(probeStats.p99Micros * 10) / 10.0);
+        setItem(4, qRound(probeStats.maxMicros * 10) / 10.0);
+        ++row;
+    }
+    engineProfileTable->setSortingEnabled(true);
+}
+
+void DlgDeveloperTools::slotEngineProfileReset() {
+    EngineProfiler::reset();
+    updateEngineProfile();
+}
+
+void DlgDeveloperTools::slotEngineProfileDump() {
+    QString timestamp = QDateTime::currentDateTime()
+            .toString("yyyy-MM-dd_hh'h'mm'm'ss's'");
+    QString dumpFileName = m_pConfig->getSettingsPath() +
+            "/engine_trace_" + timestamp + ".json";
+    if (EngineProfiler::writeChromeTrace(dumpFileName)) {
+        qInfo() << "Engine trace written to" << dumpFileName;
     }
 }
 
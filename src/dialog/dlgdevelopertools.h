@@ -23,8 +23,12 @@ class DlgDeveloperTools : public QDialog, public Ui::DlgDeveloperTools {
     void slotControlSearch(const QString& search);
     void slotLogSearch();
     void slotControlDump();
+    void slotEngineProfileReset();
+    void slotEngineProfileDump();
 
   private:
+    void updateEngineProfile();
+
     UserSettingsPointer m_pConfig;
     ControlSortFilterModel m_controlProxyModel;
 
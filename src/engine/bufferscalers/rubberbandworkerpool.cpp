@@ -1,36 +1,52 @@
 #include "engine/bufferscalers/rubberbandworkerpool.h"
 
-#include <rubberband/RubberBandStretcher.h>
+#include <QThread>
 
 #include "engine/engine.h"
+#include "engine/enginemixer.h"
 #include "util/assert.h"
 
-RubberBandWorkerPool::RubberBandWorkerPool(UserSettingsPointer pConfig)
-        : QThreadPool() {
+namespace {
+
+mixxx::audio::ChannelCount channelPerWorker(const UserSettingsPointer& pConfig) {
     bool multiThreadedOnStereo = pConfig &&
             pConfig->getValue(ConfigKey(QStringLiteral("[App]"),
                                       QStringLiteral("keylock_multithreading")),
                     false);
-    m_channelPerWorker = multiThreadedOnStereo
+    return multiThreadedOnStereo
             ? mixxx::audio::ChannelCount::mono()
             : mixxx::audio::ChannelCount::stereo();
-    DEBUG_ASSERT(mixxx::kMaxEngineChannelInputCount % m_channelPerWorker == 0);
+}
 
+int numHelperThreads(mixxx::audio::ChannelCount channelPerWorker) {
+    DEBUG_ASSERT(mixxx::kMaxEngineChannelInputCount % channelPerWorker == 0);
     int numCore = QThread::idealThreadCount();
-    int numRBTasks = qMin(numCore, mixxx::kMaxEngineChannelInputCount / m_channelPerWorker);
+    int numRBTasks = qMin(numCore, mixxx::kMaxEngineChannelInputCount / channelPerWorker);
 
-    qDebug() << "RubberBand will use" << numRBTasks << "tasks to scale the audio signal";
-
-    setThreadPriority(QThread::HighPriority);
     // The RB pool will only be used to scale n-1 buffer sample, so the engine
     // thread takes care of the last buffer and doesn't have to be idle.
-    setMaxThreadCount(numRBTasks - 1);
-
-    // We allocate one runner less than the total of maximum supported channel,
-    // so the engine thread will also perform a stretching operation, instead of
-    // waiting all workers to complete. During performance testing, this ahas
-    // show better results
-    for (int w = 0; w < maxThreadCount(); w++) {
-        reserveThread();
-    }
+    return numRBTasks - 1;
+}
+
+// The helpers of the engine mixer are pinned to the cores starting at CPU 1
+// and the RubberBand helpers to the cores after them. If the remaining cores
+// do not suffice, EngineThreadPool leaves the RubberBand helpers unpinned.
+int firstCpu(const UserSettingsPointer& pConfig) {
+    return 1 + EngineMixer::numChannelHelperThreads(pConfig);
+}
+
+} // anonymous namespace
+
+RubberBandWorkerPool::RubberBandWorkerPool(UserSettingsPointer pConfig)
+        : RubberBandWorkerPool(channelPerWorker(pConfig), firstCpu(pConfig)) {
+}
+
+RubberBandWorkerPool::RubberBandWorkerPool(
+        mixxx::audio::ChannelCount channelPerWorker, int firstCpu)
+        : EngineThreadPool(QStringLiteral("RubberBand"),
+                  numHelperThreads(channelPerWorker),
+                  firstCpu),
+          m_channelPerWorker(channelPerWorker) {
+    qDebug() << "RubberBand will use" << numThreads() + 1
+             << "tasks to scale the audio signal";
 }
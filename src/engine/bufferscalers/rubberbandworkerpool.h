@@ -1,15 +1,15 @@
 #pragma once
 
-#include <QThreadPool>
-
 #include "audio/types.h"
+#include "engine/enginethreadpool.h"
 #include "preferences/usersettings.h"
 #include "util/singleton.h"
 
-// RubberBandWorkerPool is a global pool manager for RubberBandWorkerPool. It
-// allows a the Engine thread to use a pool of agnostic RubberBandWorker which
-// can be distributed stretching job
-class RubberBandWorkerPool : public QThreadPool, public Singleton<RubberBandWorkerPool> {
+// RubberBandWorkerPool is a global pool of helper threads for the
+// RubberBandWrapper. It allows the engine thread to distribute the stretching
+// of the channel groups of a deck over multiple cores within the audio
+// callback.
+class RubberBandWorkerPool : public EngineThreadPool, public Singleton<RubberBandWorkerPool> {
   public:
     const mixxx::audio::ChannelCount& channelPerWorker() const {
         return m_channelPerWorker;
@@ -19,8 +19,9 @@ class RubberBandWorkerPool : public QThreadPool, public Singleton<RubberBandWork
     RubberBandWorkerPool(UserSettingsPointer pConfig = nullptr);
 
   private:
-    ;
-    mixxx::audio::ChannelCount m_channelPerWorker;
+    RubberBandWorkerPool(mixxx::audio::ChannelCount channelPerWorker, int firstCpu);
+
+    const mixxx::audio::ChannelCount m_channelPerWorker;
 
     friend class Singleton<RubberBandWorkerPool>;
 };
@@ -53,7 +53,7 @@ mixxx::audio::ChannelCount getChannelPerWorker(mixxx::audio::ChannelCount chCoun
     }
     auto channelPerWorker = pPool->channelPerWorker();
     // The task count includes all the thread in the pool + the engine thread
-    auto maxThreadCount = pPool->maxThreadCount() + 1;
+    auto maxThreadCount = pPool->numThreads() + 1;
     VERIFY_OR_DEBUG_ASSERT(chCount % channelPerWorker == 0) {
         return mixxx::kEngineChannelOutputCount;
     }
@@ -66,6 +66,22 @@ mixxx::audio::ChannelCount getChannelPerWorker(mixxx::audio::ChannelCount chCoun
     }
     return channelPerWorker;
 }
+
+struct ProcessContext {
+    const std::unique_ptr<RubberBandStretcher>* pInstances;
+    const float* const* input;
+    int channelPerWorker;
+    size_t samples;
+    bool isFinal;
+};
+
+void processInstance(void* pContext, int instanceIndex) {
+    const auto* pProcessContext = static_cast<const ProcessContext*>(pContext);
+    pProcessContext->pInstances[instanceIndex]->process(
+            pProcessContext->input + instanceIndex * pProcessContext->channelPerWorker,
+            pProcessContext->samples,
+            pProcessContext->isFinal);
+}
 } // namespace
 
 int RubberBandWrapper::getEngineVersion() const {
@@ -181,21 +197,22 @@ void RubberBandWrapper::process(const float* const* input, size_t samples, bool
     if (m_pInstances.size() == 1) {
         return m_pInstances[0]->process(input, samples, isFinal);
     } else {
-        RubberBandWorkerPool* pPool = RubberBandWorkerPool::instance();
-        for (auto& pInstance : m_pInstances) {
-            pInstance->set(input, samples, isFinal);
-            // We try to get the stretching job ran by the RBPool if there is a
-            // worker slot available
-            if (!pPool->tryStart(pInstance.get())) {
-                // Otherwise, it means the main thread should take care of the stretching
-                pInstance->run();
+        ProcessContext context{m_pInstances.data(),
+                input,
+                m_channelPerWorker,
+                samples,
+                isFinal};
+        const int instanceCount = static_cast<int>(m_pInstances.size());
+        // The engine thread takes part in the stretching and returns once
+        // all instances are done.
+        if (!RubberBandWorkerPool::instance()->tryRun(
+                    processInstance, &context, instanceCount)) {
+            // The pool is busy with another deck that is processed in
+            // parallel on a helper of the engine mixer, so this thread
+            // takes care of the stretching.
+            for (int i = 0; i < instanceCount; ++i) {
+                processInstance(&context, i);
             }
-            input += m_channelPerWorker;
-        }
-        // We always perform a wait, even for task that were ran in the main
-        // thread, so it resets the semaphore
-        for (auto& pInstance : m_pInstances) {
-            pInstance->waitReady();
         }
     }
 }
@@ -223,7 +240,7 @@ void RubberBandWrapper::setup(mixxx::audio::SampleRate sampleRate,
         // single instance to limit the audio imperfection that may come from
         // using RB with different parameters.
         m_pInstances.emplace_back(
-                std::make_unique<RubberBandTask>(
+                std::make_unique<RubberBandStretcher>(
                         sampleRate, chCount, opt));
         return;
     }
@@ -231,7 +248,7 @@ void RubberBandWrapper::setup(mixxx::audio::SampleRate sampleRate,
     m_pInstances.reserve(chCount / m_channelPerWorker);
     for (int c = 0; c < chCount; c += m_channelPerWorker) {
         m_pInstances.emplace_back(
-                std::make_unique<RubberBandTask>(
+                std::make_unique<RubberBandStretcher>(
                         sampleRate, m_channelPerWorker, opt));
     }
 }
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <rubberband/RubberBandStretcher.h>
+
+#include <memory>
+#include <vector>
+
 #include "audio/types.h"
-#include "engine/bufferscalers/rubberbandtask.h"
 
 /// RubberBandWrapper is a wrapper around RubberBand::RubberBandStretcher which
 /// allows to distribute signal stretching over multiple instance, but interface
@@ -31,7 +35,7 @@ class RubberBandWrapper {
 
   private:
     // copy constructor of RubberBand::RubberBandStretcher is implicitly deleted.
-    std::vector<std::unique_ptr<RubberBandTask>> m_pInstances;
+    std::vector<std::unique_ptr<RubberBand::RubberBandStretcher>> m_pInstances;
     // Number of channel used for each instance. This may vary whether the track
     // is a stereo track or a stem track
     mixxx::audio::ChannelCount m_channelPerWorker;
@@ -56,15 +56,19 @@ CachingReader::CachingReader(const QString& group,
           // the worker could get stuck in a hot loop!!!
           m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
           m_state(STATE_IDLE),
+          m_allocatedCachingReaderChunks(kNumberOfCachedChunksInMemory),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
           m_sampleBuffer(CachingReaderChunk::kFrames * maxSupportedChannel *
                   kNumberOfCachedChunksInMemory),
+          m_chunkHitCounter(QStringLiteral("CachingReader %1 chunk hits").arg(group)),
+          m_chunkMissCounter(QStringLiteral("CachingReader %1 chunk misses").arg(group)),
+          m_readStallCounter(QStringLiteral("CachingReader %1 stalls").arg(group)),
           m_worker(group,
                   &m_chunkReadRequestFIFO,
                   &m_readerStatusUpdateFIFO,
                   maxSupportedChannel) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
+    m_freeChunks.reserve(kNumberOfCachedChunksInMemory);
     // Divide up the allocated raw memory buffer into total_chunks
     // chunks. Initialize each chunk to hold nothing and add it to the free
     // list.
@@ -110,11 +114,9 @@ void CachingReader::freeChunk(CachingReaderChunkForOwner* pChunk) {
     DEBUG_ASSERT(pChunk);
     DEBUG_ASSERT(pChunk->getState() != CachingReaderChunkForOwner::READ_PENDING);
 
-    const int removed = m_allocatedCachingReaderChunks.remove(pChunk->getIndex());
-    Q_UNUSED(removed); // only used in DEBUG_ASSERT
     // We'll tolerate not being in allocatedCachingReaderChunks,
     // because sometime you free a chunk right after you allocated it.
-    DEBUG_ASSERT(removed <= 1);
+    m_allocatedCachingReaderChunks.remove(pChunk->getIndex());
 
     freeChunkFromList(pChunk);
 }
@@ -141,8 +143,8 @@ CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
     if (m_freeChunks.empty()) {
         return nullptr;
     }
-    CachingReaderChunkForOwner* pChunk = m_freeChunks.front();
-    m_freeChunks.pop_front();
+    CachingReaderChunkForOwner* pChunk = m_freeChunks.back();
+    m_freeChunks.pop_back();
 
     pChunk->init(chunkIndex);
 
@@ -168,8 +170,8 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
 }
 
 CachingReaderChunkForOwner* CachingReader::lookupChunk(SINT chunkIndex) {
-    // Defaults to nullptr if it's not in the hash.
-    auto* pChunk = m_allocatedCachingReaderChunks.value(chunkIndex, nullptr);
+    // Defaults to nullptr if it's not in the index.
+    auto* pChunk = m_allocatedCachingReaderChunks.find(chunkIndex);
     DEBUG_ASSERT(!pChunk || pChunk->getIndex() == chunkIndex);
     return pChunk;
 }
@@ -450,6 +452,7 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                 mixxx::IndexRange bufferedFrameIndexRange;
                 const CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
                 if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                    m_chunkHitCounter.increment();
                     if (reverse) {
                         bufferedFrameIndexRange =
                                 pChunk->readBufferedSampleFramesReverse(
@@ -470,6 +473,7 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                     DEBUG_ASSERT(!pChunk ||
                             (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING));
                     Counter("CachingReader::read(): Failed to read chunk on cache miss")++;
+                    m_chunkMissCounter.increment();
                     if (kLogger.traceEnabled()) {
                         kLogger.trace()
                                 << "Cache miss for chunk with index"
@@ -486,6 +490,7 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                         // the first required chunk. Inform the calling code that no
                         // data has been written into the buffer and to handle this
                         // situation appropriately.
+                        m_readStallCounter.increment();
                         return ReadResult::UNAVAILABLE;
                     }
                     // No more readable data available. Exit the loop and
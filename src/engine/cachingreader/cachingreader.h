@@ -1,15 +1,16 @@
 #pragma once
 
 #include <QAtomicInt>
-#include <QHash>
 #include <QList>
 #include <QVarLengthArray>
 #include <QVector>
-#include <list>
+#include <vector>
 
+#include "engine/cachingreader/cachingreaderchunkindex.h"
 #include "engine/cachingreader/cachingreaderworker.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
+#include "util/counter.h"
 #include "util/fifo.h"
 #include "util/types.h"
 
@@ -179,13 +180,14 @@ class CachingReader : public QObject {
     // Keeps track of all CachingReaderChunks we've allocated.
     QVector<CachingReaderChunkForOwner*> m_chunks;
 
-    // List of free chunks. Linked list so that we have constant time insertions
-    // and deletions. Iteration is not necessary.
-    std::list<CachingReaderChunkForOwner*> m_freeChunks;
+    // Stack of free chunks with a preallocated capacity for all chunks.
+    // The most recently freed chunk is reused first while its memory
+    // is still cached.
+    std::vector<CachingReaderChunkForOwner*> m_freeChunks;
 
     // Keeps track of what CachingReaderChunks we've allocated and indexes them based on what
     // chunk number they are allocated to.
-    QHash<int, CachingReaderChunkForOwner*> m_allocatedCachingReaderChunks;
+    CachingReaderChunkIndex<CachingReaderChunkForOwner> m_allocatedCachingReaderChunks;
 
     // The linked list of recently-used chunks.
     CachingReaderChunkForOwner* m_mruCachingReaderChunk;
@@ -197,5 +199,12 @@ class CachingReader : public QObject {
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // Per deck statistics of read(): the chunks that have been found in the
+    // cache, the chunks that were missing and the buffers that could not be
+    // filled at all because the first chunk was still missing.
+    Counter m_chunkHitCounter;
+    Counter m_chunkMissCounter;
+    Counter m_readStallCounter;
+
     CachingReaderWorker m_worker;
 };
@@ -77,6 +77,25 @@ mixxx::IndexRange CachingReaderChunk::bufferSampleFrames(
     return m_bufferedSampleFrames.frameIndexRange();
 }
 
+mixxx::IndexRange CachingReaderChunk::copyBufferedSampleFrames(
+        const CachingReaderChunk& sourceChunk) {
+    DEBUG_ASSERT(m_index != kInvalidChunkIndex);
+    DEBUG_ASSERT(m_index == sourceChunk.m_index);
+    const SINT sampleCount = sourceChunk.m_bufferedSampleFrames.readableLength();
+    VERIFY_OR_DEBUG_ASSERT(sampleCount <= m_sampleBuffer.length()) {
+        m_bufferedSampleFrames.frameIndexRange() = mixxx::IndexRange();
+        return m_bufferedSampleFrames.frameIndexRange();
+    }
+    SampleUtil::copy(
+            m_sampleBuffer.data(),
+            sourceChunk.m_bufferedSampleFrames.readableData(),
+            sampleCount);
+    m_bufferedSampleFrames = mixxx::ReadableSampleFrames(
+            sourceChunk.m_bufferedSampleFrames.frameIndexRange(),
+            mixxx::SampleBuffer::ReadableSlice(m_sampleBuffer.data(), sampleCount));
+    return m_bufferedSampleFrames.frameIndexRange();
+}
+
 mixxx::IndexRange CachingReaderChunk::readBufferedSampleFrames(
         CSAMPLE* sampleBuffer,
         mixxx::audio::ChannelCount channelCount,
@@ -63,6 +63,12 @@ public:
             const mixxx::AudioSourcePointer& pAudioSource,
             mixxx::SampleBuffer::WritableSlice tempOutputBuffer);
 
+    // Copy the buffered sample frames of another chunk with the same index
+    // that has been read from the same audio source, instead of reading
+    // them again. Returns the range of frames that have been copied.
+    mixxx::IndexRange copyBufferedSampleFrames(
+            const CachingReaderChunk& sourceChunk);
+
     mixxx::IndexRange readBufferedSampleFrames(CSAMPLE* sampleBuffer,
             mixxx::audio::ChannelCount channelCount,
             const mixxx::IndexRange& frameIndexRange) const;
@@ -149,3 +155,17 @@ private:
   CachingReaderChunkForOwner* m_pPrev; // previous item in double-linked list
   CachingReaderChunkForOwner* m_pNext; // next item in double-linked list
 };
+
+// A chunk that is read in advance by the CachingReaderPreloader, before
+// the track is loaded into a deck. The sample buffer is owned by the
+// preloaded track.
+class CachingReaderChunkForPreloader : public CachingReaderChunk {
+  public:
+    CachingReaderChunkForPreloader(
+            SINT index,
+            mixxx::SampleBuffer::WritableSlice sampleBuffer)
+            : CachingReaderChunk(std::move(sampleBuffer)) {
+        init(index);
+    }
+    ~CachingReaderChunkForPreloader() override = default;
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "util/assert.h"
+#include "util/types.h"
+
+/// Maps chunk indices onto the chunks that are currently allocated for them.
+///
+/// A flat, open-addressed hash table with linear probing. The slots are
+/// allocated once upfront for a fixed maximum number of entries, so neither
+/// lookups nor modifications allocate memory and the index can safely be
+/// used on the real-time thread. The table is kept at most half full so
+/// that probe sequences stay short.
+///
+/// Removed entries don't leave tombstones behind. Instead the following
+/// entries of the same probe sequence are shifted backwards. The table
+/// doesn't degrade when chunks are evicted and re-allocated over and over
+/// again, e.g. while juggling between hot cues.
+///
+/// Not thread-safe, the index is only accessed by the owner of the chunks.
+template<typename T>
+class CachingReaderChunkIndex {
+  public:
+    explicit CachingReaderChunkIndex(int maxSize)
+            : m_maxSize(maxSize),
+              m_size(0),
+              m_hashShift(64),
+              m_slotMask(0) {
+        DEBUG_ASSERT(maxSize > 0);
+        std::size_t capacity = 1;
+        while (capacity < 2 * static_cast<std::size_t>(maxSize)) {
+            capacity <<= 1;
+            --m_hashShift;
+        }
+        m_slotMask = capacity - 1;
+        m_slots.resize(capacity);
+    }
+
+    int size() const {
+        return m_size;
+    }
+    bool isEmpty() const {
+        return m_size == 0;
+    }
+
+    /// Returns nullptr if no entry exists for the chunk index.
+    T* find(SINT chunkIndex) const {
+        std::size_t slotIndex = homeSlotIndex(chunkIndex);
+        while (m_slots[slotIndex].pValue) {
+            if (m_slots[slotIndex].chunkIndex == chunkIndex) {
+                return m_slots[slotIndex].pValue;
+            }
+            slotIndex = (slotIndex + 1) & m_slotMask;
+        }
+        return nullptr;
+    }
+
+    /// Inserts or replaces the entry for the chunk index.
+    void insert(SINT chunkIndex, T* pValue) {
+        DEBUG_ASSERT(pValue);
+        DEBUG_ASSERT(chunkIndex != kEmptyChunkIndex);
+        std::size_t slotIndex = homeSlotIndex(chunkIndex);
+        while (m_slots[slotIndex].pValue) {
+            if (m_slots[slotIndex].chunkIndex == chunkIndex) {
+                m_slots[slotIndex].pValue = pValue;
+                return;
+            }
+            slotIndex = (slotIndex + 1) & m_slotMask;
+        }
+        VERIFY_OR_DEBUG_ASSERT(m_size < m_maxSize) {
+            return;
+        }
+        m_slots[slotIndex].chunkIndex = chunkIndex;
+        m_slots[slotIndex].pValue = pValue;
+        ++m_size;
+    }
+
+    /// Returns false if no entry exists for the chunk index.
+    bool remove(SINT chunkIndex) {
+        std::size_t holeIndex = homeSlotIndex(chunkIndex);
+        while (m_slots[holeIndex].chunkIndex != chunkIndex) {
+            if (!m_slots[holeIndex].pValue) {
+                return false;
+            }
+            holeIndex = (holeIndex + 1) & m_slotMask;
+        }
+        // Close the hole by moving all following entries of the probe
+        // sequence that are allowed to occupy it, i.e. whose home slot
+        // is not located between the hole and their current slot.
+        std::size_t slotIndex = holeIndex;
+        while (true) {
+            slotIndex = (slotIndex + 1) & m_slotMask;
+            const Slot& slot = m_slots[slotIndex];
+            if (!slot.pValue) {
+                break;
+            }
+            const std::size_t probeLength =
+                    (slotIndex - homeSlotIndex(slot.chunkIndex)) & m_slotMask;
+            if (probeLength >= ((slotIndex - holeIndex) & m_slotMask)) {
+                m_slots[holeIndex] = slot;
+                holeIndex = slotIndex;
+            }
+        }
+        m_slots[holeIndex] = Slot{};
+        --m_size;
+        return true;
+    }
+
+    void clear() {
+        if (m_size == 0) {
+            return;
+        }
+        std::fill(m_slots.begin(), m_slots.end(), Slot{});
+        m_size = 0;
+    }
+
+  private:
+    static constexpr SINT kEmptyChunkIndex = std::numeric_limits<SINT>::min();
+
+    struct Slot {
+        SINT chunkIndex = kEmptyChunkIndex;
+        T* pValue = nullptr;
+    };
+
+    // Fibonacci hashing spreads consecutive chunk indices evenly
+    // across the table.
+    std::size_t homeSlotIndex(SINT chunkIndex) const {
+        return static_cast<std::size_t>(
+                (static_cast<std::uint64_t>(chunkIndex) * 0x9E3779B97F4A7C15ull) >>
+                m_hashShift);
+    }
+
+    const int m_maxSize;
+    int m_size;
+    int m_hashShift;
+    std::size_t m_slotMask;
+    std::vector<Slot> m_slots;
+};
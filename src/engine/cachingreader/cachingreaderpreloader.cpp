@@ -0,0 +1,293 @@
+#include "engine/cachingreader/cachingreaderpreloader.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "moc_cachingreaderpreloader.cpp"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CachingReaderPreloader");
+
+// The Auto DJ only needs the next track, the second one is preloaded in
+// case the next one is skipped. Each preloaded track occupies up to
+// 16 chunks, i.e. ~4 MB for a stem track.
+constexpr int kMaxPreloadedTracks = 2;
+
+// The number of chunks that are preloaded from each position where playback
+// might start. This covers ~0.7 s of audio at 48 kHz, enough time to read
+// the following chunks.
+constexpr SINT kChunksPerPosition = 4;
+
+std::vector<SINT> chunkIndicesToPreload(
+        const Track& track,
+        const mixxx::AudioSource& audioSource) {
+    // A deck starts at the beginning, at the main cue or at the intro
+    // start depending on the preferences. The Auto DJ might start at the
+    // first sound.
+    std::vector<mixxx::audio::FramePos> positions{
+            mixxx::audio::kStartFramePos,
+            track.getMainCuePosition()};
+    for (const auto cueType : {mixxx::CueType::Intro, mixxx::CueType::N60dBSound}) {
+        const CuePointer pCue = track.findCueByType(cueType);
+        if (pCue) {
+            positions.push_back(pCue->getPosition());
+        }
+    }
+
+    const mixxx::IndexRange frameIndexRange = audioSource.frameIndexRange();
+    const SINT firstChunkIndex = CachingReaderChunk::indexForFrame(frameIndexRange.start());
+    const SINT lastChunkIndex = CachingReaderChunk::indexForFrame(frameIndexRange.end() - 1);
+    std::vector<SINT> chunkIndices;
+    for (const auto& position : positions) {
+        if (!position.isValid()) {
+            continue;
+        }
+        const SINT chunkIndex = std::max(firstChunkIndex,
+                CachingReaderChunk::indexForFrame(
+                        static_cast<SINT>(position.toLowerFrameBoundary().value())));
+        for (SINT i = chunkIndex;
+                i < chunkIndex + kChunksPerPosition && i <= lastChunkIndex;
+                ++i) {
+            chunkIndices.push_back(i);
+        }
+    }
+    std::sort(chunkIndices.begin(), chunkIndices.end());
+    chunkIndices.erase(
+            std::unique(chunkIndices.begin(), chunkIndices.end()),
+            chunkIndices.end());
+    return chunkIndices;
+}
+
+} // anonymous namespace
+
+CachingReaderPreloader::PreloadedTrack::PreloadedTrack(TrackId trackId,
+        mixxx::AudioSourcePointer pAudioSource,
+        const std::vector<SINT>& chunkIndices,
+        mixxx::audio::ChannelCount maxChannelCount)
+        : m_trackId(trackId),
+          m_pAudioSource(std::move(pAudioSource)),
+          m_sampleBuffer(static_cast<SINT>(chunkIndices.size()) *
+                  CachingReaderChunk::frames2samples(
+                          CachingReaderChunk::kFrames, maxChannelCount)) {
+    // Like the CachingReader every chunk has room for the maximum number
+    // of channels, mono sources are read as stereo.
+    const SINT chunkSampleCount = CachingReaderChunk::frames2samples(
+            CachingReaderChunk::kFrames, maxChannelCount);
+    m_chunks.reserve(chunkIndices.size());
+    for (SINT i = 0; i < static_cast<SINT>(chunkIndices.size()); ++i) {
+        m_chunks.push_back(std::make_unique<CachingReaderChunkForPreloader>(
+                chunkIndices[i],
+                mixxx::SampleBuffer::WritableSlice(
+                        m_sampleBuffer, i * chunkSampleCount, chunkSampleCount)));
+    }
+}
+
+const CachingReaderChunk* CachingReaderPreloader::PreloadedTrack::findChunk(
+        SINT chunkIndex) const {
+    // The chunks are sorted by index
+    const auto it = std::lower_bound(m_chunks.begin(),
+            m_chunks.end(),
+            chunkIndex,
+            [](const auto& pChunk, SINT index) {
+                return pChunk->getIndex() < index;
+            });
+    if (it == m_chunks.end() || (*it)->getIndex() != chunkIndex) {
+        return nullptr;
+    }
+    return it->get();
+}
+
+bool CachingReaderPreloader::PreloadedTrack::readChunks(const QAtomicInt& abort) {
+    auto tempReadBuffer = mixxx::SampleBuffer(
+            m_pAudioSource->getSignalInfo().frames2samples(
+                    CachingReaderChunk::kFrames));
+    for (auto& pChunk : m_chunks) {
+        if (abort.loadAcquire()) {
+            return false;
+        }
+        const auto bufferedFrameIndexRange = pChunk->bufferSampleFrames(
+                m_pAudioSource,
+                mixxx::SampleBuffer::WritableSlice(tempReadBuffer));
+        if (bufferedFrameIndexRange != pChunk->frameIndexRange(m_pAudioSource)) {
+            // Read it again when loaded and report the error there
+            pChunk.reset();
+        }
+    }
+    m_chunks.erase(std::remove(m_chunks.begin(), m_chunks.end(), nullptr), m_chunks.end());
+    return true;
+}
+
+CachingReaderPreloader::CachingReaderPreloader(mixxx::audio::ChannelCount channelCount)
+        : m_channelCount(channelCount),
+          m_stop(0),
+          m_abortCurrent(0) {
+    setObjectName(QStringLiteral("CachingReaderPreloader"));
+    // Reading the files must not delay the CachingReaderWorkers of the decks
+    start(QThread::LowestPriority);
+}
+
+CachingReaderPreloader::~CachingReaderPreloader() {
+    {
+        const auto locker = lockMutex(&m_mutex);
+        m_stop.storeRelease(1);
+        m_abortCurrent.storeRelease(1);
+        m_tracksChanged.wakeAll();
+    }
+    wait();
+}
+
+bool CachingReaderPreloader::isWanted(TrackId trackId) const {
+    return std::any_of(m_wantedTracks.cbegin(),
+            m_wantedTracks.cend(),
+            [trackId](const auto& pTrack) {
+                return pTrack->getId() == trackId;
+            });
+}
+
+bool CachingReaderPreloader::isPreloaded(TrackId trackId) const {
+    return std::any_of(m_preloadedTracks.cbegin(),
+            m_preloadedTracks.cend(),
+            [trackId](const auto& pPreloadedTrack) {
+                return pPreloadedTrack->getTrackId() == trackId;
+            });
+}
+
+void CachingReaderPreloader::preloadTracks(const QList<TrackPointer>& tracks) {
+    // Closed outside of the lock
+    std::vector<std::unique_ptr<PreloadedTrack>> discardedTracks;
+    {
+        const auto locker = lockMutex(&m_mutex);
+        m_wantedTracks.clear();
+        for (const auto& pTrack : tracks) {
+            if (m_wantedTracks.size() >= kMaxPreloadedTracks) {
+                break;
+            }
+            if (pTrack && pTrack->getId().isValid()) {
+                m_wantedTracks.append(pTrack);
+            }
+        }
+        for (auto& pPreloadedTrack : m_preloadedTracks) {
+            if (!isWanted(pPreloadedTrack->getTrackId())) {
+                discardedTracks.push_back(std::move(pPreloadedTrack));
+            }
+        }
+        m_preloadedTracks.erase(
+                std::remove(m_preloadedTracks.begin(), m_preloadedTracks.end(), nullptr),
+                m_preloadedTracks.end());
+        if (m_preloadingTrackId.isValid() && !isWanted(m_preloadingTrackId)) {
+            m_abortCurrent.storeRelease(1);
+        }
+        m_tracksChanged.wakeAll();
+    }
+}
+
+bool CachingReaderPreloader::hasPreloadedTrack(const TrackPointer& pTrack) const {
+    const auto locker = lockMutex(&m_mutex);
+    return isPreloaded(pTrack->getId());
+}
+
+std::unique_ptr<CachingReaderPreloader::PreloadedTrack>
+CachingReaderPreloader::takePreloadedTrack(
+        const TrackPointer& pTrack,
+        mixxx::audio::ChannelCount channelCount) {
+    const TrackId trackId = pTrack->getId();
+    if (!trackId.isValid()) {
+        return nullptr;
+    }
+    const auto locker = lockMutex(&m_mutex);
+    // Don't preload it again, it would be discarded anyway
+    m_wantedTracks.removeIf([trackId](const auto& pWantedTrack) {
+        return pWantedTrack->getId() == trackId;
+    });
+    if (m_preloadingTrackId == trackId) {
+        m_abortCurrent.storeRelease(1);
+    }
+    const auto it = std::find_if(m_preloadedTracks.begin(),
+            m_preloadedTracks.end(),
+            [trackId](const auto& pPreloadedTrack) {
+                return pPreloadedTrack->getTrackId() == trackId;
+            });
+    if (it == m_preloadedTracks.end()) {
+        return nullptr;
+    }
+    auto pPreloadedTrack = std::move(*it);
+    m_preloadedTracks.erase(it);
+    if (channelCount != m_channelCount) {
+        // Opened with different parameters
+        return nullptr;
+    }
+    return pPreloadedTrack;
+}
+
+void CachingReaderPreloader::run() {
+    while (!m_stop.loadAcquire()) {
+        TrackPointer pTrack;
+        {
+            const auto locker = lockMutex(&m_mutex);
+            for (const auto& pWantedTrack : std::as_const(m_wantedTracks)) {
+                if (!isPreloaded(pWantedTrack->getId())) {
+                    pTrack = pWantedTrack;
+                    break;
+                }
+            }
+            if (!pTrack) {
+                if (!m_stop.loadAcquire()) {
+                    m_tracksChanged.wait(&m_mutex);
+                }
+                continue;
+            }
+            m_preloadingTrackId = pTrack->getId();
+            m_abortCurrent.storeRelease(0);
+        }
+
+        auto pPreloadedTrack = preloadTrack(pTrack);
+
+        const auto locker = lockMutex(&m_mutex);
+        m_preloadingTrackId = TrackId();
+        if (!pPreloadedTrack) {
+            // Don't try again until it is requested again
+            m_wantedTracks.removeAll(pTrack);
+            continue;
+        }
+        if (isWanted(pPreloadedTrack->getTrackId())) {
+            m_preloadedTracks.push_back(std::move(pPreloadedTrack));
+        }
+    }
+}
+
+std::unique_ptr<CachingReaderPreloader::PreloadedTrack>
+CachingReaderPreloader::preloadTrack(const TrackPointer& pTrack) {
+    if (!pTrack->getFileInfo().checkFileExists()) {
+        return nullptr;
+    }
+    // The same parameters as the CachingReaderWorker of the decks
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(m_channelCount);
+    auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    if (!pAudioSource ||
+            pAudioSource->frameIndexRange().empty() ||
+            pAudioSource->getSignalInfo().getChannelCount() > m_channelCount) {
+        kLogger.debug() << "Failed to open" << pTrack->getFileInfo();
+        return nullptr;
+    }
+
+    auto pPreloadedTrack = std::make_unique<PreloadedTrack>(pTrack->getId(),
+            pAudioSource,
+            chunkIndicesToPreload(*pTrack, *pAudioSource),
+            m_channelCount);
+    if (!pPreloadedTrack->readChunks(m_abortCurrent)) {
+        kLogger.debug() << "Aborted preloading" << pTrack->getFileInfo();
+        return nullptr;
+    }
+    kLogger.debug()
+            << "Preloaded"
+            << pPreloadedTrack->chunkCount()
+            << "chunks of"
+            << pTrack->getFileInfo();
+    return pPreloadedTrack;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <memory>
+#include <vector>
+
+#include "audio/types.h"
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "sources/audiosource.h"
+#include "track/track_decl.h"
+#include "track/trackid.h"
+#include "util/samplebuffer.h"
+#include "util/singleton.h"
+
+/// CachingReaderPreloader opens the tracks that are about to be loaded into
+/// a deck, e.g. the next tracks of the Auto DJ queue, and reads the chunks
+/// around their intro and cue positions on a low priority thread.
+///
+/// When one of these tracks is loaded the CachingReaderWorker adopts the
+/// open audio source and copies the preloaded chunks instead of reading
+/// them from the file. This avoids stalls on slow storage at load time.
+/// The number of preloaded tracks is bounded.
+class CachingReaderPreloader : public QThread, public Singleton<CachingReaderPreloader> {
+    Q_OBJECT
+  public:
+    /// An open audio source with the chunks that have been read in advance.
+    class PreloadedTrack {
+      public:
+        PreloadedTrack(TrackId trackId,
+                mixxx::AudioSourcePointer pAudioSource,
+                const std::vector<SINT>& chunkIndices,
+                mixxx::audio::ChannelCount maxChannelCount);
+
+        TrackId getTrackId() const {
+            return m_trackId;
+        }
+
+        const mixxx::AudioSourcePointer& getAudioSource() const {
+            return m_pAudioSource;
+        }
+
+        /// Returns nullptr if the chunk has not been preloaded.
+        const CachingReaderChunk* findChunk(SINT chunkIndex) const;
+
+        /// Reads all chunks from the audio source. Chunks that cannot be
+        /// read are dropped. Returns false if the read has been aborted.
+        bool readChunks(const QAtomicInt& abort);
+
+        int chunkCount() const {
+            return static_cast<int>(m_chunks.size());
+        }
+
+      private:
+        const TrackId m_trackId;
+        const mixxx::AudioSourcePointer m_pAudioSource;
+        mixxx::SampleBuffer m_sampleBuffer;
+        std::vector<std::unique_ptr<CachingReaderChunkForPreloader>> m_chunks;
+    };
+
+    /// Replaces the tracks that should be preloaded, in order of priority.
+    /// Preloaded tracks that are no longer in the list are discarded.
+    void preloadTracks(const QList<TrackPointer>& tracks);
+
+    /// Returns the preloaded track if it has been opened with the given
+    /// channel count and removes it from the cache. Returns nullptr if it
+    /// has not been preloaded (yet).
+    std::unique_ptr<PreloadedTrack> takePreloadedTrack(
+            const TrackPointer& pTrack,
+            mixxx::audio::ChannelCount channelCount);
+
+    /// Returns true if the track has been preloaded and is ready to be
+    /// taken.
+    bool hasPreloadedTrack(const TrackPointer& pTrack) const;
+
+  protected:
+    /// The audio sources are opened with the given channel count, i.e.
+    /// the one of the decks that tracks are preloaded for.
+    explicit CachingReaderPreloader(mixxx::audio::ChannelCount channelCount);
+    ~CachingReaderPreloader() override;
+
+    void run() override;
+
+  private:
+    std::unique_ptr<PreloadedTrack> preloadTrack(const TrackPointer& pTrack);
+    bool isWanted(TrackId trackId) const;
+    bool isPreloaded(TrackId trackId) const;
+
+    const mixxx::audio::ChannelCount m_channelCount;
+
+    QAtomicInt m_stop;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_tracksChanged;
+    // The tracks that should be preloaded in order of priority
+    QList<TrackPointer> m_wantedTracks;
+    // The track that is currently preloaded by the thread
+    TrackId m_preloadingTrackId;
+    // Set to abort preloading of the current track
+    QAtomicInt m_abortCurrent;
+    std::vector<std::unique_ptr<PreloadedTrack>> m_preloadedTracks;
+
+    friend class Singleton<CachingReaderPreloader>;
+};
@@ -2,6 +2,8 @@
 
 #include <QAtomicInt>
 #include <QtDebug>
+#include <algorithm>
+#include <array>
 
 #include "analyzer/analyzersilence.h"
 #include "moc_cachingreaderworker.cpp"
@@ -20,6 +22,11 @@ mixxx::Logger kLogger("CachingReaderWorker");
 // we need the last silence frame and the first sound frame
 constexpr SINT kNumSoundFrameToVerify = 2;
 
+// The maximum number of pending read requests that are sorted and read
+// together. The read-ahead of a fast scratch or a seek to a hot cue
+// requests up to 8 chunks at once.
+constexpr int kMaxBatchedReadRequests = 16;
+
 } // anonymous namespace
 
 CachingReaderWorker::CachingReaderWorker(
@@ -51,10 +58,15 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
         return result;
     }
 
-    // Try to read the data required for the chunk from the audio source
-    const mixxx::IndexRange bufferedFrameIndexRange = pChunk->bufferSampleFrames(
-            m_pAudioSource,
-            mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
+    // Try to read the data required for the chunk from the audio source,
+    // unless it has already been read by the preloader
+    const CachingReaderChunk* pPreloadedChunk =
+            m_pPreloadedTrack ? m_pPreloadedTrack->findChunk(pChunk->getIndex()) : nullptr;
+    const mixxx::IndexRange bufferedFrameIndexRange = pPreloadedChunk
+            ? pChunk->copyBufferedSampleFrames(*pPreloadedChunk)
+            : pChunk->bufferSampleFrames(
+                      m_pAudioSource,
+                      mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
     DEBUG_ASSERT(!m_pAudioSource ||
             bufferedFrameIndexRange.isSubrangeOf(m_pAudioSource->frameIndexRange()));
     // The readable frame range might have changed
@@ -93,6 +105,61 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
     return result;
 }
 
+void CachingReaderWorker::processReadRequests(
+        CachingReaderChunkReadRequest* pRequests, int count) {
+    DEBUG_ASSERT(count <= kMaxBatchedReadRequests);
+    struct BatchedReadRequest {
+        CachingReaderChunkReadRequest request;
+        // The position in the FIFO, i.e. lower is more urgent
+        int priority;
+    };
+    std::array<BatchedReadRequest, kMaxBatchedReadRequests> batch;
+    for (int i = 0; i < count; ++i) {
+        batch[i] = BatchedReadRequest{pRequests[i], i};
+    }
+    const auto batchEnd = batch.begin() + count;
+
+    // Reading the chunks in ascending order avoids that the decoder has
+    // to seek between adjacent chunks, e.g. after a jump in reverse or
+    // when the read-ahead spans multiple chunks.
+    std::sort(batch.begin(),
+            batchEnd,
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.request.chunk->getIndex() < rhs.request.chunk->getIndex();
+            });
+    // Each run of adjacent chunks is read when its most urgent chunk is
+    // due, so the current play position is still read before cue points.
+    int runStart = 0;
+    for (int i = 1; i <= count; ++i) {
+        if (i < count &&
+                batch[i].request.chunk->getIndex() ==
+                        batch[i - 1].request.chunk->getIndex() + 1) {
+            continue;
+        }
+        const auto runBegin = batch.begin() + runStart;
+        const auto runEnd = batch.begin() + i;
+        const int runPriority = std::min_element(runBegin,
+                runEnd,
+                [](const auto& lhs, const auto& rhs) {
+                    return lhs.priority < rhs.priority;
+                })->priority;
+        std::for_each(runBegin, runEnd, [runPriority](auto& batchedRequest) {
+            batchedRequest.priority = runPriority;
+        });
+        runStart = i;
+    }
+    std::stable_sort(batch.begin(),
+            batchEnd,
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.priority < rhs.priority;
+            });
+
+    for (auto it = batch.begin(); it != batchEnd; ++it) {
+        const ReaderStatusUpdate update = processReadRequest(it->request);
+        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+    }
+}
+
 // WARNING: Always called from a different thread (GUI)
 #ifdef __STEM__
 void CachingReaderWorker::newTrack(TrackPointer pTrack, mixxx::StemChannelSelection stemMask) {
@@ -121,9 +188,9 @@ void CachingReaderWorker::run() {
             QStringLiteral("CachingReaderWorker ") + QString::number(id));
 
     Event::start(m_tag);
+    // Requests are initialized by reading from FIFO
+    std::array<CachingReaderChunkReadRequest, kMaxBatchedReadRequests> requests;
     while (!m_stop.loadAcquire()) {
-        // Request is initialized by reading from FIFO
-        CachingReaderChunkReadRequest request;
         if (m_newTrackAvailable.loadAcquire()) {
 #ifdef __STEM__
             NewTrackRequest pLoadTrack;
@@ -148,10 +215,11 @@ void CachingReaderWorker::run() {
                 // here, the engine is already stopped
                 unloadTrack();
             }
-        } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
-            // Read the requested chunk and send the result
-            const ReaderStatusUpdate update = processReadRequest(request);
-            m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        } else if (const int requestCount = m_pChunkReadRequestFIFO->read(
+                           requests.data(), kMaxBatchedReadRequests);
+                requestCount > 0) {
+            // Read the requested chunks and send the results
+            processReadRequests(requests.data(), requestCount);
         } else {
             Event::end(m_tag);
             m_semaRun.acquire();
@@ -171,6 +239,7 @@ void CachingReaderWorker::discardAllPendingRequests() {
 void CachingReaderWorker::closeAudioSource() {
     discardAllPendingRequests();
 
+    m_pPreloadedTrack.reset();
     if (m_pAudioSource) {
         // Closes open file handles of the old track.
         m_pAudioSource->close();
@@ -214,12 +283,30 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         return;
     }
 
-    mixxx::AudioSource::OpenParams config;
-    config.setChannelCount(m_maxSupportedChannel);
 #ifdef __STEM__
-    config.setStemMask(stemMask);
+    // Tracks are only preloaded with all stems
+    if (!stemMask && CachingReaderPreloader::isCreated()) {
+#else
+    if (CachingReaderPreloader::isCreated()) {
+#endif
+        m_pPreloadedTrack = CachingReaderPreloader::instance()->takePreloadedTrack(
+                pTrack, m_maxSupportedChannel);
+    }
+    if (m_pPreloadedTrack) {
+        kLogger.debug()
+                << m_group
+                << "Using" << m_pPreloadedTrack->chunkCount()
+                << "preloaded chunks of"
+                << pTrack->getFileInfo();
+        m_pAudioSource = m_pPreloadedTrack->getAudioSource();
+    } else {
+        mixxx::AudioSource::OpenParams config;
+        config.setChannelCount(m_maxSupportedChannel);
+#ifdef __STEM__
+        config.setStemMask(stemMask);
 #endif
-    m_pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+        m_pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    }
     if (!m_pAudioSource) {
         kLogger.warning()
                 << m_group
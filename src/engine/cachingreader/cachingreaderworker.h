@@ -6,6 +6,7 @@
 #include "audio/frame.h"
 #include "audio/types.h"
 #include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreaderpreloader.h"
 #include "engine/engineworker.h"
 #include "sources/audiosource.h"
 #include "track/track_decl.h"
@@ -170,12 +171,20 @@ class CachingReaderWorker : public EngineWorker {
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
 
+    // Processes a batch of read requests such that adjacent chunks are read
+    // sequentially and sends the results.
+    void processReadRequests(CachingReaderChunkReadRequest* pRequests, int count);
+
     void verifyFirstSound(const CachingReaderChunk* pChunk,
             mixxx::audio::ChannelCount channelCount);
 
     // The current audio source of the track loaded
     mixxx::AudioSourcePointer m_pAudioSource;
 
+    // The chunks of the current track that have been read in advance by
+    // the CachingReaderPreloader, if any. They share m_pAudioSource.
+    std::unique_ptr<CachingReaderPreloader::PreloadedTrack> m_pPreloadedTrack;
+
     mixxx::audio::FramePos m_firstSoundFrameToVerify;
 
     // Temporary buffer for reading samples from all channels
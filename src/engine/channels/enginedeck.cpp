@@ -159,6 +159,9 @@ void EngineDeck::processStem(CSAMPLE* pOut, const std::size_t bufferSize) {
     // We will now mix each stem (stereo channel) into a single "output"
     // stereo channel. In order to mix the steam, we will use the engine
     // effect manager so we can also apply the individual stem quick FX
+    if (m_stemMixBuffer.size() < static_cast<SINT>(bufferSize)) {
+        m_stemMixBuffer = mixxx::SampleBuffer(bufferSize);
+    }
     GroupFeatureState featureState;
     collectFeatures(&featureState);
     for (unsigned int stemIdx = 0; stemIdx < stemCount;
@@ -167,41 +170,41 @@ void EngineDeck::processStem(CSAMPLE* pOut, const std::size_t bufferSize) {
         float stemGain = m_stemMute[stemIdx]->toBool()
                 ? 0.0f
                 : static_cast<float>(m_stemGain[stemIdx]->get());
-        // Extract the stem frames into the output buffer (LR......LR...... -> LRLR)
-        SampleUtil::copyOneStereoFromMulti(
-                pOut,
+        // The first stem is processed in the output buffer, the others are
+        // added to it
+        CSAMPLE* pStem = stemIdx == 0 ? pOut : m_stemMixBuffer.data();
+        // Extract the stem frames with their gain in a single pass
+        // (LR......LR...... -> LRLR)
+        SampleUtil::copyOneStereoFromMultiWithRampingGain(
+                pStem,
                 pIn,
+                m_stemsGainCache[stemIdx],
+                stemGain,
                 numFrames,
                 chCount,
                 chOffset);
-        // Mix the stem frames with the right gain after proceeding its effect.
+        // Proceed its effect, the gain has already been applied.
         pEngineEffectsManager->processPostFaderInPlace(m_stems[stemIdx].handle(),
                 m_pEffectsManager->getMainHandle(),
-                pOut,
+                pStem,
                 bufferSize,
                 sampleRate,
                 featureState,
-                m_stemsGainCache[stemIdx],
-                stemGain,
+                CSAMPLE_GAIN_ONE,
+                CSAMPLE_GAIN_ONE,
                 false);
         // We cache the current gain so we can use it to fade the frame on
         // next iteration. Without this, (e.g using a static "previous"
         // gain) gain changes will yield to audio cracks.
         m_stemsGainCache[stemIdx] = stemGain;
 
-        m_stemVuMeter[stemIdx]->process(pOut, bufferSize);
+        m_stemVuMeter[stemIdx]->process(pStem, bufferSize);
 
-        // Put back the stem frames into the steam buffer (LRLR -> LR......LR......)
-        SampleUtil::insertStereoToMulti(
-                pIn,
-                pOut,
-                numFrames,
-                chCount,
-                chOffset);
+        // Mixxx all the stem tracks together
+        if (stemIdx > 0) {
+            SampleUtil::add(pOut, pStem, bufferSize);
+        }
     }
-
-    // Mixxx all the stem tracks together
-    SampleUtil::mixMultichannelToStereo(pOut, pIn, numFrames, chCount);
 }
 
 void EngineDeck::cloneStemState(const EngineDeck* deckToClone) {
@@ -1,6 +1,7 @@
 #include "engine/effects/engineeffectchain.h"
 
 #include "engine/effects/engineeffect.h"
+#include "engine/engineprofiler.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
@@ -12,7 +13,9 @@ EngineEffectChain::EngineEffectChain(const QString& group,
           m_mixMode(EffectChainMixMode::DrySlashWet),
           m_dMix(0),
           m_buffer1(kMaxEngineSamples),
-          m_buffer2(kMaxEngineSamples) {
+          m_buffer2(kMaxEngineSamples),
+          m_profilerProbe(EngineProfiler::registerProbe(
+                  QStringLiteral("Effect chain %1").arg(group))) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 
@@ -224,6 +227,8 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
 
     bool processingOccured = false;
     if (effectiveChainEnableState != EffectEnableState::Disabled) {
+        // Only record chains that are enabled for the channel
+        ScopedEngineProbe probe(m_profilerProbe);
         // Ramping code inside the effects need to access the original samples
         // after writing to the output buffer. This requires not to use the same buffer
         // for in and output: Also, ChannelMixer::applyEffectsAndMixChannels
@@ -75,6 +75,7 @@ class EngineEffectChain final : public EffectsRequestHandler {
     ChannelHandleMap<ChannelStatus> m_outputChannelMap;
     ChannelHandleMap<ChannelHandleMap<ChannelStatus>> m_chainStatusForChannelMatrix;
     EngineEffectsDelay m_effectsDelay;
+    const int m_profilerProbe;
 
     DISALLOW_COPY_AND_ASSIGN(EngineEffectChain);
 };
@@ -92,6 +92,7 @@ EngineBuffer::EngineBuffer(const QString& group,
           m_iSeekPhaseQueued(0),
           m_iEnableSyncQueued(SYNC_REQUEST_NONE),
           m_iSyncModeQueued(static_cast<int>(SyncMode::Invalid)),
+          m_bSyncRequestsDeferred(false),
           m_slipQuitAndAdopt(0),
           m_bPlayAfterLoading(false),
           m_channelCount(mixxx::kEngineChannelOutputCount),
@@ -169,6 +170,9 @@ EngineBuffer::EngineBuffer(const QString& group,
     connect(m_playposSlider, &ControlObject::valueChanged,
             this, &EngineBuffer::slotControlSeek,
             Qt::DirectConnection);
+    // Updated on every callback. Seeks from other threads are still
+    // delivered immediately to slotControlSeek().
+    m_playposSlider->enableCoalescedNotifications();
 
     // Control used to communicate ratio playpos to GUI thread
     m_visualPlayPos = VisualPlayPosition::getVisualPlayPosition(m_group);
@@ -464,6 +468,12 @@ void EngineBuffer::requestSyncMode(SyncMode mode) {
     }
 }
 
+bool EngineBuffer::isSyncParticipant() const {
+    return m_pSyncControl->getSyncMode() != SyncMode::None ||
+            atomicLoadRelaxed(m_iEnableSyncQueued) != SYNC_REQUEST_NONE ||
+            atomicLoadRelaxed(m_iSyncModeQueued) != static_cast<int>(SyncMode::Invalid);
+}
+
 void EngineBuffer::readToCrossfadeBuffer(const std::size_t bufferSize) {
     if (!m_bCrossfadeReady) {
         // Read buffer, as if there where no parameter change
@@ -1326,6 +1336,10 @@ void EngineBuffer::processSlip(std::size_t bufferSize) {
 }
 
 void EngineBuffer::processSyncRequests() {
+    if (m_bSyncRequestsDeferred) {
+        // EngineSync must not be accessed from a helper thread
+        return;
+    }
     SyncRequestQueued enable_request =
             static_cast<SyncRequestQueued>(
                     m_iEnableSyncQueued.fetchAndStoreRelease(SYNC_REQUEST_NONE));
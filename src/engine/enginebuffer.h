@@ -139,6 +139,14 @@ class EngineBuffer : public EngineObject {
     void requestSyncPhase();
     void requestEnableSync(bool enabled);
     void requestSyncMode(SyncMode mode);
+    /// Returns true if processing this buffer may access the shared state
+    /// of EngineSync, i.e. if sync lock is enabled or a request is pending.
+    bool isSyncParticipant() const;
+    /// While deferred, queued sync requests are kept for a later callback.
+    /// Used by EngineMixer for channels that are processed on a helper thread.
+    void setSyncRequestsDeferred(bool deferred) {
+        m_bSyncRequestsDeferred = deferred;
+    }
 
     // The process methods all run in the audio callback.
     void process(CSAMPLE* pOut, const std::size_t bufferSize) override;
@@ -474,6 +482,7 @@ class EngineBuffer : public EngineObject {
     QAtomicInt m_iSeekPhaseQueued;
     QAtomicInt m_iEnableSyncQueued;
     QAtomicInt m_iSyncModeQueued;
+    bool m_bSyncRequestsDeferred;
     ControlValueAtomic<QueuedSeek> m_queuedSeek;
     bool m_previousBufferSeek = false;
 
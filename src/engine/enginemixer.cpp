@@ -1,9 +1,11 @@
 #include "engine/enginemixer.h"
 
 #include <memory>
+#include <utility>
 
 #include "audio/types.h"
 #include "control/controlaudiotaperpot.h"
+#include "control/controlnotifier.h"
 #include "control/controlobject.h"
 #include "control/controlpotmeter.h"
 #include "control/controlpushbutton.h"
@@ -13,11 +15,14 @@
 #include "engine/effects/engineeffectsmanager.h"
 #include "engine/enginebuffer.h"
 #include "engine/enginedelay.h"
+#include "engine/engineprofiler.h"
 #include "engine/enginetalkoverducking.h"
+#include "engine/enginethreadpool.h"
 #include "engine/enginevumeter.h"
 #include "engine/engineworkerscheduler.h"
 #include "engine/enginexfader.h"
 #include "engine/sidechain/enginesidechain.h"
+#include "engine/sidechain/sharedencoder.h"
 #include "engine/sync/enginesync.h"
 #include "mixer/playermanager.h"
 #include "moc_enginemixer.cpp"
@@ -34,6 +39,19 @@ const QString kLegacyGroup = QStringLiteral("[Master]");
 const QString kMainGroup = QStringLiteral("[Main]");
 
 const ConfigKey kInternalClockBpmKey{QStringLiteral("[InternalClock]"), QStringLiteral("bpm")};
+
+// Number of helper threads for processing channels in parallel. 0 disables
+// parallel channel processing.
+const ConfigKey kEngineHelperThreadsKey{kAppGroup, QStringLiteral("engine_helper_threads")};
+// Upper bound, more threads do not pay off with the number of decks and
+// samplers typically playing at the same time.
+constexpr int kMaxEngineHelperThreads = 7;
+
+struct ParallelChannelContext {
+    EngineMixer* pEngineMixer;
+    EngineMixer::ChannelInfo* const* ppChannelInfos;
+    std::size_t bufferSize;
+};
 } // namespace
 
 EngineMixer::EngineMixer(UserSettingsPointer pConfig,
@@ -61,6 +79,14 @@ EngineMixer::EngineMixer(UserSettingsPointer pConfig,
           m_talkoverHeadphones(kMaxEngineSamples),
           m_sidechainMix(kMaxEngineSamples),
           m_pWorkerScheduler(make_parented<EngineWorkerScheduler>(this)),
+          m_profilerProbes{
+                  EngineProfiler::registerProbe(QStringLiteral("EngineMixer::process")),
+                  EngineProfiler::registerProbe(QStringLiteral("Headphone mix")),
+                  EngineProfiler::registerProbe(QStringLiteral("Talkover mix")),
+                  EngineProfiler::registerProbe(QStringLiteral("Crossfader bus mix")),
+                  EngineProfiler::registerProbe(QStringLiteral("Main effects")),
+                  EngineProfiler::registerProbe(QStringLiteral("Main VU meter")),
+                  EngineProfiler::registerProbe(QStringLiteral("Sidechain"))},
           m_pEngineSync(std::make_unique<EngineSync>(pConfig)),
           m_pMainGain(std::make_unique<ControlAudioTaperPot>(
                   ConfigKey(group, "gain"), -14, 14, 0.5)),
@@ -164,6 +190,18 @@ EngineMixer::EngineMixer(UserSettingsPointer pConfig,
     m_bExternalRecordBroadcastInputConnected = false;
     m_pWorkerScheduler->start(QThread::HighPriority);
 
+    if (m_pEngineSideChain) {
+        // Feeds the encoders shared by broadcast connections and the
+        // recording before EngineRecord is added
+        m_pEngineSideChain->addSideChainWorker(new SharedEncoderStage());
+    }
+
+    const int engineHelperThreads = numChannelHelperThreads(pConfig);
+    if (engineHelperThreads > 0) {
+        m_pChannelThreadPool = std::make_unique<EngineThreadPool>(
+                QStringLiteral("EngineHelper"), engineHelperThreads);
+    }
+
     m_pSampleRate->addAlias(ConfigKey(group, QStringLiteral("samplerate")));
     m_pSampleRate->set(44100.);
 
@@ -214,6 +252,16 @@ EngineMixer::EngineMixer(UserSettingsPointer pConfig,
 
 EngineMixer::~EngineMixer() = default;
 
+// static
+int EngineMixer::numChannelHelperThreads(const UserSettingsPointer& pConfig) {
+    if (!pConfig) {
+        return 0;
+    }
+    return std::max(0,
+            std::min(pConfig->getValue(kEngineHelperThreadsKey, 0),
+                    std::min(kMaxEngineHelperThreads, QThread::idealThreadCount() - 1)));
+}
+
 std::span<const CSAMPLE> EngineMixer::getMainBuffer() const {
     return m_main.span();
 }
@@ -319,17 +367,44 @@ void EngineMixer::processChannels(std::size_t bufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex; i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        auto& pChannel = pChannelInfo->m_pChannel;
-        DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= static_cast<SINT>(bufferSize));
-        pChannel->process(pChannelInfo->m_pBuffer.data(), bufferSize);
-
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
-            GroupFeatureState features;
-            pChannel->collectFeatures(&features);
-            pChannelInfo->m_features = features;
+    // The sync leader must be done before any follower is processed.
+    int parallelStartIndex = activeChannelsStartIndex;
+    if (activeChannelsStartIndex == 0) {
+        processChannel(m_activeChannels[0], bufferSize);
+        parallelStartIndex = 1;
+    }
+    if (m_pChannelThreadPool) {
+        // EngineSync is not thread-safe and sync followers notify each other.
+        // They are processed on the engine thread right after the leader.
+        for (int i = parallelStartIndex; i < m_activeChannels.size(); ++i) {
+            EngineBuffer* pBuffer = m_activeChannels[i]->m_pChannel->getEngineBuffer();
+            if (pBuffer && pBuffer->isSyncParticipant()) {
+                processChannel(m_activeChannels[i], bufferSize);
+                std::swap(m_activeChannels[i], m_activeChannels[parallelStartIndex]);
+                ++parallelStartIndex;
+            }
+        }
+    }
+    const int parallelCount = m_activeChannels.size() - parallelStartIndex;
+    if (m_pChannelThreadPool && parallelCount > 1) {
+        // The remaining channels do not depend on each other. Sync requests
+        // that are queued in the meantime are processed in the next callback.
+        setSyncRequestsDeferred(parallelStartIndex, true);
+        ParallelChannelContext context{
+                this, m_activeChannels.constData() + parallelStartIndex, bufferSize};
+        m_pChannelThreadPool->run(
+                [](void* pContext, int jobIndex) {
+                    auto* pParallelContext = static_cast<ParallelChannelContext*>(pContext);
+                    pParallelContext->pEngineMixer->processChannel(
+                            pParallelContext->ppChannelInfos[jobIndex],
+                            pParallelContext->bufferSize);
+                },
+                &context,
+                parallelCount);
+        setSyncRequestsDeferred(parallelStartIndex, false);
+    } else {
+        for (int i = parallelStartIndex; i < m_activeChannels.size(); ++i) {
+            processChannel(m_activeChannels[i], bufferSize);
         }
     }
     // Do internal sync lock post-processing before the other
@@ -358,6 +433,29 @@ void EngineMixer::processChannels(std::size_t bufferSize) {
             });
 }
 
+void EngineMixer::setSyncRequestsDeferred(int startIndex, bool deferred) {
+    for (int i = startIndex; i < m_activeChannels.size(); ++i) {
+        EngineBuffer* pBuffer = m_activeChannels[i]->m_pChannel->getEngineBuffer();
+        if (pBuffer) {
+            pBuffer->setSyncRequestsDeferred(deferred);
+        }
+    }
+}
+
+void EngineMixer::processChannel(ChannelInfo* pChannelInfo, std::size_t bufferSize) {
+    ScopedEngineProbe probe(pChannelInfo->m_profilerProbe);
+    auto& pChannel = pChannelInfo->m_pChannel;
+    DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= static_cast<SINT>(bufferSize));
+    pChannel->process(pChannelInfo->m_pBuffer.data(), bufferSize);
+
+    // Collect metadata for effects
+    if (m_pEngineEffectsManager) {
+        GroupFeatureState features;
+        pChannel->collectFeatures(&features);
+        pChannelInfo->m_features = features;
+    }
+}
+
 void EngineMixer::process(const std::size_t bufferSize) {
     DEBUG_ASSERT(bufferSize <= static_cast<int>(kMaxEngineSamples));
 
@@ -367,6 +465,8 @@ void EngineMixer::process(const std::size_t bufferSize) {
         haveSetName = true;
     }
     // Trace t("EngineMixer::process");
+    ScopedEngineProbe processProbe(m_profilerProbes.process);
+    ControlNotifier::ScopedEngineThread engineThread;
 
     bool mainEnabled = m_pMainEnabled->toBool();
     bool boothEnabled = m_pBoothEnabled->toBool();
@@ -400,6 +500,7 @@ void EngineMixer::process(const std::size_t bufferSize) {
     m_headphoneGain.setGain(pflMixGainInHeadphones);
 
     if (headphoneEnabled) {
+        ScopedEngineProbe probe(m_profilerProbes.headphoneMix);
         // Process effects and mix PFL channels together for the headphones.
         // Effects will be reprocessed post-fader for the crossfader buses
         // and main mix, so the channel input buffers cannot be modified here.
@@ -437,15 +538,18 @@ void EngineMixer::process(const std::size_t bufferSize) {
 
     // Mix all the talkover enabled channels together.
     // Effects processing is done in place to avoid unnecessary buffer copying.
-    ChannelMixer::applyEffectsInPlaceAndMixChannels(
-            m_talkoverGain,
-            m_activeTalkoverChannels,
-            &m_channelTalkoverGainCache,
-            m_talkover.data(),
-            m_mainHandle.handle(),
-            bufferSize,
-            m_sampleRate,
-            m_pEngineEffectsManager);
+    {
+        ScopedEngineProbe probe(m_profilerProbes.talkoverMix);
+        ChannelMixer::applyEffectsInPlaceAndMixChannels(
+                m_talkoverGain,
+                m_activeTalkoverChannels,
+                &m_channelTalkoverGainCache,
+                m_talkover.data(),
+                m_mainHandle.handle(),
+                bufferSize,
+                m_sampleRate,
+                m_pEngineEffectsManager);
+    }
 
     // Process effects on all microphones mixed together
     // We have no metadata for mixed effect buses, so use an empty GroupFeatureState.
@@ -492,6 +596,7 @@ void EngineMixer::process(const std::size_t bufferSize) {
     m_mainGain.setGains(crossfaderLeftGain, 1.0f, crossfaderRightGain);
 
     for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+        ScopedEngineProbe probe(m_profilerProbes.busMix);
         ChannelMixer::applyEffectsInPlaceAndMixChannels(m_mainGain,
                 m_activeBusChannels[o],
                 &m_channelMainGainCache, // no [o] because the old gain
@@ -726,6 +831,7 @@ void EngineMixer::process(const std::size_t bufferSize) {
         // EngineSideChain::receiveBuffer has copied the input buffer to m_pSidechainMix
         // via before (called by SoundManager::pushInputBuffers())
         if (m_pEngineSideChain) {
+            ScopedEngineProbe probe(m_profilerProbes.sidechain);
             m_pEngineSideChain->writeSamples(m_sidechainMix.data(), iFrames);
         }
 
@@ -767,6 +873,7 @@ void EngineMixer::process(const std::size_t bufferSize) {
         // Update VU meter (it does not return anything). Needs to be here so that
         // main balance and talkover is reflected in the VU meter.
         if (m_pVumeter != nullptr) {
+            ScopedEngineProbe probe(m_profilerProbes.vuMeter);
             m_pVumeter->process(m_main.data(), bufferSize);
         }
     }
@@ -795,6 +902,7 @@ void EngineMixer::process(const std::size_t bufferSize) {
 void EngineMixer::applyMainEffects(std::size_t bufferSize) {
     // Apply main effects
     if (m_pEngineEffectsManager) {
+        ScopedEngineProbe probe(m_profilerProbes.mainEffects);
         GroupFeatureState mainFeatures;
         mainFeatures.gain = m_pMainGain->get();
         m_pEngineEffectsManager->processPostFaderInPlace(m_mainHandle.handle(),
@@ -851,6 +959,8 @@ void EngineMixer::addChannel(std::unique_ptr<EngineChannel> pChannel) {
     // take ownership of the pointer explicitly
     pChannelInfo->m_pChannel = std::move(pChannel);
     pChannelInfo->m_handle = m_pChannelHandleFactory->getOrCreateHandle(group);
+    pChannelInfo->m_profilerProbe = EngineProfiler::registerProbe(
+            QStringLiteral("Channel %1").arg(group));
     pChannelInfo->m_pVolumeControl = std::make_unique<ControlAudioTaperPot>(
             ConfigKey(group, "volume"), -20, 0, 1);
     pChannelInfo->m_pVolumeControl->setDefaultValue(1.0);
@@ -13,6 +13,7 @@
 #include "engine/channels/enginechannel.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/engineobject.h"
+#include "engine/engineprofiler.h"
 #include "preferences/usersettings.h"
 #include "recording/recordingmanager.h"
 #include "soundio/soundmanager.h"
@@ -31,6 +32,7 @@ class EngineEffectsManager;
 class EngineSync;
 class EngineTalkoverDucking;
 class EngineDelay;
+class EngineThreadPool;
 
 // The number of channels to pre-allocate in various structures in the
 // engine. Prevents memory allocation in EngineMixer::addChannel.
@@ -46,6 +48,11 @@ class EngineMixer : public QObject, public AudioSource {
             bool bEnableSidechain);
     ~EngineMixer() override;
 
+    // The number of helper threads for processing channels in parallel as
+    // configured and limited by the available cores. They are pinned to the
+    // cores starting at CPU 1.
+    static int numChannelHelperThreads(const UserSettingsPointer& pConfig);
+
     // Get access to the sample buffers. None of these are thread safe. Only to
     // be called by SoundManager.
     std::span<const CSAMPLE> buffer(const AudioOutput& output) const override;
@@ -125,6 +132,7 @@ class EngineMixer : public QObject, public AudioSource {
         std::unique_ptr<ControlPushButton> m_pMuteControl{nullptr};
         GroupFeatureState m_features{};
         int m_index;
+        int m_profilerProbe{EngineProfiler::kInvalidProbe};
     };
 
     struct GainCache {
@@ -252,6 +260,10 @@ class EngineMixer : public QObject, public AudioSource {
     std::unique_ptr<ControlObject> m_pHeadphoneEnabled;
     std::unique_ptr<ControlObject> m_pBoothEnabled;
 
+    // Helper threads for processing channels in parallel. Only created if
+    // enabled in the preferences. Protected so tests can create it.
+    std::unique_ptr<EngineThreadPool> m_pChannelThreadPool;
+
   private:
     // Processes active channels. The sync lock channel (if any) is processed
     // first and all others are processed after. Populates m_activeChannels,
@@ -259,6 +271,11 @@ class EngineMixer : public QObject, public AudioSource {
     // m_activeTalkoverChannels with each channel that is active for the
     // respective output.
     void processChannels(std::size_t bufferSize);
+    // Processes a single channel and collects its features for effects.
+    // May be called concurrently for different channels.
+    void processChannel(ChannelInfo* pChannelInfo, std::size_t bufferSize);
+    // Defers the sync requests of the active channels from startIndex on.
+    void setSyncRequestsDeferred(int startIndex, bool deferred);
 
     ChannelHandleFactoryPointer m_pChannelHandleFactory;
     void applyMainEffects(std::size_t bufferSize);
@@ -296,6 +313,18 @@ class EngineMixer : public QObject, public AudioSource {
     mixxx::SampleBuffer m_sidechainMix;
 
     parented_ptr<EngineWorkerScheduler> m_pWorkerScheduler;
+
+    // Probes of EngineProfiler for the stages of process()
+    struct ProfilerProbes {
+        int process;
+        int headphoneMix;
+        int talkoverMix;
+        int busMix;
+        int mainEffects;
+        int vuMeter;
+        int sidechain;
+    };
+    const ProfilerProbes m_profilerProbes;
     std::unique_ptr<EngineSync> m_pEngineSync;
 
     std::unique_ptr<ControlObject> m_pMainGain;
@@ -0,0 +1,330 @@
+#include "engine/engineprofiler.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QStringList>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <memory>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+#include "util/math.h"
+
+namespace {
+
+const mixxx::Logger kLogger("EngineProfiler");
+
+// Events that are this close to being overwritten by a concurrently
+// recording thread are skipped when exporting them.
+constexpr quint64 kTraceEventsGuard = 64;
+
+struct ProbeHistogram {
+    std::atomic<quint64> count{0};
+    std::atomic<quint64> sumCycles{0};
+    std::atomic<quint64> maxCycles{0};
+    std::array<std::atomic<quint32>, EngineProfiler::kHistogramBuckets> buckets{};
+};
+
+struct TraceEvent {
+    std::atomic<quint64> startCycles{0};
+    std::atomic<quint64> durationCycles{0};
+    std::atomic<int> probe{EngineProfiler::kInvalidProbe};
+};
+
+// Only written by the thread that owns it. The slot of a finished thread
+// is reused by the next thread and keeps accumulating its statistics.
+struct ThreadSlot {
+    std::array<ProbeHistogram, EngineProfiler::kMaxProbes> histograms;
+    std::array<TraceEvent, EngineProfiler::kTraceEventsPerThread> events;
+    std::atomic<quint64> numEvents{0};
+    std::atomic<bool> owned{false};
+};
+
+struct ProfilerState {
+    ProfilerState()
+            : threadSlots(std::make_unique<ThreadSlot[]>(EngineProfiler::kMaxThreads)),
+              startCycles(EngineProfiler::cycles()),
+              startTime(std::chrono::steady_clock::now()) {
+    }
+
+    QMutex mutex;
+    // Guarded by mutex, only appended
+    QStringList probeNames;
+    // The number of slots that have ever been owned
+    std::atomic<int> numThreads{0};
+    std::atomic<bool> outOfThreadSlotsLogged{false};
+    const std::unique_ptr<ThreadSlot[]> threadSlots;
+    const quint64 startCycles;
+    const std::chrono::steady_clock::time_point startTime;
+};
+
+// Allocated on first use, i.e. when the first probe is registered
+ProfilerState& state() {
+    static ProfilerState s_state;
+    return s_state;
+}
+
+// Owns a slot for the lifetime of the thread
+class ThreadSlotOwner final {
+  public:
+    static constexpr int kNoSlot = -1;
+    static constexpr int kUnclaimed = -2;
+
+    ~ThreadSlotOwner() {
+        if (m_threadSlot >= 0) {
+            state().threadSlots[m_threadSlot].owned.store(false, std::memory_order_release);
+        }
+    }
+
+    int threadSlot() {
+        if (m_threadSlot == kUnclaimed) {
+            // Once per thread
+            m_threadSlot = claimThreadSlot();
+        }
+        return m_threadSlot;
+    }
+
+  private:
+    static int claimThreadSlot() {
+        ProfilerState& s = state();
+        for (int threadSlot = 0; threadSlot < EngineProfiler::kMaxThreads; ++threadSlot) {
+            bool owned = false;
+            if (s.threadSlots[threadSlot].owned.compare_exchange_strong(
+                        owned, true, std::memory_order_acq_rel)) {
+                int numThreads = s.numThreads.load(std::memory_order_relaxed);
+                while (numThreads <= threadSlot &&
+                        !s.numThreads.compare_exchange_weak(numThreads,
+                                threadSlot + 1,
+                                std::memory_order_acq_rel)) {
+                }
+                return threadSlot;
+            }
+        }
+        if (!s.outOfThreadSlotsLogged.exchange(true, std::memory_order_relaxed)) {
+            // Only logged once, not for every record()
+            kLogger.warning() << "All" << EngineProfiler::kMaxThreads
+                              << "thread slots are in use, not profiling"
+                                 " additional threads";
+        }
+        return kNoSlot;
+    }
+
+    int m_threadSlot = kUnclaimed;
+};
+
+thread_local ThreadSlotOwner t_threadSlotOwner;
+
+// The values are only modified by a single thread. There is no need
+// for an atomic read-modify-write that would lock the memory bus.
+template<typename T>
+inline void addRelaxed(std::atomic<T>* pValue, T delta) {
+    pValue->store(pValue->load(std::memory_order_relaxed) + delta,
+            std::memory_order_relaxed);
+}
+
+int activeThreadSlots(const ProfilerState& s) {
+    return math_min(s.numThreads.load(std::memory_order_acquire),
+            EngineProfiler::kMaxThreads);
+}
+
+} // anonymous namespace
+
+// static
+int EngineProfiler::registerProbe(const QString& name) {
+    ProfilerState& s = state();
+    const auto locker = lockMutex(&s.mutex);
+    const int existingProbe = s.probeNames.indexOf(name);
+    if (existingProbe >= 0) {
+        return existingProbe;
+    }
+    if (s.probeNames.size() >= kMaxProbes) {
+        kLogger.warning() << "Too many probes, not profiling" << name;
+        return kInvalidProbe;
+    }
+    s.probeNames.append(name);
+    return static_cast<int>(s.probeNames.size()) - 1;
+}
+
+// static
+void EngineProfiler::record(int probe, quint64 startCycles, quint64 endCycles) {
+    if (probe == kInvalidProbe) {
+        return;
+    }
+    DEBUG_ASSERT(probe >= 0 && probe < kMaxProbes);
+    ProfilerState& s = state();
+    const int threadSlot = t_threadSlotOwner.threadSlot();
+    if (threadSlot < 0) {
+        return;
+    }
+    ThreadSlot& slot = s.threadSlots[threadSlot];
+    // The time stamp counter might differ slightly between cores
+    const quint64 duration = endCycles > startCycles ? endCycles - startCycles : 0;
+
+    ProbeHistogram& histogram = slot.histograms[probe];
+    addRelaxed<quint64>(&histogram.count, 1);
+    addRelaxed(&histogram.sumCycles, duration);
+    if (duration > histogram.maxCycles.load(std::memory_order_relaxed)) {
+        histogram.maxCycles.store(duration, std::memory_order_relaxed);
+    }
+    const int bucket = math_min(static_cast<int>(std::bit_width(duration)),
+            kHistogramBuckets - 1);
+    addRelaxed<quint32>(&histogram.buckets[bucket], 1);
+
+    const quint64 eventIndex = slot.numEvents.load(std::memory_order_relaxed);
+    TraceEvent& event = slot.events[eventIndex % kTraceEventsPerThread];
+    event.startCycles.store(startCycles, std::memory_order_relaxed);
+    event.durationCycles.store(duration, std::memory_order_relaxed);
+    event.probe.store(probe, std::memory_order_relaxed);
+    slot.numEvents.store(eventIndex + 1, std::memory_order_release);
+}
+
+// static
+double EngineProfiler::cyclesPerMicro() {
+    const ProfilerState& s = state();
+    const auto elapsedMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - s.startTime)
+                                       .count();
+    if (elapsedMicros <= 0) {
+        return 1;
+    }
+    return static_cast<double>(cycles() - s.startCycles) / elapsedMicros;
+}
+
+// static
+QList<EngineProfiler::ProbeStats> EngineProfiler::stats() {
+    ProfilerState& s = state();
+    QStringList probeNames;
+    {
+        const auto locker = lockMutex(&s.mutex);
+        probeNames = s.probeNames;
+    }
+    const double microsPerCycle = 1 / cyclesPerMicro();
+    const int numThreadSlots = activeThreadSlots(s);
+
+    QList<ProbeStats> result;
+    result.reserve(probeNames.size());
+    for (int probe = 0; probe < probeNames.size(); ++probe) {
+        ProbeStats probeStats;
+        probeStats.name = probeNames[probe];
+        quint64 sumCycles = 0;
+        quint64 maxCycles = 0;
+        for (int threadSlot = 0; threadSlot < numThreadSlots; ++threadSlot) {
+            const ProbeHistogram& histogram = s.threadSlots[threadSlot].histograms[probe];
+            probeStats.count += histogram.count.load(std::memory_order_relaxed);
+            sumCycles += histogram.sumCycles.load(std::memory_order_relaxed);
+            maxCycles = math_max(maxCycles, histogram.maxCycles.load(std::memory_order_relaxed));
+            for (int bucket = 0; bucket < kHistogramBuckets; ++bucket) {
+                probeStats.histogram[bucket] +=
+                        histogram.buckets[bucket].load(std::memory_order_relaxed);
+            }
+        }
+        if (probeStats.count > 0) {
+            probeStats.meanMicros = sumCycles * microsPerCycle / probeStats.count;
+            probeStats.maxMicros = maxCycles * microsPerCycle;
+            quint64 countBelow = 0;
+            for (int bucket = 0; bucket < kHistogramBuckets; ++bucket) {
+                countBelow += probeStats.histogram[bucket];
+                if (countBelow * 100 >= probeStats.count * 99) {
+                    // The upper bound of the bucket
+                    probeStats.p99Micros = static_cast<double>(1ull << bucket) * microsPerCycle;
+                    break;
+                }
+            }
+        }
+        result.append(probeStats);
+    }
+    return result;
+}
+
+// static
+void EngineProfiler::reset() {
+    ProfilerState& s = state();
+    const int numThreadSlots = activeThreadSlots(s);
+    for (int threadSlot = 0; threadSlot < numThreadSlots; ++threadSlot) {
+        ThreadSlot& slot = s.threadSlots[threadSlot];
+        for (auto& histogram : slot.histograms) {
+            histogram.count.store(0, std::memory_order_relaxed);
+            histogram.sumCycles.store(0, std::memory_order_relaxed);
+            histogram.maxCycles.store(0, std::memory_order_relaxed);
+            for (auto& bucket : histogram.buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+        for (auto& event : slot.events) {
+            event.probe.store(kInvalidProbe, std::memory_order_relaxed);
+        }
+    }
+}
+
+// static
+bool EngineProfiler::writeChromeTrace(const QString& fileName) {
+    ProfilerState& s = state();
+    QStringList probeNames;
+    {
+        const auto locker = lockMutex(&s.mutex);
+        probeNames = s.probeNames;
+    }
+    const double microsPerCycle = 1 / cyclesPerMicro();
+    const int numThreadSlots = activeThreadSlots(s);
+
+    QJsonArray traceEvents;
+    for (int threadSlot = 0; threadSlot < numThreadSlots; ++threadSlot) {
+        traceEvents.append(QJsonObject{
+                {QStringLiteral("name"), QStringLiteral("thread_name")},
+                {QStringLiteral("ph"), QStringLiteral("M")},
+                {QStringLiteral("pid"), 1},
+                {QStringLiteral("tid"), threadSlot},
+                {QStringLiteral("args"),
+                        QJsonObject{{QStringLiteral("name"),
+                                QStringLiteral("Engine thread %1").arg(threadSlot)}}},
+        });
+
+        const ThreadSlot& slot = s.threadSlots[threadSlot];
+        const quint64 numEvents = slot.numEvents.load(std::memory_order_acquire);
+        const quint64 numAvailableEvents = kTraceEventsPerThread - kTraceEventsGuard;
+        const quint64 firstEvent =
+                numEvents > numAvailableEvents ? numEvents - numAvailableEvents : 0;
+        for (quint64 eventIndex = firstEvent; eventIndex < numEvents; ++eventIndex) {
+            const TraceEvent& event = slot.events[eventIndex % kTraceEventsPerThread];
+            const int probe = event.probe.load(std::memory_order_relaxed);
+            if (probe < 0 || probe >= probeNames.size()) {
+                continue;
+            }
+            const quint64 startCycles = event.startCycles.load(std::memory_order_relaxed);
+            if (startCycles < s.startCycles) {
+                continue;
+            }
+            traceEvents.append(QJsonObject{
+                    {QStringLiteral("name"), probeNames[probe]},
+                    {QStringLiteral("ph"), QStringLiteral("X")},
+                    {QStringLiteral("pid"), 1},
+                    {QStringLiteral("tid"), threadSlot},
+                    {QStringLiteral("ts"), (startCycles - s.startCycles) * microsPerCycle},
+                    {QStringLiteral("dur"),
+                            event.durationCycles.load(std::memory_order_relaxed) *
+                                    microsPerCycle},
+            });
+        }
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        kLogger.warning() << "Failed to open" << fileName << file.errorString();
+        return false;
+    }
+    const QJsonObject trace{
+            {QStringLiteral("traceEvents"), traceEvents},
+            {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")},
+    };
+    if (file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) < 0) {
+        kLogger.warning() << "Failed to write" << fileName << file.errorString();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <array>
+
+#include "util/types.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+/// Always-on profiler for the stages of the audio callback.
+///
+/// Stages are identified by probes that are registered by name from a
+/// non-realtime thread, usually when the object that processes the stage
+/// is created. The engine threads record the cycles that each stage took
+/// with ScopedEngineProbe. Recording neither allocates nor locks: Every
+/// thread owns a preallocated slot with a histogram per probe and a ring
+/// buffer with the most recent events, which are only written by this
+/// thread. The slot is released when the thread finishes and reused by
+/// the next one. Threads that find no free slot are not profiled. Other threads read them without synchronization and might see
+/// slightly inconsistent values, which is acceptable for statistics.
+///
+/// Nested probes record inclusive durations, e.g. the mix of the main
+/// bus includes the effect chains that are processed while mixing.
+class EngineProfiler {
+  public:
+    static constexpr int kInvalidProbe = -1;
+    static constexpr int kMaxProbes = 128;
+    static constexpr int kMaxThreads = 16;
+    /// Bucket i counts all durations with bit width i, i.e. durations
+    /// in [2^(i-1), 2^i) cycles.
+    static constexpr int kHistogramBuckets = 40;
+    /// The number of most recent events per thread that are available
+    /// for writeChromeTrace().
+    static constexpr int kTraceEventsPerThread = 2048;
+
+    /// Registers a probe and returns its id. Probes with the same name are
+    /// shared. Returns kInvalidProbe if the maximum number of probes has
+    /// been reached. Must not be called from a realtime thread.
+    static int registerProbe(const QString& name);
+
+    /// A timestamp with the highest resolution that is available, i.e. the
+    /// time stamp counter of the CPU. Not necessarily a multiple of time.
+    static quint64 cycles() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+#endif
+    }
+
+    /// Records that the stage of the probe has been processed between
+    /// the two timestamps on the calling thread. Realtime safe.
+    static void record(int probe, quint64 startCycles, quint64 endCycles);
+
+    struct ProbeStats {
+        QString name;
+        quint64 count = 0;
+        double meanMicros = 0;
+        double maxMicros = 0;
+        /// The upper bound of the bucket that contains 99% of all durations
+        double p99Micros = 0;
+        std::array<quint64, kHistogramBuckets> histogram{};
+    };
+
+    /// Accumulates the histograms of all threads for every probe.
+    static QList<ProbeStats> stats();
+
+    /// Resets all histograms and events. Recording threads might keep
+    /// their last value if they are recording concurrently.
+    static void reset();
+
+    /// Writes the most recent events of all threads in the Trace Event
+    /// Format that is read by chrome://tracing and Perfetto.
+    static bool writeChromeTrace(const QString& fileName);
+
+    /// The number of cycles per microsecond, measured since the first
+    /// probe has been registered.
+    static double cyclesPerMicro();
+};
+
+/// Records the lifetime of the object for the probe.
+class ScopedEngineProbe final {
+  public:
+    explicit ScopedEngineProbe(int probe)
+            : m_probe(probe),
+              m_startCycles(EngineProfiler::cycles()) {
+    }
+    ~ScopedEngineProbe() {
+        EngineProfiler::record(m_probe, m_startCycles, EngineProfiler::cycles());
+    }
+
+  private:
+    const int m_probe;
+    const quint64 m_startCycles;
+};
@@ -0,0 +1,213 @@
+#include "engine/enginethreadpool.h"
+
+#include <QThread>
+#include <QtDebug>
+#include <algorithm>
+
+#ifdef __LINUX__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "control/controlnotifier.h"
+#include "util/assert.h"
+#include "util/denormalsarezero.h"
+
+namespace {
+
+// Number of polls of the join semaphore before the engine thread blocks.
+// Channel jobs take in the order of tens of microseconds, so in most callbacks
+// the helpers are done before the engine thread would fall asleep.
+constexpr int kJoinSpinCount = 2000;
+
+inline void cpuRelax() {
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+} // anonymous namespace
+
+class EngineThreadPool::HelperThread : public QThread {
+  public:
+    HelperThread(EngineThreadPool* pPool, const QString& name, int cpu)
+            : m_pPool(pPool),
+              m_cpu(cpu),
+              m_quit(false) {
+        setObjectName(name);
+    }
+
+    ~HelperThread() override {
+        m_quit.store(true);
+        m_semaWake.release();
+        wait();
+    }
+
+    void wake() {
+        m_semaWake.release();
+    }
+
+    void adoptSchedulingPolicy(int policy, int priority) {
+#ifdef __LINUX__
+        struct sched_param param = {};
+        param.sched_priority = priority;
+        const auto handle = reinterpret_cast<pthread_t>(m_nativeHandle.load());
+        if (pthread_setschedparam(handle, policy, &param) != 0) {
+            qWarning() << objectName() << "Failed to adopt the engine thread priority";
+        }
+#else
+        Q_UNUSED(policy);
+        Q_UNUSED(priority);
+#endif
+    }
+
+    Qt::HANDLE nativeHandle() const {
+        return m_nativeHandle.load();
+    }
+
+  protected:
+    void run() override {
+        m_nativeHandle.store(QThread::currentThreadId());
+#ifdef __LINUX__
+        if (m_cpu >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(m_cpu, &cpuset);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0) {
+                qWarning() << objectName() << "Failed to pin thread to CPU" << m_cpu;
+            }
+        }
+#endif
+        // The helpers run the same DSP code as the audio callback, so they
+        // need the same denormal handling, see SoundDevicePortAudio.
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+        _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+        _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+        const ControlNotifier::ScopedEngineThread engineThread;
+        while (true) {
+            m_semaWake.acquire();
+            if (m_quit.load()) {
+                break;
+            }
+            m_pPool->processJobs();
+            m_pPool->m_semaJoin.release();
+        }
+    }
+
+  private:
+    EngineThreadPool* const m_pPool;
+    const int m_cpu;
+    std::atomic<bool> m_quit;
+    std::atomic<Qt::HANDLE> m_nativeHandle{nullptr};
+    QSemaphore m_semaWake;
+};
+
+EngineThreadPool::EngineThreadPool(const QString& name, int numThreads, int firstCpu)
+        : m_job(nullptr),
+          m_pContext(nullptr),
+          m_jobCount(0),
+          m_nextJob(0),
+          m_schedulingPolicyAdopted(false),
+          m_busy(false) {
+    DEBUG_ASSERT(numThreads >= 0);
+    DEBUG_ASSERT(firstCpu >= 0);
+    const int numCpus = QThread::idealThreadCount();
+    m_threads.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        // By default CPU 0 is left to the audio callback and the OS. Only
+        // pin if there are enough cores for one helper each.
+        const int cpu = firstCpu + numThreads <= numCpus ? firstCpu + i : -1;
+        m_threads.push_back(std::make_unique<HelperThread>(
+                this, QStringLiteral("%1 %2").arg(name).arg(i + 1), cpu));
+        m_threads.back()->start(QThread::TimeCriticalPriority);
+    }
+    qDebug() << "EngineThreadPool" << name << "started" << numThreads << "helper threads";
+}
+
+EngineThreadPool::~EngineThreadPool() {
+    // The helpers are woken and joined by their destructors.
+    m_threads.clear();
+}
+
+void EngineThreadPool::adoptCallerSchedulingPolicy() {
+#ifdef __LINUX__
+    int policy = SCHED_OTHER;
+    struct sched_param param = {};
+    if (pthread_getschedparam(pthread_self(), &policy, &param) != 0) {
+        return;
+    }
+    if (policy != SCHED_FIFO && policy != SCHED_RR) {
+        // The caller is not a real-time thread, keep the QThread priority.
+        return;
+    }
+    for (const auto& pThread : m_threads) {
+        if (pThread->nativeHandle()) {
+            pThread->adoptSchedulingPolicy(policy, param.sched_priority);
+        }
+    }
+#endif
+}
+
+void EngineThreadPool::processJobs() {
+    int jobIndex = m_nextJob.fetch_add(1, std::memory_order_acq_rel);
+    while (jobIndex < m_jobCount) {
+        m_job(m_pContext, jobIndex);
+        jobIndex = m_nextJob.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+void EngineThreadPool::run(JobFunction job, void* pContext, int jobCount) {
+    DEBUG_ASSERT(job);
+    if (jobCount <= 0) {
+        return;
+    }
+    const int numHelpers = std::min(numThreads(), jobCount - 1);
+    if (numHelpers <= 0) {
+        for (int i = 0; i < jobCount; ++i) {
+            job(pContext, i);
+        }
+        return;
+    }
+
+    if (!m_schedulingPolicyAdopted) {
+        // Only done once, the syscalls are not real-time safe.
+        adoptCallerSchedulingPolicy();
+        m_schedulingPolicyAdopted = true;
+    }
+
+    m_job = job;
+    m_pContext = pContext;
+    m_jobCount = jobCount;
+    // The release semantics of the store, in combination with the semaphore,
+    // publishes the batch to the helpers.
+    m_nextJob.store(0, std::memory_order_release);
+    for (int i = 0; i < numHelpers; ++i) {
+        m_threads[i]->wake();
+    }
+
+    processJobs();
+
+    // Join: All woken helpers must have left processJobs() before the batch
+    // may be replaced or the context goes out of scope.
+    for (int i = 0; i < kJoinSpinCount; ++i) {
+        if (m_semaJoin.tryAcquire(numHelpers)) {
+            return;
+        }
+        cpuRelax();
+    }
+    m_semaJoin.acquire(numHelpers);
+}
+
+bool EngineThreadPool::tryRun(JobFunction job, void* pContext, int jobCount) {
+    // The acquire and release semantics pass the batch members and the
+    // scheduling policy flag on to the next thread that uses the pool.
+    if (m_busy.exchange(true, std::memory_order_acquire)) {
+        return false;
+    }
+    run(job, pContext, jobCount);
+    m_busy.store(false, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// EngineThreadPool is a fork/join helper for the audio callback. It owns a
+// fixed set of pre-spawned helper threads that sleep on a semaphore until the
+// engine thread hands them a batch of independent jobs. The engine thread
+// takes part in processing the batch and returns only after all jobs have
+// been completed.
+//
+// Nothing in run() allocates memory or takes a lock: jobs are distributed
+// through an atomic counter, helpers are woken by releasing their semaphore
+// and the engine thread spins for a short while before it blocks on the join
+// semaphore. The helpers adopt the scheduling policy and priority of the
+// thread that calls run() for the first time, so they are real-time threads
+// whenever the audio callback is one.
+class EngineThreadPool {
+  public:
+    /// A job is a plain function pointer plus an opaque context, so that
+    /// submitting a batch never needs to allocate a closure.
+    using JobFunction = void (*)(void* pContext, int jobIndex);
+
+    /// Spawns numThreads helper threads. The helpers are pinned to the
+    /// distinct cores starting at firstCpu if the platform allows it and
+    /// there are enough cores.
+    EngineThreadPool(const QString& name, int numThreads, int firstCpu = 1);
+    ~EngineThreadPool();
+
+    int numThreads() const {
+        return static_cast<int>(m_threads.size());
+    }
+
+    /// Runs job(pContext, i) for all i in [0, jobCount) and returns after
+    /// all of them have finished. Must only be called from one thread at a
+    /// time, usually the engine thread.
+    void run(JobFunction job, void* pContext, int jobCount);
+
+    /// Like run(), but may be called from multiple threads concurrently.
+    /// Returns false without running any job if the pool is busy with the
+    /// batch of another thread, which then needs to run the jobs itself.
+    bool tryRun(JobFunction job, void* pContext, int jobCount);
+
+  private:
+    class HelperThread;
+
+    // Executes jobs from the current batch until none are left.
+    void processJobs();
+    void adoptCallerSchedulingPolicy();
+
+    std::vector<std::unique_ptr<HelperThread>> m_threads;
+
+    // The current batch. Written by run() before the helpers are woken.
+    JobFunction m_job;
+    void* m_pContext;
+    int m_jobCount;
+    std::atomic<int> m_nextJob;
+
+    // Each woken helper releases this once when it is done with the batch.
+    QSemaphore m_semaJoin;
+
+    bool m_schedulingPolicyAdopted;
+
+    // Set while a batch submitted by tryRun() is in progress.
+    std::atomic<bool> m_busy;
+};
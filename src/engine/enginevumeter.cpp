@@ -29,6 +29,13 @@ EngineVuMeter::EngineVuMeter(const QString& group,
           m_peakIndicatorRight(
                   ConfigKey(group, QStringLiteral("peak_indicator_right"))),
           m_sampleRate(QStringLiteral("[App]"), QStringLiteral("samplerate")) {
+    // Set on every callback, but only displayed once per frame
+    m_vuMeter.enableCoalescedNotifications();
+    m_vuMeterLeft.enableCoalescedNotifications();
+    m_vuMeterRight.enableCoalescedNotifications();
+    m_peakIndicator.enableCoalescedNotifications();
+    m_peakIndicatorLeft.enableCoalescedNotifications();
+    m_peakIndicatorRight.enableCoalescedNotifications();
     if (createLegacyAliases) {
         const QString& aliasGroup = legacyGroup.isEmpty() ? group : legacyGroup;
         m_vuMeter.addAlias(ConfigKey(aliasGroup, QStringLiteral("VuMeter")));
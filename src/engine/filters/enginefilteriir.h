@@ -6,6 +6,14 @@
 #define MIXXX
 #include <fidlib.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENGINE_FILTER_IIR_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ENGINE_FILTER_IIR_NEON
+#include <arm_neon.h>
+#endif
+
 #include "engine/engine.h"
 #include "engine/engineobject.h"
 #include "util/sample.h"
@@ -32,6 +40,121 @@ class EngineFilterIIRBase : public EngineObjectConstIn {
     virtual void assumeSettled() = 0;
 };
 
+// The left and right sample that are filtered in the same step.
+// The recursion of an IIR filter can't be vectorized over time, but both
+// channels run through the same equations with the same coefficients.
+// Processing them in the two lanes of one SSE2/NEON register halves the
+// number of instructions for the whole cascade. Auto-vectorization is not
+// reliable for this pattern, so the lanes are explicit.
+class EngineFilterIIRStereoSample {
+  public:
+    EngineFilterIIRStereoSample() = default;
+    EngineFilterIIRStereoSample(double left, double right)
+#if defined(ENGINE_FILTER_IIR_SSE2)
+            : m_lanes(_mm_set_pd(right, left)) {
+#elif defined(ENGINE_FILTER_IIR_NEON)
+            : m_lanes(vsetq_lane_f64(right, vdupq_n_f64(left), 1)) {
+#else
+            : m_left(left),
+              m_right(right) {
+#endif
+    }
+
+    double left() const {
+#if defined(ENGINE_FILTER_IIR_SSE2)
+        return _mm_cvtsd_f64(m_lanes);
+#elif defined(ENGINE_FILTER_IIR_NEON)
+        return vgetq_lane_f64(m_lanes, 0);
+#else
+        return m_left;
+#endif
+    }
+
+    double right() const {
+#if defined(ENGINE_FILTER_IIR_SSE2)
+        return _mm_cvtsd_f64(_mm_unpackhi_pd(m_lanes, m_lanes));
+#elif defined(ENGINE_FILTER_IIR_NEON)
+        return vgetq_lane_f64(m_lanes, 1);
+#else
+        return m_right;
+#endif
+    }
+
+    friend EngineFilterIIRStereoSample operator+(
+            EngineFilterIIRStereoSample lhs, EngineFilterIIRStereoSample rhs) {
+#if defined(ENGINE_FILTER_IIR_SSE2)
+        return EngineFilterIIRStereoSample(_mm_add_pd(lhs.m_lanes, rhs.m_lanes));
+#elif defined(ENGINE_FILTER_IIR_NEON)
+        return EngineFilterIIRStereoSample(vaddq_f64(lhs.m_lanes, rhs.m_lanes));
+#else
+        return EngineFilterIIRStereoSample(lhs.m_left + rhs.m_left, lhs.m_right + rhs.m_right);
+#endif
+    }
+
+    friend EngineFilterIIRStereoSample operator-(
+            EngineFilterIIRStereoSample lhs, EngineFilterIIRStereoSample rhs) {
+#if defined(ENGINE_FILTER_IIR_SSE2)
+        return EngineFilterIIRStereoSample(_mm_sub_pd(lhs.m_lanes, rhs.m_lanes));
+#elif defined(ENGINE_FILTER_IIR_NEON)
+        return EngineFilterIIRStereoSample(vsubq_f64(lhs.m_lanes, rhs.m_lanes));
+#else
+        return EngineFilterIIRStereoSample(lhs.m_left - rhs.m_left, lhs.m_right - rhs.m_right);
+#endif
+    }
+
+    friend EngineFilterIIRStereoSample operator-(EngineFilterIIRStereoSample val) {
+#if defined(ENGINE_FILTER_IIR_SSE2)
+        // Flip the sign bits, like the scalar negation
+        return EngineFilterIIRStereoSample(_mm_xor_pd(val.m_lanes, _mm_set1_pd(-0.0)));
+#elif defined(ENGINE_FILTER_IIR_NEON)
+        return EngineFilterIIRStereoSample(vnegq_f64(val.m_lanes));
+#else
+        return EngineFilterIIRStereoSample(-val.m_left, -val.m_right);
+#endif
+    }
+
+    friend EngineFilterIIRStereoSample operator*(EngineFilterIIRStereoSample lhs, double rhs) {
+#if defined(ENGINE_FILTER_IIR_SSE2)
+        return EngineFilterIIRStereoSample(_mm_mul_pd(lhs.m_lanes, _mm_set1_pd(rhs)));
+#elif defined(ENGINE_FILTER_IIR_NEON)
+        return EngineFilterIIRStereoSample(vmulq_n_f64(lhs.m_lanes, rhs));
+#else
+        return EngineFilterIIRStereoSample(lhs.m_left * rhs, lhs.m_right * rhs);
+#endif
+    }
+
+    friend EngineFilterIIRStereoSample operator*(double lhs, EngineFilterIIRStereoSample rhs) {
+        return rhs * lhs;
+    }
+
+    friend EngineFilterIIRStereoSample& operator+=(
+            EngineFilterIIRStereoSample& lhs, EngineFilterIIRStereoSample rhs) {
+        lhs = lhs + rhs;
+        return lhs;
+    }
+
+    friend EngineFilterIIRStereoSample& operator-=(
+            EngineFilterIIRStereoSample& lhs, EngineFilterIIRStereoSample rhs) {
+        lhs = lhs - rhs;
+        return lhs;
+    }
+
+  private:
+#if defined(ENGINE_FILTER_IIR_SSE2)
+    explicit EngineFilterIIRStereoSample(__m128d lanes)
+            : m_lanes(lanes) {
+    }
+    __m128d m_lanes;
+#elif defined(ENGINE_FILTER_IIR_NEON)
+    explicit EngineFilterIIRStereoSample(float64x2_t lanes)
+            : m_lanes(lanes) {
+    }
+    float64x2_t m_lanes;
+#else
+    double m_left;
+    double m_right;
+#endif
+};
 
 // length of the 3rd argument to fid_design_coef
 #define FIDSPEC_LENGTH 40
@@ -85,11 +208,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 
     void initBuffers() {
         // Copy the current buffers into the old buffers
-        memcpy(m_oldBuf1, m_buf1, sizeof(m_buf1));
-        memcpy(m_oldBuf2, m_buf2, sizeof(m_buf2));
+        memcpy(m_oldBuf, m_buf, sizeof(m_buf));
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        memset(m_buf, 0, sizeof(m_buf));
         m_doRamping = true;
     }
 
@@ -106,6 +227,16 @@ class EngineFilterIIR : public EngineFilterIIRBase {
         // Copy to dynamic-ish memory to prevent fidlib API breakage.
         std::strncpy(spec_d, spec, bufsize);
 
+        DesignParams design{};
+        std::strncpy(design.spec1, spec, bufsize);
+        design.sampleRate = sampleRate;
+        design.freq01 = freq0;
+        design.freq11 = freq1;
+        design.adj1 = adj;
+        if (!updateDesign(design)) {
+            return;
+        }
+
         // Copy the old coefficients into m_oldCoef
         memcpy(m_oldCoef, m_coef, sizeof(m_coef));
 
@@ -168,6 +299,21 @@ class EngineFilterIIR : public EngineFilterIIRBase {
         spec1_d[FIDSPEC_LENGTH - 1] = '\0';
         spec2_d[FIDSPEC_LENGTH - 1] = '\0';
 
+        DesignParams design{};
+        std::strncpy(design.spec1, spec1, spec1size);
+        std::strncpy(design.spec2, spec2, spec2size);
+        design.sampleRate = sampleRate;
+        design.nCoef1 = n_coef1;
+        design.freq01 = freq01;
+        design.freq11 = freq11;
+        design.adj1 = adj1;
+        design.freq02 = freq02;
+        design.freq12 = freq12;
+        design.adj2 = adj2;
+        if (!updateDesign(design)) {
+            return;
+        }
+
         // Copy the old coefficients into m_oldCoef
         memcpy(m_oldCoef, m_coef, sizeof(m_coef));
         m_coef[0] = fid_design_coef(m_coef + 1,
@@ -239,8 +385,10 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     virtual void process(const CSAMPLE* pIn, CSAMPLE* pOutput, const std::size_t bufferSize) {
         if (!m_doRamping) {
             for (std::size_t i = 0; i < bufferSize; i += 2) {
-                pOutput[i] = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                pOutput[i + 1] = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                const EngineFilterIIRStereoSample out = processSample(
+                        m_coef, m_buf, EngineFilterIIRStereoSample(pIn[i], pIn[i + 1]));
+                pOutput[i] = static_cast<CSAMPLE>(out.left());
+                pOutput[i + 1] = static_cast<CSAMPLE>(out.right());
             }
         } else {
             double cross_mix = 0.0;
@@ -257,12 +405,14 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                 // of the new filter but it turns out that this produces
                 // a gain drop due to the filter delay which is more
                 // conspicuous than the settling noise.
+                const EngineFilterIIRStereoSample in(pIn[i], pIn[i + 1]);
                 double old1;
                 double old2;
                 if (!m_doStart) {
                     // Process old filter, but only if we do not do a fresh start
-                    old1 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf1, pIn[i]));
-                    old2 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf2, pIn[i + 1]));
+                    const EngineFilterIIRStereoSample old = processSample(m_oldCoef, m_oldBuf, in);
+                    old1 = static_cast<CSAMPLE>(old.left());
+                    old2 = static_cast<CSAMPLE>(old.right());
                 } else {
                     if (m_startFromDry) {
                         old1 = pIn[i];
@@ -272,8 +422,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                         old2 = 0;
                     }
                 }
-                double new1 = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                double new2 = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                const EngineFilterIIRStereoSample out = processSample(m_coef, m_buf, in);
+                double new1 = static_cast<CSAMPLE>(out.left());
+                double new2 = static_cast<CSAMPLE>(out.right());
 
                 if (i < bufferSize / 2) {
                     pOutput[i] = static_cast<CSAMPLE>(old1);
@@ -291,11 +442,42 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     }
 
   protected:
-    inline double processSample(double* coef, double* buf, double val);
+    // The parameters of the current design
+    struct DesignParams {
+        char spec1[FIDSPEC_LENGTH];
+        char spec2[FIDSPEC_LENGTH];
+        double sampleRate;
+        int nCoef1;
+        double freq01;
+        double freq11;
+        int adj1;
+        double freq02;
+        double freq12;
+        int adj2;
+
+        bool operator==(const DesignParams& other) const = default;
+    };
+
+    // Returns false if the filter already uses this design. Redesigning
+    // the same filter would not only parse the spec and calculate the
+    // coefficients again, but also restart the filter from zero state and
+    // crossfade from the old one. This happens for every knob movement
+    // that is quantized to the same filter, e.g. by
+    // setFrequencyCornersForIntDelay().
+    bool updateDesign(const DesignParams& design) {
+        if (design == m_design) {
+            return false;
+        }
+        m_design = design;
+        return true;
+    }
+
+    // T is either a single double or an EngineFilterIIRStereoSample
+    template<typename T>
+    inline T processSample(const double* coef, T* buf, T val);
     inline void pauseFilterInner() {
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        memset(m_buf, 0, sizeof(m_buf));
         m_doRamping = true;
         m_doStart = true;
     }
@@ -304,15 +486,12 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     // Old coefficients needed for ramping
     double m_oldCoef[SIZE + 1];
 
-    // Channel 1 state
-    double m_buf1[SIZE];
-    // Old channel 1 buffer needed for ramping
-    double m_oldBuf1[SIZE];
+    // State of both channels
+    EngineFilterIIRStereoSample m_buf[SIZE];
+    // Old buffer of both channels needed for ramping
+    EngineFilterIIRStereoSample m_oldBuf[SIZE];
 
-    // Channel 2 state
-    double m_buf2[SIZE];
-    // Old channel 2 buffer needed for ramping
-    double m_oldBuf2[SIZE];
+    DesignParams m_design{};
 
     // Flag set to true if ramping needs to be done
     bool m_doRamping;
@@ -323,10 +502,11 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 };
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_LP>::processSample(const double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -337,10 +517,11 @@ inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_BP>::processSample(const double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = -tmp;
@@ -351,10 +532,11 @@ inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_HP>::processSample(const double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -365,10 +547,11 @@ inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_LP>::processSample(const double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -384,10 +567,11 @@ inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_BP>::processSample(const double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -414,10 +598,11 @@ inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_HP>::processSample(const double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir= val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -433,10 +618,11 @@ inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_LP>::processSample(const double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -463,10 +649,11 @@ inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
-                                                         double* buf,
-                                                         double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<16, IIR_BP>::processSample(const double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     buf[7] = buf[8]; buf[8] = buf[9]; buf[9] = buf[10]; buf[10] = buf[11];
@@ -515,10 +702,11 @@ inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_HP>::processSample(const double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -546,10 +734,11 @@ inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
 
 // IIR_LP and IIR_HP use the same processSample routine
 template<>
-inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<5, IIR_BP>::processSample(const double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = coef[2] * tmp;
@@ -560,10 +749,11 @@ inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_LPMO>::processSample(const double* coef,
+        T* buf,
+        T val) {
+   T tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= tmp;
@@ -586,10 +776,11 @@ inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_HPMO>::processSample(const double* coef,
+        T* buf,
+        T val) {
+   T tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= -tmp;
@@ -611,10 +802,11 @@ inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_LP2>::processSample(const double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -632,10 +824,11 @@ inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_HP2>::processSample(const double* coef,
+        T* buf,
+        T val) {
+    T tmp, fir, iir;
     tmp = buf[0];
     iir = val * -coef[0]; // swap gain to be in phase with LP2
     iir -= coef[1] * tmp; fir = -tmp;
@@ -1,5 +1,8 @@
 #include "engine/readaheadmanager.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "audio/frame.h"
 #include "engine/cachingreader/cachingreader.h"
 #include "engine/controls/cuecontrol.h"
@@ -8,6 +11,14 @@
 #include "util/defs.h"
 #include "util/sample.h"
 
+namespace {
+
+constexpr SINT kMinChunkCountToCache = 2;
+// ~1.4 s at 48 kHz, 1/10 of the chunks of the cache
+constexpr SINT kMaxChunkCountToCache = 8;
+
+} // anonymous namespace
+
 ReadAheadManager::ReadAheadManager()
         : m_pLoopingControl(nullptr),
           m_pCueControl(nullptr),
@@ -288,8 +299,14 @@ void ReadAheadManager::hintReader(double dRate,
     Hint current_position;
 
     // SoundTouch can read up to 2 chunks ahead. Always keep 2 chunks ahead in
-    // cache.
-    SINT frameCountToCache = 2 * CachingReaderChunk::kFrames;
+    // cache. The chunks are consumed faster when playing or scratching faster,
+    // so proportionally more are requested in the direction of play. The
+    // worker reads adjacent chunks in one go.
+    const SINT chunkCountToCache = std::clamp(
+            static_cast<SINT>(std::ceil(std::abs(dRate) * kMinChunkCountToCache)),
+            kMinChunkCountToCache,
+            kMaxChunkCountToCache);
+    SINT frameCountToCache = chunkCountToCache * CachingReaderChunk::kFrames;
     current_position.frameCount = frameCountToCache;
 
     // this called after the precious chunk was consumed
@@ -62,10 +62,30 @@ int EngineRecord::updateFromPreferences() {
     if (m_pEncoder) {
         m_pEncoder.reset();
     }
+    m_pSharedEncoder.reset();
     Encoder::Format format = EncoderFactory::getFactory().getSelectedFormat(m_pConfig);
     m_encoding = format.internalName;
-    m_pEncoder = EncoderFactory::getFactory().createRecordingEncoder(
-            format, m_pConfig, this);
+    EncoderRecordingSettingsPointer pRecordingSettings =
+            EncoderFactory::getFactory().getEncoderRecordingSettings(format, m_pConfig);
+
+    // Reuse the encoder of a running broadcast with equal settings. The
+    // tags are written by the encoder into the stream, so only recordings
+    // without tags can share it. Mono recordings are downmixed before
+    // encoding.
+    if (m_baAuthor.isEmpty() && m_baTitle.isEmpty() && m_baAlbum.isEmpty() &&
+            !m_bTracklistAsCommentEnabled &&
+            pRecordingSettings->getChannelMode() ==
+                    EncoderSettings::ChannelMode::STEREO) {
+        m_pSharedEncoder = SharedEncoder::find(
+                SharedEncoder::keyFor(*pRecordingSettings, m_sampleRate));
+        if (m_pSharedEncoder) {
+            qDebug() << "Recording with the shared encoder of the broadcast";
+            return 0;
+        }
+    }
+
+    m_pEncoder = EncoderFactory::getFactory().createEncoder(
+            pRecordingSettings, this);
 
     QString userErrorMsg;
     int ret = -1;
@@ -237,8 +257,12 @@ void EngineRecord::process(const CSAMPLE* pBuffer, const std::size_t bufferSize)
         }
 
         // Compress audio. Encoder will call method 'write()' below to
-        // write a file stream and emit bytesRecorded.
-        m_pEncoder->encodeBuffer(bufferToEncode, encoderBufferSize);
+        // write a file stream and emit bytesRecorded. The shared encoder
+        // has already been fed by the SharedEncoderStage and passed its
+        // packets to receivePacket().
+        if (m_pEncoder) {
+            m_pEncoder->encodeBuffer(bufferToEncode, encoderBufferSize);
+        }
 
         if (metaDataHasChanged()) {
             // Writing cueLine before updating the time counter since we prefer to be ahead
@@ -249,7 +273,7 @@ void EngineRecord::process(const CSAMPLE* pBuffer, const std::size_t bufferSize)
                 m_cueFile.flush();
             }
 
-            if (m_pCurrentTrack && m_bTracklistAsCommentEnabled) {
+            if (m_pEncoder && m_pCurrentTrack && m_bTracklistAsCommentEnabled) {
                 m_pEncoder->updateMetaData(m_pCurrentTrack->getArtist(),
                         m_pCurrentTrack->getTitle(),
                         m_pCurrentTrack->getAlbum(),
@@ -327,6 +351,15 @@ void EngineRecord::write(const unsigned char *header, const unsigned char *body,
     emit bytesRecorded((headerLen+bodyLen));
 
 }
+void EngineRecord::receivePacket(const QByteArray& packet) {
+    // Called from the sidechain thread like process()
+    if (!fileOpen()) {
+        return;
+    }
+    m_dataStream.writeRawData(packet.constData(), packet.size());
+    emit bytesRecorded(packet.size());
+}
+
 // Encoder calls this method to write compressed audio
 int EngineRecord::tell() {
     if (!fileOpen()) {
@@ -355,7 +388,7 @@ bool EngineRecord::fileOpen() {
 
 bool EngineRecord::openFile() {
     // We can use a QFile to write compressed audio.
-    if (m_pEncoder) {
+    if (m_pEncoder || m_pSharedEncoder) {
         m_file.setFileName(m_fileName);
         if (!m_file.open(QIODevice::WriteOnly)) {
             qDebug() << "EngineRecord::openFile() failed for"
@@ -365,6 +398,9 @@ bool EngineRecord::openFile() {
         }
         if (m_file.handle() != -1) {
             m_dataStream.setDevice(&m_file);
+            if (m_pSharedEncoder) {
+                m_pSharedEncoder->attach(this);
+            }
         }
     } else {
         return false;
@@ -425,6 +461,10 @@ void EngineRecord::closeFile() {
             m_pEncoder->flush();
             m_pEncoder.reset();
         }
+        if (m_pSharedEncoder) {
+            m_pSharedEncoder->detach(this);
+            m_pSharedEncoder.reset();
+        }
         m_file.close();
     }
 }
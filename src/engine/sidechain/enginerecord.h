@@ -8,13 +8,17 @@
 #include "encoder/encoder.h"
 #include "encoder/encodercallback.h"
 #include "encoder/encodersettings.h"
+#include "engine/sidechain/sharedencoder.h"
 #include "engine/sidechain/sidechainworker.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
 
 class ControlProxy;
 
-class EngineRecord : public QObject, public EncoderCallback, public SideChainWorker {
+class EngineRecord : public QObject,
+                     public EncoderCallback,
+                     public SharedEncoder::Sink,
+                     public SideChainWorker {
     Q_OBJECT
   public:
     EngineRecord(UserSettingsPointer pConfig);
@@ -32,6 +36,9 @@ class EngineRecord : public QObject, public EncoderCallback, public SideChainWor
     // gets stream length
     int filelen()  override;
 
+    // writes the packets of a shared encoder to file
+    void receivePacket(const QByteArray& packet) override;
+
     // creates or opens an audio file
     bool openFile();
     // closes the audio file
@@ -63,6 +70,9 @@ class EngineRecord : public QObject, public EncoderCallback, public SideChainWor
 
     UserSettingsPointer m_pConfig;
     EncoderPointer m_pEncoder;
+    // The encoder of a broadcast connection with equal settings, used
+    // instead of m_pEncoder
+    std::shared_ptr<SharedEncoder> m_pSharedEncoder;
     QString m_encoding;
     QString m_fileName;
     QString m_baTitle;
@@ -0,0 +1,161 @@
+#include "engine/sidechain/sharedencoder.h"
+
+#include <QHash>
+#include <QVarLengthArray>
+#include <utility>
+
+#include "encoder/encodermp3settings.h"
+#include "recording/defs_recording.h"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SharedEncoder");
+
+QMutex s_registryMutex;
+// Encoders that may be shared, by key
+QHash<QString, std::weak_ptr<SharedEncoder>> s_registry;
+
+} // anonymous namespace
+
+// static
+QString SharedEncoder::keyFor(const EncoderSettings& settings,
+        mixxx::audio::SampleRate sampleRate) {
+    const QString format = settings.getFormat();
+    // Ogg Vorbis and Opus streams need the headers that are written
+    // when the encoder starts
+    if (format != ENCODING_MP3 &&
+            format != ENCODING_AAC &&
+            format != ENCODING_HEAAC &&
+            format != ENCODING_HEAACV2) {
+        return QString();
+    }
+    return QStringLiteral("%1 %2 %3 %4 %5")
+            .arg(format,
+                    QString::number(settings.getQuality()),
+                    QString::number(settings.getSelectedOption(
+                            EncoderMp3Settings::ENCODING_MODE_GROUP)),
+                    QString::number(static_cast<int>(settings.getChannelMode())),
+                    QString::number(sampleRate.value()));
+}
+
+// static
+std::shared_ptr<SharedEncoder> SharedEncoder::getOrCreate(
+        const QString& key,
+        const CreateEncoder& createEncoder,
+        mixxx::audio::SampleRate sampleRate,
+        QString* pUserErrorMessage) {
+    const auto locker = lockMutex(&s_registryMutex);
+    if (!key.isEmpty()) {
+        auto pSharedEncoder = s_registry.value(key).lock();
+        if (pSharedEncoder) {
+            kLogger.debug() << "Sharing encoder" << key;
+            return pSharedEncoder;
+        }
+    }
+
+    // The constructor is private
+    auto pSharedEncoder = std::shared_ptr<SharedEncoder>(new SharedEncoder());
+    pSharedEncoder->m_pEncoder = createEncoder(pSharedEncoder.get());
+    if (!pSharedEncoder->m_pEncoder ||
+            pSharedEncoder->m_pEncoder->initEncoder(sampleRate, pUserErrorMessage) < 0) {
+        // Not registered yet
+        return nullptr;
+    }
+    if (!key.isEmpty()) {
+        pSharedEncoder->m_key = key;
+        s_registry.insert(key, pSharedEncoder);
+    }
+    return pSharedEncoder;
+}
+
+// static
+std::shared_ptr<SharedEncoder> SharedEncoder::find(const QString& key) {
+    if (key.isEmpty()) {
+        return nullptr;
+    }
+    const auto locker = lockMutex(&s_registryMutex);
+    return s_registry.value(key).lock();
+}
+
+// static
+void SharedEncoder::encodeShared(const CSAMPLE* pBuffer, std::size_t bufferSize) {
+    QVarLengthArray<std::shared_ptr<SharedEncoder>, 4> encoders;
+    {
+        const auto locker = lockMutex(&s_registryMutex);
+        for (const auto& pWeakEncoder : std::as_const(s_registry)) {
+            auto pSharedEncoder = pWeakEncoder.lock();
+            if (pSharedEncoder && pSharedEncoder->sinkCount() > 0) {
+                encoders.append(std::move(pSharedEncoder));
+            }
+        }
+    }
+    // The registry must not be locked while encoding, the last reference
+    // to an encoder might be released meanwhile
+    for (const auto& pSharedEncoder : std::as_const(encoders)) {
+        const auto locker = lockMutex(&pSharedEncoder->m_encodeMutex);
+        pSharedEncoder->m_pEncoder->encodeBuffer(pBuffer, bufferSize);
+    }
+}
+
+SharedEncoder::~SharedEncoder() {
+    // The encoder may flush its remaining packets to write()
+    m_pEncoder.reset();
+    DEBUG_ASSERT(sinkCount() == 0);
+
+    if (m_key.isEmpty()) {
+        return;
+    }
+    const auto locker = lockMutex(&s_registryMutex);
+    // Another encoder might have already been created for the key
+    const auto it = s_registry.constFind(m_key);
+    if (it != s_registry.constEnd() && it->expired()) {
+        s_registry.erase(it);
+    }
+}
+
+void SharedEncoder::attach(Sink* pSink) {
+    const MMutexLocker locker(&m_sinksMutex);
+    DEBUG_ASSERT(!m_sinks.contains(pSink));
+    m_sinks.append(pSink);
+}
+
+void SharedEncoder::detach(Sink* pSink) {
+    const MMutexLocker locker(&m_sinksMutex);
+    m_sinks.removeOne(pSink);
+}
+
+int SharedEncoder::sinkCount() const {
+    const MMutexLocker locker(&m_sinksMutex);
+    return static_cast<int>(m_sinks.size());
+}
+
+void SharedEncoder::encodeBuffer(const CSAMPLE* pBuffer, std::size_t bufferSize) {
+    DEBUG_ASSERT(!isShared());
+    const auto locker = lockMutex(&m_encodeMutex);
+    m_pEncoder->encodeBuffer(pBuffer, bufferSize);
+}
+
+void SharedEncoder::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    // The only copy of the encoded data, the sinks share the packet
+    QByteArray packet;
+    packet.reserve(headerLen + bodyLen);
+    if (headerLen > 0) {
+        packet.append(reinterpret_cast<const char*>(header), headerLen);
+    }
+    if (bodyLen > 0) {
+        packet.append(reinterpret_cast<const char*>(body), bodyLen);
+    }
+    if (packet.isEmpty()) {
+        return;
+    }
+    const MMutexLocker locker(&m_sinksMutex);
+    for (Sink* pSink : std::as_const(m_sinks)) {
+        pSink->receivePacket(packet);
+    }
+}
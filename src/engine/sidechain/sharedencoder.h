@@ -0,0 +1,119 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <functional>
+#include <memory>
+
+#include "audio/types.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "encoder/encodersettings.h"
+#include "engine/sidechain/sidechainworker.h"
+#include "util/mutex.h"
+#include "util/types.h"
+
+/// Encodes the samples for several broadcast connections and the recording
+/// with the same encoder settings only once.
+///
+/// Every attached sink receives each encoded packet as an implicitly shared
+/// QByteArray, i.e. the packet is neither copied nor encoded again per
+/// sink. Shared encoders are fed by the SharedEncoderStage of the engine
+/// sidechain, so a sink that blocks while sending does not stall the others.
+/// An encoder that is not shared is fed by its only sink.
+///
+/// Sinks may be attached to a running encoder at any time, so encoders
+/// are only shared for formats that can be decoded without the headers
+/// at the start of the stream, i.e. MP3 and ADTS AAC.
+class SharedEncoder : public EncoderCallback {
+  public:
+    class Sink {
+      public:
+        virtual ~Sink() = default;
+        /// Called from the thread that feeds the encoder.
+        virtual void receivePacket(const QByteArray& packet) = 0;
+    };
+
+    typedef std::function<EncoderPointer(EncoderCallback* pCallback)> CreateEncoder;
+
+    /// Returns the key under which encoders with these settings are shared,
+    /// or an empty string if the format can't be shared.
+    static QString keyFor(const EncoderSettings& settings,
+            mixxx::audio::SampleRate sampleRate);
+
+    /// Returns the encoder that is already used for the key, or creates and
+    /// initializes a new one. An empty key never shares the encoder.
+    /// Returns nullptr if the encoder could not be initialized.
+    static std::shared_ptr<SharedEncoder> getOrCreate(
+            const QString& key,
+            const CreateEncoder& createEncoder,
+            mixxx::audio::SampleRate sampleRate,
+            QString* pUserErrorMessage);
+
+    /// Returns the encoder that is already used for the key, if any.
+    static std::shared_ptr<SharedEncoder> find(const QString& key);
+
+    /// Encodes the samples with all shared encoders that have sinks
+    /// attached. Called by SharedEncoderStage.
+    static void encodeShared(const CSAMPLE* pBuffer, std::size_t bufferSize);
+
+    ~SharedEncoder() override;
+
+    bool isShared() const {
+        return !m_key.isEmpty();
+    }
+
+    void attach(Sink* pSink);
+    void detach(Sink* pSink);
+
+    /// Encodes the samples and passes the encoded packets to all attached
+    /// sinks. Must only be called by the sink of an encoder that is not
+    /// shared, shared encoders are fed by encodeShared().
+    void encodeBuffer(const CSAMPLE* pBuffer, std::size_t bufferSize);
+
+    int sinkCount() const;
+
+    // EncoderCallback
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    // Streams are not seekable
+    int tell() override {
+        return -1;
+    }
+    void seek(int pos) override {
+        Q_UNUSED(pos);
+    }
+    int filelen() override {
+        return 0;
+    }
+
+  private:
+    SharedEncoder() = default;
+
+    // Empty if not shared
+    QString m_key;
+
+    // Serializes encoding and flushing the encoder
+    QMutex m_encodeMutex;
+
+    mutable MMutex m_sinksMutex;
+    QList<Sink*> m_sinks GUARDED_BY(m_sinksMutex);
+
+    EncoderPointer m_pEncoder;
+};
+
+/// The stage of the engine sidechain that feeds all shared encoders, before
+/// the recording and independent of the send loops of the broadcast
+/// connections.
+class SharedEncoderStage final : public SideChainWorker {
+  public:
+    void process(const CSAMPLE* pBuffer, const std::size_t bufferSize) override {
+        SharedEncoder::encodeShared(pBuffer, bufferSize);
+    }
+    void shutdown() override {
+    }
+};
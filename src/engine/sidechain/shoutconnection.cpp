@@ -24,6 +24,7 @@
 #include "recording/defs_recording.h"
 #include "track/track.h"
 #include "util/compatibility/qatomic.h"
+#include "util/compatibility/qmutex.h"
 #include "util/logger.h"
 
 namespace {
@@ -49,7 +50,8 @@ ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
           m_iShoutFailures(0),
           m_pConfig(pConfig),
           m_pProfile(profile),
-          m_encoder(nullptr),
+          m_pEncoder(nullptr),
+          m_pendingPacketsSize(0),
           m_mainSamplerate(QStringLiteral("[App]"), QStringLiteral("samplerate")),
           m_broadcastEnabled(BROADCAST_PREF_KEY, "enabled"),
           m_custom_metadata(false),
@@ -101,6 +103,8 @@ ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
 }
 
 ShoutConnection::~ShoutConnection() {
+    releaseEncoder();
+
     if (m_pShoutMetaData) {
         shout_metadata_free(m_pShoutMetaData);
     }
@@ -179,10 +183,9 @@ void ShoutConnection::updateFromPreferences() {
 
     setState(NETWORKSTREAMWORKER_STATE_BUSY);
 
-    // Delete m_encoder if it has been initialized (with maybe) different bitrate.
-    // delete m_encoder calls write() check if it will be exit early
+    // Release the encoder if it has been initialized (with maybe) different bitrate.
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    releaseEncoder();
 
     m_format_is_mp3 = false;
     m_format_is_ov = false;
@@ -446,24 +449,25 @@ void ShoutConnection::updateFromPreferences() {
         return;
     }
 
-    // Initialize m_encoder
+    // Initialize m_pEncoder
     EncoderSettingsPointer pBroadcastSettings =
             std::make_shared<EncoderBroadcastSettings>(m_pProfile);
-    m_encoder = EncoderFactory::getFactory().createEncoder(
-                    pBroadcastSettings, this);
+    // Connections with equal settings share the encoder, if listeners can
+    // start decoding the stream at any frame.
+    const QString sharedEncoderKey =
+            SharedEncoder::keyFor(*pBroadcastSettings, mainSamplerate);
 
     QString userErrorMsg;
-    int ret = -1;
-    if (m_encoder) {
-        ret = m_encoder->initEncoder(mainSamplerate, &userErrorMsg);
-    }
-
-    // TODO(XXX): Use mixxx::audio::SampleRate instead of int in initEncoder
-    if (ret < 0) {
-        // delete m_encoder calls write() make sure it will be exit early
-        DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-        m_encoder.reset();
-
+    m_pEncoder = SharedEncoder::getOrCreate(
+            sharedEncoderKey,
+            [&pBroadcastSettings](EncoderCallback* pCallback) {
+                return EncoderFactory::getFactory().createEncoder(
+                        pBroadcastSettings, pCallback);
+            },
+            mainSamplerate,
+            &userErrorMsg);
+
+    if (!m_pEncoder) {
         setState(NETWORKSTREAMWORKER_STATE_ERROR);
 
         m_lastErrorStr = pBroadcastSettings->getFormat() + QChar(' ') +
@@ -495,7 +499,7 @@ bool ShoutConnection::processConnect() {
     // Make sure that we call updateFromPreferences always
     updateFromPreferences();
 
-    if (!m_encoder) {
+    if (!m_pEncoder) {
         // updateFromPreferences failed
         setStatus(BroadcastProfile::STATUS_FAILURE);
         kLogger.warning() << "ShoutOutput::processConnect() returning false";
@@ -592,6 +596,7 @@ bool ShoutConnection::processConnect() {
             	m_pOutputFifo->flushReadData(m_pOutputFifo->readAvailable());
             }
             m_threadWaiting = true;
+            m_pEncoder->attach(this);
 
             setStatus(BroadcastProfile::STATUS_CONNECTED);
             emit broadcastConnected();
@@ -619,9 +624,8 @@ bool ShoutConnection::processConnect() {
 
     // no connection, clean up
     shout_close(m_pShout);
-    // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    releaseEncoder();
     if (m_pProfile->getEnabled()) {
         setStatus(BroadcastProfile::STATUS_FAILURE);
     } else {
@@ -644,29 +648,58 @@ bool ShoutConnection::processDisconnect() {
         emit broadcastDisconnected();
         disconnected = true;
     }
-    // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
-    m_encoder.reset();
+    releaseEncoder();
     return disconnected;
 }
 
-void ShoutConnection::write(const unsigned char* header, const unsigned char* body,
-                            int headerLen, int bodyLen) {
-    setFunctionCode(7);
-	if (!m_pShout || m_iShoutStatus != SHOUTERR_CONNECTED) {
-        // This happens when the decoder calls flush() and the connection is
-        // already down
-        return;
+void ShoutConnection::releaseEncoder() {
+    if (m_pEncoder) {
+        m_pEncoder->detach(this);
+        // The encoder is deleted if no other connection uses it. It might
+        // flush the remaining packets, but this connection does not
+        // receive them anymore.
+        m_pEncoder.reset();
+    }
+    const auto locker = lockMutex(&m_pendingPacketsMutex);
+    m_pendingPackets.clear();
+    m_pendingPacketsSize = 0;
+}
+
+void ShoutConnection::receivePacket(const QByteArray& packet) {
+    const auto locker = lockMutex(&m_pendingPacketsMutex);
+    // Only increments the reference count of the shared packet
+    m_pendingPackets.append(packet);
+    m_pendingPacketsSize += packet.size();
+    // The packets keep coming from the sidechain while this connection
+    // is blocked sending. Drop the oldest ones like the server would.
+    while (m_pendingPacketsSize > kMaxNetworkCache && m_pendingPackets.size() > 1) {
+        m_pendingPacketsSize -= m_pendingPackets.takeFirst().size();
     }
+}
 
-    // Send header if there is one
-    if (headerLen > 0) {
-        if(!writeSingle(header, headerLen)) {
-            return;
-        }
+void ShoutConnection::writePendingPackets() {
+    QList<QByteArray> packets;
+    {
+        const auto locker = lockMutex(&m_pendingPacketsMutex);
+        packets.swap(m_pendingPackets);
+        m_pendingPacketsSize = 0;
+    }
+    for (const auto& packet : std::as_const(packets)) {
+        writePacket(packet);
+    }
+}
+
+void ShoutConnection::writePacket(const QByteArray& packet) {
+    setFunctionCode(7);
+    if (!m_pShout || m_iShoutStatus != SHOUTERR_CONNECTED) {
+        // This happens when the connection went down while sending the
+        // previous packets
+        return;
     }
 
-    if(!writeSingle(body, bodyLen)) {
+    if (!writeSingle(reinterpret_cast<const unsigned char*>(packet.constData()),
+                packet.size())) {
         return;
     }
 
@@ -679,23 +712,6 @@ void ShoutConnection::write(const unsigned char* header, const unsigned char* bo
         }
     }
 }
-// These are not used for streaming, but the interface requires them
-int ShoutConnection::tell() {
-    if (!m_pShout) {
-        return -1;
-    }
-    return -1;
-}
-// These are not used for streaming, but the interface requires them
-void ShoutConnection::seek(int pos) {
-    Q_UNUSED(pos)
-    return;
-}
-// These are not used for streaming, but the interface requires them
-int ShoutConnection::filelen() {
-    return 0;
-}
-
 bool ShoutConnection::writeSingle(const unsigned char* data, std::size_t len) {
     setFunctionCode(8);
     int ret = shout_send_raw(m_pShout, data, len);
@@ -737,14 +753,16 @@ void ShoutConnection::process(const CSAMPLE* pBuffer, const std::size_t bufferSi
     // Save a copy of the smart pointer in a local variable
     // to prevent race conditions when resetting the member
     // pointer while disconnecting in the worker thread!
-    const EncoderPointer pEncoder = m_encoder;
+    const std::shared_ptr<SharedEncoder> pEncoder = m_pEncoder;
 
-    // If we are connected, encode the samples.
-    if (bufferSize > 0 && pEncoder) {
+    // If we are connected, encode the samples. Shared encoders are fed by
+    // the engine sidechain, the samples only pace sending their packets.
+    if (bufferSize > 0 && pEncoder && !pEncoder->isShared()) {
         setFunctionCode(6);
         pEncoder->encodeBuffer(pBuffer, bufferSize);
-        // the encoded frames are received by the write() callback.
     }
+    // the encoded frames are received by receivePacket()
+    writePendingPackets();
 
     // Check if track metadata has changed and if so, update.
     if (metaDataHasChanged()) {
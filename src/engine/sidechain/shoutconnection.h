@@ -2,6 +2,7 @@
 
 #include <engine/sidechain/networkoutputstreamworker.h>
 
+#include <QList>
 #include <QMutex>
 #include <QSemaphore>
 #include <QSharedPointer>
@@ -10,8 +11,7 @@
 #include <QWaitCondition>
 
 #include "control/pollingcontrolproxy.h"
-#include "encoder/encoder.h"
-#include "encoder/encodercallback.h"
+#include "engine/sidechain/sharedencoder.h"
 #include "preferences/broadcastprofile.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
@@ -25,7 +25,7 @@ typedef struct _util_dict shout_metadata_t;
 class QTextCodec;
 
 class ShoutConnection
-        : public QThread, public EncoderCallback, public NetworkOutputStreamWorker {
+        : public QThread, public SharedEncoder::Sink, public NetworkOutputStreamWorker {
     Q_OBJECT
   public:
     ShoutConnection(BroadcastProfilePtr profile, UserSettingsPointer pConfig);
@@ -38,16 +38,9 @@ class ShoutConnection
     void shutdown() override {
     }
 
-    // Called by the encoder in method 'encodebuffer()' to flush the stream to
-    // the server.
-    void write(const unsigned char* header, const unsigned char* body,
-               int headerLen, int bodyLen) override;
-    // gets stream position
-    int tell() override;
-    // sets stream position
-    void seek(int pos) override;
-    // gets stream length
-    int filelen() override;
+    // Called by the shared encoder with the packets that are encoded for
+    // this connection. They are sent to the server by process().
+    void receivePacket(const QByteArray& packet) override;
 
     /** connects to server **/
     bool serverConnect();
@@ -94,8 +87,11 @@ class ShoutConnection
     void errorDialog(const QString& text, const QString& detailedError);
     void infoDialog(const QString& text, const QString& detailedError);
 
-    void serverWrite(unsigned char *header, unsigned char *body,
-               int headerLen, int bodyLen);
+    // Sends the packets that have been received from the encoder
+    void writePendingPackets();
+    void writePacket(const QByteArray& packet);
+    // Stops receiving packets and releases the encoder if it is not shared
+    void releaseEncoder();
 
 #ifndef __WINDOWS__
     void ignoreSigpipe();
@@ -119,7 +115,10 @@ class ShoutConnection
     long m_iShoutFailures;
     UserSettingsPointer m_pConfig;
     BroadcastProfilePtr m_pProfile;
-    EncoderPointer m_encoder;
+    std::shared_ptr<SharedEncoder> m_pEncoder;
+    QMutex m_pendingPacketsMutex;
+    QList<QByteArray> m_pendingPackets;
+    int m_pendingPacketsSize;
     PollingControlProxy m_mainSamplerate;
     PollingControlProxy m_broadcastEnabled;
     // static metadata according to prefereneces
@@ -89,6 +89,8 @@ SyncControl::SyncControl(const QString& group,
     // The relative position between two beats in the range 0.0 ... 1.0
     m_pBeatDistance.reset(
             new ControlObject(ConfigKey(group, "beat_distance")));
+    // Updated on every callback, the engine itself only polls it
+    m_pBeatDistance->enableCoalescedNotifications();
 
     m_pPassthroughEnabled = new ControlProxy(group, "passthrough", this);
     m_pPassthroughEnabled->connectValueChanged(this,
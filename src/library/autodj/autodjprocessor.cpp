@@ -1,5 +1,8 @@
 #include "library/autodj/autodjprocessor.h"
 
+#include <algorithm>
+
+#include "engine/cachingreader/cachingreaderpreloader.h"
 #include "engine/channels/enginedeck.h"
 #include "mixer/basetrackplayer.h"
 #include "mixer/playermanager.h"
@@ -19,6 +22,9 @@ constexpr double kKeepPosition = -1.0;
 constexpr double kMinimumTrackDurationSec = 0.2;
 
 constexpr bool sDebug = false;
+
+// The next track and one more in case the next track is skipped
+constexpr int kPreloadedQueueTracks = 2;
 } // anonymous namespace
 
 DeckAttributes::DeckAttributes(int index,
@@ -574,6 +580,7 @@ AutoDJProcessor::AutoDJError AutoDJProcessor::toggleAutoDJ(bool enable) {
         m_enabledAutoDJ.setAndConfirm(0.0);
         qDebug() << "Auto DJ disabled";
         m_eState = ADJ_DISABLED;
+        preloadUpcomingTracks();
         disconnect(&m_coCrossfader,
                 &ControlProxy::valueChanged,
                 this,
@@ -998,6 +1005,35 @@ void AutoDJProcessor::maybeFillRandomTracks() {
     }
 }
 
+void AutoDJProcessor::preloadUpcomingTracks() {
+    if (!CachingReaderPreloader::isCreated()) {
+        return;
+    }
+    QList<TrackPointer> upcomingTracks;
+    if (m_eState != ADJ_DISABLED) {
+        for (int row = 0; row < m_pAutoDJTableModel->rowCount() &&
+                upcomingTracks.size() < kPreloadedQueueTracks;
+                ++row) {
+            TrackPointer pTrack = m_pAutoDJTableModel->getTrack(
+                    m_pAutoDJTableModel->index(row, 0));
+            if (!pTrack) {
+                continue;
+            }
+            // The track at the top of the queue is usually already loaded
+            // into the deck that fades in next.
+            const bool loaded = std::any_of(m_decks.cbegin(),
+                    m_decks.cend(),
+                    [&pTrack](const auto& pDeck) {
+                        return pDeck->getLoadedTrack() == pTrack;
+                    });
+            if (!loaded) {
+                upcomingTracks.append(pTrack);
+            }
+        }
+    }
+    CachingReaderPreloader::instance()->preloadTracks(upcomingTracks);
+}
+
 void AutoDJProcessor::playerPlayChanged(DeckAttributes* thisDeck, bool playing) {
     if constexpr (sDebug) {
         qDebug() << this << "playerPlayChanged" << thisDeck->group << playing;
@@ -1574,6 +1610,7 @@ void AutoDJProcessor::playerTrackLoaded(DeckAttributes* pDeck, TrackPointer pTra
     }
 
     pDeck->loading = false;
+    preloadUpcomingTracks();
 
     // Since the end position is measured in seconds from 0:00 it is also
     // the track duration.
@@ -1702,6 +1739,7 @@ void AutoDJProcessor::playlistFirstTrackChanged() {
         } else if (!pRightDeck->isPlaying()) {
             loadNextTrackFromQueue(*pRightDeck);
         }
+        preloadUpcomingTracks();
     }
 }
 
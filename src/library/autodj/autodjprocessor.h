@@ -296,6 +296,11 @@ class AutoDJProcessor : public QObject {
     // present.
     bool removeTrackFromTopOfQueue(TrackPointer pTrack);
     void maybeFillRandomTracks();
+
+    // Passes the next tracks of the queue that are not loaded yet to the
+    // CachingReaderPreloader, or none if Auto DJ is disabled.
+    void preloadUpcomingTracks();
+
     UserSettingsPointer m_pConfig;
     parented_ptr<PlaylistTableModel> m_pAutoDJTableModel;
 
@@ -79,6 +79,8 @@ void BansheePlaylistModel::dropTempTable() {
     if (m_playlistId >= 0) {
         // Clear old playlist
         m_playlistId = kInvalidPlaylistId;
+        // A pending query would lock the table
+        maybeStopModelPopulation();
         QSqlQuery query(m_database);
         QString strQuery("DROP TABLE IF EXISTS %1");
         if (!query.exec(strQuery.arg(m_tempTableName))) {
@@ -1,6 +1,10 @@
 #include "library/basesqltablemodel.h"
 
+#include <QRegularExpression>
+#include <QSqlRecord>
+#include <QThreadPool>
 #include <QUrl>
+#include <QtConcurrentRun>
 #include <QtDebug>
 #include <algorithm>
 
@@ -17,6 +21,7 @@
 #include "util/assert.h"
 #include "util/datetime.h"
 #include "util/db/dbconnection.h"
+#include "util/db/dbconnectionpooled.h"
 #include "util/duration.h"
 #include "util/performancetimer.h"
 #include "util/platform.h"
@@ -31,6 +36,25 @@ const bool sDebug = false;
 constexpr int kIdColumn = 0;
 constexpr int kMaxSortColumns = 3;
 
+// The time an incremental select() may block the event loop before
+// continuing to read the rows in the next iteration
+constexpr int kSelectTimeSliceMillis = 15;
+constexpr int kSelectRowsPerTimeCheck = 64;
+
+// The rows that are shown before all rows of a select() on a worker
+// thread have been read, enough to fill the visible part of the table
+constexpr int kFirstPageRows = 100;
+
+// SQLite stores the statements of temporary views without the
+// TEMPORARY keyword
+const QString kCreateView = QStringLiteral("CREATE VIEW ");
+const QString kCreateTempView = QStringLiteral("CREATE TEMPORARY VIEW ");
+
+bool referencesName(const QString& sql, const QString& name) {
+    return sql.contains(QRegularExpression(
+            QStringLiteral("\\b%1\\b").arg(QRegularExpression::escape(name))));
+}
+
 // Constant for getModelSetting(name)
 const QString COLUMNS_SORTING = QStringLiteral("ColumnsSorting");
 
@@ -38,6 +62,88 @@ const QString kModelName = "table:";
 
 } // anonymous namespace
 
+// Reads the rows of all models on a single worker thread with a long-lived
+// database connection. The temporary views of the models are only recreated
+// on this connection if their definition has changed.
+class BaseSqlTableModel::SelectThread {
+  public:
+    explicit SelectThread(mixxx::DbConnectionPoolPtr pDbConnectionPool)
+            : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+              m_connectionCreated(false) {
+        m_threadPool.setMaxThreadCount(1);
+        // The thread must not expire, it owns the connection
+        m_threadPool.setExpiryTimeout(-1);
+    }
+
+    ~SelectThread() {
+        // The connection must be closed on the thread that has opened it
+        QtConcurrent::run(&m_threadPool, [this] {
+            if (m_connectionCreated) {
+                m_pDbConnectionPool->destroyThreadLocalConnection();
+            }
+        }).waitForFinished();
+        m_threadPool.waitForDone();
+    }
+
+    /// Returns the thread that is shared by all models with the same
+    /// connection pool.
+    static std::shared_ptr<SelectThread> instance(
+            const mixxx::DbConnectionPoolPtr& pDbConnectionPool) {
+        auto pInstance = s_pInstance.lock();
+        if (!pInstance || pInstance->m_pDbConnectionPool != pDbConnectionPool) {
+            pInstance = std::make_shared<SelectThread>(pDbConnectionPool);
+            s_pInstance = pInstance;
+        }
+        return pInstance;
+    }
+
+    QThreadPool* threadPool() {
+        return &m_threadPool;
+    }
+
+    /// Must only be called on the worker thread. Returns the connection
+    /// with the temporary views, or an invalid connection on failure.
+    QSqlDatabase database(const QList<TempView>& tempViews) {
+        if (!m_connectionCreated) {
+            m_connectionCreated = m_pDbConnectionPool->createThreadLocalConnection();
+            if (!m_connectionCreated) {
+                return QSqlDatabase();
+            }
+        }
+        const QSqlDatabase database = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+        for (const auto& tempView : tempViews) {
+            if (m_tempViews.value(tempView.name) == tempView.sql) {
+                continue;
+            }
+            // Qualified to not drop a persistent view with the same name
+            QSqlQuery query(database);
+            if (!query.exec(QStringLiteral("DROP VIEW IF EXISTS temp.%1")
+                                    .arg(tempView.name))) {
+                LOG_FAILED_QUERY(query);
+            }
+            m_tempViews.remove(tempView.name);
+            if (!query.exec(tempView.sql)) {
+                LOG_FAILED_QUERY(query);
+                return QSqlDatabase();
+            }
+            m_tempViews.insert(tempView.name, tempView.sql);
+        }
+        return database;
+    }
+
+  private:
+    static std::weak_ptr<SelectThread> s_pInstance;
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    QThreadPool m_threadPool;
+    // Only accessed on the worker thread
+    bool m_connectionCreated;
+    QHash<QString, QString> m_tempViews;
+};
+
+// static
+std::weak_ptr<BaseSqlTableModel::SelectThread> BaseSqlTableModel::SelectThread::s_pInstance;
+
 BaseSqlTableModel::BaseSqlTableModel(
         QObject* parent,
         TrackCollectionManager* pTrackCollectionManager,
@@ -45,10 +151,19 @@ BaseSqlTableModel::BaseSqlTableModel(
         : BaseTrackTableModel(parent, pTrackCollectionManager, settingsNamespace),
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_database(pTrackCollectionManager->internalCollection()->database()),
-          m_bInitialized(false) {
+          m_bInitialized(false),
+          m_pSelectWatcher(nullptr),
+          m_pFirstPageWatcher(nullptr) {
+    m_pendingSelectTimer.setSingleShot(true);
+    m_pendingSelectTimer.setInterval(0);
+    connect(&m_pendingSelectTimer,
+            &QTimer::timeout,
+            this,
+            &BaseSqlTableModel::slotReadPendingSelect);
 }
 
 BaseSqlTableModel::~BaseSqlTableModel() {
+    abortPendingSelect();
 }
 
 void BaseSqlTableModel::initSortColumnMapping() {
@@ -210,8 +325,97 @@ void BaseSqlTableModel::select() {
         qDebug() << this << "select()";
     }
 
-    PerformanceTimer time;
-    time.start();
+    if (!beginSelect()) {
+        return;
+    }
+    readPendingSelect(-1);
+    finishPendingSelect();
+}
+
+void BaseSqlTableModel::selectIncrementally() {
+    if (!m_bInitialized) {
+        return;
+    }
+    if (sDebug) {
+        qDebug() << this << "selectIncrementally()";
+    }
+
+    if (!beginSelect()) {
+        return;
+    }
+    // Small results are finished immediately, like with select()
+    if (readPendingSelect(kSelectTimeSliceMillis)) {
+        finishPendingSelect();
+    } else {
+        m_pendingSelectTimer.start();
+    }
+}
+
+void BaseSqlTableModel::slotReadPendingSelect() {
+    if (!m_pPendingSelect) {
+        return;
+    }
+    if (readPendingSelect(kSelectTimeSliceMillis)) {
+        finishPendingSelect();
+    } else {
+        m_pendingSelectTimer.start();
+    }
+}
+
+void BaseSqlTableModel::maybeStopModelPopulation() {
+    abortPendingSelect();
+    for (auto& future : m_abortedSelects) {
+        future.waitForFinished();
+    }
+    m_abortedSelects.clear();
+}
+
+void BaseSqlTableModel::abortPendingSelect() {
+    m_pendingSelectTimer.stop();
+    if (m_pPendingSelect) {
+        if (sDebug) {
+            qDebug() << this << "aborting select() after reading"
+                     << m_pPendingSelect->rowInfos.size() << "rows";
+        }
+        m_pPendingSelect.reset();
+    }
+    if (m_pSelectWatcher) {
+        if (sDebug) {
+            qDebug() << this << "aborting select() on worker thread";
+        }
+        *m_pSelectAborted = true;
+        abortSelectWatcher(m_pSelectWatcher);
+        m_pSelectWatcher = nullptr;
+    }
+    if (m_pFirstPageWatcher) {
+        abortSelectWatcher(m_pFirstPageWatcher);
+        m_pFirstPageWatcher = nullptr;
+    }
+}
+
+void BaseSqlTableModel::abortSelectWatcher(SelectWatcher* pWatcher) {
+    // Keep the futures until the workers have finished, they don't
+    // access the model
+    m_abortedSelects.erase(
+            std::remove_if(m_abortedSelects.begin(),
+                    m_abortedSelects.end(),
+                    [](const QFuture<SelectResult>& future) {
+                        return future.isFinished();
+                    }),
+            m_abortedSelects.end());
+    if (!pWatcher->isFinished()) {
+        m_abortedSelects.append(pWatcher->future());
+    }
+    pWatcher->disconnect(this);
+    pWatcher->deleteLater();
+}
+
+bool BaseSqlTableModel::beginSelect() {
+    // A previous select() is stale, its rows would be replaced anyway
+    abortPendingSelect();
+
+    auto pSelect = std::make_unique<PendingSelect>();
+    pSelect->time.start();
 
     // Prepare query for id and all columns not in m_trackSource
     QString queryString = QString("SELECT %1 FROM %2 %3")
@@ -221,139 +425,561 @@ void BaseSqlTableModel::select() {
         qDebug() << this << "select() executing:" << queryString;
     }
 
-    QSqlQuery query(m_database);
+    pSelect->query = QSqlQuery(m_database);
+    QSqlQuery& query = pSelect->query;
     // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
     // won't allocate a giant in-memory table that we won't use at all.
     query.setForwardOnly(true);
     if (!query.prepare(queryString)) {
         LOG_FAILED_QUERY(query);
-        return;
+        return false;
     }
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
-        return;
+        return false;
     }
 
-    // Remove all the rows from the table after(!) the query has been
-    // executed successfully. See issue #6782.
-    // TODO(rryan) we could edit the table in place instead of clearing it?
-    clearRows();
+    // TODO(XXX): Can we get rid of the hard-coded assumption that
+    // the the first column always contains the id?
+    const QSqlRecord sqlRecord = query.record();
+    const int idColumn = sqlRecord.indexOf(m_idColumn);
+    DEBUG_ASSERT(idColumn == kIdColumn);
+    VERIFY_OR_DEBUG_ASSERT(idColumn != -1) {
+        qCritical()
+                << "ID column not available in database query results:"
+                << m_idColumn;
+        return false;
+    }
+    if (hasPositionColumn()) {
+        pSelect->posColumn = sqlRecord.indexOf(PLAYLISTTABLE_POSITION);
+    }
+
+    m_pPendingSelect = std::move(pSelect);
+    return true;
+}
+
+// static
+void BaseSqlTableModel::appendRow(
+        QVector<RowInfo>* pRowInfos,
+        const QSqlQuery& query,
+        int columnCount) {
+    // Access the values directly instead of allocating a QSqlRecord
+    // with all the field names for every row
+    RowInfo rowInfo;
+    rowInfo.trackId = TrackId(query.value(kIdColumn));
+    rowInfo.row = pRowInfos->size();
+    rowInfo.columnValues.reserve(columnCount);
+    for (int i = 0; i < columnCount; ++i) {
+        rowInfo.columnValues.push_back(query.value(i));
+    }
+    pRowInfos->push_back(std::move(rowInfo));
+}
+
+bool BaseSqlTableModel::readPendingSelect(int maxDurationMillis) {
+    VERIFY_OR_DEBUG_ASSERT(m_pPendingSelect) {
+        return true;
+    }
+    PendingSelect* const pSelect = m_pPendingSelect.get();
+    QSqlQuery& query = pSelect->query;
+    PerformanceTimer sliceTime;
+    sliceTime.start();
 
     // The size of the result set is not known in advance for a
     // forward-only query, so we cannot reserve memory for rows
     // in advance.
-    QVector<RowInfo> rowInfos;
-    QSet<TrackId> trackIds;
-    int idColumn = -1;
-    int posColumn = -1;
+    const int columnCount = m_tableColumns.size();
+    int rowCount = 0;
     while (query.next()) {
-        QSqlRecord sqlRecord = query.record();
+        appendRow(&pSelect->rowInfos, query, columnCount);
+        pSelect->trackIds.insert(pSelect->rowInfos.last().trackId);
 
-        if (idColumn < 0) {
-            idColumn = sqlRecord.indexOf(m_idColumn);
+        if (maxDurationMillis >= 0 &&
+                ++rowCount % kSelectRowsPerTimeCheck == 0 &&
+                sliceTime.elapsed().toIntegerMillis() >= maxDurationMillis) {
+            return false;
         }
+    }
+    if (query.lastError().isValid()) {
+        // e.g. if a rollback on the connection interrupted the query
+        // while it was pending
+        LOG_FAILED_QUERY(query);
+    }
+    return true;
+}
 
-        if (posColumn == -1 && hasPositionColumn()) {
-            posColumn = sqlRecord.indexOf(PLAYLISTTABLE_POSITION);
+// static
+void BaseSqlTableModel::sortRows(
+        QVector<RowInfo>* pRowInfos,
+        const QHash<TrackId, int>& trackSortOrder,
+        bool trackSourceOrder) {
+    // Re-sort the track IDs since filterAndSort can change their order or mark
+    // them for removal (by setting their row to -1).
+    for (auto& rowInfo : *pRowInfos) {
+        // If the sort is not a track column then we will sort only to
+        // separate removed tracks (order == -1) from present tracks (order ==
+        // 0). Otherwise we sort by the order that filterAndSort returned to us.
+        if (trackSourceOrder) {
+            rowInfo.row = trackSortOrder.value(rowInfo.trackId, -1);
+        } else {
+            rowInfo.row = trackSortOrder.contains(rowInfo.trackId) ? 0 : -1;
         }
+    }
 
-        // TODO(XXX): Can we get rid of the hard-coded assumption that
-        // the the first column always contains the id?
-        DEBUG_ASSERT(idColumn == kIdColumn);
+    // RowInfo::operator< sorts by the order field, except -1 is placed at the
+    // end so we can easily slice off rows that are no longer present. Stable
+    // sort is necessary because the tracks may be in pre-sorted order so we
+    // should not disturb that if we are only removing tracks.
+    std::stable_sort(pRowInfos->begin(), pRowInfos->end());
 
-        VERIFY_OR_DEBUG_ASSERT(idColumn != -1) {
-            qCritical()
-                    << "ID column not available in database query results:"
-                    << m_idColumn;
-            return;
+    for (int i = 0; i < pRowInfos->size(); ++i) {
+        if (pRowInfos->at(i).row == -1) {
+            // We've reached the end of valid rows. Resize rowInfo to cut off
+            // this and all further elements.
+            pRowInfos->resize(i);
+            break;
         }
+    }
+}
 
-        TrackId trackId(sqlRecord.value(idColumn));
-        trackIds.insert(trackId);
-
-        RowInfo rowInfo;
-        rowInfo.trackId = trackId;
-        rowInfo.row = rowInfos.size();
+// static
+void BaseSqlTableModel::indexRows(
+        const QVector<RowInfo>& rowInfos,
+        int posColumn,
+        TrackId2Rows* pTrackIdToRows,
+        TrackPos2Row* pTrackPosToRows) {
+    // We expect almost all rows to be valid and that only a few tracks
+    // are contained multiple times in rowInfos (e.g. in history playlists)
+    pTrackIdToRows->reserve(rowInfos.size());
+    for (int i = 0; i < rowInfos.size(); ++i) {
+        (*pTrackIdToRows)[rowInfos[i].trackId].push_back(i);
+    }
+    // The number of unique tracks cannot be greater than the
+    // number of total rows returned by the query
+    DEBUG_ASSERT(pTrackIdToRows->size() <= rowInfos.size());
 
-        rowInfo.columnValues.reserve(sqlRecord.count());
-        for (int i = 0; i < m_tableColumns.size(); ++i) {
-            rowInfo.columnValues.push_back(sqlRecord.value(i));
+    if (posColumn >= 0) {
+        // We expect as many positions as we have rows
+        pTrackPosToRows->reserve(rowInfos.size());
+        for (int i = 0; i < rowInfos.size(); ++i) {
+            pTrackPosToRows->insert(rowInfos[i].getPosition(posColumn), i);
         }
-        rowInfos.push_back(rowInfo);
+        DEBUG_ASSERT(pTrackPosToRows->size() == rowInfos.size());
+    }
+}
+
+void BaseSqlTableModel::finishPendingSelect() {
+    VERIFY_OR_DEBUG_ASSERT(m_pPendingSelect) {
+        return;
     }
+    const std::unique_ptr<PendingSelect> pSelect = std::move(m_pPendingSelect);
+    m_pendingSelectTimer.stop();
+    QVector<RowInfo>& rowInfos = pSelect->rowInfos;
 
     if (sDebug) {
         qDebug() << "Rows actually received:" << rowInfos.size();
     }
 
+    // Remove all the rows from the table after(!) the query has been
+    // executed successfully. See issue #6782.
+    // TODO(rryan) we could edit the table in place instead of clearing it?
+    clearRows();
+
     if (m_trackSource) {
-        m_trackSource->filterAndSort(trackIds,
+        m_trackSource->filterAndSort(pSelect->trackIds,
                 m_currentSearch,
                 m_currentSearchFilter,
                 m_trackSourceOrderBy,
                 m_sortColumns,
                 m_tableColumns.size() - 1, // exclude the 1st column with the id
                 &m_trackSortOrder);
+        sortRows(&rowInfos, m_trackSortOrder, !m_trackSourceOrderBy.isEmpty());
+    }
 
-        // Re-sort the track IDs since filterAndSort can change their order or mark
-        // them for removal (by setting their row to -1).
-        for (auto& rowInfo : rowInfos) {
-            // If the sort is not a track column then we will sort only to
-            // separate removed tracks (order == -1) from present tracks (order ==
-            // 0). Otherwise we sort by the order that filterAndSort returned to us.
-            if (m_trackSourceOrderBy.isEmpty()) {
-                rowInfo.row = m_trackSortOrder.contains(rowInfo.trackId) ? 0 : -1;
-            } else {
-                rowInfo.row = m_trackSortOrder.value(rowInfo.trackId, -1);
+    TrackId2Rows trackIdToRows;
+    TrackPos2Row trackPosToRows;
+    indexRows(rowInfos, pSelect->posColumn, &trackIdToRows, &trackPosToRows);
+
+    // We're done! Issue the update signals and replace the main maps.
+    replaceRows(
+            std::move(rowInfos),
+            std::move(trackIdToRows),
+            std::move(trackPosToRows));
+    // Both rowInfo and trackIdToRows (might) have been moved and
+    // must not be used afterwards!
+
+    qDebug() << this << "select() returned" << m_rowInfo.size()
+             << "results in" << pSelect->time.elapsed().debugMillisWithUnit();
+    emit selectFinished();
+}
+
+bool BaseSqlTableModel::prepareSelectQueries(SelectQueries* pQueries) const {
+    if (!m_pTrackCollectionManager->dbConnectionPool()) {
+        return false;
+    }
+    const QString trackSourceTable =
+            m_trackSource ? m_trackSource->tableName() : QString();
+    QSqlQuery query(m_database);
+    if (!query.exec(QStringLiteral(
+                "SELECT type,name,sql FROM sqlite_temp_master "
+                "WHERE type IN ('table','view') ORDER BY rowid"))) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    // In the order of creation, views only depend on views that have
+    // been created before
+    QList<TempView> tempObjects;
+    QSet<QString> tempTables;
+    while (query.next()) {
+        const QString name = query.value(1).toString();
+        if (query.value(0).toString() == QStringLiteral("table")) {
+            tempTables.insert(name);
+        }
+        tempObjects.append(TempView{name, query.value(2).toString()});
+    }
+
+    // Only the temporary views that are referenced by the queries,
+    // directly or by other views, are created on the worker connection
+    QSet<QString> referencedNames{m_tableName};
+    if (m_trackSource) {
+        referencedNames.insert(trackSourceTable);
+    }
+    for (int i = tempObjects.size() - 1; i >= 0; --i) {
+        const TempView& tempObject = tempObjects.at(i);
+        if (!referencedNames.contains(tempObject.name)) {
+            continue;
+        }
+        if (tempTables.contains(tempObject.name)) {
+            // The contents of temporary tables are only visible on our
+            // connection, e.g. the tracks of a Banshee playlist
+            return false;
+        }
+        for (int j = 0; j < i; ++j) {
+            if (referencesName(tempObject.sql, tempObjects.at(j).name)) {
+                referencedNames.insert(tempObjects.at(j).name);
             }
         }
     }
+    for (const auto& tempObject : std::as_const(tempObjects)) {
+        if (!referencedNames.contains(tempObject.name)) {
+            continue;
+        }
+        QString sql = tempObject.sql;
+        VERIFY_OR_DEBUG_ASSERT(sql.startsWith(kCreateView, Qt::CaseInsensitive)) {
+            return false;
+        }
+        sql.replace(0, kCreateView.size(), kCreateTempView);
+        pQueries->tempViews.append(TempView{tempObject.name, sql});
+    }
 
-    // RowInfo::operator< sorts by the order field, except -1 is placed at the
-    // end so we can easily slice off rows that are no longer present. Stable
-    // sort is necessary because the tracks may be in pre-sorted order so we
-    // should not disturb that if we are only removing tracks.
-    std::stable_sort(rowInfos.begin(), rowInfos.end());
+    const QString tableColumns = m_tableColumns.join(",");
+    pQueries->tableQuery = QString("SELECT %1 FROM %2 %3")
+                                   .arg(tableColumns, m_tableName, m_tableOrderBy);
+    pQueries->idColumn = m_idColumn;
+    pQueries->columnCount = m_tableColumns.size();
+    pQueries->hasPositionColumn =
+            fieldIndex(ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION) >= 0;
+    if (!m_trackSource) {
+        pQueries->firstPageQuery = QString("%1 LIMIT %2")
+                                           .arg(pQueries->tableQuery)
+                                           .arg(kFirstPageRows);
+        return true;
+    }
 
-    TrackId2Rows trackIdToRows;
-    // We expect almost all rows to be valid and that only a few tracks
-    // are contained multiple times in rowInfos (e.g. in history playlists)
-    trackIdToRows.reserve(rowInfos.size());
-    for (int i = 0; i < rowInfos.size(); ++i) {
-        const RowInfo& rowInfo = rowInfos[i];
-        if (rowInfo.row == -1) {
-            // We've reached the end of valid rows. Resize rowInfo to cut off
-            // this and all further elements.
-            rowInfos.resize(i);
-            break;
+    const QString filter = m_trackSource->searchFilter(
+            m_currentSearch, m_currentSearchFilter);
+    const QString trackSourceId = m_trackSource->idColumn();
+    pQueries->trackSourceQuery = QString("SELECT %1 FROM %2 %3 %4")
+                                         .arg(trackSourceId,
+                                                 trackSourceTable,
+                                                 filter.isEmpty()
+                                                         ? QString()
+                                                         : QStringLiteral("WHERE ") + filter,
+                                                 m_trackSourceOrderBy);
+    pQueries->trackSourceOrder = !m_trackSourceOrderBy.isEmpty();
+    if (pQueries->trackSourceOrder) {
+        // Only the tracks of the table in the order of the track source
+        pQueries->firstPageIdsQuery =
+                QString("SELECT %1 FROM %2 WHERE %3 %1 IN (SELECT %4 FROM %5) %6 LIMIT %7")
+                        .arg(trackSourceId,
+                                trackSourceTable,
+                                filter.isEmpty()
+                                        ? QString()
+                                        : QStringLiteral("(") + filter + QStringLiteral(") AND"),
+                                m_idColumn,
+                                m_tableName,
+                                m_trackSourceOrderBy,
+                                QString::number(kFirstPageRows));
+        // The ids of the page are inserted by the worker
+        pQueries->firstPageQuery = QString("SELECT %1 FROM %2 WHERE %3 IN (%4) %5")
+                                           .arg(tableColumns,
+                                                   m_tableName,
+                                                   m_idColumn,
+                                                   QStringLiteral("%1"),
+                                                   m_tableOrderBy);
+    } else {
+        pQueries->firstPageQuery =
+                QString("SELECT %1 FROM %2 WHERE %3 IN (SELECT %4 FROM %5 %6) %7 LIMIT %8")
+                        .arg(tableColumns,
+                                m_tableName,
+                                m_idColumn,
+                                trackSourceId,
+                                trackSourceTable,
+                                filter.isEmpty()
+                                        ? QString()
+                                        : QStringLiteral("WHERE ") + filter,
+                                m_tableOrderBy,
+                                QString::number(kFirstPageRows));
+    }
+    return true;
+}
+
+void BaseSqlTableModel::selectAsync() {
+    if (!m_bInitialized) {
+        return;
+    }
+    if (sDebug) {
+        qDebug() << this << "selectAsync()";
+    }
+
+    // A previous select() is stale, its rows would be replaced anyway
+    abortPendingSelect();
+
+    SelectQueries queries;
+    if (!prepareSelectQueries(&queries)) {
+        selectIncrementally();
+        return;
+    }
+
+    if (!m_pSelectThread) {
+        m_pSelectThread = SelectThread::instance(
+                m_pTrackCollectionManager->dbConnectionPool());
+    }
+    m_selectTime.start();
+    m_pSelectAborted = std::make_shared<std::atomic<bool>>(false);
+    // The first page is read before all rows on the single worker thread
+    m_pFirstPageWatcher = new SelectWatcher(this);
+    connect(m_pFirstPageWatcher,
+            &SelectWatcher::finished,
+            this,
+            &BaseSqlTableModel::slotFirstPageSelected);
+    m_pFirstPageWatcher->setFuture(QtConcurrent::run(
+            m_pSelectThread->threadPool(),
+            &BaseSqlTableModel::executeFirstPage,
+            m_pSelectThread.get(),
+            queries,
+            m_pSelectAborted));
+    m_pSelectWatcher = new SelectWatcher(this);
+    connect(m_pSelectWatcher,
+            &SelectWatcher::finished,
+            this,
+            &BaseSqlTableModel::slotRowsSelected);
+    m_pSelectWatcher->setFuture(QtConcurrent::run(
+            m_pSelectThread->threadPool(),
+            &BaseSqlTableModel::executeSelect,
+            m_pSelectThread.get(),
+            queries,
+            m_pSelectAborted));
+}
+
+// static
+BaseSqlTableModel::SelectResult BaseSqlTableModel::executeSelect(
+        SelectThread* pSelectThread,
+        const SelectQueries& queries,
+        const std::shared_ptr<std::atomic<bool>>& pAborted) {
+    SelectResult result;
+    if (*pAborted) {
+        return result;
+    }
+    const QSqlDatabase database = pSelectThread->database(queries.tempViews);
+    if (!database.isOpen()) {
+        return result;
+    }
+
+    if (!queries.trackSourceQuery.isEmpty()) {
+        QSqlQuery query(database);
+        query.setForwardOnly(true);
+        if (!query.exec(queries.trackSourceQuery)) {
+            LOG_FAILED_QUERY(query);
+            return result;
+        }
+        while (query.next()) {
+            if (*pAborted) {
+                return result;
+            }
+            const TrackId trackId(query.value(0));
+            result.trackSortOrder.insert(trackId, result.trackOrder.size());
+            result.trackOrder.append(trackId);
         }
-        trackIdToRows[rowInfo.trackId].push_back(i);
     }
-    // The number of unique tracks cannot be greater than the
-    // number of total rows returned by the query
-    DEBUG_ASSERT(trackIdToRows.size() <= rowInfos.size());
 
-    TrackPos2Row trackPosToRows;
-    if (hasPositionColumn()) {
-        // We expect as many positions as we have rows
-        trackPosToRows.reserve(rowInfos.size());
-        for (int i = 0; i < rowInfos.size(); ++i) {
-            const RowInfo& rowInfo = rowInfos[i];
-            trackPosToRows.insert(rowInfo.getPosition(posColumn), i);
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    if (!query.exec(queries.tableQuery)) {
+        LOG_FAILED_QUERY(query);
+        return result;
+    }
+    const QSqlRecord sqlRecord = query.record();
+    VERIFY_OR_DEBUG_ASSERT(sqlRecord.indexOf(queries.idColumn) == kIdColumn) {
+        return result;
+    }
+    if (queries.hasPositionColumn) {
+        result.posColumn = sqlRecord.indexOf(PLAYLISTTABLE_POSITION);
+    }
+    int rowCount = 0;
+    while (query.next()) {
+        if (++rowCount % kSelectRowsPerTimeCheck == 0 && *pAborted) {
+            return result;
         }
-        DEBUG_ASSERT(trackPosToRows.size() == rowInfos.size());
+        appendRow(&result.rowInfos, query, queries.columnCount);
     }
 
-    // We're done! Issue the update signals and replace the main maps.
+    if (!queries.trackSourceQuery.isEmpty()) {
+        for (const auto& rowInfo : std::as_const(result.rowInfos)) {
+            result.trackIds.insert(rowInfo.trackId);
+        }
+        result.queryRowInfos = result.rowInfos;
+        sortRows(&result.rowInfos, result.trackSortOrder, queries.trackSourceOrder);
+    }
+    indexRows(result.rowInfos,
+            result.posColumn,
+            &result.trackIdToRows,
+            &result.trackPosToRows);
+    result.ok = true;
+    return result;
+}
+
+// static
+BaseSqlTableModel::SelectResult BaseSqlTableModel::executeFirstPage(
+        SelectThread* pSelectThread,
+        const SelectQueries& queries,
+        const std::shared_ptr<std::atomic<bool>>& pAborted) {
+    SelectResult result;
+    if (*pAborted) {
+        return result;
+    }
+    const QSqlDatabase database = pSelectThread->database(queries.tempViews);
+    if (!database.isOpen()) {
+        return result;
+    }
+
+    QString firstPageQuery = queries.firstPageQuery;
+    QHash<TrackId, int> trackSortOrder;
+    if (!queries.firstPageIdsQuery.isEmpty()) {
+        QSqlQuery query(database);
+        if (!query.exec(queries.firstPageIdsQuery)) {
+            LOG_FAILED_QUERY(query);
+            return result;
+        }
+        QStringList idStrings;
+        while (query.next()) {
+            const TrackId trackId(query.value(0));
+            trackSortOrder.insert(trackId, idStrings.size());
+            idStrings.append(trackId.toString());
+        }
+        firstPageQuery = firstPageQuery.arg(idStrings.join(","));
+    }
+
+    QSqlQuery query(database);
+    if (!query.exec(firstPageQuery)) {
+        LOG_FAILED_QUERY(query);
+        return result;
+    }
+    if (queries.hasPositionColumn) {
+        result.posColumn = query.record().indexOf(PLAYLISTTABLE_POSITION);
+    }
+    while (query.next()) {
+        appendRow(&result.rowInfos, query, queries.columnCount);
+    }
+    if (!queries.firstPageIdsQuery.isEmpty()) {
+        sortRows(&result.rowInfos, trackSortOrder, true);
+    }
+    indexRows(result.rowInfos,
+            result.posColumn,
+            &result.trackIdToRows,
+            &result.trackPosToRows);
+    result.ok = true;
+    return result;
+}
+
+void BaseSqlTableModel::slotFirstPageSelected() {
+    VERIFY_OR_DEBUG_ASSERT(m_pFirstPageWatcher) {
+        return;
+    }
+    SelectResult result = m_pFirstPageWatcher->result();
+    m_pFirstPageWatcher->deleteLater();
+    m_pFirstPageWatcher = nullptr;
+    if (!result.ok) {
+        return;
+    }
+    if (sDebug) {
+        qDebug() << this << "select() returned first page with"
+                 << result.rowInfos.size() << "rows";
+    }
+    clearRows();
     replaceRows(
-            std::move(rowInfos),
-            std::move(trackIdToRows),
-            std::move(trackPosToRows));
-    // Both rowInfo and trackIdToRows (might) have been moved and
-    // must not be used afterwards!
+            std::move(result.rowInfos),
+            std::move(result.trackIdToRows),
+            std::move(result.trackPosToRows));
+}
+
+void BaseSqlTableModel::slotRowsSelected() {
+    VERIFY_OR_DEBUG_ASSERT(m_pSelectWatcher) {
+        return;
+    }
+    SelectResult result = m_pSelectWatcher->result();
+    m_pSelectWatcher->deleteLater();
+    m_pSelectWatcher = nullptr;
+    if (m_pFirstPageWatcher) {
+        // Too late
+        abortSelectWatcher(m_pFirstPageWatcher);
+        m_pFirstPageWatcher = nullptr;
+    }
+    if (!result.ok) {
+        // The first page must not remain as if it was the whole result
+        qWarning() << this << "select() failed on worker thread,"
+                   << "selecting the rows on the connection of the model";
+        if (beginSelect()) {
+            readPendingSelect(-1);
+            // Emits selectFinished()
+            finishPendingSelect();
+        } else {
+            emit selectFinished();
+        }
+        return;
+    }
+
+    if (m_trackSource) {
+        // Modified tracks are only known on this thread
+        if (m_trackSource->sortDirtyTracks(result.trackIds,
+                    m_currentSearch,
+                    m_currentSearchFilter,
+                    m_sortColumns,
+                    m_tableColumns.size() - 1, // exclude the 1st column with the id
+                    &result.trackOrder,
+                    &result.trackSortOrder)) {
+            result.rowInfos = std::move(result.queryRowInfos);
+            sortRows(&result.rowInfos,
+                    result.trackSortOrder,
+                    !m_trackSourceOrderBy.isEmpty());
+            result.trackIdToRows.clear();
+            result.trackPosToRows.clear();
+            indexRows(result.rowInfos,
+                    result.posColumn,
+                    &result.trackIdToRows,
+                    &result.trackPosToRows);
+        }
+        m_trackSortOrder = std::move(result.trackSortOrder);
+    }
+
+    clearRows();
+    replaceRows(
+            std::move(result.rowInfos),
+            std::move(result.trackIdToRows),
+            std::move(result.trackPosToRows));
 
     qDebug() << this << "select() returned" << m_rowInfo.size()
-             << "results in" << time.elapsed().debugMillisWithUnit();
+             << "results in" << m_selectTime.elapsed().debugMillisWithUnit();
+    emit selectFinished();
 }
 
 void BaseSqlTableModel::setTable(QString tableName,
@@ -363,6 +989,7 @@ void BaseSqlTableModel::setTable(QString tableName,
     if (sDebug) {
         qDebug() << this << "setTable" << tableName << tableColumns << idColumn;
     }
+    abortPendingSelect();
     m_tableName = std::move(tableName);
     m_idColumn = std::move(idColumn);
     m_tableColumns = std::move(tableColumns);
@@ -431,7 +1058,9 @@ void BaseSqlTableModel::search(const QString& searchText) {
         qDebug() << this << "search" << searchText;
     }
     setSearch(searchText);
-    select();
+    // Searching while typing must neither block the GUI on large libraries
+    // nor finish the queries of outdated search texts
+    selectAsync();
 }
 
 void BaseSqlTableModel::setSort(int column, Qt::SortOrder order) {
@@ -576,7 +1205,8 @@ void BaseSqlTableModel::sort(int column, Qt::SortOrder order) {
         qDebug() << this << "sort()" << column << order;
     }
     setSort(column, order);
-    select();
+    // Sorting a large library must not block the GUI
+    selectAsync();
 }
 
 int BaseSqlTableModel::rowCount(const QModelIndex& parent) const {
@@ -866,7 +1496,8 @@ void BaseSqlTableModel::removeTrackRows(const QSet<TrackId>& trackIdsToRemove) {
     // the tracks' positions in the playlist. We need to get the tracks' new
     // positions from the database, so let's do a select().
     // FIXME Update position without re-sorting
-    if (hasPositionColumn()) {
+    // A pending select() might still read the removed tracks.
+    if (hasPositionColumn() || isSelectPending()) {
         select();
         return;
     }
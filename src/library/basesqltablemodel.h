@@ -1,12 +1,19 @@
 #pragma once
 
+#include <QFutureWatcher>
 #include <QHash>
+#include <QSqlQuery>
+#include <QTimer>
+#include <atomic>
+#include <memory>
 
 #include "library/basetrackcache.h"
 #include "library/dao/trackdao.h"
 #include "library/basetracktablemodel.h"
 #include "library/columncache.h"
 #include "util/class.h"
+#include "util/db/dbconnectionpool.h"
+#include "util/performancetimer.h"
 
 class TrackCollectionManager;
 
@@ -71,6 +78,18 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     void select() override;
 
+    /// Aborts a search that is still reading the rows of its query and
+    /// waits until no worker thread reads the tables of the model anymore,
+    /// e.g. before dropping them.
+    void maybeStopModelPopulation() override;
+
+    /// Returns true while the rows of a search are read on a worker thread
+    /// or incrementally. selectFinished() is emitted once the rows have
+    /// been replaced.
+    bool isSelectPending() const {
+        return m_pPendingSelect != nullptr || m_pSelectWatcher != nullptr;
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // Inherited from BaseTrackTableModel
     ///////////////////////////////////////////////////////////////////////////
@@ -115,8 +134,14 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     int m_columnIndexBySortColumnId[static_cast<int>(TrackModel::SortColumnId::IdMax)];
     QMap<int, TrackModel::SortColumnId> m_sortColumnIdByColumnIndex;
 
+  signals:
+    void selectFinished();
+
   private slots:
     void tracksChanged(const QSet<TrackId>& trackIds);
+    void slotReadPendingSelect();
+    void slotFirstPageSelected();
+    void slotRowsSelected();
 
   private:
     void setTrackValueForColumn(
@@ -164,6 +189,102 @@ class BaseSqlTableModel : public BaseTrackTableModel {
             TrackId2Rows&& trackIdToRows,
             TrackPos2Row&& trackPosToRows);
 
+    // The query of a select() and the rows that have been read so far
+    struct PendingSelect {
+        QSqlQuery query;
+        QVector<RowInfo> rowInfos;
+        QSet<TrackId> trackIds;
+        int posColumn = -1;
+        PerformanceTimer time;
+    };
+
+    /// Executes the query and stores it in m_pPendingSelect. Aborts a
+    /// previous select() that is still pending.
+    bool beginSelect();
+    /// Reads the rows of the pending select() for at most
+    /// maxDurationMillis, or all of them if negative. Returns false
+    /// if there are rows left.
+    bool readPendingSelect(int maxDurationMillis);
+    /// Filters and sorts the rows that have been read and replaces the
+    /// rows of the model.
+    void finishPendingSelect();
+    /// Starts a select() that keeps the previous rows until all new rows
+    /// have been read in time slices from the event loop.
+    void selectIncrementally();
+    void abortPendingSelect();
+
+    static void appendRow(
+            QVector<RowInfo>* pRowInfos,
+            const QSqlQuery& query,
+            int columnCount);
+    /// Sorts the rows by the order of the track source and removes the rows
+    /// of tracks that don't match the search.
+    static void sortRows(
+            QVector<RowInfo>* pRowInfos,
+            const QHash<TrackId, int>& trackSortOrder,
+            bool trackSourceOrder);
+    static void indexRows(
+            const QVector<RowInfo>& rowInfos,
+            int posColumn,
+            TrackId2Rows* pTrackIdToRows,
+            TrackPos2Row* pTrackPosToRows);
+
+    class SelectThread;
+
+    struct TempView {
+        QString name;
+        QString sql;
+    };
+    // The queries of a select() on a worker thread. The worker has its
+    // own connection and recreates the temporary views of our connection
+    // that are referenced by the queries.
+    struct SelectQueries {
+        QList<TempView> tempViews;
+        QString tableQuery;
+        // Empty without a track source
+        QString trackSourceQuery;
+        bool trackSourceOrder = false;
+        // The ids of the first page in the order of the track source, if
+        // the page is not already ordered by firstPageQuery
+        QString firstPageIdsQuery;
+        QString firstPageQuery;
+        QString idColumn;
+        int columnCount = 0;
+        bool hasPositionColumn = false;
+    };
+    struct SelectResult {
+        // The sorted rows
+        QVector<RowInfo> rowInfos;
+        TrackId2Rows trackIdToRows;
+        TrackPos2Row trackPosToRows;
+        // The unsorted rows and the order of the track source for
+        // correcting the result with modified tracks
+        QVector<RowInfo> queryRowInfos;
+        QSet<TrackId> trackIds;
+        QVector<TrackId> trackOrder;
+        QHash<TrackId, int> trackSortOrder;
+        int posColumn = -1;
+        bool ok = false;
+    };
+    typedef QFutureWatcher<SelectResult> SelectWatcher;
+
+    /// Returns false if the rows can only be read on our connection, e.g.
+    /// if the table is a temporary table.
+    bool prepareSelectQueries(SelectQueries* pQueries) const;
+    /// Starts a select() that keeps the previous rows until the new rows
+    /// have been read and sorted on a worker thread. The first page of
+    /// the new rows is shown as soon as it is available.
+    void selectAsync();
+    static SelectResult executeSelect(
+            SelectThread* pSelectThread,
+            const SelectQueries& queries,
+            const std::shared_ptr<std::atomic<bool>>& pAborted);
+    static SelectResult executeFirstPage(
+            SelectThread* pSelectThread,
+            const SelectQueries& queries,
+            const std::shared_ptr<std::atomic<bool>>& pAborted);
+    void abortSelectWatcher(SelectWatcher* pWatcher);
+
     QVector<RowInfo> m_rowInfo;
 
     QString m_idColumn;
@@ -179,5 +300,16 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     QVector<QHash<int, QVariant>> m_headerInfo;
     QString m_trackSourceOrderBy;
 
+    std::unique_ptr<PendingSelect> m_pPendingSelect;
+    QTimer m_pendingSelectTimer;
+
+    std::shared_ptr<SelectThread> m_pSelectThread;
+    SelectWatcher* m_pSelectWatcher;
+    SelectWatcher* m_pFirstPageWatcher;
+    std::shared_ptr<std::atomic<bool>> m_pSelectAborted;
+    PerformanceTimer m_selectTime;
+    // Workers that might still read the tables after being aborted
+    QList<QFuture<SelectResult>> m_abortedSelects;
+
     DISALLOW_COPY_AND_ASSIGN(BaseSqlTableModel);
 };
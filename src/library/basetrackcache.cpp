@@ -39,6 +39,10 @@ BaseTrackCache::~BaseTrackCache() {
     // in header file
 }
 
+void BaseTrackCache::setSearchIndex(const TrackSearchIndexDAO* pSearchIndex) {
+    m_pQueryParser->setSearchIndex(pSearchIndex);
+}
+
 int BaseTrackCache::columnCount() const {
     return m_columnCount;
 }
@@ -446,37 +450,9 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     return fields.value(column, QVariant{});
 }
 
-void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
-                                   const QString& searchQuery,
-                                   const QString& extraFilter,
-                                   const QString& orderByClause,
-                                   const QList<SortColumn>& sortColumns,
-                                   const int columnOffset,
-                                   QHash<TrackId, int>* trackToIndex) {
-    // Skip processing if there are no tracks to filter or sort.
-    if (trackIds.size() == 0) {
-        return;
-    }
-
-    if (!m_bIndexBuilt) {
-        buildIndex();
-    }
-
-    // The id string we need for our QSqlQuery
-    QStringList idStrings;
-    // The id set we need for removing/adding dirty tracks
-    QSet<TrackId> ids;
-    // TODO(rryan) consider making this the data passed in and a separate
-    // QVector for output
-    QSet<TrackId> dirtyTracks;
-    for (const auto& trackId : trackIds) {
-        idStrings << trackId.toString();
-        ids << trackId;
-        if (m_dirtyTracks.contains(trackId)) {
-            dirtyTracks.insert(trackId);
-        }
-    }
-
+std::unique_ptr<QueryNode> BaseTrackCache::parseSearch(
+        const QString& searchQuery,
+        const QString& extraFilter) const {
     // Note: don't use the extraFilter for m_pQueryParser->parseQuery(), just
     // append it to searchQuery if not empty and let the parser construct
     // a SQL query from it.
@@ -489,10 +465,32 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         searchPlusExtraFilter += ' ';
         searchPlusExtraFilter += extraFilter;
     }
-    const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(searchPlusExtraFilter, QString());
+    return m_pQueryParser->parseQuery(searchPlusExtraFilter, QString());
+}
+
+QString BaseTrackCache::searchFilter(
+        const QString& searchQuery,
+        const QString& extraFilter) {
+    // The data of the filtered tracks is read from the index
+    if (!m_bIndexBuilt) {
+        buildIndex();
+    }
+    return parseSearch(searchQuery, extraFilter)->toSql();
+}
+
+void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
+                                   const QString& searchQuery,
+                                   const QString& extraFilter,
+                                   const QString& orderByClause,
+                                   const QList<SortColumn>& sortColumns,
+                                   const int columnOffset,
+                                   QHash<TrackId, int>* trackToIndex) {
+    // Skip processing if there are no tracks to filter or sort.
+    if (trackIds.size() == 0) {
+        return;
+    }
 
-    QString filter = pQuery->toSql();
+    QString filter = searchFilter(searchQuery, extraFilter);
     if (!filter.isEmpty()) {
         filter.prepend("WHERE ");
     }
@@ -534,6 +532,22 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         m_trackOrder.append(trackId);
     }
 
+    sortDirtyTracks(trackIds,
+            searchQuery,
+            extraFilter,
+            sortColumns,
+            columnOffset,
+            &m_trackOrder,
+            trackToIndex);
+}
+
+bool BaseTrackCache::sortDirtyTracks(const QSet<TrackId>& trackIds,
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        QVector<TrackId>* pTrackOrder,
+        QHash<TrackId, int>* trackToIndex) {
     // At this point, the original set of tracks have been divided into two
     // pieces: those that should be in the result set and those that should
     // not. Unfortunately, due to TrackDAO caching, there may be tracks in
@@ -542,11 +556,33 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     // would match or not match the given filter criteria. Once we correct the
     // membership of tracks in either set, we must then insertion-sort the
     // missing tracks into the resulting index list.
+    if (!m_bIsCaching) {
+        return false;
+    }
 
-    if (!m_bIsCaching || dirtyTracks.isEmpty()) {
-        return;
+    // TODO(rryan) consider making this the data passed in and a separate
+    // QVector for output
+    QSet<TrackId> dirtyTracks;
+    for (const auto& trackId : trackIds) {
+        if (m_dirtyTracks.contains(trackId)) {
+            dirtyTracks.insert(trackId);
+        }
     }
+    if (dirtyTracks.isEmpty()) {
+        return false;
+    }
+
+    if (!m_bIndexBuilt) {
+        buildIndex();
+    }
+
+    const bool searchPlusExtraFilterEmpty =
+            searchQuery.isEmpty() && extraFilter.isEmpty();
+    const std::unique_ptr<QueryNode> pQuery =
+            parseSearch(searchQuery, extraFilter);
 
+    QVector<TrackId>& trackOrder = *pTrackOrder;
+    bool modified = false;
     for (TrackId trackId : std::as_const(dirtyTracks)) {
         // Only get the track if it is in the cache.
         // Tracks that are not cached in memory cannot be dirty.
@@ -560,8 +596,9 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         // the search and extra filter are empty
         // or
         // the track matches the search and ids (if not empty) contains its id
-        bool shouldBeInResultSet = searchPlusExtraFilter.isEmpty() ||
-                ((ids.isEmpty() || ids.contains(trackId)) && pQuery->match(pTrack));
+        bool shouldBeInResultSet = searchPlusExtraFilterEmpty ||
+                ((trackIds.isEmpty() || trackIds.contains(trackId)) &&
+                        pQuery->match(pTrack));
 
         // If the track is in this result set.
         bool isInResultSet = trackToIndex->contains(trackId);
@@ -573,14 +610,14 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
             // will sort wrong).
             if (isInResultSet) {
                 int index = (*trackToIndex)[trackId];
-                m_trackOrder.remove(index);
+                trackOrder.remove(index);
                 // Don't update trackToIndex, since we do it below.
             }
 
             // Figure out where it is supposed to sort. The table is sorted by
             // the sort column, so we can binary search.
             int insertRow = findSortInsertionPoint(
-                    pTrack, sortColumns, columnOffset, m_trackOrder);
+                    pTrack, sortColumns, columnOffset, trackOrder);
 
             if (sDebug) {
                 qDebug() << this
@@ -589,26 +626,29 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
             }
 
             // The track should sort at insertRow
-            m_trackOrder.insert(insertRow, trackId);
+            trackOrder.insert(insertRow, trackId);
 
             trackToIndex->clear();
             // Fix the index. TODO(rryan) find a non-stupid way to do this.
-            for (int i = 0; i < m_trackOrder.size(); ++i) {
-                (*trackToIndex)[m_trackOrder[i]] = i;
+            for (int i = 0; i < trackOrder.size(); ++i) {
+                (*trackToIndex)[trackOrder[i]] = i;
             }
+            modified = true;
         } else if (isInResultSet) {
             // Track should not be in this result set, but it is. We need to
             // remove it.
             int index = (*trackToIndex)[trackId];
-            m_trackOrder.remove(index);
+            trackOrder.remove(index);
 
             trackToIndex->clear();
             // Fix the index. TODO(rryan) find a non-stupid way to do this.
-            for (int i = 0; i < m_trackOrder.size(); ++i) {
-                (*trackToIndex)[m_trackOrder[i]] = i;
+            for (int i = 0; i < trackOrder.size(); ++i) {
+                (*trackToIndex)[trackOrder[i]] = i;
             }
+            modified = true;
         }
     }
+    return modified;
 }
 
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
@@ -16,8 +16,10 @@
 #include "util/class.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackCollection;
+class TrackSearchIndexDAO;
 
 class SortColumn {
   public:
@@ -54,10 +56,21 @@ class BaseTrackCache : public QObject {
     // expensive on large tables.
     virtual void buildIndex();
 
+    // Use the full-text index for text searches. Only applicable if the
+    // table is a view on the internal library.
+    void setSearchIndex(const TrackSearchIndexDAO* pSearchIndex);
+
     ////////////////////////////////////////////////////////////////////////////
     // Data access methods
     ////////////////////////////////////////////////////////////////////////////
 
+    const QString& tableName() const {
+        return m_tableName;
+    }
+    const QString& idColumn() const {
+        return m_idColumn;
+    }
+
     virtual QVariant data(TrackId trackId, int column) const;
     virtual int columnCount() const;
     virtual int fieldIndex(const QString& column) const;
@@ -72,6 +85,23 @@ class BaseTrackCache : public QObject {
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
                                QHash<TrackId, int>* trackToIndex);
+    // Returns the SQL filter of the search and the extra filter for the
+    // table, empty if all tracks match. The table can also be filtered
+    // with it on another connection, e.g. on a worker thread. Builds the
+    // index if needed.
+    QString searchFilter(
+            const QString& searchQuery,
+            const QString& extraFilter);
+    // Corrects the result of filtering and sorting the table for tracks
+    // that have been modified but not saved yet, i.e. with values that
+    // differ from the database. Returns true if the order was modified.
+    bool sortDirtyTracks(const QSet<TrackId>& trackIds,
+            const QString& searchQuery,
+            const QString& extraFilter,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset,
+            QVector<TrackId>* pTrackOrder,
+            QHash<TrackId, int>* trackToIndex);
     virtual bool isCached(TrackId trackId) const;
     virtual void ensureCached(TrackId trackId);
 
@@ -87,6 +117,10 @@ class BaseTrackCache : public QObject {
     void slotTrackClean(TrackId trackId);
 
   private:
+    std::unique_ptr<QueryNode> parseSearch(
+            const QString& searchQuery,
+            const QString& extraFilter) const;
+
     const TrackPointer& getCachedTrack(TrackId trackId) const;
     void replaceRecentTrack(TrackPointer pTrack) const;
     void replaceRecentTrack(TrackId trackId, TrackPointer pTrack) const;
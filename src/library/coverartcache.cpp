@@ -5,6 +5,7 @@
 #include <QtConcurrentRun>
 #include <QtDebug>
 
+#include "library/coverartdiskcache.h"
 #include "moc_coverartcache.cpp"
 #include "track/track.h"
 #include "util/logger.h"
@@ -29,7 +30,18 @@ inline QImage resizeImageWidth(const QImage& image, int width) {
 
 } // anonymous namespace
 
-CoverArtCache::CoverArtCache() {
+CoverArtCache::CoverArtCache(const QString& diskCacheDirPath) {
+    if (!diskCacheDirPath.isEmpty()) {
+        m_pDiskCache = std::make_shared<const CoverArtDiskCache>(diskCacheDirPath);
+    }
+}
+
+void CoverArtCache::removeUnusedThumbnails(
+        const QSet<mixxx::cache_key_t>& cacheKeys) const {
+    if (!m_pDiskCache) {
+        return;
+    }
+    m_pDiskCache->removeUnusedImages(cacheKeys);
 }
 
 //static
@@ -174,7 +186,8 @@ void CoverArtCache::tryLoadCover(
             &CoverArtCache::loadCover,
             pTrack,
             coverInfo,
-            desiredWidth);
+            desiredWidth,
+            m_pDiskCache);
     connect(watcher,
             &QFutureWatcher<FutureResult>::finished,
             this,
@@ -187,7 +200,8 @@ void CoverArtCache::tryLoadCover(
 CoverArtCache::FutureResult CoverArtCache::loadCover(
         TrackPointer pTrack,
         CoverInfo coverInfo,
-        int desiredWidth) {
+        int desiredWidth,
+        const std::shared_ptr<const CoverArtDiskCache>& pDiskCache) {
     if (kLogger.traceEnabled()) {
         kLogger.trace()
                 << "loadCover"
@@ -200,6 +214,31 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
     auto res = FutureResult(
             coverInfo.cacheKey());
 
+    // The legacy hash is too short for addressing images on disk
+    const bool diskCacheable = pDiskCache &&
+            !coverInfo.imageDigest().isEmpty() &&
+            CoverArtDiskCache::bucketWidth(desiredWidth) > 0;
+    if (diskCacheable) {
+        QImage image = pDiskCache->loadImage(coverInfo.cacheKey(), desiredWidth);
+        if (!image.isNull()) {
+            if (kLogger.traceEnabled()) {
+                kLogger.trace()
+                        << "loadCover disk cache hit"
+                        << coverInfo;
+            }
+            CoverInfo::LoadedImage loadedImage(CoverInfo::LoadedImage::Result::Ok);
+            loadedImage.image = std::move(image);
+            loadedImage.location = pDiskCache->imageFilePath(
+                    coverInfo.cacheKey(),
+                    CoverArtDiskCache::bucketWidth(desiredWidth));
+            res.coverArt = CoverArt(
+                    std::move(coverInfo),
+                    std::move(loadedImage),
+                    desiredWidth);
+            return res;
+        }
+    }
+
     CoverInfo::LoadedImage loadedImage = coverInfo.loadImage(pTrack);
     if (!loadedImage.image.isNull()) {
         if (coverInfo.imageDigest().isEmpty()) {
@@ -216,6 +255,13 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
             }
         }
 
+        if (diskCacheable) {
+            pDiskCache->storeImage(
+                    coverInfo.cacheKey(),
+                    desiredWidth,
+                    loadedImage.image);
+        }
+
         // Resize image to requested size
         if (desiredWidth > 0) {
             // Adjust the cover size according to the request
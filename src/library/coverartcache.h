@@ -5,11 +5,14 @@
 #include <QPixmap>
 #include <QSet>
 #include <QtDebug>
+#include <memory>
 
 #include "library/coverart.h"
 #include "track/track_decl.h"
 #include "util/singleton.h"
 
+class CoverArtDiskCache;
+
 class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
     Q_OBJECT
   public:
@@ -37,6 +40,11 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const TrackPointer& pTrack,
             int desiredWidth);
 
+    /// Removes the thumbnails of covers that are not referenced by any
+    /// of the cacheKeys from the disk. Blocks the calling thread, which
+    /// should not be the GUI thread.
+    void removeUnusedThumbnails(const QSet<mixxx::cache_key_t>& cacheKeys) const;
+
     // Only public for testing
     struct FutureResult {
         FutureResult()
@@ -54,7 +62,8 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
     static FutureResult loadCover(
             TrackPointer pTrack,
             CoverInfo coverInfo,
-            int desiredWidth);
+            int desiredWidth,
+            const std::shared_ptr<const CoverArtDiskCache>& pDiskCache = nullptr);
 
   private slots:
     // Called when loadCover is complete in the main thread.
@@ -67,7 +76,8 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const QPixmap& pixmap);
 
   protected:
-    CoverArtCache();
+    /// Thumbnails are only stored on disk if a directory is provided.
+    explicit CoverArtCache(const QString& diskCacheDirPath = QString());
     ~CoverArtCache() override = default;
     friend class Singleton<CoverArtCache>;
 
@@ -89,4 +99,7 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
         int desiredWidth;
     };
     QMultiHash<mixxx::cache_key_t, RequestData> m_runningRequests;
+
+    // Shared with the worker threads that might outlive the singleton
+    std::shared_ptr<const CoverArtDiskCache> m_pDiskCache;
 };
@@ -0,0 +1,175 @@
+#include "library/coverartdiskcache.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <utility>
+
+#include "util/cachedir.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CoverArtDiskCache");
+
+// The cover column of the library table is narrow. Larger covers are
+// only requested by the skin widgets, which are updated rarely.
+constexpr int kBucketWidths[] = {64, 128, 256, 512};
+
+// JPEG is the fastest format to decode. Artifacts are not visible
+// after downscaling from the bucket width.
+const char* const kImageFormat = "JPG";
+constexpr int kImageQuality = 90;
+
+const QString kImageFileSuffix = QStringLiteral("jpg");
+
+// The thumbnails of all buckets take about 100 KB per cover
+constexpr qint64 kSizeLimitBytes = 256 * 1024 * 1024;
+
+// Checking the size needs to list all files, which is only done after
+// storing a batch of new thumbnails
+constexpr int kStoredImagesBetweenSizeChecks = 256;
+
+// PNG images are decoded with an alpha channel even if they
+// don't use it
+bool isOpaque(const QImage& image) {
+    if (!image.hasAlphaChannel()) {
+        return true;
+    }
+    const QImage argbImage = image.convertToFormat(QImage::Format_ARGB32);
+    for (int y = 0; y < argbImage.height(); ++y) {
+        const auto* pLine = reinterpret_cast<const QRgb*>(argbImage.constScanLine(y));
+        for (int x = 0; x < argbImage.width(); ++x) {
+            if (qAlpha(pLine[x]) != 255) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+CoverArtDiskCache::CoverArtDiskCache(QString dirPath)
+        : m_dirPath(std::move(dirPath)),
+          m_storedImageCount(0) {
+}
+
+//static
+int CoverArtDiskCache::bucketWidth(int desiredWidth) {
+    if (desiredWidth <= 0) {
+        // Original size
+        return 0;
+    }
+    for (const int bucketWidth : kBucketWidths) {
+        if (desiredWidth <= bucketWidth) {
+            return bucketWidth;
+        }
+    }
+    return 0;
+}
+
+QString CoverArtDiskCache::imageFilePath(
+        mixxx::cache_key_t cacheKey,
+        int bucketWidth) const {
+    const QString fileName =
+            QStringLiteral("%1").arg(cacheKey, 16, 16, QChar('0'));
+    // Spread the files over subdirectories to keep the directories
+    // small for large libraries
+    return QDir(m_dirPath).filePath(
+            QString::number(bucketWidth) + QChar('/') +
+            fileName.left(2) + QChar('/') +
+            fileName + QChar('.') + kImageFileSuffix);
+}
+
+QImage CoverArtDiskCache::loadImage(
+        mixxx::cache_key_t cacheKey,
+        int desiredWidth) const {
+    const int width = bucketWidth(desiredWidth);
+    if (width <= 0) {
+        return QImage();
+    }
+    QImage image;
+    const QString filePath = imageFilePath(cacheKey, width);
+    if (!image.load(filePath, kImageFormat)) {
+        return QImage();
+    }
+    mixxx::cachedir::touchFile(filePath);
+    if (image.width() != desiredWidth) {
+        image = image.scaledToWidth(desiredWidth, Qt::SmoothTransformation);
+    }
+    return image;
+}
+
+void CoverArtDiskCache::storeImage(
+        mixxx::cache_key_t cacheKey,
+        int desiredWidth,
+        const QImage& image) const {
+    const int width = bucketWidth(desiredWidth);
+    if (width <= 0 || image.isNull()) {
+        return;
+    }
+    // Small images are never upscaled, that is done when loading them
+    const QImage thumbnail = image.width() > width
+            ? image.scaledToWidth(width, Qt::SmoothTransformation)
+            : image;
+    if (!isOpaque(thumbnail)) {
+        // Transparency would get lost, the cover is decoded again
+        // on the next request
+        return;
+    }
+    const QString filePath = imageFilePath(cacheKey, width);
+    if (!QDir().mkpath(QFileInfo(filePath).path())) {
+        kLogger.warning()
+                << "Failed to create directory for"
+                << filePath;
+        return;
+    }
+    // Replaces the file atomically, another thread might read it
+    // concurrently
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) ||
+            !thumbnail.save(&file, kImageFormat, kImageQuality) ||
+            !file.commit()) {
+        kLogger.warning()
+                << "Failed to store cover art thumbnail"
+                << filePath;
+        return;
+    }
+    if (++m_storedImageCount % kStoredImagesBetweenSizeChecks == 0) {
+        removeLeastRecentlyUsedImages();
+    }
+}
+
+void CoverArtDiskCache::removeUnusedImages(
+        const QSet<mixxx::cache_key_t>& cacheKeys) const {
+    int removedCount = 0;
+    QDirIterator it(m_dirPath,
+            QStringList{QStringLiteral("*.") + kImageFileSuffix},
+            QDir::Files,
+            QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString filePath = it.next();
+        bool ok = false;
+        const mixxx::cache_key_t cacheKey =
+                it.fileInfo().completeBaseName().toULongLong(&ok, 16);
+        if (ok && cacheKeys.contains(cacheKey)) {
+            continue;
+        }
+        if (QFile::remove(filePath)) {
+            ++removedCount;
+        }
+    }
+    if (removedCount > 0) {
+        kLogger.info()
+                << "Removed" << removedCount
+                << "unused cover art thumbnails";
+    }
+    removeLeastRecentlyUsedImages();
+}
+
+void CoverArtDiskCache::removeLeastRecentlyUsedImages() const {
+    mixxx::cachedir::removeLeastRecentlyUsedFiles(m_dirPath, kSizeLimitBytes);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QImage>
+#include <QSet>
+#include <QString>
+#include <atomic>
+
+#include "util/cache.h"
+
+/// Persistent store of cover art thumbnails that survives restarts,
+/// so that the cover column of the library table doesn't need to
+/// extract and decode all the full-size images again.
+///
+/// Thumbnails are addressed by the cache key of the image digest
+/// and stored in a few fixed size buckets. Images are never updated
+/// in place: a modified cover results in a new digest and thus in a
+/// new file. The file system is the index, a lookup needs a single
+/// open() without any shared state. All functions are thread-safe.
+///
+/// The size of the directory is limited. The least recently used
+/// thumbnails are removed after storing new ones exceeds the limit.
+class CoverArtDiskCache final {
+  public:
+    explicit CoverArtDiskCache(QString dirPath);
+
+    /// The width of the bucket that stores thumbnails of the
+    /// desired width. 0 if the width is too large to be cached.
+    static int bucketWidth(int desiredWidth);
+
+    /// Returns the thumbnail scaled to the desired width or a null
+    /// image if it has not been stored yet.
+    QImage loadImage(
+            mixxx::cache_key_t cacheKey,
+            int desiredWidth) const;
+
+    /// Stores the thumbnail of the full-size image in the bucket
+    /// of the desired width.
+    void storeImage(
+            mixxx::cache_key_t cacheKey,
+            int desiredWidth,
+            const QImage& image) const;
+
+    /// Removes the thumbnails of all images that are not contained in
+    /// cacheKeys, e.g. the covers of tracks that have been removed from
+    /// the library. Then enforces the size limit.
+    void removeUnusedImages(
+            const QSet<mixxx::cache_key_t>& cacheKeys) const;
+
+    /// The path of the thumbnail file, only public for testing.
+    QString imageFilePath(
+            mixxx::cache_key_t cacheKey,
+            int bucketWidth) const;
+
+  private:
+    void removeLeastRecentlyUsedImages() const;
+
+    const QString m_dirPath;
+
+    mutable std::atomic<int> m_storedImageCount;
+};
@@ -8,15 +8,51 @@
 #include "preferences/waveformsettings.h"
 #include "util/performancetimer.h"
 #include "waveform/waveform.h"
+#include "waveform/waveformfactory.h"
 
 const QString AnalysisDao::s_analysisTableName = "track_analysis";
 
+namespace {
+
 // For a track that takes 1.2MB to store the big waveform, the default
 // compression level (-1) takes the size down to about 600KB. The difference
 // between the default and 9 (the max) was only about 1-2KB for a lot of extra
 // CPU time so I think we should stick with the default. rryan 4/3/2012
 constexpr int kCompressionLevel = -1;
 
+int dataChecksum(const QByteArray& data) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return qChecksum(data);
+#else
+    return qChecksum(data.constData(), data.length());
+#endif
+}
+
+// Waveforms in the binary format are stored uncompressed, so that they can
+// be mapped into memory. Only the header is covered by the checksum, which
+// allows to validate the file without reading all of it.
+int fileChecksum(const QByteArray& fileData) {
+    if (Waveform::isBinary(fileData)) {
+        return dataChecksum(fileData.left(Waveform::kBinaryHeaderSize));
+    }
+    return dataChecksum(fileData);
+}
+
+bool isCurrentWaveformVersion(const AnalysisDao::AnalysisInfo& info) {
+    switch (info.type) {
+    case AnalysisDao::TYPE_WAVEFORM:
+        return WaveformFactory::waveformVersionToVersionClass(info.version) ==
+                WaveformFactory::VC_USE;
+    case AnalysisDao::TYPE_WAVESUMMARY:
+        return WaveformFactory::waveformSummaryVersionToVersionClass(info.version) ==
+                WaveformFactory::VC_USE;
+    default:
+        return false;
+    }
+}
+
+} // anonymous namespace
+
 AnalysisDao::AnalysisDao(UserSettingsPointer pConfig)
         : m_pConfig(pConfig) {
     QDir storagePath = getAnalysisStoragePath();
@@ -84,24 +120,36 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
         int checksum = query->value(dataChecksumColumn).toInt();
         QString dataPath = analysisPath.absoluteFilePath(
             QString::number(info.analysisId));
-        const QByteArray compressedData = loadDataFromFile(dataPath);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        const int file_checksum = qChecksum(
-                compressedData);
-#else
-        const int file_checksum = qChecksum(
-                compressedData.constData(),
-                compressedData.length());
-#endif
+        // Waveforms in the binary format are mapped into memory on demand,
+        // reading the header is sufficient to validate them.
+        QByteArray fileData = loadDataFromFile(dataPath, Waveform::kBinaryHeaderSize);
+        if (!Waveform::isBinary(fileData)) {
+            fileData = loadDataFromFile(dataPath);
+        }
+        const int file_checksum = fileChecksum(fileData);
         if (checksum != file_checksum) {
             qDebug() << "WARNING: Corrupt analysis loaded from" << dataPath
-                     << "length" << compressedData.length();
+                     << "length" << fileData.length();
             continue;
         }
-        info.data = qUncompress(compressedData);
-        bytes += info.data.length();
+        if (Waveform::isBinary(fileData)) {
+            info.binaryDataPath = dataPath;
+        } else {
+            info.data = qUncompress(fileData);
+            bytes += info.data.length();
+        }
         analyses.append(info);
     }
+
+    // Lazily convert waveforms from the protobuf format. Subsequent loads
+    // only need to map the converted files into memory. Waveforms of other
+    // versions are kept as is for older versions of Mixxx.
+    for (auto& info : analyses) {
+        if (info.binaryDataPath.isEmpty() && isCurrentWaveformVersion(info)) {
+            convertToBinary(&info,
+                    analysisPath.absoluteFilePath(QString::number(info.analysisId)));
+        }
+    }
     qDebug() << "AnalysisDAO fetched" << analyses.size() << "analyses,"
              << bytes << "bytes for track"
              << trackId << "in" << time.elapsed().debugMillisWithUnit();
@@ -120,15 +168,10 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
     PerformanceTimer time;
     time.start();
 
-    const QByteArray compressedData = qCompress(info->data, kCompressionLevel);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-    const int checksum = qChecksum(
-            compressedData);
-#else
-    const int checksum = qChecksum(
-            compressedData.constData(),
-            compressedData.length());
-#endif
+    const QByteArray fileData = Waveform::isBinary(info->data)
+            ? info->data
+            : qCompress(info->data, kCompressionLevel);
+    const int checksum = fileChecksum(fileData);
     QSqlQuery query(m_database);
     if (info->analysisId == -1) {
         query.prepare(QString(
@@ -172,14 +215,14 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
 
     QString dataPath = getAnalysisStoragePath().absoluteFilePath(
         QString::number(info->analysisId));
-    if (!saveDataToFile(dataPath, compressedData)) {
+    if (!saveDataToFile(dataPath, fileData)) {
         qDebug() << "WARNING: Couldn't save analysis data to file" << dataPath;
         return false;
     }
 
     qDebug() << "AnalysisDAO saved analysis" << info->analysisId
-             << QString("%1 (%2 compressed)").arg(QString::number(info->data.length()),
-                                                  QString::number(compressedData.length()))
+             << QString("%1 (%2 stored)").arg(QString::number(info->data.length()),
+                                              QString::number(fileData.length()))
              << "bytes for track"
              << info->trackId << "in" << time.elapsed().debugMillisWithUnit();
     return true;
@@ -262,7 +305,7 @@ QDir AnalysisDao::getAnalysisStoragePath() const {
     return dir.absolutePath().append("/");
 }
 
-QByteArray AnalysisDao::loadDataFromFile(const QString& filename) const {
+QByteArray AnalysisDao::loadDataFromFile(const QString& filename, qint64 maxSize) const {
     QFile file(filename);
     if (!file.exists()) {
         return QByteArray();
@@ -270,9 +313,47 @@ QByteArray AnalysisDao::loadDataFromFile(const QString& filename) const {
     if (!file.open(QIODevice::ReadOnly)) {
         return QByteArray();
     }
+    if (maxSize >= 0) {
+        return file.read(maxSize);
+    }
     return file.readAll();
 }
 
+bool AnalysisDao::convertToBinary(AnalysisInfo* info, const QString& dataPath) {
+    PerformanceTimer time;
+    time.start();
+
+    const Waveform waveform(info->data);
+    if (waveform.saveState() != Waveform::SaveState::Saved) {
+        // Failed to parse, the waveform will be analyzed again
+        return false;
+    }
+    const QByteArray binaryData = waveform.toBinary();
+
+    QSqlQuery query(m_database);
+    query.prepare(QString(
+        "UPDATE %1 SET data_checksum = :data_checksum "
+        "WHERE id = :analysisId").arg(s_analysisTableName));
+    query.bindValue(":analysisId", info->analysisId);
+    query.bindValue(":data_checksum", fileChecksum(binaryData));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "couldn't update analysis checksum";
+        return false;
+    }
+    // The existing file is replaced, not overwritten
+    if (!saveDataToFile(dataPath, binaryData)) {
+        qDebug() << "WARNING: Couldn't save converted analysis data to file" << dataPath;
+        return false;
+    }
+
+    qDebug() << "AnalysisDAO converted analysis" << info->analysisId
+             << "into the binary format for track"
+             << info->trackId << "in" << time.elapsed().debugMillisWithUnit();
+    info->data.clear();
+    info->binaryDataPath = dataPath;
+    return true;
+}
+
 bool AnalysisDao::deleteFile(const QString& fileName) const {
     QFile file(fileName);
     return file.remove();
@@ -340,7 +421,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVEFORM;
     analysis.description = pWaveform->getDescription();
     analysis.version = pWaveform->getVersion();
-    analysis.data = pWaveform->toByteArray();
+    analysis.data = pWaveform->toBinary();
     bool success = saveAnalysis(&analysis);
     if (success) {
         pWaveform->setSaveState(Waveform::SaveState::Saved);
@@ -355,7 +436,7 @@ void AnalysisDao::saveTrackAnalyses(
     analysis.type = AnalysisDao::TYPE_WAVESUMMARY;
     analysis.description = pWaveSummary->getDescription();
     analysis.version = pWaveSummary->getVersion();
-    analysis.data = pWaveSummary->toByteArray();
+    analysis.data = pWaveSummary->toBinary();
 
     success = saveAnalysis(&analysis);
     if (success) {
@@ -30,6 +30,9 @@ class AnalysisDao : public DAO {
         QString description;
         QString version;
         QByteArray data;
+        // Waveforms in the binary format are not loaded into data. Instead
+        // the file is mapped into memory when loading the waveform.
+        QString binaryDataPath;
     };
 
     explicit AnalysisDao(UserSettingsPointer pConfig);
@@ -59,9 +62,10 @@ class AnalysisDao : public DAO {
 
   private:
     QDir getAnalysisStoragePath() const;
-    QByteArray loadDataFromFile(const QString& fileName) const;
+    QByteArray loadDataFromFile(const QString& fileName, qint64 maxSize = -1) const;
     bool saveDataToFile(const QString& fileName, const QByteArray& data) const;
     bool deleteFile(const QString& filename) const;
+    bool convertToBinary(AnalysisInfo* info, const QString& dataPath);
     QList<AnalysisInfo> loadAnalysesFromQuery(TrackId trackId, QSqlQuery* query);
 
     const UserSettingsPointer m_pConfig;
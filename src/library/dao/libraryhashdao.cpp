@@ -147,6 +147,40 @@ void LibraryHashDAO::invalidateAllDirectories() {
     }
 }
 
+void LibraryHashDAO::invalidateDirectories(const QStringList& dirPaths) {
+    FieldEscaper escaper(m_database);
+    QStringList escapedDirPaths = escaper.escapeStrings(dirPaths);
+
+    QSqlQuery query(m_database);
+    query.prepare(
+            QString("UPDATE LibraryHashes "
+                    "SET needs_verification=1 "
+                    "WHERE directory_path IN (%1)")
+                    .arg(escapedDirPaths.join(",")));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query)
+                << "Couldn't mark directories as needing verification.";
+    }
+}
+
+void LibraryHashDAO::invalidateDirectoryTrees(const QStringList& dirPaths) {
+    // Compare the prefix instead of using LIKE that would require to
+    // escape the wildcard characters in the paths
+    QSqlQuery query(m_database);
+    query.prepare("UPDATE LibraryHashes "
+                  "SET needs_verification=1 "
+                  "WHERE directory_path=:directory_path OR "
+                  "substr(directory_path,1,length(:prefix))=:prefix");
+    for (const auto& dirPath : dirPaths) {
+        query.bindValue(":directory_path", dirPath);
+        query.bindValue(":prefix", QString(dirPath + QChar('/')));
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query)
+                    << "Couldn't mark directory tree as needing verification.";
+        }
+    }
+}
+
 void LibraryHashDAO::markUnverifiedDirectoriesAsDeleted() {
     //qDebug() << "LibraryHashDAO::markUnverifiedDirectoriesAsDeleted"
     //<< QThread::currentThread() << m_database.connectionName();
@@ -185,3 +219,35 @@ QStringList LibraryHashDAO::getDeletedDirectories() {
     }
     return result;
 }
+
+QStringList LibraryHashDAO::getChangedDirectories() {
+    QStringList result;
+    QSqlQuery query(m_database);
+    query.prepare("SELECT directory_path FROM LibraryChanges");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+    const int directoryPathColumn = query.record().indexOf("directory_path");
+    while (query.next()) {
+        result << query.value(directoryPathColumn).toString();
+    }
+    return result;
+}
+
+void LibraryHashDAO::addChangedDirectory(const QString& dirPath) {
+    QSqlQuery query(m_database);
+    query.prepare("INSERT OR IGNORE INTO LibraryChanges (directory_path) "
+                  "VALUES (:directory_path)");
+    query.bindValue(":directory_path", dirPath);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "Journaling changed directory failed.";
+    }
+}
+
+void LibraryHashDAO::removeChangedDirectories() {
+    QSqlQuery query(m_database);
+    query.prepare("DELETE FROM LibraryChanges");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+}
@@ -18,9 +18,18 @@ class LibraryHashDAO : public DAO {
                              int dir_deleted);
     void markAsExisting(const QString& dirPath);
     void invalidateAllDirectories();
+    void invalidateDirectories(const QStringList& dirPaths);
+    /// Also invalidates all subdirectories, e.g. of a directory that has
+    /// been deleted or moved.
+    void invalidateDirectoryTrees(const QStringList& dirPaths);
     void markUnverifiedDirectoriesAsDeleted();
     void removeDeletedDirectoryHashes();
     void updateDirectoryStatuses(const QStringList& dirPaths,
                                  const bool deleted, const bool verified);
     QStringList getDeletedDirectories();
+
+    // Journal of directories that have been changed since the last scan
+    QStringList getChangedDirectories();
+    void addChangedDirectory(const QString& dirPath);
+    void removeChangedDirectories();
 };
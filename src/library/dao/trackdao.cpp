@@ -17,6 +17,7 @@
 #include "library/dao/libraryhashdao.h"
 #include "library/dao/playlistdao.h"
 #include "library/dao/trackschema.h"
+#include "library/dao/tracksearchindexdao.h"
 #include "library/library_prefs.h"
 #include "library/queryutil.h"
 #include "moc_trackdao.cpp"
@@ -92,11 +93,13 @@ TrackDAO::TrackDAO(CueDAO& cueDao,
                    PlaylistDAO& playlistDao,
                    AnalysisDao& analysisDao,
                    LibraryHashDAO& libraryHashDao,
+                   TrackSearchIndexDAO& trackSearchIndexDao,
                    UserSettingsPointer pConfig)
         : m_cueDao(cueDao),
           m_playlistDao(playlistDao),
           m_analysisDao(analysisDao),
           m_libraryHashDao(libraryHashDao),
+          m_trackSearchIndexDao(trackSearchIndexDao),
           m_pConfig(pConfig),
           m_trackLocationIdColumn(UndefinedRecordIndex),
           m_queryLibraryIdColumn(UndefinedRecordIndex),
@@ -317,6 +320,34 @@ QSet<QString> TrackDAO::getAllExistingTrackLocations() const {
     return collectTrackLocations(query);
 }
 
+QHash<QString, TrackFileFingerprint> TrackDAO::getAllTrackFileFingerprints() const {
+    FwdSqlQuery query(m_database,
+            QStringLiteral("SELECT track_locations.location,"
+                           "track_locations.filesize,"
+                           "track_locations.fs_modified_ms "
+                           "FROM track_locations "
+                           "INNER JOIN library "
+                           "ON library.location = track_locations.id"));
+    VERIFY_OR_DEBUG_ASSERT(!query.hasError() && query.execPrepared()) {
+        LOG_FAILED_QUERY(query);
+        return {};
+    }
+    QHash<QString, TrackFileFingerprint> fingerprints;
+    const int locationColumn = query.record().indexOf(LIBRARYTABLE_LOCATION);
+    const int fileSizeColumn = query.record().indexOf(TRACKLOCATIONSTABLE_FILESIZE);
+    const int modifiedColumn = query.record().indexOf(TRACKLOCATIONSTABLE_FSMODIFIED);
+    while (query.next()) {
+        const QVariant modified = query.fieldValue(modifiedColumn);
+        fingerprints.insert(query.fieldValue(locationColumn).toString(),
+                modified.isNull()
+                        ? TrackFileFingerprint()
+                        : TrackFileFingerprint(
+                                  query.fieldValue(fileSizeColumn).toLongLong(),
+                                  modified.toLongLong()));
+    }
+    return fingerprints;
+}
+
 QSet<QString> TrackDAO::getAllMissingTrackLocations() const {
     FwdSqlQuery query(m_database, QStringLiteral("SELECT track_locations.location "
                                                  "FROM library INNER JOIN track_locations "
@@ -329,6 +360,28 @@ QSet<QString> TrackDAO::getAllMissingTrackLocations() const {
     return collectTrackLocations(query);
 }
 
+QSet<mixxx::cache_key_t> TrackDAO::getAllCoverArtCacheKeys() const {
+    FwdSqlQuery query(m_database,
+            QStringLiteral("SELECT DISTINCT coverart_digest,coverart_hash "
+                           "FROM library WHERE coverart_type<>%1")
+                    .arg(QString::number(static_cast<int>(CoverInfo::NONE))));
+    VERIFY_OR_DEBUG_ASSERT(!query.hasError() && query.execPrepared()) {
+        LOG_FAILED_QUERY(query);
+        return {};
+    }
+    QSet<mixxx::cache_key_t> cacheKeys;
+    while (query.next()) {
+        const QByteArray digest = query.fieldValue(0).toByteArray();
+        if (digest.isEmpty()) {
+            // Legacy fallback, see CoverInfo::cacheKey()
+            cacheKeys.insert(static_cast<quint16>(query.fieldValue(1).toUInt()));
+        } else {
+            cacheKeys.insert(CoverImageUtils::cacheKeyFromDigest(digest));
+        }
+    }
+    return cacheKeys;
+}
+
 // Some code (eg. drag and drop) needs to just get a track's location, and it's
 // not worth retrieving a whole Track.
 QString TrackDAO::getTrackLocation(TrackId trackId) const {
@@ -379,6 +432,9 @@ bool TrackDAO::saveTrack(Track* pTrack) const {
 }
 
 void TrackDAO::slotDatabaseTracksChanged(const QSet<TrackId>& changedTrackIds) {
+    // The tracks have been modified directly in the database, bypassing
+    // the hooks that maintain the search index
+    m_trackSearchIndexDao.updateOutdatedTracks();
     if (!changedTrackIds.isEmpty()) {
         emit tracksChanged(changedTrackIds);
     }
@@ -400,6 +456,9 @@ void TrackDAO::slotDatabaseTracksRelocated(const QList<RelocatedTrack>& relocate
     }
     DEBUG_ASSERT(removedTrackIds.size() <= changedTrackIds.size());
     DEBUG_ASSERT(!removedTrackIds.intersects(changedTrackIds));
+    // The locations of the changed tracks are part of the search index
+    m_trackSearchIndexDao.removeTracks(removedTrackIds.values());
+    m_trackSearchIndexDao.updateTracks(changedTrackIds.values());
     if (!removedTrackIds.isEmpty()) {
         emit tracksRemoved(removedTrackIds);
     }
@@ -428,9 +487,11 @@ void TrackDAO::addTracksPrepare() {
 
     m_pQueryTrackLocationInsert->prepare("INSERT INTO track_locations "
             "("
-            "location,directory,filename,filesize,fs_deleted,needs_verification"
+            "location,directory,filename,filesize,fs_modified_ms,"
+            "fs_deleted,needs_verification"
             ") VALUES ("
-            ":location,:directory,:filename,:filesize,:fs_deleted,:needs_verification"
+            ":location,:directory,:filename,:filesize,:fs_modified_ms,"
+            ":fs_deleted,:needs_verification"
             ")");
 
     m_pQueryTrackLocationSelect->prepare("SELECT id FROM track_locations WHERE location=:location");
@@ -550,6 +611,8 @@ void TrackDAO::addTracksFinish(bool rollback) {
             m_pTransaction->rollback();
             m_tracksAddedSet.clear();
         } else {
+            // Index all added tracks at once within the same transaction
+            m_trackSearchIndexDao.updateTracks(m_tracksAddedSet.values());
             m_pTransaction->commit();
         }
     }
@@ -572,7 +635,13 @@ bool insertTrackLocation(
     pTrackLocationInsert->bindValue(":location", fileInfo.location());
     pTrackLocationInsert->bindValue(":directory", fileInfo.locationPath());
     pTrackLocationInsert->bindValue(":filename", fileInfo.fileName());
+    const auto fingerprint = TrackFileFingerprint::fromFileInfo(fileInfo.asQFileInfo());
     pTrackLocationInsert->bindValue(":filesize", fileInfo.sizeInBytes());
+    if (fingerprint.isValid()) {
+        pTrackLocationInsert->bindValue(":fs_modified_ms", fingerprint.lastModifiedMillis());
+    } else {
+        pTrackLocationInsert->bindValue(":fs_modified_ms", QVariant());
+    }
     pTrackLocationInsert->bindValue(":fs_deleted", 0);
     pTrackLocationInsert->bindValue(":needs_verification", 0);
     if (pTrackLocationInsert->exec()) {
@@ -872,7 +941,8 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
 
 TrackPointer TrackDAO::addTracksAddFile(
         const QString& filePath,
-        bool unremove) {
+        bool unremove,
+        const SoundSourceProxy::ImportedMetadata* pImportedMetadata) {
     const auto fileAccess = mixxx::FileAccess(mixxx::FileInfo(filePath));
     // Check that track is a supported extension.
     // TODO(uklotzde): The following check can be skipped if
@@ -940,7 +1010,8 @@ TrackPointer TrackDAO::addTracksAddFile(
     // from the file.
     SoundSourceProxy(pTrack).updateTrackFromSource(
             SoundSourceProxy::UpdateTrackFromSourceMode::Once,
-            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig),
+            pImportedMetadata);
     if (!pTrack->checkSourceSynchronized()) {
         kLogger.warning() << "addTracksAddFile:"
                           << "Failed to parse track metadata from file"
@@ -1116,6 +1187,7 @@ bool TrackDAO::onPurgingTracks(
             return false;
         }
     }
+    m_trackSearchIndexDao.removeTracks(trackIds);
     {
         // invalidate the hash in LibraryHash,
         // in case the file was not deleted to detect it on a rescan
@@ -1771,6 +1843,7 @@ bool TrackDAO::updateTrack(const Track& track) const {
             track.getWaveformSummary());
     m_cueDao.saveTrackCues(
             trackId, track.getCuePoints());
+    m_trackSearchIndexDao.updateTracks({trackId});
     transaction.commit();
 
     // kLogger.debug() << "Update track in database took: " <<
@@ -1816,6 +1889,39 @@ void TrackDAO::invalidateTrackLocationsInLibrary() const {
     }
 }
 
+void TrackDAO::invalidateTrackLocationsInDirectories(const QStringList& directories) const {
+    QSqlQuery query(m_database);
+    query.prepare(QString("UPDATE track_locations "
+                          "SET needs_verification=1 "
+                          "WHERE directory IN (%1)")
+                          .arg(SqlStringFormatter::formatList(m_database, directories)));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query)
+                << "Couldn't mark tracks in" << directories.size()
+                << "directories as needing verification.";
+        DEBUG_ASSERT(!"Failed query");
+    }
+}
+
+void TrackDAO::invalidateTrackLocationsInDirectoryTrees(const QStringList& directories) const {
+    QSqlQuery query(m_database);
+    query.prepare(
+            "UPDATE track_locations "
+            "SET needs_verification=1 "
+            "WHERE directory=:directory OR "
+            "substr(directory,1,length(:prefix))=:prefix");
+    for (const auto& directory : directories) {
+        query.bindValue(":directory", directory);
+        query.bindValue(":prefix", QString(directory + QChar('/')));
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query)
+                    << "Couldn't mark tracks in" << directory
+                    << "as needing verification.";
+            DEBUG_ASSERT(!"Failed query");
+        }
+    }
+}
+
 void TrackDAO::markTrackLocationsAsVerified(const QStringList& locations) const {
     // kLogger.debug()<< "markTrackLocationsAsVerified" <<
     // QThread::currentThread() << m_database.connectionName();
@@ -1849,6 +1955,25 @@ void TrackDAO::markTracksInDirectoriesAsVerified(const QStringList& directories)
     }
 }
 
+void TrackDAO::updateTrackFileFingerprint(
+        const QString& location,
+        const TrackFileFingerprint& fingerprint) const {
+    DEBUG_ASSERT(fingerprint.isValid());
+    QSqlQuery query(m_database);
+    query.prepare(
+            "UPDATE track_locations "
+            "SET filesize=:filesize, fs_modified_ms=:fs_modified_ms "
+            "WHERE location=:location");
+    query.bindValue(":filesize", fingerprint.sizeInBytes());
+    query.bindValue(":fs_modified_ms", fingerprint.lastModifiedMillis());
+    query.bindValue(":location", location);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query)
+                << "Couldn't update the fingerprint of" << location;
+        DEBUG_ASSERT(!"Failed query");
+    }
+}
+
 void TrackDAO::markUnverifiedTracksAsDeleted() {
     // kLogger.debug()<< "markUnverifiedTracksAsDeleted" <<
     // QThread::currentThread() << m_database.connectionName();
@@ -8,7 +8,10 @@
 
 #include "library/dao/dao.h"
 #include "library/relocatedtrack.h"
+#include "library/trackfilefingerprint.h"
 #include "preferences/usersettings.h"
+#include "sources/soundsourceproxy.h"
+#include "util/cache.h"
 #include "track/globaltrackcache.h"
 #include "util/class.h"
 
@@ -17,6 +20,7 @@ class PlaylistDAO;
 class AnalysisDao;
 class CueDAO;
 class LibraryHashDAO;
+class TrackSearchIndexDAO;
 
 namespace mixxx {
 class FileInfo;
@@ -42,6 +46,7 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
             PlaylistDAO& playlistDao,
             AnalysisDao& analysisDao,
             LibraryHashDAO& libraryHashDao,
+            TrackSearchIndexDAO& trackSearchIndexDao,
             UserSettingsPointer pConfig);
     ~TrackDAO() override;
 
@@ -67,6 +72,12 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     QSet<QString> getAllExistingTrackLocations() const;
     // Return all tracks reported missing during last scan.
     QSet<QString> getAllMissingTrackLocations() const;
+    // The same locations as getAllTrackLocations() with the fingerprints
+    // of the files from the last scan.
+    QHash<QString, TrackFileFingerprint> getAllTrackFileFingerprints() const;
+    // The cache keys of the cover art of all tracks, incl. tracks that are
+    // currently marked as missing or deleted.
+    QSet<mixxx::cache_key_t> getAllCoverArtCacheKeys() const;
     QString getTrackLocation(TrackId trackId) const;
 
     // Only used by friend class LibraryScanner, but public for testing!
@@ -159,9 +170,13 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     TrackId addTracksAddTrack(
             const TrackPointer& pTrack,
             bool unremove);
+    /// Metadata that has already been imported from the file, e.g. by a
+    /// worker thread of the library scanner, is used instead of parsing
+    /// the file again.
     TrackPointer addTracksAddFile(
             const QString& filePath,
-            bool unremove);
+            bool unremove,
+            const SoundSourceProxy::ImportedMetadata* pImportedMetadata = nullptr);
     void addTracksFinish(bool rollback = false);
 
     bool updateTrack(const Track& track) const;
@@ -186,8 +201,13 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     // Scanning related calls.
     void markTrackLocationsAsVerified(const QStringList& locations) const;
     void markTracksInDirectoriesAsVerified(const QStringList& directories) const;
+    void updateTrackFileFingerprint(
+            const QString& location,
+            const TrackFileFingerprint& fingerprint) const;
     void cleanupTrackLocationsDirectory() const;
     void invalidateTrackLocationsInLibrary() const;
+    void invalidateTrackLocationsInDirectories(const QStringList& directories) const;
+    void invalidateTrackLocationsInDirectoryTrees(const QStringList& directories) const;
     void markUnverifiedTracksAsDeleted();
 
     bool verifyRemainingTracks(
@@ -204,6 +224,7 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     PlaylistDAO& m_playlistDao;
     AnalysisDao& m_analysisDao;
     LibraryHashDAO& m_libraryHashDao;
+    TrackSearchIndexDAO& m_trackSearchIndexDao;
 
     const UserSettingsPointer m_pConfig;
 
@@ -60,6 +60,7 @@ const QString TRACKLOCATIONSTABLE_LOCATION = QStringLiteral("location");
 const QString TRACKLOCATIONSTABLE_FILENAME = QStringLiteral("filename");
 const QString TRACKLOCATIONSTABLE_DIRECTORY = QStringLiteral("directory");
 const QString TRACKLOCATIONSTABLE_FILESIZE = QStringLiteral("filesize");
+const QString TRACKLOCATIONSTABLE_FSMODIFIED = QStringLiteral("fs_modified_ms");
 const QString TRACKLOCATIONSTABLE_FSDELETED = QStringLiteral("fs_deleted");
 const QString TRACKLOCATIONSTABLE_NEEDSVERIFICATION = QStringLiteral("needs_verification");
 
@@ -0,0 +1,310 @@
+#include "library/dao/tracksearchindexdao.h"
+
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+#include "library/dao/trackschema.h"
+#include "library/queryutil.h"
+#include "util/db/sqltransaction.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("TrackSearchIndexDAO");
+
+const QString kTable = QStringLiteral("track_search_index");
+
+// The ids of all tracks whose indexed values have been modified, filled by
+// triggers. Unlike the hooks in TrackDAO the triggers also catch bulk updates
+// and modifications by other versions of Mixxx. They only use plain SQL and
+// no custom functions, so every client is able to execute them.
+const QString kOutdatedTable = QStringLiteral("track_search_index_outdated");
+
+// The trigram tokenizer only finds terms with at least 3 characters.
+constexpr int kMinArgumentLength = 3;
+
+// The indexed columns, named like the columns of the library_cache_view that
+// SearchQueryParser refers to.
+const QStringList kIndexedColumns = {
+        LIBRARYTABLE_ARTIST,
+        LIBRARYTABLE_TITLE,
+        LIBRARYTABLE_ALBUM,
+        LIBRARYTABLE_ALBUMARTIST,
+        LIBRARYTABLE_GENRE,
+        LIBRARYTABLE_COMPOSER,
+        LIBRARYTABLE_GROUPING,
+        LIBRARYTABLE_COMMENT,
+        TRACKLOCATIONSTABLE_LOCATION,
+};
+
+// Selects the normalized values of all indexed columns with the track id as
+// the first column. mixxx_latin_low() is registered by DbConnection.
+QString selectIndexedValues() {
+    QStringList values;
+    values.reserve(kIndexedColumns.size() + 1);
+    values << QStringLiteral(LIBRARY_TABLE ".") + LIBRARYTABLE_ID;
+    for (const auto& column : kIndexedColumns) {
+        const QString table = column == TRACKLOCATIONSTABLE_LOCATION
+                ? QStringLiteral(TRACKLOCATIONS_TABLE)
+                : QStringLiteral(LIBRARY_TABLE);
+        values << QStringLiteral("mixxx_latin_low(%1.%2)").arg(table, column);
+    }
+    return QStringLiteral(
+            "SELECT %1 FROM " LIBRARY_TABLE " INNER JOIN " TRACKLOCATIONS_TABLE
+            " ON " LIBRARY_TABLE ".location=" TRACKLOCATIONS_TABLE ".id")
+            .arg(values.join(','));
+}
+
+QString insertIndexedValues(const QString& whereClause) {
+    return QStringLiteral("INSERT INTO %1 (rowid,%2) %3 %4")
+            .arg(kTable,
+                    kIndexedColumns.join(','),
+                    selectIndexedValues(),
+                    whereClause);
+}
+
+QString joinTrackIds(const QList<TrackId>& trackIds) {
+    QStringList idList;
+    idList.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        idList.append(trackId.toString());
+    }
+    return idList.join(',');
+}
+
+QString insertOutdatedTrackId(const QString& trackId) {
+    return QStringLiteral("INSERT OR IGNORE INTO %1 (id) VALUES (%2);")
+            .arg(kOutdatedTable, trackId);
+}
+
+bool tableExists(const QSqlDatabase& database, const QString& table) {
+    QSqlQuery query(database);
+    query.prepare(QStringLiteral(
+            "SELECT 1 FROM sqlite_master WHERE type='table' AND name=:name"));
+    query.bindValue(QStringLiteral(":name"), table);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    return query.next();
+}
+
+bool createOutdatedTableAndTriggers(const QSqlDatabase& database) {
+    const QStringList statements = {
+            QStringLiteral("CREATE TABLE IF NOT EXISTS %1 (id INTEGER PRIMARY KEY)")
+                    .arg(kOutdatedTable),
+            QStringLiteral("CREATE TRIGGER IF NOT EXISTS %1_insert "
+                           "AFTER INSERT ON " LIBRARY_TABLE " BEGIN %2 END")
+                    .arg(kOutdatedTable, insertOutdatedTrackId(QStringLiteral("NEW.id"))),
+            QStringLiteral("CREATE TRIGGER IF NOT EXISTS %1_delete "
+                           "AFTER DELETE ON " LIBRARY_TABLE " BEGIN %2 END")
+                    .arg(kOutdatedTable, insertOutdatedTrackId(QStringLiteral("OLD.id"))),
+            // The location column of the library table references the
+            // track_locations table and has the same name as the indexed column
+            QStringLiteral("CREATE TRIGGER IF NOT EXISTS %1_update "
+                           "AFTER UPDATE OF %2 ON " LIBRARY_TABLE " BEGIN %3 END")
+                    .arg(kOutdatedTable,
+                            kIndexedColumns.join(','),
+                            insertOutdatedTrackId(QStringLiteral("NEW.id"))),
+            QStringLiteral("CREATE TRIGGER IF NOT EXISTS %1_update_location "
+                           "AFTER UPDATE OF %2 ON " TRACKLOCATIONS_TABLE " BEGIN "
+                           "INSERT OR IGNORE INTO %1 (id) SELECT id FROM " LIBRARY_TABLE
+                           " WHERE location=NEW.id; END")
+                    .arg(kOutdatedTable, TRACKLOCATIONSTABLE_LOCATION),
+    };
+    QSqlQuery query(database);
+    for (const auto& statement : statements) {
+        if (!query.exec(statement)) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+    }
+    return true;
+}
+
+int queryCount(const QSqlDatabase& database, const QString& table) {
+    QSqlQuery query(database);
+    if (!query.exec(QStringLiteral("SELECT COUNT(*) FROM %1").arg(table)) ||
+            !query.next()) {
+        LOG_FAILED_QUERY(query);
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+} // anonymous namespace
+
+void TrackSearchIndexDAO::initialize(const QSqlDatabase& database) {
+    DAO::initialize(database);
+
+    // The values are normalized before they are indexed, so the tokenizer
+    // must not fold the case again.
+    QSqlQuery query(m_database);
+    m_available = query.exec(QStringLiteral(
+            "CREATE VIRTUAL TABLE IF NOT EXISTS %1 USING fts5(%2,"
+            "tokenize='trigram case_sensitive 1')")
+                                     .arg(kTable, kIndexedColumns.join(',')));
+    if (!m_available) {
+        kLogger.info()
+                << "Full-text search is not supported by SQLite,"
+                << "searching the library without index:"
+                << query.lastError().text();
+        return;
+    }
+
+    // Without the table the changes since the index has been populated are
+    // unknown, e.g. if it has been created by a previous version of Mixxx.
+    m_rebuildRequired = !tableExists(m_database, kOutdatedTable);
+    if (!createOutdatedTableAndTriggers(m_database)) {
+        // The index would silently miss modified tracks
+        m_available = false;
+    }
+}
+
+void TrackSearchIndexDAO::rebuildIfOutdated() {
+    if (!m_available) {
+        return;
+    }
+    const int numTracks = queryCount(m_database, QStringLiteral(LIBRARY_TABLE));
+    const int numIndexedTracks = queryCount(m_database, kTable);
+    if (!m_rebuildRequired && numTracks >= 0 && numTracks == numIndexedTracks) {
+        updateOutdatedTracks();
+        return;
+    }
+    kLogger.info()
+            << "Rebuilding search index with"
+            << numIndexedTracks
+            << "of"
+            << numTracks
+            << "tracks";
+    rebuild();
+    m_rebuildRequired = false;
+}
+
+void TrackSearchIndexDAO::rebuild() const {
+    if (!m_available) {
+        return;
+    }
+    PerformanceTimer timer;
+    timer.start();
+
+    SqlTransaction transaction(m_database);
+    QSqlQuery query(m_database);
+    if (!query.exec(QStringLiteral("DELETE FROM %1").arg(kTable)) ||
+            !query.exec(QStringLiteral("DELETE FROM %1").arg(kOutdatedTable))) {
+        LOG_FAILED_QUERY(query);
+        return;
+    }
+    if (!query.exec(insertIndexedValues(QString()))) {
+        LOG_FAILED_QUERY(query);
+        return;
+    }
+    // Merge all b-trees of the freshly populated index into one
+    if (!query.exec(QStringLiteral("INSERT INTO %1(%1) VALUES('optimize')").arg(kTable))) {
+        LOG_FAILED_QUERY(query);
+    }
+    transaction.commit();
+
+    kLogger.info()
+            << "Rebuilding search index took"
+            << timer.elapsed().debugMillisWithUnit();
+}
+
+void TrackSearchIndexDAO::updateOutdatedTracks() const {
+    if (!m_available) {
+        return;
+    }
+    QSqlQuery query(m_database);
+    if (!query.exec(QStringLiteral("SELECT id FROM %1").arg(kOutdatedTable))) {
+        LOG_FAILED_QUERY(query);
+        return;
+    }
+    QList<TrackId> trackIds;
+    while (query.next()) {
+        trackIds.append(TrackId(query.value(0)));
+    }
+    if (trackIds.isEmpty()) {
+        return;
+    }
+    kLogger.debug()
+            << "Updating"
+            << trackIds.size()
+            << "outdated tracks in search index";
+    SqlTransaction transaction(m_database);
+    updateTracks(trackIds);
+    transaction.commit();
+}
+
+void TrackSearchIndexDAO::updateTracks(const QList<TrackId>& trackIds) const {
+    if (!m_available || trackIds.isEmpty()) {
+        return;
+    }
+    // FTS5 has no UPSERT, all rows are deleted before they are re-inserted.
+    // Tracks that have been deleted from the library in the meantime are
+    // not re-inserted by the INNER JOIN.
+    removeTracks(trackIds);
+    QSqlQuery query(m_database);
+    if (!query.exec(insertIndexedValues(
+                QStringLiteral("WHERE " LIBRARY_TABLE ".id IN (%1)")
+                        .arg(joinTrackIds(trackIds))))) {
+        LOG_FAILED_QUERY(query);
+    }
+}
+
+void TrackSearchIndexDAO::removeTracks(const QList<TrackId>& trackIds) const {
+    if (!m_available || trackIds.isEmpty()) {
+        return;
+    }
+    const QString idList = joinTrackIds(trackIds);
+    QSqlQuery query(m_database);
+    if (!query.exec(QStringLiteral("DELETE FROM %1 WHERE rowid IN (%2)")
+                    .arg(kTable, idList))) {
+        LOG_FAILED_QUERY(query);
+    }
+    // The tracks are up to date after they have been re-inserted
+    if (!query.exec(QStringLiteral("DELETE FROM %1 WHERE id IN (%2)")
+                    .arg(kOutdatedTable, idList))) {
+        LOG_FAILED_QUERY(query);
+    }
+}
+
+QString TrackSearchIndexDAO::formatContainsFilter(
+        const QStringList& sqlColumns,
+        const QString& argument) const {
+    if (!m_available || sqlColumns.isEmpty()) {
+        return QString();
+    }
+    for (const auto& sqlColumn : sqlColumns) {
+        if (!isIndexedColumn(sqlColumn)) {
+            return QString();
+        }
+    }
+    if (argument.toUcs4().size() < kMinArgumentLength) {
+        return QString();
+    }
+    // TextFilterNode passes the argument unescaped into the LIKE pattern,
+    // i.e. '%' and '_' are wildcards and a trailing space requires another
+    // character to follow. Neither can be expressed as an FTS5 phrase.
+    if (argument.contains(QChar('%')) ||
+            argument.contains(QChar('_')) ||
+            argument.back().isSpace()) {
+        return QString();
+    }
+
+    // A phrase that is restricted to the given columns. Double quotes
+    // inside the phrase are escaped by doubling them.
+    QString phrase = argument;
+    phrase.replace(QChar('"'), QStringLiteral("\"\""));
+    const QString match = QStringLiteral("{%1} : \"%2\"")
+                                  .arg(sqlColumns.join(' '), phrase);
+    return QStringLiteral("%1 IN (SELECT rowid FROM %2 WHERE %2 MATCH %3)")
+            .arg(LIBRARYTABLE_ID,
+                    kTable,
+                    FieldEscaper(m_database).escapeString(match));
+}
+
+// static
+bool TrackSearchIndexDAO::isIndexedColumn(const QString& sqlColumn) {
+    return kIndexedColumns.contains(sqlColumn);
+}
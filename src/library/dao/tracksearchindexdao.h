@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "library/dao/dao.h"
+#include "track/trackid.h"
+
+/// Full-text index of the library columns that are searched by
+/// SearchQueryParser.
+///
+/// The index is an FTS5 table with the trigram tokenizer that is able to
+/// answer substring queries like `col LIKE '%term%'` without scanning the
+/// whole library. The indexed values are normalized with
+/// DbConnection::makeStringLatinLow() in the same way as the custom LIKE
+/// function does it, so both return the same tracks.
+///
+/// The table is created at runtime instead of in the schema, because FTS5
+/// and the trigram tokenizer (SQLite 3.34) are optional. If they are not
+/// available isAvailable() returns false and all searches keep using LIKE.
+class TrackSearchIndexDAO : public DAO {
+  public:
+    ~TrackSearchIndexDAO() override = default;
+
+    void initialize(const QSqlDatabase& database) override;
+
+    bool isAvailable() const {
+        return m_available;
+    }
+
+    /// Rebuilds the index if it is out of sync with the library table,
+    /// e.g. on first use or after the database has been modified by a
+    /// version of Mixxx that did not maintain the index. Otherwise only
+    /// the tracks that have been modified since are re-indexed.
+    void rebuildIfOutdated();
+    void rebuild() const;
+
+    /// Re-indexes all tracks that have been modified without updating the
+    /// index, e.g. by bulk updates of the library scanner. The modifications
+    /// are recorded by triggers on the library and track_locations tables.
+    void updateOutdatedTracks() const;
+
+    /// (Re-)indexes the given tracks from the current contents of the
+    /// library and track_locations tables.
+    void updateTracks(const QList<TrackId>& trackIds) const;
+    void removeTracks(const QList<TrackId>& trackIds) const;
+
+    /// Returns an SQL expression that selects all tracks where at least one
+    /// of sqlColumns contains the already normalized argument. An empty
+    /// string is returned if the index is not able to answer the query, the
+    /// caller must fall back to LIKE in this case.
+    QString formatContainsFilter(
+            const QStringList& sqlColumns,
+            const QString& argument) const;
+
+    static bool isIndexedColumn(const QString& sqlColumn);
+
+  private:
+    bool m_available = false;
+    bool m_rebuildRequired = false;
+};
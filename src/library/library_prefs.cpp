@@ -18,6 +18,26 @@ const ConfigKey mixxx::library::prefs::kRescanOnStartupConfigKey =
                 mixxx::library::prefs::kConfigGroup,
                 QStringLiteral("RescanOnStartup")};
 
+const ConfigKey mixxx::library::prefs::kWatchLibraryDirectoriesConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("WatchLibraryDirectories")};
+
+const ConfigKey mixxx::library::prefs::kDatabaseWriteAheadLogConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("DatabaseWriteAheadLog")};
+
+const ConfigKey mixxx::library::prefs::kDatabaseMmapSizeMiBConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("DatabaseMmapSizeMiB")};
+
+const ConfigKey mixxx::library::prefs::kDatabaseCacheSizeMiBConfigKey =
+        ConfigKey{
+                mixxx::library::prefs::kConfigGroup,
+                QStringLiteral("DatabaseCacheSizeMiB")};
+
 const ConfigKey mixxx::library::prefs::kShowScanSummaryConfigKey =
         ConfigKey{
                 mixxx::library::prefs::kConfigGroup,
@@ -14,6 +14,23 @@ extern const QString kConfigGroup;
 
 extern const ConfigKey kRescanOnStartupConfigKey;
 
+extern const ConfigKey kWatchLibraryDirectoriesConfigKey;
+
+const bool kWatchLibraryDirectoriesDefault = true;
+
+extern const ConfigKey kDatabaseWriteAheadLogConfigKey;
+
+// Opt-in, because WAL doesn't work with databases on network file systems
+const bool kDatabaseWriteAheadLogDefault = false;
+
+extern const ConfigKey kDatabaseMmapSizeMiBConfigKey;
+
+const int kDatabaseMmapSizeMiBDefault = 256;
+
+extern const ConfigKey kDatabaseCacheSizeMiBConfigKey;
+
+const int kDatabaseCacheSizeMiBDefault = 16;
+
 extern const ConfigKey kShowScanSummaryConfigKey;
 
 extern const ConfigKey kKeyNotationConfigKey;
@@ -111,6 +111,8 @@ MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
             std::move(columns),
             std::move(searchColumns),
             true);
+    pBaseTrackCache->setSearchIndex(
+            &m_pTrackCollection->getTrackSearchIndexDAO());
     m_pBaseTrackCache = QSharedPointer<BaseTrackCache>(pBaseTrackCache);
     m_pTrackCollection->connectTrackSource(m_pBaseTrackCache);
 
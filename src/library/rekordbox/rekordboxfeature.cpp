@@ -1382,6 +1382,8 @@ RekordboxFeature::RekordboxFeature(
 RekordboxFeature::~RekordboxFeature() {
     m_devicesFuture.waitForFinished();
     m_tracksFuture.waitForFinished();
+    // A search might still read the tables
+    m_pRekordboxPlaylistModel->maybeStopModelPopulation();
 
     // Drop temporary Rekordbox database tables on shutdown
     QSqlDatabase database = m_pTrackCollection->database();
@@ -1551,6 +1553,7 @@ void RekordboxFeature::onRekordboxDevicesFound() {
 
     if (foundDevices.size() == 0) {
         // No Rekordbox devices found
+        m_pRekordboxPlaylistModel->maybeStopModelPopulation();
         ScopedTransaction transaction(database);
 
         dropTable(database, kRekordboxPlaylistTracksTable);
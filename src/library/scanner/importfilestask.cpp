@@ -1,8 +1,17 @@
 #include "library/scanner/importfilestask.h"
 
+#include "library/coverartutils.h"
 #include "moc_importfilestask.cpp"
 #include "util/timer.h"
 
+namespace {
+
+// The number of files that are handed over to the LibraryScanner
+// at once. Small enough to keep the progress updates fluent.
+constexpr int kImportBatchSize = 64;
+
+} // anonymous namespace
+
 ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
         const ScannerGlobalPointer scannerGlobal,
         const QString& dirPath,
@@ -22,6 +31,13 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
 
 void ImportFilesTask::run() {
     ScopedTimer timer(QStringLiteral("ImportFilesTask::run"));
+    // All files are located in the same directory and the guesser
+    // caches the image files of the last directory.
+    CoverInfoGuesser coverInfoGuesser;
+    QStringList existingTracks;
+    QList<ModifiedTrackFile> modifiedTracks;
+    QList<ImportedTrackFile> newTracks;
+    newTracks.reserve(kImportBatchSize);
     for (const QFileInfo& fileInfo: m_filesToImport) {
         // If a flag was raised telling us to cancel the library scan then stop.
         if (m_scannerGlobal->shouldCancel()) {
@@ -40,7 +56,14 @@ void ImportFilesTask::run() {
             // If the track is in the database, mark it as existing. This code gets
             // executed when other files in the same directory have changed (the
             // directory hash has changed).
-            emit trackExists(trackLocation);
+            existingTracks.append(trackLocation);
+            const auto fingerprint = TrackFileFingerprint::fromFileInfo(fileInfo);
+            if (fingerprint.isValid() &&
+                    fingerprint !=
+                            m_scannerGlobal->trackFileFingerprintInDatabase(
+                                    trackLocation)) {
+                modifiedTracks.append(ModifiedTrackFile{trackLocation, fingerprint});
+            }
         } else {
             if (!fileInfo.exists()) {
                 qWarning() << "ImportFilesTask: Skipping inaccessible file"
@@ -49,9 +72,28 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
-            emit addNewTrack(trackLocation);
+            // Parse the file tags here, concurrently with other tasks. The
+            // LibraryScanner only needs to add the tracks to the database.
+            newTracks.append(ImportedTrackFile{trackLocation,
+                    SoundSourceProxy::importMetadataFromFile(
+                            mixxx::FileAccess(mixxx::FileInfo(fileInfo), m_pToken),
+                            m_scannerGlobal->syncTrackMetadataParams(),
+                            &coverInfoGuesser)});
+            if (newTracks.size() >= kImportBatchSize) {
+                emit addNewTracks(newTracks);
+                newTracks.clear();
+            }
         }
     }
+    if (!existingTracks.isEmpty()) {
+        emit tracksExist(existingTracks);
+    }
+    if (!modifiedTracks.isEmpty()) {
+        emit trackFilesModified(modifiedTracks);
+    }
+    if (!newTracks.isEmpty()) {
+        emit addNewTracks(newTracks);
+    }
     // Insert or update the hash in the database.
     emit directoryHashedAndScanned(m_dirPath, !m_prevHashExists, m_newHash);
     setSuccess(true);
@@ -1,10 +1,17 @@
 #include "library/scanner/libraryscanner.h"
 
+#include <QDateTime>
+#include <algorithm>
+
+#include "library/coverartcache.h"
 #include "library/coverartutils.h"
+#include "library/dao/settingsdao.h"
 #include "library/library_decl.h"
+#include "library/library_prefs.h"
 #include "library/queryutil.h"
 #include "library/scanner/importfilestask.h"
 #include "library/scanner/libraryscannerdlg.h"
+#include "library/scanner/librarywatcher.h"
 #include "library/scanner/recursivescandirectorytask.h"
 #include "library/scanner/scannertask.h"
 #include "library/scanner/scannerutil.h"
@@ -21,9 +28,32 @@
 
 namespace {
 
+// Directories are traversed sequentially to always discover the same
+// folder first in case of duplicated folders by symlinks.
 // TODO(rryan) make configurable
 constexpr int kScannerThreadPoolSize = 1;
 
+// Parsing the file tags is limited by the latency of the file system
+// rather than the CPU, e.g. for network shares. Use at least 2 threads
+// even on single core machines.
+constexpr int kMinImportThreadPoolSize = 2;
+constexpr int kMaxImportThreadPoolSize = 8;
+
+// Collects the changes of file operations that affect many files, e.g.
+// copying an album, before scanning the changed directories.
+constexpr int kScanChangesDelayMillis = 5000;
+
+// SQLite recommends to optimize long-lived connections periodically
+constexpr int kOptimizeDatabaseIntervalMillis = 60 * 60 * 1000;
+
+// The time until all changes have been journaled, stored on shutdown if the
+// journal is complete. Directories that have been modified since then are
+// scanned on the next startup instead of the whole library.
+const QString kJournaledUntilKey = QStringLiteral("mixxx.libraryscanner.journaleduntil");
+
+// FAT stores the modification time with a resolution of 2 s
+constexpr int kModificationTimeToleranceSecs = 2;
+
 mixxx::Logger kLogger("LibraryScanner");
 
 QAtomicInt s_instanceCounter(0);
@@ -73,6 +103,12 @@ void cleanUpDatabase(const QSqlDatabase& database) {
             << timer.elapsed().debugMillisWithUnit();
 }
 
+bool isInDirectory(const QString& path, const QString& dirPath) {
+    return path.startsWith(dirPath) &&
+            (path.size() == dirPath.size() ||
+                    path.at(dirPath.size()) == QChar('/'));
+}
+
 /// Update statistics for the query planner
 /// See also: https://www.sqlite.org/lang_analyze.html
 void updateQueryPlannerStatisticsForDatabase(const QSqlDatabase& database) {
@@ -94,33 +130,84 @@ void updateQueryPlannerStatisticsForDatabase(const QSqlDatabase& database) {
     }
 }
 
+/// Update the statistics for the query planner only for tables
+/// and indices that would benefit from it. Much cheaper than ANALYZE.
+/// See also: https://www.sqlite.org/pragma.html#pragma_optimize
+void optimizeQueryPlannerForDatabase(const QSqlDatabase& database) {
+    PerformanceTimer timer;
+    timer.start();
+    FwdSqlQuery query(database, QStringLiteral("PRAGMA optimize"));
+    if (query.hasError() || !query.execPrepared()) {
+        // Might fail if another connection is writing for a long time
+        kLogger.warning()
+                << "Failed to optimize query planner for database";
+        return;
+    }
+    kLogger.debug()
+            << "Optimized query planner for database:"
+            << timer.elapsed().debugMillisWithUnit();
+}
+
 } // anonymous namespace
 
 LibraryScanner::LibraryScanner(
         mixxx::DbConnectionPoolPtr pDbConnectionPool,
         const UserSettingsPointer& pConfig)
         : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pConfig(pConfig),
           m_analysisDao(pConfig),
-          m_trackDao(m_cueDao, m_playlistDao, m_analysisDao, m_libraryHashDao, pConfig),
+          m_trackDao(m_cueDao,
+                  m_playlistDao,
+                  m_analysisDao,
+                  m_libraryHashDao,
+                  m_trackSearchIndexDao,
+                  pConfig),
           m_stateSema(1), // only one transaction is possible at a time
           m_state(IDLE),
           m_numRelocatedTracks(0),
           m_pProgressDlg(std::make_unique<LibraryScannerDlg>()),
-          m_manualScan(true) {
+          m_manualScan(true),
+          m_scanChangesOnly(false),
+          m_startupScan(false),
+          m_fullScanRequired(true),
+          m_deferredScan(NONE) {
     // Move LibraryScanner to its own thread so that our signals/slots will
     // queue to our event loop.
     moveToThread(this);
     m_pool.moveToThread(this);
+    m_importPool.moveToThread(this);
+    m_scanChangesTimer.moveToThread(this);
+    m_optimizeDatabaseTimer.moveToThread(this);
 
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
     m_pool.setMaxThreadCount(kScannerThreadPoolSize);
+    m_importPool.setMaxThreadCount(std::clamp(QThread::idealThreadCount(),
+            kMinImportThreadPoolSize,
+            kMaxImportThreadPoolSize));
+
+    // Imported files are passed from the worker threads to the scanner thread
+    qRegisterMetaType<QList<ImportedTrackFile>>();
+    qRegisterMetaType<QList<ModifiedTrackFile>>();
 
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
     connect(this, &LibraryScanner::startScan, this, &LibraryScanner::slotStartScan);
 
+    m_scanChangesTimer.setSingleShot(true);
+    m_scanChangesTimer.setInterval(kScanChangesDelayMillis);
+    connect(&m_scanChangesTimer,
+            &QTimer::timeout,
+            this,
+            &LibraryScanner::slotScanChanges);
+
+    m_optimizeDatabaseTimer.setInterval(kOptimizeDatabaseIntervalMillis);
+    connect(&m_optimizeDatabaseTimer,
+            &QTimer::timeout,
+            this,
+            &LibraryScanner::slotOptimizeDatabase);
+
     connect(this,
             &LibraryScanner::progressLoading,
             m_pProgressDlg.get(),
@@ -176,11 +263,60 @@ void LibraryScanner::run() {
         m_playlistDao.initialize(dbConnection);
         m_analysisDao.initialize(dbConnection);
         m_directoryDao.initialize(dbConnection);
+        m_trackSearchIndexDao.initialize(dbConnection);
+
+        if (m_pConfig->getValue(
+                    mixxx::library::prefs::kWatchLibraryDirectoriesConfigKey,
+                    mixxx::library::prefs::kWatchLibraryDirectoriesDefault)) {
+            m_pWatcher = std::make_unique<LibraryWatcher>();
+            connect(m_pWatcher.get(),
+                    &LibraryWatcher::directoryChanged,
+                    this,
+                    &LibraryScanner::slotDirectoryChanged);
+            connect(m_pWatcher.get(),
+                    &LibraryWatcher::overflowed,
+                    this,
+                    &LibraryScanner::slotWatcherOverflowed);
+            updateWatchedDirectories();
+        }
+
+        // Changes that have not been scanned before the last shutdown
+        const QStringList changedDirectories = m_libraryHashDao.getChangedDirectories();
+        for (const auto& dirPath : changedDirectories) {
+            m_changedDirectories.insert(dirPath);
+        }
+        const SettingsDAO settings(dbConnection);
+        bool journaled = false;
+        const qint64 journaledUntilMillis =
+                settings.getValue(kJournaledUntilKey).toLongLong(&journaled);
+        // Not valid anymore if Mixxx crashes
+        settings.setValue(kJournaledUntilKey, QString());
+        if (journaled && m_pWatcher && m_pWatcher->isWatching()) {
+            m_fullScanRequired = false;
+            journalDirectoriesModifiedSince(
+                    QDateTime::fromMSecsSinceEpoch(journaledUntilMillis, Qt::UTC));
+        }
+        if (!m_changedDirectories.isEmpty()) {
+            m_scanChangesTimer.start();
+        }
+        m_optimizeDatabaseTimer.start();
 
         // Start the event loop.
         kLogger.debug() << "Event loop starting";
         exec();
         kLogger.debug() << "Event loop stopped";
+
+        m_scanChangesTimer.stop();
+        m_optimizeDatabaseTimer.stop();
+
+        // Changes whose scan has been interrupted by the shutdown
+        for (const auto& dirPath : std::as_const(m_scannedChangedDirectories)) {
+            m_libraryHashDao.addChangedDirectory(dirPath);
+        }
+        if (m_pWatcher && m_pWatcher->isWatching() && !m_fullScanRequired) {
+            settings.setValue(kJournaledUntilKey, QDateTime::currentMSecsSinceEpoch());
+        }
+        m_pWatcher.reset();
     }
     kLogger.debug() << "Exiting thread";
 }
@@ -189,19 +325,48 @@ void LibraryScanner::slotStartScan() {
     kLogger.debug() << "slotStartScan()";
     DEBUG_ASSERT(m_state == STARTING);
 
-    cleanUpDatabase(m_libraryHashDao.database());
+    if (m_startupScan.exchange(false) && !m_fullScanRequired) {
+        kLogger.info()
+                << "Scanning only the directories that have been changed"
+                << "since the last run";
+        m_scanChangesOnly = true;
+    }
+
+    if (!m_scanChangesOnly) {
+        cleanUpDatabase(m_libraryHashDao.database());
+    }
 
     // Recursively scan each directory in the directories table.
     m_libraryRootDirs = m_directoryDao.loadAllDirectories();
     // If there are no directories then we still have to scan independently added tracks.
-    QSet<QString> trackLocations = m_trackDao.getAllTrackLocations();
+    QHash<QString, TrackFileFingerprint> trackFileFingerprints =
+            m_trackDao.getAllTrackFileFingerprints();
+
+    if (m_scanChangesOnly) {
+        m_scannedChangedDirectories = m_changedDirectories.values();
+    } else {
+        // The full scan covers all changes that have been journaled so far
+        m_scannedChangedDirectories.clear();
+        m_scanChangesTimer.stop();
+    }
+    m_changedDirectories.clear();
+    m_libraryHashDao.removeChangedDirectories();
 
-    if (m_libraryRootDirs.isEmpty() && trackLocations.isEmpty()) {
+    if (m_scanChangesOnly &&
+            (m_libraryRootDirs.isEmpty() || m_scannedChangedDirectories.isEmpty())) {
+        m_scannedChangedDirectories.clear();
+        m_scanChangesOnly = false;
+        changeScannerState(IDLE);
+        startDeferredScan();
+        return;
+    }
+    if (m_libraryRootDirs.isEmpty() && trackFileFingerprints.isEmpty()) {
         // Nothing to do. noDirectoriesConfigured == true will show the "no dirs" message.
         LibraryScanResultSummary result;
         result.autoscan = m_manualScan;
         result.noDirectoriesConfigured = true;
 
+        m_deferredScan = NONE;
         changeScannerState(IDLE);
         emit scanSummary(result);
         return;
@@ -209,7 +374,9 @@ void LibraryScanner::slotStartScan() {
     changeScannerState(SCANNING);
     // Store number of existing tracks so we can calculate the number
     // of missing tracks in slotFinishUnhashedScan().
-    m_previouslyMissingTracks = m_trackDao.getAllMissingTrackLocations();
+    if (!m_scanChangesOnly) {
+        m_previouslyMissingTracks = m_trackDao.getAllMissingTrackLocations();
+    }
     QHash<QString, mixxx::cache_key_t> directoryHashes = m_libraryHashDao.getDirectoryHashes();
     QRegularExpression extensionFilter(SoundSourceProxy::getSupportedFileNamesRegex());
     QRegularExpression coverExtensionFilter =
@@ -219,28 +386,42 @@ void LibraryScanner::slotStartScan() {
     m_numRelocatedTracks = 0;
 
     m_scannerGlobal = ScannerGlobalPointer(
-            new ScannerGlobal(trackLocations, directoryHashes, extensionFilter,
-                              coverExtensionFilter, directoryBlacklist));
+            new ScannerGlobal(trackFileFingerprints,
+                    directoryHashes,
+                    extensionFilter,
+                    coverExtensionFilter,
+                    directoryBlacklist,
+                    SyncTrackMetadataParams::readFromUserSettings(*m_pConfig)));
 
     m_scannerGlobal->startTimer();
 
     emit scanStarted();
 
-    // First, we're going to mark all the directories that we've previously
-    // hashed as needing verification. As we search through the directory tree
-    // when we rescan, we'll mark any directory that does still exist as
-    // verified.
-    m_libraryHashDao.invalidateAllDirectories();
-
-    // Make sure that `directory` in in track_locations table is indeed a
-    // directory path. This works around / removes residues of a bug where tracks
-    // are falsely marked missing because `directory` == `location`.
-    m_trackDao.cleanupTrackLocationsDirectory();
-
-    // Mark all the tracks in the library as needing verification of their
-    // existence. (ie. we want to check they're still on your hard drive where
-    // we think they are)
-    m_trackDao.invalidateTrackLocationsInLibrary();
+    QList<mixxx::FileAccess> changedDirs;
+    if (m_scanChangesOnly) {
+        // Only the changed directories need verification. The changes in
+        // their subdirectories are reported separately.
+        changedDirs = invalidateChangedDirectories();
+    } else {
+        // Until it has finished cleanly
+        m_fullScanRequired = true;
+
+        // First, we're going to mark all the directories that we've previously
+        // hashed as needing verification. As we search through the directory tree
+        // when we rescan, we'll mark any directory that does still exist as
+        // verified.
+        m_libraryHashDao.invalidateAllDirectories();
+
+        // Make sure that `directory` in in track_locations table is indeed a
+        // directory path. This works around / removes residues of a bug where tracks
+        // are falsely marked missing because `directory` == `location`.
+        m_trackDao.cleanupTrackLocationsDirectory();
+
+        // Mark all the tracks in the library as needing verification of their
+        // existence. (ie. we want to check they're still on your hard drive where
+        // we think they are)
+        m_trackDao.invalidateTrackLocationsInLibrary();
+    }
 
     kLogger.debug() << "Recursively scanning library.";
 
@@ -262,6 +443,19 @@ void LibraryScanner::slotStartScan() {
             this,
             &LibraryScanner::slotFinishHashedScan);
 
+    if (m_scanChangesOnly) {
+        // Unhashed subdirectories of the changed directories are
+        // imported immediately without a second stage
+        for (mixxx::FileAccess& dirAccess : changedDirs) {
+            if (!m_scannerGlobal->testAndMarkDirectoryScanned(dirAccess.info().toQDir())) {
+                queueTask(new RecursiveScanDirectoryTask(
+                        this, m_scannerGlobal, std::move(dirAccess), true, false));
+            }
+        }
+        pWatcher->taskDone();
+        return;
+    }
+
     for (const mixxx::FileInfo& rootDir : std::as_const(m_libraryRootDirs)) {
         // Acquire a security bookmark for this directory if we are in a
         // sandbox. For speed we avoid opening security bookmarks when recursive
@@ -393,6 +587,11 @@ void LibraryScanner::cleanUpScan() {
 
     transaction.commit();
 
+    if (m_scanChangesOnly) {
+        // The cover art of new tracks is guessed while importing them
+        return;
+    }
+
     kLogger.debug() << "Detecting cover art for unscanned files";
     QSet<TrackId> coverArtTracksChanged;
     m_trackDao.detectCoverArtForTracksWithoutCover(
@@ -402,6 +601,13 @@ void LibraryScanner::cleanUpScan() {
     if (!coverArtTracksChanged.isEmpty()) {
         emit tracksChanged(coverArtTracksChanged);
     }
+
+    // Only a full scan knows all tracks that are still in the library
+    if (!m_scannerGlobal->shouldCancel() && CoverArtCache::isCreated()) {
+        kLogger.debug() << "Removing unused cover art thumbnails";
+        CoverArtCache::instance()->removeUnusedThumbnails(
+                m_trackDao.getAllCoverArtCacheKeys());
+    }
 }
 
 // is called when all tasks of the second stage are done (threads are finished)
@@ -429,9 +635,37 @@ void LibraryScanner::slotFinishUnhashedScan() {
         cleanUpScan();
     }
 
+    if (m_scanChangesOnly) {
+        const bool canceled = m_scannerGlobal->shouldCancel();
+        if (canceled || !bScanFinishedCleanly) {
+            // Keep the changes for the next scan
+            for (const auto& dirPath : std::as_const(m_scannedChangedDirectories)) {
+                m_changedDirectories.insert(dirPath);
+                m_libraryHashDao.addChangedDirectory(dirPath);
+            }
+        }
+        kLogger.info()
+                << "Scanned"
+                << m_scannedChangedDirectories.size()
+                << "changed directories:"
+                << m_scannerGlobal->timerElapsed().debugMillisWithUnit();
+        m_scannedChangedDirectories.clear();
+        m_scannerGlobal.clear();
+        m_scanChangesOnly = false;
+        changeScannerState(FINISHED);
+
+        // No summary for scans in the background
+        emit scanFinished();
+        // Don't repeat a scan that has been canceled by the user before
+        // the next change
+        startPendingScan(!canceled);
+        return;
+    }
+
     if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
         const auto dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
         updateQueryPlannerStatisticsForDatabase(dbConnection);
+        m_fullScanRequired = false;
     }
 
     if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
@@ -480,6 +714,7 @@ void LibraryScanner::slotFinishUnhashedScan() {
     qInfo(" %d tracks verified from changed/added directories", numVerifiedTracks);
     qInfo(" %d new tracks", numNewTracks);
     qInfo(" %d moved tracks", m_numRelocatedTracks);
+    qInfo(" %d modified tracks", m_scannerGlobal->numModifiedTracks());
     qInfo(" %d new missing tracks", numNewMissingTracks);
     qInfo(" %d missing tracks total", numMissingTracks);
     qInfo(" %d rediscovered tracks", numRediscoveredTracks);
@@ -497,18 +732,212 @@ void LibraryScanner::slotFinishUnhashedScan() {
     result.autoscan = m_manualScan;
 
     m_scannerGlobal.clear();
+    // Requests during a full scan are covered by it
+    m_deferredScan = NONE;
     changeScannerState(FINISHED);
     // now we may accept new scan commands
 
     emit scanFinished();
     emit scanSummary(result);
+    startPendingScan(true);
+}
+
+void LibraryScanner::slotScanChanges() {
+    if (m_changedDirectories.isEmpty()) {
+        return;
+    }
+    if (!changeScannerState(STARTING)) {
+        // The changes are scanned after the current scan has finished
+        return;
+    }
+    m_scanChangesOnly = true;
+    slotStartScan();
+}
+
+void LibraryScanner::slotDirectoryChanged(const QString& dirPath) {
+    if (m_changedDirectories.contains(dirPath)) {
+        return;
+    }
+    m_changedDirectories.insert(dirPath);
+    // Journal the changes in the database, they are scanned after a restart
+    // if Mixxx is closed before.
+    m_libraryHashDao.addChangedDirectory(dirPath);
+    if (!m_scanChangesTimer.isActive()) {
+        m_scanChangesTimer.start();
+    }
+}
+
+void LibraryScanner::slotOptimizeDatabase() {
+    if (!changeScannerState(STARTING)) {
+        // Tried again after the next interval
+        return;
+    }
+    optimizeQueryPlannerForDatabase(m_libraryHashDao.database());
+    changeScannerState(IDLE);
+    // A scan that has been requested in the meantime
+    startDeferredScan();
+}
+
+void LibraryScanner::slotWatcherOverflowed() {
+    // The journal is incomplete
+    m_fullScanRequired = true;
+    scan(true);
+}
+
+QList<mixxx::FileAccess> LibraryScanner::invalidateChangedDirectories() {
+    QList<mixxx::FileAccess> rootDirAccesses;
+    for (const mixxx::FileInfo& rootDir : std::as_const(m_libraryRootDirs)) {
+        rootDirAccesses.append(mixxx::FileAccess(rootDir));
+    }
+
+    QStringList existingDirPaths;
+    QStringList removedDirPaths;
+    QList<mixxx::FileAccess> existingDirs;
+    for (const auto& dirPath : std::as_const(m_scannedChangedDirectories)) {
+        auto dirInfo = mixxx::FileInfo(dirPath);
+        if (!dirInfo.exists() || !dirInfo.isDir()) {
+            // Deleted or moved including all subdirectories
+            removedDirPaths.append(dirPath);
+            continue;
+        }
+        // The directory might have been removed from the library in the
+        // meantime. The security bookmark of the containing library
+        // directory grants access on sandboxed systems.
+        const auto rootDirAccess = std::find_if(
+                rootDirAccesses.cbegin(),
+                rootDirAccesses.cend(),
+                [&dirPath](const mixxx::FileAccess& rootDirAccess) {
+                    return isInDirectory(dirPath, rootDirAccess.info().location());
+                });
+        if (rootDirAccess == rootDirAccesses.cend()) {
+            continue;
+        }
+        existingDirPaths.append(dirPath);
+        existingDirs.append(mixxx::FileAccess(std::move(dirInfo), rootDirAccess->token()));
+    }
+
+    if (!existingDirPaths.isEmpty()) {
+        m_libraryHashDao.invalidateDirectories(existingDirPaths);
+        m_trackDao.invalidateTrackLocationsInDirectories(existingDirPaths);
+    }
+    if (!removedDirPaths.isEmpty()) {
+        m_libraryHashDao.invalidateDirectoryTrees(removedDirPaths);
+        m_trackDao.invalidateTrackLocationsInDirectoryTrees(removedDirPaths);
+    }
+    return existingDirs;
+}
+
+QSet<QString> LibraryScanner::loadLibraryDirectories() {
+    QStringList rootDirPaths;
+    QSet<QString> dirPaths;
+    const QList<mixxx::FileInfo> rootDirs = m_directoryDao.loadAllDirectories();
+    for (const mixxx::FileInfo& rootDir : rootDirs) {
+        if (rootDir.exists() && rootDir.isDir()) {
+            rootDirPaths.append(rootDir.location());
+            dirPaths.insert(rootDir.location());
+        }
+    }
+    const QHash<QString, mixxx::cache_key_t> directoryHashes =
+            m_libraryHashDao.getDirectoryHashes();
+    for (auto it = directoryHashes.keyBegin(); it != directoryHashes.keyEnd(); ++it) {
+        const bool inLibrary = std::any_of(
+                rootDirPaths.cbegin(),
+                rootDirPaths.cend(),
+                [&it](const QString& rootDirPath) {
+                    return isInDirectory(*it, rootDirPath);
+                });
+        if (!inLibrary) {
+            continue;
+        }
+        // Parent directories without any tracks have no hash, but are
+        // watched for new subdirectories
+        QString dirPath = *it;
+        while (!dirPaths.contains(dirPath)) {
+            dirPaths.insert(dirPath);
+            const auto separatorIndex = dirPath.lastIndexOf(QChar('/'));
+            if (separatorIndex <= 0) {
+                break;
+            }
+            dirPath.truncate(separatorIndex);
+        }
+    }
+    return dirPaths;
+}
+
+void LibraryScanner::updateWatchedDirectories() {
+    if (!m_pWatcher) {
+        return;
+    }
+    if (!m_pWatcher->watchDirectories(loadLibraryDirectories())) {
+        kLogger.info()
+                << "Library directories are not watched for changes";
+        m_fullScanRequired = true;
+    }
+}
+
+void LibraryScanner::journalDirectoriesModifiedSince(const QDateTime& since) {
+    PerformanceTimer timer;
+    timer.start();
+    // Adding, removing or renaming an entry modifies the directory. Files
+    // that have been modified in place are only detected by a full scan.
+    const QDateTime modifiedSince = since.addSecs(-kModificationTimeToleranceSecs);
+    const QSet<QString> dirPaths = loadLibraryDirectories();
+    int numModifiedDirs = 0;
+    for (const auto& dirPath : dirPaths) {
+        const auto dirInfo = mixxx::FileInfo(dirPath);
+        // Deleted or moved directories are journaled themselves
+        if (!dirInfo.exists() || !dirInfo.isDir() ||
+                dirInfo.lastModified() >= modifiedSince) {
+            slotDirectoryChanged(dirPath);
+            ++numModifiedDirs;
+        }
+    }
+    kLogger.info()
+            << "Found"
+            << numModifiedDirs
+            << "of"
+            << dirPaths.size()
+            << "directories modified since the last run:"
+            << timer.elapsed().debugMillisWithUnit();
+}
+
+void LibraryScanner::startPendingScan(bool scanChanges) {
+    // The library directories might have been changed by the scan
+    updateWatchedDirectories();
+
+    if (!startDeferredScan() && scanChanges && !m_changedDirectories.isEmpty()) {
+        m_scanChangesTimer.start();
+    }
+}
+
+void LibraryScanner::scanOnStartup() {
+    m_deferredScan = STARTUP;
+    startDeferredScan();
 }
 
 void LibraryScanner::scan(bool autoscan) {
-    if (changeScannerState(STARTING)) {
-        m_manualScan = autoscan;
-        emit startScan();
+    // The request is published before the scan is started. A scan that
+    // finishes concurrently then starts it instead of losing it.
+    m_deferredScan = autoscan ? AUTO : MANUAL;
+    startDeferredScan();
+}
+
+bool LibraryScanner::startDeferredScan() {
+    // Repeated for requests that are published after the pending request
+    // has been taken but before the STARTING state has been left again
+    while (m_deferredScan != NONE && changeScannerState(STARTING)) {
+        const DeferredScan deferredScan = m_deferredScan.exchange(NONE);
+        if (deferredScan != NONE) {
+            m_manualScan = deferredScan != MANUAL;
+            m_scanChangesOnly = false;
+            // Decided by the scanner thread that knows the journal
+            m_startupScan = deferredScan == STARTUP;
+            emit startScan();
+            return true;
+        }
+        changeScannerState(IDLE);
     }
+    return false;
 }
 
 // this is called after pressing the cancel button in the scanner
@@ -518,6 +947,7 @@ void LibraryScanner::slotCancel() {
     // All pending scan start request are canceled
     // as well until the scanner is idle again.
     changeScannerState(CANCELING);
+    m_deferredScan = NONE;
     cancel();
     changeScannerState(IDLE);
 }
@@ -545,10 +975,12 @@ void LibraryScanner::cancel() {
         scanner->cancel();
     }
 
-    // Wait for the thread pool to empty. This is important because ScannerTasks
+    // Wait for the thread pools to empty. This is important because ScannerTasks
     // have pointers to the LibraryScanner and can cause a segfault if they run
-    // after the LibraryScanner has been destroyed.
+    // after the LibraryScanner has been destroyed. The directory tasks queue
+    // the import tasks and finish first.
     m_pool.waitForDone();
+    m_importPool.waitForDone();
 }
 
 void LibraryScanner::queueTask(ScannerTask* pTask) {
@@ -557,6 +989,7 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
     if (m_scannerGlobal.isNull() || m_scannerGlobal->shouldCancel()) {
         delete pTask;
         m_pool.clear();
+        m_importPool.clear();
         return;
     }
 
@@ -588,15 +1021,23 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             this,
             &LibraryScanner::slotDirectoryUnchanged);
     connect(pTask,
-            &ScannerTask::trackExists,
+            &ScannerTask::tracksExist,
             this,
-            &LibraryScanner::slotTrackExists);
+            &LibraryScanner::slotTracksExist);
     connect(pTask,
-            &ScannerTask::addNewTrack,
+            &ScannerTask::addNewTracks,
             this,
-            &LibraryScanner::slotAddNewTrack);
+            &LibraryScanner::slotAddNewTracks);
+    connect(pTask,
+            &ScannerTask::trackFilesModified,
+            this,
+            &LibraryScanner::slotTrackFilesModified);
 
-    m_pool.start(pTask);
+    if (pFileTask) {
+        m_importPool.start(pTask);
+    } else {
+        m_pool.start(pTask);
+    }
 }
 
 void LibraryScanner::slotDirectoryHashedAndScanned(const QString& directoryPath,
@@ -628,51 +1069,85 @@ void LibraryScanner::slotDirectoryUnchanged(const QString& directoryPath) {
     emit progressHashing(directoryPath);
 }
 
-void LibraryScanner::slotTrackExists(const QString& trackPath) {
-    //kLogger.debug() << "slotTrackExists" << trackPath;
-    ScopedTimer timer(QStringLiteral("LibraryScanner::slotTrackExists"));
+void LibraryScanner::slotTracksExist(const QStringList& trackPaths) {
+    //kLogger.debug() << "slotTracksExist" << trackPaths;
+    ScopedTimer timer(QStringLiteral("LibraryScanner::slotTracksExist"));
     if (m_scannerGlobal) {
-        m_scannerGlobal->addVerifiedTrack(trackPath);
-    }
-}
-
-// triggered by ScannerTask::addNewTrack / in ImportFilesTask::run()
-void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
-    // kLogger.debug() << "slotAddNewTrack" << trackPath;
-    if (!m_scannerGlobal || m_scannerGlobal->shouldCancel()) {
-        // Fix/workaround for Cancel not cancelling the entire scan process
-        // https://github.com/mixxxdj/mixxx/issues/14940
-        // Pretty quickly after starting the scan, many ImportFilesTask queue
-        // many addNewTrack() signals connected to this slot. When cancelling the
-        // scan via Cancel button in the progress dialog, all signals are usually
-        // already queued, hence Cancel has no effect on these calls and Mixxx
-        // keeps adding/analyzing tracks as if nothing happened.
-        // Simply abort here does the trick.
-        return;
-    }
-    ScopedTimer timer(QStringLiteral("LibraryScanner::addNewTrack"));
-    // For statistics tracking and to detect moved tracks
-    TrackPointer pTrack = m_trackDao.addTracksAddFile(
-            trackPath,
-            false);
-    if (!pTrack) {
-        // This happens only when there is an issue with the database which
-        // has been logged already. No need for yet another warning here.
-        return;
+        for (const auto& trackPath : trackPaths) {
+            m_scannerGlobal->addVerifiedTrack(trackPath);
+        }
     }
+}
 
-    DEBUG_ASSERT(!pTrack->isDirty());
-    // The track's actual location might differ from the
-    // given trackPath
-    const QString trackLocation = pTrack->getLocation();
-    // Acknowledge successful track addition
-    if (m_scannerGlobal) {
+// triggered by ScannerTask::addNewTracks / in ImportFilesTask::run()
+void LibraryScanner::slotAddNewTracks(const QList<ImportedTrackFile>& files) {
+    // kLogger.debug() << "slotAddNewTracks" << files.size();
+    ScopedTimer timer(QStringLiteral("LibraryScanner::addNewTracks"));
+    for (const auto& file : files) {
+        if (!m_scannerGlobal || m_scannerGlobal->shouldCancel()) {
+            // Fix/workaround for Cancel not cancelling the entire scan process
+            // https://github.com/mixxxdj/mixxx/issues/14940
+            // Pretty quickly after starting the scan, many ImportFilesTask queue
+            // many addNewTracks() signals connected to this slot. When cancelling
+            // the scan via Cancel button in the progress dialog, all signals are
+            // usually already queued, hence Cancel has no effect on these calls
+            // and Mixxx keeps adding/analyzing tracks as if nothing happened.
+            // Simply abort here does the trick.
+            break;
+        }
+        // The metadata has already been imported by the worker thread,
+        // only the database needs to be updated here.
+        TrackPointer pTrack = m_trackDao.addTracksAddFile(
+                file.location,
+                false,
+                &file.metadata);
+        if (!pTrack) {
+            // This happens only when there is an issue with the database which
+            // has been logged already. No need for yet another warning here.
+            continue;
+        }
+
+        DEBUG_ASSERT(!pTrack->isDirty());
+        // The track's actual location might differ from the
+        // given location
+        const QString trackLocation = pTrack->getLocation();
+        // Acknowledge successful track addition
+        // For statistics tracking and to detect moved tracks
         m_scannerGlobal->trackAdded(trackLocation);
+        // Signal the main instance of TrackDAO, that there is
+        // a new track in the database.
+        emit trackAdded(pTrack);
+        emit progressLoading(trackLocation);
+    }
+}
+
+void LibraryScanner::slotTrackFilesModified(const QList<ModifiedTrackFile>& files) {
+    ScopedTimer timer(QStringLiteral("LibraryScanner::slotTrackFilesModified"));
+    // Re-importing the metadata would overwrite the changes in the library
+    // unless the user has decided to keep it synchronized with the files
+    const bool reimportMetadata = m_pConfig->getValue(
+            mixxx::library::prefs::kSyncTrackMetadataConfigKey, false);
+    for (const auto& file : files) {
+        if (!m_scannerGlobal || m_scannerGlobal->shouldCancel()) {
+            break;
+        }
+        // Unknown fingerprints of tracks that have been added by previous
+        // versions are stored once without checking the file
+        const bool modified =
+                m_scannerGlobal->trackFileFingerprintInDatabase(file.location).isValid();
+        m_trackDao.updateTrackFileFingerprint(file.location, file.fingerprint);
+        if (!modified || !reimportMetadata) {
+            continue;
+        }
+        // Loading the track re-imports the metadata if the file is newer
+        // than the last synchronization, see TrackDAO::getTrackById()
+        const TrackPointer pTrack =
+                m_trackDao.getTrackByRef(TrackRef::fromFilePath(file.location));
+        if (pTrack && pTrack->isDirty()) {
+            m_scannerGlobal->trackModified();
+            emit progressLoading(file.location);
+        }
     }
-    // Signal the main instance of TrackDAO, that there is
-    // a new track in the database.
-    emit trackAdded(pTrack);
-    emit progressLoading(trackLocation);
 }
 
 bool LibraryScanner::changeScannerState(ScannerState newState) {
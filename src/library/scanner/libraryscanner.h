@@ -7,6 +7,9 @@
 #include <QSemaphore>
 #include <QThread>
 #include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <memory>
 
 #include "library/dao/analysisdao.h"
 #include "library/dao/cuedao.h"
@@ -14,17 +17,22 @@
 #include "library/dao/libraryhashdao.h"
 #include "library/dao/playlistdao.h"
 #include "library/dao/trackdao.h"
+#include "library/dao/tracksearchindexdao.h"
 #include "library/scanner/scannerglobal.h"
+#include "library/scanner/scannertask.h"
 #include "track/track_decl.h"
 #include "util/db/dbconnectionpool.h"
 
-class ScannerTask;
 class LibraryScannerDlg;
+class LibraryWatcher;
+class QDateTime;
 class QString;
 struct LibraryScanResultSummary;
 
 class LibraryScanner : public QThread {
     FRIEND_TEST(LibraryScannerTest, ScannerRoundtrip);
+    FRIEND_TEST(LibraryScannerTest, ScanOnlyChangedDirectories);
+    FRIEND_TEST(LibraryScannerTest, ScanChangesOnStartup);
     Q_OBJECT
   public:
     LibraryScanner(
@@ -34,12 +42,19 @@ class LibraryScanner : public QThread {
 
   public slots:
     // Call from any thread to start a scan. Does nothing if a scan is already
-    // in progress.
+    // in progress. If only the directories that have been changed are scanned
+    // in the background the scan is started afterwards.
     // The autoscan flag is used for the summary report. Receivers of scanSummary()
     // can use this to decide whether to show the summary dialog, for example hide
     // it for the automatic scan during startup.
     void scan(bool autoscan = false);
 
+    // Call from any thread to verify the library after startup like an
+    // autoscan. If all changes of the previous run have been journaled
+    // only the directories that have been changed since then are scanned
+    // instead of walking the whole library.
+    void scanOnStartup();
+
     // Call from any thread to cancel the scan.
     void slotCancel();
 
@@ -69,12 +84,19 @@ class LibraryScanner : public QThread {
     void slotFinishHashedScan();
     void slotFinishUnhashedScan();
 
+    // Scans only the directories reported by the LibraryWatcher
+    void slotScanChanges();
+    void slotDirectoryChanged(const QString& dirPath);
+    void slotWatcherOverflowed();
+    void slotOptimizeDatabase();
+
     // ScannerTask signal handlers.
     void slotDirectoryHashedAndScanned(const QString& directoryPath,
                                    bool newDirectory, mixxx::cache_key_t hash);
     void slotDirectoryUnchanged(const QString& directoryPath);
-    void slotTrackExists(const QString& trackPath);
-    void slotAddNewTrack(const QString& trackPath);
+    void slotTracksExist(const QStringList& trackPaths);
+    void slotAddNewTracks(const QList<ImportedTrackFile>& files);
+    void slotTrackFilesModified(const QList<ModifiedTrackFile>& files);
 
   private:
     enum ScannerState {
@@ -100,10 +122,27 @@ class LibraryScanner : public QThread {
 
     void cleanUpScan();
 
+    QList<mixxx::FileAccess> invalidateChangedDirectories();
+    // The directories that contain tracks and their parent directories
+    // within the library
+    QSet<QString> loadLibraryDirectories();
+    void updateWatchedDirectories();
+    // Journals the directories that have been modified while Mixxx was
+    // not running
+    void journalDirectoriesModifiedSince(const QDateTime& since);
+    void startPendingScan(bool scanChanges);
+    // Starts the scan that has been requested by scan() if the scanner
+    // is idle. Returns false if no scan has been started.
+    bool startDeferredScan();
+
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
 
-    // The pool of threads used for worker tasks.
+    // The pool of threads used for traversing the directories.
     QThreadPool m_pool;
+    // The pool of threads used for importing the metadata of new files
+    // concurrently. The tracks are then added by the scanner thread.
+    QThreadPool m_importPool;
 
     // The library scanner thread's DAOs.
     LibraryHashDAO m_libraryHashDao;
@@ -111,6 +150,7 @@ class LibraryScanner : public QThread {
     PlaylistDAO m_playlistDao;
     DirectoryDAO m_directoryDao;
     AnalysisDao m_analysisDao;
+    TrackSearchIndexDAO m_trackSearchIndexDao;
     TrackDAO m_trackDao;
 
     // Global scanner state for scan currently in progress.
@@ -130,4 +170,27 @@ class LibraryScanner : public QThread {
     std::unique_ptr<LibraryScannerDlg> m_pProgressDlg;
 
     bool m_manualScan;
+
+    enum DeferredScan {
+        NONE,
+        MANUAL,
+        AUTO,
+        STARTUP
+    };
+
+    std::unique_ptr<LibraryWatcher> m_pWatcher;
+    QTimer m_scanChangesTimer;
+    QTimer m_optimizeDatabaseTimer;
+    // Mirrors the journal in the database
+    QSet<QString> m_changedDirectories;
+    QStringList m_scannedChangedDirectories;
+    // this is accessed main and LibraryScanner thread
+    std::atomic<bool> m_scanChangesOnly;
+    std::atomic<bool> m_startupScan;
+    // Set if changes might have been missed, e.g. while Mixxx was not
+    // running or if the watcher overflowed, until a full scan has finished.
+    // Otherwise the journal is persisted as complete on shutdown.
+    bool m_fullScanRequired;
+    // The last request of scan() that has not been started yet
+    std::atomic<DeferredScan> m_deferredScan;
 };
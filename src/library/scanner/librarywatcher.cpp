@@ -0,0 +1,191 @@
+#include "library/scanner/librarywatcher.h"
+
+#include <QFile>
+#include <QSocketNotifier>
+#include <utility>
+
+#ifdef __LINUX__
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "moc_librarywatcher.cpp"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("LibraryWatcher");
+
+#ifdef __LINUX__
+// New files are reported by IN_CLOSE_WRITE after they have been written
+// completely. IN_CREATE is only needed for new directories.
+constexpr uint32_t kWatchMask = IN_CREATE | IN_CLOSE_WRITE |
+        IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE |
+        IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+} // anonymous namespace
+
+LibraryWatcher::LibraryWatcher(QObject* pParent)
+        : QObject(pParent)
+#ifdef __LINUX__
+          ,
+          m_fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)),
+          m_pNotifier(nullptr)
+#endif
+{
+#ifdef __LINUX__
+    if (m_fd < 0) {
+        kLogger.warning()
+                << "Failed to initialize inotify:"
+                << strerror(errno);
+        return;
+    }
+    m_pNotifier = new QSocketNotifier(m_fd, QSocketNotifier::Read, this);
+    connect(m_pNotifier,
+            &QSocketNotifier::activated,
+            this,
+            &LibraryWatcher::readEvents);
+#endif
+}
+
+LibraryWatcher::~LibraryWatcher() {
+#ifdef __LINUX__
+    if (m_fd >= 0) {
+        // Closing the file descriptor removes all watches
+        m_pNotifier->setEnabled(false);
+        close(m_fd);
+    }
+#endif
+}
+
+bool LibraryWatcher::watchDirectories(const QSet<QString>& dirPaths) {
+#ifdef __LINUX__
+    if (m_fd < 0) {
+        return false;
+    }
+    // Remove the obsolete watches first. The inode of a directory that has
+    // been moved still has the watch descriptor of its previous path.
+    for (auto it = m_watchDescriptors.begin(); it != m_watchDescriptors.end();) {
+        if (dirPaths.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        inotify_rm_watch(m_fd, it.value());
+        m_watchedPaths.remove(it.value());
+        it = m_watchDescriptors.erase(it);
+    }
+    for (const auto& dirPath : dirPaths) {
+        if (m_watchDescriptors.contains(dirPath)) {
+            continue;
+        }
+        const int wd = inotify_add_watch(
+                m_fd, QFile::encodeName(dirPath).constData(), kWatchMask);
+        if (wd < 0) {
+            if (errno == ENOSPC) {
+                kLogger.warning()
+                        << "Unable to watch all"
+                        << dirPaths.size()
+                        << "library directories, consider increasing"
+                        << "fs.inotify.max_user_watches";
+                unwatchAll();
+                return false;
+            }
+            // The directory has been deleted in the meantime
+            continue;
+        }
+        if (m_watchedPaths.contains(wd)) {
+            // Another path of the same directory, e.g. by a symlink
+            continue;
+        }
+        m_watchDescriptors.insert(dirPath, wd);
+        m_watchedPaths.insert(wd, dirPath);
+    }
+    kLogger.debug()
+            << "Watching"
+            << m_watchDescriptors.size()
+            << "directories";
+    return true;
+#else
+    Q_UNUSED(dirPaths);
+    return false;
+#endif
+}
+
+void LibraryWatcher::unwatchAll() {
+#ifdef __LINUX__
+    for (const int wd : std::as_const(m_watchDescriptors)) {
+        inotify_rm_watch(m_fd, wd);
+    }
+#endif
+    m_watchDescriptors.clear();
+    m_watchedPaths.clear();
+}
+
+void LibraryWatcher::unwatchTree(const QString& dirPath) {
+#ifdef __LINUX__
+    const QString prefix = dirPath + QChar('/');
+    for (auto it = m_watchDescriptors.begin(); it != m_watchDescriptors.end();) {
+        if (it.key() != dirPath && !it.key().startsWith(prefix)) {
+            ++it;
+            continue;
+        }
+        inotify_rm_watch(m_fd, it.value());
+        m_watchedPaths.remove(it.value());
+        it = m_watchDescriptors.erase(it);
+    }
+#else
+    Q_UNUSED(dirPath);
+#endif
+}
+
+void LibraryWatcher::readEvents() {
+#ifdef __LINUX__
+    alignas(struct inotify_event) char buffer[4096];
+    for (;;) {
+        const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN, no more events pending
+            break;
+        }
+        for (const char* pNext = buffer; pNext < buffer + length;) {
+            const auto* pEvent = reinterpret_cast<const struct inotify_event*>(pNext);
+            pNext += sizeof(struct inotify_event) + pEvent->len;
+            if (pEvent->mask & IN_Q_OVERFLOW) {
+                kLogger.warning() << "Event queue overflowed";
+                emit overflowed();
+                continue;
+            }
+            const QString dirPath = m_watchedPaths.value(pEvent->wd);
+            if (dirPath.isEmpty()) {
+                // Pending events of a removed watch
+                continue;
+            }
+            if (pEvent->mask & IN_IGNORED) {
+                m_watchedPaths.remove(pEvent->wd);
+                m_watchDescriptors.remove(dirPath);
+                continue;
+            }
+            if (pEvent->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                // The paths of the directory and its subdirectories
+                // are invalid now
+                unwatchTree(dirPath);
+                emit directoryChanged(dirPath);
+                continue;
+            }
+            const bool isDir = pEvent->mask & IN_ISDIR;
+            if ((pEvent->mask & IN_CREATE) && !isDir) {
+                continue;
+            }
+            if (isDir && pEvent->len > 0 &&
+                    (pEvent->mask & (IN_DELETE | IN_MOVED_FROM))) {
+                emit directoryChanged(dirPath + QChar('/') +
+                        QFile::decodeName(pEvent->name));
+            }
+            emit directoryChanged(dirPath);
+        }
+    }
+#endif
+}
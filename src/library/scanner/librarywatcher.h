@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+class QSocketNotifier;
+
+/// Watches the directories of the music library for changes while Mixxx
+/// is running, so that only the changed directories need to be rescanned.
+///
+/// Reports directories that have files added, written, moved or deleted.
+/// A directory that has been deleted or moved away is reported itself.
+/// Modifications of the directory tree itself are not tracked, the
+/// watched directories must be updated after each scan.
+///
+/// Only implemented with inotify on Linux. On other platforms no
+/// directories are watched.
+class LibraryWatcher : public QObject {
+    Q_OBJECT
+  public:
+    explicit LibraryWatcher(QObject* pParent = nullptr);
+    ~LibraryWatcher() override;
+
+    /// Watches exactly the given directories. Returns false and stops
+    /// watching if not all of them could be watched, e.g. if the limit of
+    /// the system has been exceeded.
+    bool watchDirectories(const QSet<QString>& dirPaths);
+
+    void unwatchAll();
+
+    bool isWatching() const {
+        return !m_watchDescriptors.isEmpty();
+    }
+
+  signals:
+    void directoryChanged(const QString& dirPath);
+
+    /// Changes might have been missed, all directories need to be rescanned.
+    void overflowed();
+
+  private:
+    void readEvents();
+    void unwatchTree(const QString& dirPath);
+
+#ifdef __LINUX__
+    int m_fd;
+    QSocketNotifier* m_pNotifier;
+#endif
+
+    QHash<QString, int> m_watchDescriptors;
+    QHash<int, QString> m_watchedPaths;
+};
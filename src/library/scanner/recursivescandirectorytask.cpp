@@ -13,10 +13,12 @@ RecursiveScanDirectoryTask::RecursiveScanDirectoryTask(
         LibraryScanner* pScanner,
         const ScannerGlobalPointer& scannerGlobal,
         const mixxx::FileAccess&& dirAccess,
-        bool scanUnhashed)
+        bool scanUnhashed,
+        bool scanHashedSubdirs)
         : ScannerTask(pScanner, scannerGlobal),
           m_dirAccess(std::move(dirAccess)),
-          m_scanUnhashed(scanUnhashed) {
+          m_scanUnhashed(scanUnhashed),
+          m_scanHashedSubdirs(scanHashedSubdirs) {
 }
 
 void RecursiveScanDirectoryTask::run() {
@@ -109,6 +111,25 @@ void RecursiveScanDirectoryTask::run() {
                 emit directoryHashedAndScanned(dirLocation, !prevHashExists, newHash);
             }
         } else {
+            // The same files, but they might have been modified in place.
+            // Only the files of existing tracks need to be checked.
+            QList<ModifiedTrackFile> modifiedTracks;
+            for (const QFileInfo& fileInfo : filesToImport) {
+                const QString trackLocation = mixxx::FileInfo(fileInfo).location();
+                if (!m_scannerGlobal->trackExistsInDatabase(trackLocation)) {
+                    continue;
+                }
+                const auto fingerprint = TrackFileFingerprint::fromFileInfo(fileInfo);
+                if (fingerprint.isValid() &&
+                        fingerprint !=
+                                m_scannerGlobal->trackFileFingerprintInDatabase(
+                                        trackLocation)) {
+                    modifiedTracks.append(ModifiedTrackFile{trackLocation, fingerprint});
+                }
+            }
+            if (!modifiedTracks.isEmpty()) {
+                emit trackFilesModified(modifiedTracks);
+            }
             emit directoryUnchanged(dirLocation);
         }
     } else {
@@ -117,6 +138,12 @@ void RecursiveScanDirectoryTask::run() {
 
     // Process all of the sub-directories.
     for (const mixxx::FileInfo& dirInfo : dirsToScan) {
+        if (!m_scanHashedSubdirs &&
+                mixxx::isValidCacheKey(m_scannerGlobal->directoryHashInDatabase(
+                        dirInfo.location()))) {
+            // Known subdirectories are only scanned if they have changed
+            continue;
+        }
         // Atomically test and mark the directory as scanned to avoid
         // that the same directory is scanned multiple times by different
         // tasks.
@@ -126,7 +153,8 @@ void RecursiveScanDirectoryTask::run() {
                             m_pScanner,
                             m_scannerGlobal,
                             mixxx::FileAccess(dirInfo, m_dirAccess.token()),
-                            m_scanUnhashed));
+                            m_scanUnhashed,
+                            m_scanHashedSubdirs));
         }
     }
     setSuccess(true);
@@ -8,13 +8,17 @@
 /// performing a hash of the directory's file list, and those hashes are stored
 /// in the database. Successful if the scan completed without being
 /// cancelled. False if the scan was cancelled part-way through.
+///
+/// Subdirectories that have a hash are skipped if scanHashedSubdirs is false,
+/// e.g. when only the directories reported by the LibraryWatcher are scanned.
 class RecursiveScanDirectoryTask : public ScannerTask {
     Q_OBJECT
   public:
     RecursiveScanDirectoryTask(LibraryScanner* pScanner,
             const ScannerGlobalPointer& scannerGlobal,
             const mixxx::FileAccess&& dirAccess,
-            bool scanUnhashed);
+            bool scanUnhashed,
+            bool scanHashedSubdirs = true);
     ~RecursiveScanDirectoryTask() override = default;
 
     void run() override;
@@ -22,4 +26,5 @@ class RecursiveScanDirectoryTask : public ScannerTask {
   private:
     const mixxx::FileAccess m_dirAccess;
     const bool m_scanUnhashed;
+    const bool m_scanHashedSubdirs;
 };
@@ -8,6 +8,8 @@
 #include <QSharedPointer>
 #include <QStringList>
 
+#include "library/trackfilefingerprint.h"
+#include "track/track_decl.h"
 #include "util/cache.h"
 #include "util/compatibility/qmutex.h"
 #include "util/fileaccess.h"
@@ -16,21 +18,24 @@
 
 class ScannerGlobal {
   public:
-    ScannerGlobal(const QSet<QString>& trackLocations,
+    ScannerGlobal(const QHash<QString, TrackFileFingerprint>& trackFileFingerprints,
             const QHash<QString, mixxx::cache_key_t>& directoryHashes,
             const QRegularExpression& supportedExtensionsMatcher,
             const QRegularExpression& supportedCoverExtensionsMatcher,
-            const QStringList& directoriesBlacklist)
-            : m_trackLocations(trackLocations),
+            const QStringList& directoriesBlacklist,
+            const SyncTrackMetadataParams& syncTrackMetadataParams)
+            : m_trackFileFingerprints(trackFileFingerprints),
               m_directoryHashes(directoryHashes),
               m_supportedExtensionsMatcher(supportedExtensionsMatcher),
               m_supportedCoverExtensionsMatcher(supportedCoverExtensionsMatcher),
               m_directoriesBlacklist(directoriesBlacklist),
+              m_syncTrackMetadataParams(syncTrackMetadataParams),
               // Unless marked un-clean, we assume it will finish cleanly.
               m_scanFinishedCleanly(true),
               m_shouldCancel(false),
               m_numScannedDirectories(0),
-              m_numRelocatedTracks(0) {
+              m_numRelocatedTracks(0),
+              m_numModifiedTracks(0) {
     }
 
     TaskWatcher& getTaskWatcher() {
@@ -39,7 +44,12 @@ class ScannerGlobal {
 
     // Returns whether the track already exists in the database.
     bool trackExistsInDatabase(const QString& trackLocation) const {
-        return m_trackLocations.contains(trackLocation);
+        return m_trackFileFingerprints.contains(trackLocation);
+    }
+
+    // Returns the fingerprint of the track's file from the last scan.
+    TrackFileFingerprint trackFileFingerprintInDatabase(const QString& trackLocation) const {
+        return m_trackFileFingerprints.value(trackLocation);
     }
 
     // Returns the directory hash if it exists or mixxx::invalidCacheKey() if it doesn't.
@@ -95,6 +105,12 @@ class ScannerGlobal {
         return match.hasMatch();
     }
 
+    // The parameters for importing the metadata of new tracks, read
+    // once when the scan is started.
+    const SyncTrackMetadataParams& syncTrackMetadataParams() const {
+        return m_syncTrackMetadataParams;
+    }
+
     bool shouldCancel() const {
         return m_shouldCancel;
     }
@@ -161,10 +177,17 @@ class ScannerGlobal {
         m_numRelocatedTracks += numTracks;
     }
 
+    int numModifiedTracks() const {
+        return m_numModifiedTracks;
+    }
+    void trackModified() {
+        m_numModifiedTracks++;
+    }
+
   private:
     TaskWatcher m_watcher;
 
-    QSet<QString> m_trackLocations;
+    QHash<QString, TrackFileFingerprint> m_trackFileFingerprints;
     QHash<QString, mixxx::cache_key_t> m_directoryHashes;
 
     mutable QMutex m_supportedExtensionsMatcherMutex;
@@ -190,6 +213,8 @@ class ScannerGlobal {
     // this has never been investigated.
     QStringList m_directoriesBlacklist;
 
+    const SyncTrackMetadataParams m_syncTrackMetadataParams;
+
     // The list of directories verified by the scan.
     QStringList m_verifiedDirectories;
 
@@ -206,6 +231,7 @@ class ScannerGlobal {
     PerformanceTimer m_timer;
     int m_numScannedDirectories;
     int m_numRelocatedTracks;
+    int m_numModifiedTracks;
 };
 
 typedef QSharedPointer<ScannerGlobal> ScannerGlobalPointer;
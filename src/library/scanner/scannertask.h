@@ -1,12 +1,31 @@
 #pragma once
 
+#include <QList>
 #include <QObject>
 #include <QRunnable>
+#include <QStringList>
 
 #include "library/scanner/scannerglobal.h"
+#include "sources/soundsourceproxy.h"
 
 class LibraryScanner;
 
+/// A new file and the metadata that has been imported from it
+/// by a worker thread.
+struct ImportedTrackFile {
+    QString location;
+    SoundSourceProxy::ImportedMetadata metadata;
+};
+Q_DECLARE_METATYPE(ImportedTrackFile);
+
+/// The file of an existing track that has been modified since the
+/// last scan.
+struct ModifiedTrackFile {
+    QString location;
+    TrackFileFingerprint fingerprint;
+};
+Q_DECLARE_METATYPE(ModifiedTrackFile);
+
 class ScannerTask : public QObject, public QRunnable {
     Q_OBJECT
   public:
@@ -22,8 +41,9 @@ class ScannerTask : public QObject, public QRunnable {
     void directoryHashedAndScanned(const QString& directoryPath,
                                    bool newDirectory, mixxx::cache_key_t hash);
     void directoryUnchanged(const QString& directoryPath);
-    void trackExists(const QString& filePath);
-    void addNewTrack(const QString& filePath);
+    void tracksExist(const QStringList& filePaths);
+    void addNewTracks(const QList<ImportedTrackFile>& files);
+    void trackFilesModified(const QList<ModifiedTrackFile>& files);
 
   protected:
     void setSuccess(bool success) {
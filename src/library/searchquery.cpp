@@ -4,6 +4,7 @@
 #include <QRegularExpression>
 
 #include "library/dao/trackschema.h"
+#include "library/dao/tracksearchindexdao.h"
 #include "library/queryutil.h"
 #include "library/trackset/crate/crateschema.h"
 #include "library/trackset/crate/cratestorage.h" // for CrateTrackSelectResult
@@ -173,11 +174,13 @@ QString NotNode::toSql() const {
 TextFilterNode::TextFilterNode(const QSqlDatabase& database,
         const QStringList& sqlColumns,
         const QString& argument,
-        const StringMatch matchMode)
+        const StringMatch matchMode,
+        const TrackSearchIndexDAO* pSearchIndex)
         : m_database(database),
           m_sqlColumns(sqlColumns),
           m_argument(argument),
-          m_matchMode(matchMode) {
+          m_matchMode(matchMode),
+          m_pSearchIndex(pSearchIndex) {
     mixxx::DbConnection::makeStringLatinLow(&m_argument);
 }
 
@@ -204,6 +207,13 @@ bool TextFilterNode::match(const TrackPointer& pTrack) const {
 }
 
 QString TextFilterNode::toSql() const {
+    if (m_pSearchIndex && m_matchMode == StringMatch::Contains) {
+        const QString indexFilter =
+                m_pSearchIndex->formatContainsFilter(m_sqlColumns, m_argument);
+        if (!indexFilter.isEmpty()) {
+            return indexFilter;
+        }
+    }
     FieldEscaper escaper(m_database);
     QString argument = m_argument;
     if (argument.size() > 0) {
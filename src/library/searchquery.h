@@ -16,6 +16,7 @@
 
 class CrateStorage;
 class TrackId;
+class TrackSearchIndexDAO;
 
 const QString kMissingFieldSearchTerm = "\"\""; // "" searches for an empty string
 
@@ -78,10 +79,13 @@ class NotNode : public QueryNode {
 
 class TextFilterNode : public QueryNode {
   public:
+    /// If a search index is provided it is used for all queries it is able
+    /// to answer, otherwise the columns are matched with LIKE.
     TextFilterNode(const QSqlDatabase& database,
             const QStringList& sqlColumns,
             const QString& argument,
-            const StringMatch matchMode = StringMatch::Contains);
+            const StringMatch matchMode = StringMatch::Contains,
+            const TrackSearchIndexDAO* pSearchIndex = nullptr);
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
@@ -91,6 +95,7 @@ class TextFilterNode : public QueryNode {
     QStringList m_sqlColumns;
     QString m_argument;
     StringMatch m_matchMode;
+    const TrackSearchIndexDAO* m_pSearchIndex;
 };
 
 class NullOrEmptyTextFilterNode : public QueryNode {
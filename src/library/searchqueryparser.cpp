@@ -69,6 +69,7 @@ const QRegularExpression kSplitOnOrOperatorRegexp = QRegularExpression(
 
 SearchQueryParser::SearchQueryParser(TrackCollection* pTrackCollection, QStringList searchColumns)
         : m_pTrackCollection(pTrackCollection),
+          m_pSearchIndex(nullptr),
           m_searchCrates(false) {
     setSearchColumns(std::move(searchColumns));
 
@@ -228,7 +229,8 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                             m_pTrackCollection->database(),
                             m_fieldToSqlColumns[field],
                             argument,
-                            matchMode);
+                            matchMode,
+                            m_pSearchIndex);
                 }
             }
         } else if (numericFilterMatch.hasMatch()) {
@@ -306,11 +308,19 @@ void SearchQueryParser::parseTokens(QStringList tokens,
                     gNode->addNode(std::make_unique<CrateFilterNode>(
                                     &m_pTrackCollection->crates(), argument));
                     gNode->addNode(std::make_unique<TextFilterNode>(
-                            m_pTrackCollection->database(), m_queryColumns, argument));
+                            m_pTrackCollection->database(),
+                            m_queryColumns,
+                            argument,
+                            StringMatch::Contains,
+                            m_pSearchIndex));
                     pNode = std::move(gNode);
                 } else {
                     pNode = std::make_unique<TextFilterNode>(
-                            m_pTrackCollection->database(), m_queryColumns, argument);
+                            m_pTrackCollection->database(),
+                            m_queryColumns,
+                            argument,
+                            StringMatch::Contains,
+                            m_pSearchIndex);
                 }
             }
         }
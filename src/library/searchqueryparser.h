@@ -8,6 +8,7 @@
 #include "util/class.h"
 
 class TrackCollection;
+class TrackSearchIndexDAO;
 class QueryNode;
 class AndNode;
 
@@ -17,6 +18,12 @@ class SearchQueryParser {
 
     void setSearchColumns(QStringList searchColumns);
 
+    /// Text searches that can be answered by the index will use it instead
+    /// of LIKE. Only applicable for queries on the internal library.
+    void setSearchIndex(const TrackSearchIndexDAO* pSearchIndex) {
+        m_pSearchIndex = pSearchIndex;
+    }
+
     std::unique_ptr<QueryNode> parseQuery(
             const QString& query,
             const QString& extraFilter) const;
@@ -43,6 +50,7 @@ class SearchQueryParser {
             bool removeLeadingEqualsSign = true) const;
 
     TrackCollection* m_pTrackCollection;
+    const TrackSearchIndexDAO* m_pSearchIndex;
     QStringList m_queryColumns;
     bool m_searchCrates;
     QStringList m_textFilters;
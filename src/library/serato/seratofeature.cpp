@@ -915,6 +915,8 @@ SeratoFeature::SeratoFeature(
 SeratoFeature::~SeratoFeature() {
     m_databasesFuture.waitForFinished();
     m_tracksFuture.waitForFinished();
+    // A search might still read the tables
+    m_pSeratoPlaylistModel->maybeStopModelPopulation();
 
     // Drop temporary Serato database tables on shutdown
     QSqlDatabase database = m_pTrackCollection->database();
@@ -81,12 +81,16 @@ void CoverArtDelegate::requestUncachedCover(
 void CoverArtDelegate::slotInhibitLazyLoading(
         bool inhibitLazyLoading) {
     m_inhibitLazyLoading = inhibitLazyLoading;
-    if (m_inhibitLazyLoading || m_cacheMissRows.isEmpty()) {
+    if (m_inhibitLazyLoading || !m_pCache) {
         return;
     }
     VERIFY_OR_DEBUG_ASSERT(m_pTrackModel) {
         return;
     }
+    if (m_pTableView->isColumnHidden(m_column)) {
+        m_cacheMissRows.clear();
+        return;
+    }
     const double scaleFactor = m_pTableView->devicePixelRatioF();
     const int width = static_cast<int>(m_pTableView->columnWidth(m_column) * scaleFactor);
 
@@ -99,6 +103,48 @@ void CoverArtDelegate::slotInhibitLazyLoading(
         }
     }
     m_cacheMissRows.clear();
+
+    // The user has stopped scrolling. The prefetched covers are
+    // loaded after the visible ones.
+    prefetchCovers(width);
+}
+
+void CoverArtDelegate::prefetchCovers(int width) {
+    const QAbstractItemModel* pModel = m_pTableView->model();
+    const QRect viewportRect = m_pTableView->viewport()->rect();
+    const int firstVisibleRow = m_pTableView->rowAt(viewportRect.top());
+    if (firstVisibleRow < 0) {
+        // Empty table
+        return;
+    }
+    int lastVisibleRow = m_pTableView->rowAt(viewportRect.bottom());
+    if (lastVisibleRow < 0) {
+        // The rows don't fill the viewport
+        lastVisibleRow = pModel->rowCount() - 1;
+    }
+    // One page in both directions
+    const int pageRows = lastVisibleRow - firstVisibleRow + 1;
+    const auto prefetchRow = [this, pModel, width](int row) {
+        const QModelIndex index = pModel->index(row, m_column);
+        const CoverInfo coverInfo = m_pTrackModel->getCoverInfo(index);
+        // Covers with a legacy hash would need to load the track
+        // for updating it, which is only done for visible rows
+        if (!coverInfo.hasImage() ||
+                coverInfo.imageDigest().isEmpty() ||
+                m_pendingCacheRows.contains(coverInfo.cacheKey()) ||
+                !CoverArtCache::getCachedCover(coverInfo, width).isNull()) {
+            return;
+        }
+        requestUncachedCover(coverInfo, width, row);
+    };
+    const int endRow = std::min(lastVisibleRow + 1 + pageRows, pModel->rowCount());
+    for (int row = lastVisibleRow + 1; row < endRow; ++row) {
+        prefetchRow(row);
+    }
+    const int beginRow = std::max(firstVisibleRow - pageRows, 0);
+    for (int row = firstVisibleRow - 1; row >= beginRow; --row) {
+        prefetchRow(row);
+    }
 }
 
 void CoverArtDelegate::slotCoverFound(
@@ -56,6 +56,9 @@ class CoverArtDelegate : public TableItemDelegate {
     void emitRowsChanged(
             QList<int>&& rows);
     void cleanCacheMissRows() const;
+    // Loads the covers of the rows around the visible rows
+    // into the cache before the user scrolls to them.
+    void prefetchCovers(int width);
     void requestUncachedCover(
             const CoverInfo& coverInfo,
             int width,
@@ -21,7 +21,8 @@ TrackCollection::TrackCollection(
         : QObject(parent),
           m_analysisDao(pConfig),
           m_trackDao(m_cueDao, m_playlistDao,
-                     m_analysisDao, m_libraryHashDao, pConfig) {
+                     m_analysisDao, m_libraryHashDao,
+                     m_trackSearchIndexDao, pConfig) {
     // Forward signals from TrackDAO
     connect(&m_trackDao,
             &TrackDAO::trackDirty,
@@ -77,6 +78,8 @@ void TrackCollection::connectDatabase(const QSqlDatabase& database) {
     m_directoryDao.initialize(database);
     m_analysisDao.initialize(database);
     m_libraryHashDao.initialize(database);
+    m_trackSearchIndexDao.initialize(database);
+    m_trackSearchIndexDao.rebuildIfOutdated();
     m_crates.connectDatabase(database);
 }
 
@@ -42,6 +42,7 @@ TrackCollectionManager::TrackCollectionManager(
         deleteTrackFn_t /*only-needed-for-testing*/ deleteTrackForTestingFn)
     : QObject(parent),
       m_pConfig(pConfig),
+      m_pDbConnectionPool(pDbConnectionPool),
       m_pInternalCollection(createInternalTrackCollection(this, pConfig, deleteTrackForTestingFn)) {
     const QSqlDatabase dbConnection = mixxx::DbConnectionPooled(pDbConnectionPool);
 
@@ -179,6 +180,13 @@ void TrackCollectionManager::startLibraryAutoScan() {
     m_pScanner->scan(true);
 }
 
+void TrackCollectionManager::startLibraryStartupScan() {
+    VERIFY_OR_DEBUG_ASSERT(m_pScanner) {
+        return;
+    }
+    m_pScanner->scanOnStartup();
+}
+
 void TrackCollectionManager::startLibraryScan() {
     VERIFY_OR_DEBUG_ASSERT(m_pScanner) {
         return;
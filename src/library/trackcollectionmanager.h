@@ -48,6 +48,11 @@ class TrackCollectionManager: public QObject,
         return m_externalCollections;
     }
 
+    /// For database queries on worker threads
+    const mixxx::DbConnectionPoolPtr& dbConnectionPool() const {
+        return m_pDbConnectionPool;
+    }
+
     TrackPointer getTrackById(
             TrackId trackId) const;
     TrackPointer getTrackByRef(
@@ -97,6 +102,9 @@ class TrackCollectionManager: public QObject,
     SaveTrackResult saveTrack(const TrackPointer& pTrack) const;
     // Same as startLibraryScan() but don't emit the scan summary.
     void startLibraryAutoScan();
+    // Same as startLibraryAutoScan() but only scans the changes since the
+    // last run if they are known.
+    void startLibraryStartupScan();
 
   signals:
     void libraryScanStarted();
@@ -129,6 +137,8 @@ class TrackCollectionManager: public QObject,
 
     const UserSettingsPointer m_pConfig;
 
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
     const parented_ptr<TrackCollection> m_pInternalCollection;
 
     QList<ExternalTrackCollection*> m_externalCollections;
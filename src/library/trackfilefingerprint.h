@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QFileDevice>
+#include <QFileInfo>
+#include <QMetaType>
+
+/// The size and the modification time of a track file. Reveals in-place
+/// modifications of the file, e.g. by editing its tags, without opening it.
+class TrackFileFingerprint final {
+  public:
+    TrackFileFingerprint() = default;
+    TrackFileFingerprint(
+            qint64 sizeInBytes,
+            qint64 lastModifiedMillis)
+            : m_sizeInBytes(sizeInBytes),
+              m_lastModifiedMillis(lastModifiedMillis) {
+    }
+
+    /// Needs to stat the file unless the QFileInfo has cached it.
+    static TrackFileFingerprint fromFileInfo(const QFileInfo& fileInfo) {
+        const QDateTime lastModified =
+                fileInfo.fileTime(QFileDevice::FileModificationTime);
+        if (!lastModified.isValid()) {
+            return {};
+        }
+        return TrackFileFingerprint(
+                fileInfo.size(),
+                lastModified.toMSecsSinceEpoch());
+    }
+
+    /// Unknown for tracks that have been added by previous versions
+    /// until the next scan.
+    bool isValid() const {
+        return m_sizeInBytes >= 0;
+    }
+
+    qint64 sizeInBytes() const {
+        return m_sizeInBytes;
+    }
+
+    qint64 lastModifiedMillis() const {
+        return m_lastModifiedMillis;
+    }
+
+  private:
+    qint64 m_sizeInBytes = -1;
+    qint64 m_lastModifiedMillis = 0;
+};
+
+inline bool operator==(
+        const TrackFileFingerprint& lhs,
+        const TrackFileFingerprint& rhs) {
+    return lhs.sizeInBytes() == rhs.sizeInBytes() &&
+            lhs.lastModifiedMillis() == rhs.lastModifiedMillis();
+}
+
+inline bool operator!=(
+        const TrackFileFingerprint& lhs,
+        const TrackFileFingerprint& rhs) {
+    return !(lhs == rhs);
+}
+
+Q_DECLARE_METATYPE(TrackFileFingerprint);
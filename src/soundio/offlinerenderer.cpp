@@ -0,0 +1,263 @@
+#include "soundio/offlinerenderer.h"
+
+#include <QIODevice>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <algorithm>
+#include <vector>
+
+#include "control/controlobject.h"
+#include "engine/enginemixer.h"
+#include "soundio/soundmanagerutil.h"
+#include "util/assert.h"
+#include "util/defs.h"
+#include "util/denormalsarezero.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("OfflineRenderer");
+
+const QString kAppGroup = QStringLiteral("[App]");
+
+// A control change whose control has been looked up before rendering
+struct ResolvedControlChange {
+    SINT frame;
+    ControlObject* pControl;
+    double value;
+};
+
+} // anonymous namespace
+
+// static
+bool OfflineRenderer::parseScript(
+        QIODevice* pDevice,
+        mixxx::audio::SampleRate sampleRate,
+        Script* pScript,
+        QString* pErrorMessage) {
+    DEBUG_ASSERT(pDevice);
+    DEBUG_ASSERT(pScript);
+    DEBUG_ASSERT(sampleRate.isValid());
+    static const QRegularExpression kSeparator(QStringLiteral("\\s+"));
+
+    Script script;
+    QTextStream stream(pDevice);
+    int lineNumber = 0;
+    QString line;
+    while (stream.readLineInto(&line)) {
+        ++lineNumber;
+        line = line.trimmed();
+        if (line.isEmpty() || line.startsWith(QChar('#'))) {
+            continue;
+        }
+        const QStringList fields = line.split(kSeparator, Qt::SkipEmptyParts);
+        bool secondsValid = false;
+        bool valueValid = false;
+        const double seconds = fields.size() == 4 ? fields[0].toDouble(&secondsValid) : 0;
+        const double value = fields.size() == 4 ? fields[3].toDouble(&valueValid) : 0;
+        const ConfigKey key = fields.size() == 4 ? ConfigKey(fields[1], fields[2]) : ConfigKey();
+        if (!secondsValid || seconds < 0 || !valueValid || !key.isValid()) {
+            if (pErrorMessage) {
+                *pErrorMessage = QStringLiteral("Invalid control change in line %1: %2")
+                                         .arg(QString::number(lineNumber), line);
+            }
+            return false;
+        }
+        script.append(ControlChange{
+                static_cast<SINT>(seconds * sampleRate.toDouble()),
+                key,
+                value});
+    }
+    std::stable_sort(script.begin(),
+            script.end(),
+            [](const ControlChange& lhs, const ControlChange& rhs) {
+                return lhs.frame < rhs.frame;
+            });
+    *pScript = std::move(script);
+    return true;
+}
+
+double OfflineRenderer::Result::realtimeFactor(mixxx::audio::SampleRate sampleRate) const {
+    const double elapsedSeconds = elapsed.toDoubleSeconds();
+    if (elapsedSeconds <= 0 || !sampleRate.isValid()) {
+        return 0;
+    }
+    return frames / sampleRate.toDouble() / elapsedSeconds;
+}
+
+OfflineRenderer::OfflineRenderer(
+        UserSettingsPointer pConfig,
+        EngineMixer* pEngineMixer,
+        mixxx::audio::SampleRate sampleRate,
+        SINT framesPerBuffer)
+        : m_pConfig(pConfig),
+          m_pEngineMixer(pEngineMixer),
+          m_sampleRate(sampleRate),
+          m_framesPerBuffer(framesPerBuffer) {
+    DEBUG_ASSERT(m_pEngineMixer);
+    DEBUG_ASSERT(m_sampleRate.isValid());
+    DEBUG_ASSERT(m_framesPerBuffer > 0 &&
+            m_framesPerBuffer <= static_cast<SINT>(kMaxEngineFrames));
+}
+
+OfflineRenderer::~OfflineRenderer() {
+    closeEncoder();
+}
+
+bool OfflineRenderer::render(const Script& script,
+        SINT frames,
+        const QString& fileName,
+        const QString& format,
+        Result* pResult) {
+    m_errorMessage.clear();
+
+    // Resolve all controls upfront, a typo in the script should not
+    // silently produce a different render.
+    std::vector<ResolvedControlChange> changes;
+    changes.reserve(script.size());
+    for (const auto& change : script) {
+        ControlObject* pControl = ControlObject::getControl(
+                change.key, ControlFlag::AllowMissingOrInvalid);
+        if (!pControl) {
+            m_errorMessage = QStringLiteral("Unknown control %1,%2")
+                                     .arg(change.key.group, change.key.item);
+            return false;
+        }
+        changes.push_back(ResolvedControlChange{change.frame, pControl, change.value});
+    }
+    // Scripts that have not been parsed are not necessarily sorted
+    std::stable_sort(changes.begin(),
+            changes.end(),
+            [](const ResolvedControlChange& lhs, const ResolvedControlChange& rhs) {
+                return lhs.frame < rhs.frame;
+            });
+
+    if (!openEncoder(fileName, format)) {
+        return false;
+    }
+
+    // The same setup that the clock reference device does when it is opened
+    ControlObject::set(ConfigKey(kAppGroup, QStringLiteral("samplerate")),
+            m_sampleRate.toDouble());
+    ControlObject::set(ConfigKey(kAppGroup, QStringLiteral("output_latency_ms")),
+            mixxx::Duration::fromSeconds(m_framesPerBuffer / m_sampleRate.toDouble())
+                    .toDoubleMillis());
+    m_pEngineMixer->onOutputConnected(AudioOutput(
+            AudioPathType::Main, 0, mixxx::audio::ChannelCount::stereo()));
+
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+    // Denormals are disabled on the real-time thread of the sound devices
+    const unsigned int savedCsr = _mm_getcsr();
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+
+    kLogger.info() << "Rendering" << frames << "frames @" << m_sampleRate
+                   << "into" << fileName;
+
+    Result result;
+    auto nextChange = changes.cbegin();
+    PerformanceTimer timer;
+    timer.start();
+    while (result.frames < frames) {
+        while (nextChange != changes.cend() && nextChange->frame <= result.frames) {
+            nextChange->pControl->set(nextChange->value);
+            ++nextChange;
+        }
+        const SINT framesPerBuffer = std::min(m_framesPerBuffer, frames - result.frames);
+        const std::size_t samplesPerBuffer =
+                framesPerBuffer * mixxx::audio::ChannelCount::stereo();
+        m_pEngineMixer->process(samplesPerBuffer);
+        m_pEncoder->encodeBuffer(
+                m_pEngineMixer->getMainBuffer().data(), samplesPerBuffer);
+        result.frames += framesPerBuffer;
+        ++result.callbacks;
+    }
+    result.elapsed = timer.elapsed();
+
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+    _mm_setcsr(savedCsr);
+#endif
+
+    closeEncoder();
+
+    kLogger.info() << "Rendered" << result.frames << "frames in"
+                   << result.elapsed.formatMillisWithUnit() << "="
+                   << result.realtimeFactor(m_sampleRate) << "x realtime";
+    if (pResult) {
+        *pResult = result;
+    }
+    return true;
+}
+
+bool OfflineRenderer::openEncoder(const QString& fileName, const QString& format) {
+    closeEncoder();
+    m_pEncoder = EncoderFactory::getFactory().createRecordingEncoder(
+            EncoderFactory::getFactory().getFormatFor(format), m_pConfig, this);
+    if (!m_pEncoder) {
+        m_errorMessage = QStringLiteral("No encoder for format %1").arg(format);
+        return false;
+    }
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_errorMessage = QStringLiteral("Failed to open %1: %2")
+                                 .arg(fileName, m_file.errorString());
+        m_pEncoder.reset();
+        return false;
+    }
+    // Some encoders already write their header when being initialized
+    if (m_pEncoder->initEncoder(m_sampleRate, &m_errorMessage) < 0) {
+        if (m_errorMessage.isEmpty()) {
+            m_errorMessage = QStringLiteral("Failed to initialize the encoder");
+        }
+        m_pEncoder.reset();
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+void OfflineRenderer::closeEncoder() {
+    if (m_pEncoder) {
+        m_pEncoder->flush();
+        m_pEncoder.reset();
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+void OfflineRenderer::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    if (!m_file.isOpen()) {
+        return;
+    }
+    if (headerLen > 0) {
+        m_file.write(reinterpret_cast<const char*>(header), headerLen);
+    }
+    m_file.write(reinterpret_cast<const char*>(body), bodyLen);
+}
+
+int OfflineRenderer::tell() {
+    if (!m_file.isOpen()) {
+        return -1;
+    }
+    return static_cast<int>(m_file.pos());
+}
+
+void OfflineRenderer::seek(int pos) {
+    if (!m_file.isOpen()) {
+        return;
+    }
+    m_file.seek(pos);
+}
+
+int OfflineRenderer::filelen() {
+    if (!m_file.isOpen()) {
+        return 0;
+    }
+    return static_cast<int>(m_file.size());
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QFile>
+#include <QList>
+#include <QString>
+
+#include "audio/types.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "preferences/usersettings.h"
+#include "util/duration.h"
+#include "util/types.h"
+
+class EngineMixer;
+class QIODevice;
+
+/// Renders the main output of the engine into a file without audio hardware.
+///
+/// The renderer drives the engine like the clock reference sound device
+/// does, but it requests the next callback as soon as the previous one has
+/// been processed instead of waiting for the sound card. The main output is
+/// written through the encoder of the requested recording format. Control
+/// changes are applied from a script at fixed positions of the rendered
+/// output, so that renders are reproducible, e.g. for throughput benchmarks
+/// and regression renders on machines without a sound card.
+///
+/// The engine must not be processed by a sound device at the same time.
+class OfflineRenderer : public EncoderCallback {
+  public:
+    struct ControlChange {
+        /// The change is applied before the first callback that starts at
+        /// or after this frame of the rendered output.
+        SINT frame;
+        ConfigKey key;
+        double value;
+    };
+    typedef QList<ControlChange> Script;
+
+    /// Parses a script with one control change per line:
+    ///
+    ///   <seconds> <group> <item> <value>
+    ///
+    /// e.g. "2.5 [Channel1] play 1". Empty lines and lines that start with
+    /// '#' are ignored. The changes are sorted by their position.
+    static bool parseScript(
+            QIODevice* pDevice,
+            mixxx::audio::SampleRate sampleRate,
+            Script* pScript,
+            QString* pErrorMessage);
+
+    struct Result {
+        SINT frames = 0;
+        SINT callbacks = 0;
+        mixxx::Duration elapsed;
+
+        /// How many seconds of audio have been rendered per second.
+        double realtimeFactor(mixxx::audio::SampleRate sampleRate) const;
+    };
+
+    OfflineRenderer(
+            UserSettingsPointer pConfig,
+            EngineMixer* pEngineMixer,
+            mixxx::audio::SampleRate sampleRate,
+            SINT framesPerBuffer);
+    ~OfflineRenderer() override;
+
+    /// Renders the given number of frames into the file. The format is the
+    /// internal name of a recording format, e.g. ENCODING_WAVE, and uses
+    /// the recording settings of that format. Blocks the calling thread
+    /// until all frames have been rendered.
+    bool render(const Script& script,
+            SINT frames,
+            const QString& fileName,
+            const QString& format,
+            Result* pResult = nullptr);
+
+    const QString& errorMessage() const {
+        return m_errorMessage;
+    }
+
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    int tell() override;
+    void seek(int pos) override;
+    int filelen() override;
+
+  private:
+    bool openEncoder(const QString& fileName, const QString& format);
+    void closeEncoder();
+
+    const UserSettingsPointer m_pConfig;
+    EngineMixer* const m_pEngineMixer;
+    const mixxx::audio::SampleRate m_sampleRate;
+    const SINT m_framesPerBuffer;
+
+    EncoderPointer m_pEncoder;
+    QFile m_file;
+    QString m_errorMessage;
+};
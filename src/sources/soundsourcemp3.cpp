@@ -1,10 +1,19 @@
 #include "sources/soundsourcemp3.h"
 #include "sources/mp3decoding.h"
 
+#include "util/cachedir.h"
+#include "util/compatibility/qmutex.h"
 #include "util/logger.h"
 #include "util/math.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QSaveFile>
+#include <QtEndian>
+
 #include <id3tag.h>
+#include <limits>
 
 namespace mixxx {
 
@@ -25,6 +34,33 @@ constexpr int kSampleRateCount = 9;
 // constexpr char kVbrTag1[] = "Info";
 constexpr int kInfoTagStrLen = 4;
 
+// "MP3S" followed by the version of the seek index file format
+constexpr quint32 kSeekIndexMagic = 0x4d503353;
+constexpr quint32 kSeekIndexVersion = 2;
+
+// About 20 KB per 5 minutes of audio, i.e. the seek indexes of a few
+// thousand tracks
+constexpr qint64 kSeekIndexCacheSizeLimitBytes = 64 * 1024 * 1024;
+
+QMutex s_seekIndexCacheMutex;
+QString s_seekIndexCacheDir;
+
+QString seekIndexCacheDir() {
+    const auto locker = lockMutex(&s_seekIndexCacheMutex);
+    return s_seekIndexCacheDir;
+}
+
+QString seekIndexFilePath(const QString& cacheDir, const QString& fileName) {
+    const QByteArray hash = QCryptographicHash::hash(
+            fileName.toUtf8(), QCryptographicHash::Sha1);
+    return QDir(cacheDir).filePath(
+            QString::fromLatin1(hash.toHex()) + QStringLiteral(".seekindex"));
+}
+
+qint64 fileLastModified(const QFile& file) {
+    return QFileInfo(file).lastModified().toMSecsSinceEpoch();
+}
+
 int getIndexBySampleRate(audio::SampleRate sampleRate) {
     switch (sampleRate) {
     case 8000:
@@ -197,11 +233,18 @@ SoundSourceMp3::SoundSourceMp3(const QUrl& url)
           m_avgSeekFrameCount(0),
           m_curFrameIndex(0),
           m_madSynthCount(0),
-          m_leftoverBuffer(kMaxBytesPerMp3Frame + MAD_BUFFER_GUARD) {
+          m_leftoverBuffer(kMaxBytesPerMp3Frame + MAD_BUFFER_GUARD),
+          m_leftoverFileOffset(0) {
     m_seekFrameList.reserve(kSeekFrameListCapacity);
     initDecoding();
 }
 
+//static
+void SoundSourceMp3::setSeekIndexCacheDir(const QString& cacheDir) {
+    const auto locker = lockMutex(&s_seekIndexCacheMutex);
+    s_seekIndexCacheDir = cacheDir;
+}
+
 SoundSourceMp3::~SoundSourceMp3() {
     close();
     finishDecoding();
@@ -247,6 +290,45 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     DEBUG_ASSERT(m_seekFrameList.empty());
     m_avgSeekFrameCount = 0;
     m_curFrameIndex = 0;
+
+    HeaderInfo headerInfo;
+    if (!loadSeekIndex(&headerInfo)) {
+        const OpenResult result = scanFrameHeaders(&headerInfo);
+        if (result != OpenResult::Succeeded) {
+            return result;
+        }
+        storeSeekIndex(headerInfo);
+    }
+    DEBUG_ASSERT(!m_seekFrameList.empty());
+    DEBUG_ASSERT(m_seekFrameList.front().frameIndex == 0);
+
+    // Initialize the AudioSource
+    initChannelCountOnce(headerInfo.channelCount);
+    initSampleRateOnce(headerInfo.sampleRate);
+    initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
+
+    m_avgSeekFrameCount = frameLength() / static_cast<SINT>(m_seekFrameList.size());
+    if (headerInfo.bitrate.isValid()) {
+        initBitrateOnce(headerInfo.bitrate);
+    }
+
+    // Terminate m_seekFrameList
+    addSeekFrame(m_curFrameIndex, nullptr);
+    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
+
+    // Restart decoding at the beginning of the audio stream
+    restartDecoding(m_seekFrameList.front());
+
+    if (m_curFrameIndex != frameIndexMin()) {
+        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
+        // Abort
+        return OpenResult::Failed;
+    }
+
+    return OpenResult::Succeeded;
+}
+
+SoundSource::OpenResult SoundSourceMp3::scanFrameHeaders(HeaderInfo* pHeaderInfo) {
     int headerPerSampleRate[kSampleRateCount];
     for (int i = 0; i < kSampleRateCount; ++i) {
         headerPerSampleRate[i] = 0;
@@ -440,7 +522,6 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         kLogger.warning() << "Mixxx tries to plays it with the most common sample rate for this file";
     }
 
-    // Initialize the AudioSource
     if (!maxChannelCount.isValid() || (maxChannelCount > kChannelCountMax)) {
         kLogger.warning()
                 << "Invalid number of channels"
@@ -450,7 +531,7 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         // Abort
         return OpenResult::Failed;
     }
-    initChannelCountOnce(maxChannelCount);
+    pHeaderInfo->channelCount = maxChannelCount;
     if (mostCommonSampleRateIndex > kSampleRateCount) {
         kLogger.warning()
                 << "Unknown sample rate in MP3 file:"
@@ -458,33 +539,194 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         // Abort
         return OpenResult::Failed;
     }
-    initSampleRateOnce(getSampleRateByIndex(mostCommonSampleRateIndex));
-    initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
+    pHeaderInfo->sampleRate = getSampleRateByIndex(mostCommonSampleRateIndex);
 
     // Calculate average bitrate values
-    DEBUG_ASSERT(m_seekFrameList.size() > 0); // see above
-    m_avgSeekFrameCount = frameLength() / static_cast<SINT>(m_seekFrameList.size());
     if (cntBitrateFrames > 0) {
         const unsigned long avgBitrate = sumBitrateFrames / cntBitrateFrames;
-        initBitrateOnce(avgBitrate / 1000); // bps -> kbps
+        pHeaderInfo->bitrate = audio::Bitrate(avgBitrate / 1000); // bps -> kbps
     } else {
         kLogger.warning() << "Bitrate cannot be calculated from headers";
     }
 
-    // Terminate m_seekFrameList
-    addSeekFrame(m_curFrameIndex, nullptr);
-    DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
+    return OpenResult::Succeeded;
+}
 
-    // Restart decoding at the beginning of the audio stream
-    restartDecoding(m_seekFrameList.front());
+bool SoundSourceMp3::loadSeekIndex(HeaderInfo* pHeaderInfo) {
+    DEBUG_ASSERT(m_seekFrameList.empty());
+    const QString cacheDir = seekIndexCacheDir();
+    if (cacheDir.isEmpty()) {
+        return false;
+    }
+    QFile cacheFile(seekIndexFilePath(cacheDir, m_file.fileName()));
+    if (!cacheFile.open(QIODevice::ReadOnly)) {
+        // Not cached yet
+        return false;
+    }
+    QDataStream in(&cacheFile);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != kSeekIndexMagic || version != kSeekIndexVersion) {
+        kLogger.debug() << "Ignoring seek index of unknown format"
+                        << cacheFile.fileName();
+        return false;
+    }
+    QString fileName;
+    qint64 fileSize = 0;
+    qint64 lastModified = 0;
+    in >> fileName >> fileSize >> lastModified;
+    if (fileName != m_file.fileName() ||
+            fileSize != static_cast<qint64>(m_fileSize) ||
+            lastModified != fileLastModified(m_file)) {
+        kLogger.debug() << "Ignoring outdated seek index of" << m_file.fileName();
+        return false;
+    }
+    quint32 channelCount = 0;
+    quint32 sampleRate = 0;
+    quint32 bitrate = 0;
+    qint64 frameCount = 0;
+    quint32 seekFrameCount = 0;
+    quint32 seekFrameLength = 0;
+    qint64 firstFileOffset = 0;
+    in >> channelCount >> sampleRate >> bitrate >> frameCount >> seekFrameCount >>
+            seekFrameLength >> firstFileOffset;
+    if (in.status() != QDataStream::Ok ||
+            channelCount == 0 || channelCount > static_cast<quint32>(kChannelCountMax) ||
+            getIndexBySampleRate(audio::SampleRate(sampleRate)) >= kSampleRateCount ||
+            seekFrameCount == 0 || seekFrameCount > m_fileSize ||
+            seekFrameLength == 0 ||
+            static_cast<qint64>(seekFrameCount - 1) * seekFrameLength >= frameCount ||
+            firstFileOffset < 0 || firstFileOffset >= static_cast<qint64>(m_fileSize)) {
+        kLogger.warning() << "Ignoring corrupt seek index"
+                          << cacheFile.fileName();
+        return false;
+    }
+    // The size of every MP3 frame after the first one, which are read
+    // at once instead of item by item
+    const QByteArray fileOffsetDiffs = cacheFile.read(
+            static_cast<qint64>(seekFrameCount - 1) * sizeof(quint16));
+    if (fileOffsetDiffs.size() !=
+            static_cast<int>((seekFrameCount - 1) * sizeof(quint16))) {
+        kLogger.warning() << "Ignoring corrupt seek index"
+                          << cacheFile.fileName();
+        return false;
+    }
 
-    if (m_curFrameIndex != frameIndexMin()) {
-        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
-        // Abort
-        return OpenResult::Failed;
+    // Materializing m_seekFrameList is linear in the number of MP3 frames
+    // like the header scan, but it only touches 2 bytes per frame instead
+    // of the whole file
+    m_seekFrameList.reserve(seekFrameCount);
+    addSeekFrame(0, m_pFileData + firstFileOffset);
+    SINT frameIndex = 0;
+    qint64 fileOffset = firstFileOffset;
+    const char* pFileOffsetDiff = fileOffsetDiffs.constData();
+    for (quint32 i = 1; i < seekFrameCount; ++i) {
+        const quint16 fileOffsetDiff = qFromBigEndian<quint16>(pFileOffsetDiff);
+        pFileOffsetDiff += sizeof(quint16);
+        frameIndex += seekFrameLength;
+        fileOffset += fileOffsetDiff;
+        if (fileOffsetDiff == 0 || fileOffset >= static_cast<qint64>(m_fileSize)) {
+            kLogger.warning() << "Ignoring corrupt seek index"
+                              << cacheFile.fileName();
+            m_seekFrameList.clear();
+            return false;
+        }
+        addSeekFrame(frameIndex, m_pFileData + fileOffset);
     }
+    cacheFile.close();
+    cachedir::touchFile(cacheFile.fileName());
+    m_curFrameIndex = frameCount;
 
-    return OpenResult::Succeeded;
+    pHeaderInfo->channelCount = audio::ChannelCount(channelCount);
+    pHeaderInfo->sampleRate = audio::SampleRate(sampleRate);
+    pHeaderInfo->bitrate = audio::Bitrate(bitrate);
+    return true;
+}
+
+void SoundSourceMp3::storeSeekIndex(const HeaderInfo& headerInfo) const {
+    DEBUG_ASSERT(!m_seekFrameList.empty());
+    const QString cacheDir = seekIndexCacheDir();
+    if (cacheDir.isEmpty()) {
+        return;
+    }
+    if (!QDir().mkpath(cacheDir)) {
+        kLogger.warning() << "Failed to create seek index cache directory"
+                          << cacheDir;
+        return;
+    }
+    // Replaces the file atomically, another instance might read it
+    // concurrently
+    QSaveFile cacheFile(seekIndexFilePath(cacheDir, m_file.fileName()));
+    if (!cacheFile.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to create seek index"
+                          << cacheFile.fileName();
+        return;
+    }
+    // All MP3 frames of a file usually contain the same number of samples,
+    // so only the file offsets need to be stored. The size of an MP3 frame
+    // fits into 2 bytes.
+    const SINT seekFrameLength = m_seekFrameList.size() > 1
+            ? m_seekFrameList[1].frameIndex - m_seekFrameList[0].frameIndex
+            : m_curFrameIndex;
+    QDataStream out(&cacheFile);
+    out.setVersion(QDataStream::Qt_5_12);
+
+    out << kSeekIndexMagic << kSeekIndexVersion
+        << m_file.fileName()
+        << static_cast<qint64>(m_fileSize)
+        << fileLastModified(m_file)
+        << static_cast<quint32>(headerInfo.channelCount)
+        << static_cast<quint32>(headerInfo.sampleRate)
+        << static_cast<quint32>(headerInfo.bitrate)
+        << static_cast<qint64>(m_curFrameIndex)
+        << static_cast<quint32>(m_seekFrameList.size())
+        << static_cast<quint32>(seekFrameLength)
+        << seekFrameFileOffset(m_seekFrameList.front().pInputData);
+    QByteArray fileOffsetDiffs;
+    fileOffsetDiffs.reserve(static_cast<int>(
+            (m_seekFrameList.size() - 1) * sizeof(quint16)));
+    for (std::size_t i = 1; i < m_seekFrameList.size(); ++i) {
+        const qint64 fileOffsetDiff =
+                seekFrameFileOffset(m_seekFrameList[i].pInputData) -
+                seekFrameFileOffset(m_seekFrameList[i - 1].pInputData);
+        if (m_seekFrameList[i].frameIndex - m_seekFrameList[i - 1].frameIndex !=
+                        seekFrameLength ||
+                fileOffsetDiff <= 0 ||
+                fileOffsetDiff > std::numeric_limits<quint16>::max()) {
+            // Only the common case of MP3 frames with the same number of
+            // samples that are not separated by other data is cached. Files
+            // with mixed MPEG versions or garbage between frames are scanned
+            // on every open as before.
+            kLogger.debug() << "Not caching the seek index of irregular file"
+                            << m_file.fileName();
+            cacheFile.cancelWriting();
+            return;
+        }
+        char buffer[sizeof(quint16)];
+        qToBigEndian(static_cast<quint16>(fileOffsetDiff), buffer);
+        fileOffsetDiffs.append(buffer, sizeof(buffer));
+    }
+    out.writeRawData(fileOffsetDiffs.constData(), fileOffsetDiffs.size());
+    if (!cacheFile.commit()) {
+        kLogger.warning() << "Failed to write seek index"
+                          << cacheFile.fileName();
+        return;
+    }
+    // Only new files can exceed the limit
+    cachedir::removeLeastRecentlyUsedFiles(cacheDir, kSeekIndexCacheSizeLimitBytes);
+}
+
+qint64 SoundSourceMp3::seekFrameFileOffset(const unsigned char* pInputData) const {
+    const unsigned char* pLeftoverBuffer = m_leftoverBuffer.data();
+    if (pInputData >= pLeftoverBuffer &&
+            pInputData < pLeftoverBuffer + m_leftoverBuffer.size()) {
+        // The last frame has been copied from the file
+        return m_leftoverFileOffset + (pInputData - pLeftoverBuffer);
+    }
+    return pInputData - m_pFileData;
 }
 
 void SoundSourceMp3::close() {
@@ -861,6 +1103,7 @@ bool SoundSourceMp3::copyLeftoverFrame() {
         DEBUG_ASSERT(remainingBytes <= kMaxBytesPerMp3Frame); // only last MP3 frame
         const SINT leftoverBytes = remainingBytes + MAD_BUFFER_GUARD;
         if ((remainingBytes > 0) && (leftoverBytes <= SINT(m_leftoverBuffer.size()))) {
+            m_leftoverFileOffset = m_madStream.next_frame - m_pFileData;
             // Copy the data of the last MP3 frame into the leftover buffer...
             std::copy(m_madStream.next_frame,
                     m_madStream.next_frame + remainingBytes,
@@ -23,6 +23,10 @@ class SoundSourceMp3 final : public SoundSource {
 
     void close() override;
 
+    /// Sets the directory in which the seek frames of opened files are
+    /// cached. The cache is disabled if the path is empty.
+    static void setSeekIndexCacheDir(const QString& cacheDir);
+
   protected:
     ReadableSampleFrames readSampleFramesClamped(
             const WritableSampleFrames& sampleFrames) override;
@@ -32,6 +36,23 @@ class SoundSourceMp3 final : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
+    struct HeaderInfo {
+        audio::ChannelCount channelCount;
+        audio::SampleRate sampleRate;
+        audio::Bitrate bitrate;
+    };
+
+    /// Decodes the headers of all MP3 frames to populate m_seekFrameList.
+    OpenResult scanFrameHeaders(HeaderInfo* pHeaderInfo);
+
+    /// Populates m_seekFrameList from the cache if the file has not been
+    /// modified since the headers have been scanned.
+    bool loadSeekIndex(HeaderInfo* pHeaderInfo);
+    void storeSeekIndex(const HeaderInfo& headerInfo) const;
+
+    /// Returns the position of the seek frame in m_file.
+    qint64 seekFrameFileOffset(const unsigned char* pInputData) const;
+
     QFile m_file;
     quint64 m_fileSize;
     unsigned char* m_pFileData;
@@ -74,6 +95,8 @@ class SoundSourceMp3 final : public SoundSource {
     SINT m_madSynthCount; // left overs from the previous read
 
     std::vector<unsigned char> m_leftoverBuffer;
+    // Position of the frame in m_leftoverBuffer in m_file
+    qint64 m_leftoverFileOffset;
 };
 
 class SoundSourceProviderMp3 : public SoundSourceProvider {
@@ -4,6 +4,7 @@
 #include <QMimeType>
 #include <QRegularExpression>
 #include <QStandardPaths>
+#include <tuple>
 
 #include "sources/audiosourcetrackproxy.h"
 
@@ -591,6 +592,32 @@ SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
     }
 }
 
+// static
+SoundSourceProxy::ImportedMetadata SoundSourceProxy::importMetadataFromFile(
+        const mixxx::FileAccess& trackFileAccess,
+        const SyncTrackMetadataParams& syncParams,
+        CoverInfoGuesser* pCoverInfoGuesser) {
+    DEBUG_ASSERT(pCoverInfoGuesser);
+    ImportedMetadata importedMetadata;
+    importedMetadata.resetMissingTagMetadata = syncParams.resetMissingTagMetadataOnImport;
+    QImage coverImage;
+    std::tie(importedMetadata.importResult, importedMetadata.sourceSynchronizedAt) =
+            importTrackMetadataAndCoverImageFromFile(
+                    trackFileAccess,
+                    &importedMetadata.trackMetadata,
+                    &coverImage,
+                    importedMetadata.resetMissingTagMetadata);
+    if (importedMetadata.sourceSynchronizedAt.isValid()) {
+        // Same as in updateTrackFromSource(), the album is not
+        // affected by the remaining adjustments of the metadata.
+        importedMetadata.guessedCoverInfo = pCoverInfoGuesser->guessCoverInfo(
+                trackFileAccess.info(),
+                importedMetadata.trackMetadata.getAlbumInfo().getTitle(),
+                coverImage);
+    }
+    return importedMetadata;
+}
+
 std::pair<mixxx::MetadataSource::ImportResult, QDateTime>
 SoundSourceProxy::importTrackMetadataAndCoverImage(
         mixxx::TrackMetadata* pTrackMetadata,
@@ -636,7 +663,8 @@ inline bool shouldImportSeratoTagsFromSource(
 
 SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromSource(
         UpdateTrackFromSourceMode mode,
-        const SyncTrackMetadataParams& syncParams) {
+        const SyncTrackMetadataParams& syncParams,
+        const ImportedMetadata* pImportedMetadata) {
     DEBUG_ASSERT(m_pTrack);
 
     if (getUrl().isEmpty()) {
@@ -713,13 +741,31 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
         }
     }
 
+    // Metadata that has been imported in advance is only equivalent to
+    // parsing the file now if it has been imported without any defaults
+    // and with the same parameters.
+    const bool useImportedMetadata = pImportedMetadata &&
+            sourceSyncStatus == mixxx::TrackRecord::SourceSyncStatus::Void &&
+            pCoverImg &&
+            pImportedMetadata->resetMissingTagMetadata ==
+                    syncParams.resetMissingTagMetadataOnImport &&
+            trackMetadata == mixxx::TrackMetadata();
+
     // Parse the tags stored in the audio file and the date and time when the
     // file has been last modified to detect future changes of the tags.
-    auto [metadataImportResult, sourceSynchronizedAt] =
-            importTrackMetadataAndCoverImage(
-                    &trackMetadata,
-                    pCoverImg,
-                    syncParams.resetMissingTagMetadataOnImport);
+    std::pair<mixxx::MetadataSource::ImportResult, QDateTime> importResult;
+    if (useImportedMetadata) {
+        trackMetadata = pImportedMetadata->trackMetadata;
+        importResult = std::make_pair(
+                pImportedMetadata->importResult,
+                pImportedMetadata->sourceSynchronizedAt);
+    } else {
+        importResult = importTrackMetadataAndCoverImage(
+                &trackMetadata,
+                pCoverImg,
+                syncParams.resetMissingTagMetadataOnImport);
+    }
+    auto [metadataImportResult, sourceSynchronizedAt] = std::move(importResult);
     VERIFY_OR_DEBUG_ASSERT(!sourceSynchronizedAt.isValid() ||
             sourceSynchronizedAt.timeSpec() == Qt::UTC) {
         qWarning() << "Converting source synchronization time to UTC:" << sourceSynchronizedAt;
@@ -867,7 +913,10 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
         }
     }
 
-    if (pCoverImg) {
+    if (useImportedMetadata) {
+        DEBUG_ASSERT(pImportedMetadata->guessedCoverInfo.source == CoverInfo::GUESSED);
+        m_pTrack->setCoverInfo(pImportedMetadata->guessedCoverInfo);
+    } else if (pCoverImg) {
         // If the pointer is not null then the cover art should be guessed
         auto coverInfo =
                 CoverInfoGuesser().guessCoverInfo(
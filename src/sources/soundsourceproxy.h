@@ -2,8 +2,10 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <QDateTime>
 #include <QMimeType>
 
+#include "library/coverart.h"
 #include "sources/soundsourceproviderregistry.h"
 #include "track/track_decl.h"
 
@@ -14,6 +16,8 @@ class FileInfo;
 
 } // namespace mixxx
 
+class CoverInfoGuesser;
+
 /// Creates sound sources for tracks. Only intended to be used
 /// in a narrow scope and not shareable between multiple threads!
 class SoundSourceProxy {
@@ -107,6 +111,35 @@ class SoundSourceProxy {
             QImage* pCoverImage,
             bool resetMissingTagMetadata);
 
+    /// Track metadata and cover art that have been imported from a file
+    /// before the corresponding track object has been created.
+    ///
+    /// Allows to parse the file tags on a worker thread, e.g. while scanning
+    /// the library, and to only apply the results on the thread that adds
+    /// the track to the library. See updateTrackFromSource().
+    struct ImportedMetadata {
+        mixxx::MetadataSource::ImportResult importResult =
+                mixxx::MetadataSource::ImportResult::Unavailable;
+        QDateTime sourceSynchronizedAt;
+        mixxx::TrackMetadata trackMetadata;
+        /// Guessed from the embedded cover image or from the image
+        /// files next to the file.
+        CoverInfoRelative guessedCoverInfo;
+        bool resetMissingTagMetadata = false;
+    };
+
+    /// Imports the track metadata of a file that has not been added to the
+    /// library yet and guesses its cover art. The cover info guesser caches
+    /// the image files of the last directory and should be reused for files
+    /// in the same directory.
+    ///
+    /// This function is thread-safe, see
+    /// importTrackMetadataAndCoverImageFromFile().
+    static ImportedMetadata importMetadataFromFile(
+            const mixxx::FileAccess& trackFileAccess,
+            const SyncTrackMetadataParams& syncParams,
+            CoverInfoGuesser* pCoverInfoGuesser);
+
     /// Import both track metadata and/or the cover image of the
     /// captured track object from the corresponding file.
     ///
@@ -174,10 +207,15 @@ class SoundSourceProxy {
     /// properly. The application log will contain warning messages for a detailed
     /// analysis in case unexpected behavior has been reported.
     ///
+    /// Metadata that has been imported with importMetadataFromFile() is used
+    /// instead of parsing the file again if the track object has not been
+    /// initialized from the file yet. Otherwise it is ignored.
+    ///
     /// Returns true if the track has been modified and false otherwise.
     UpdateTrackFromSourceResult updateTrackFromSource(
             UpdateTrackFromSourceMode mode,
-            const SyncTrackMetadataParams& syncParams);
+            const SyncTrackMetadataParams& syncParams,
+            const ImportedMetadata* pImportedMetadata = nullptr);
 
     /// Opening the audio source through the proxy will update the
     /// audio properties of the corresponding track object. Returns
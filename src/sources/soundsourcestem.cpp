@@ -9,6 +9,8 @@ extern "C" {
 
 } // extern "C"
 
+#include <QSemaphore>
+#include <QThreadPool>
 #include <memory>
 
 #include "sources/soundsourceffmpeg.h"
@@ -30,6 +32,14 @@ constexpr int kRequiredStreamCount = kNumStreams - 1; // Stem count doesn't incl
 
 const Logger kLogger("SoundSourceSTEM");
 
+// Shared by all stem sources for decoding their streams in parallel. Each
+// stream has its own decoder, so the stems of a chunk can be decoded
+// independently by different threads.
+QThreadPool* stemDecoderThreadPool() {
+    static QThreadPool s_threadPool;
+    return &s_threadPool;
+}
+
 // Local RAII for AVFormatContext; SoundSourceFFmpeg's wrapper is private.
 struct AVFormatContextDeleter {
     void operator()(AVFormatContext* ctx) const {
@@ -244,13 +254,6 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
     SINT stemSampleLength = m_pStereoStreams.front()->getSignalInfo().frames2samples(
             globalSampleFrames.frameLength());
 
-    // The same buffer is reused between requests tp prevent reallocation, but
-    // it will be reallocated if a larger chunk is requested and will keep the
-    // new maximum size
-    if (stemSampleLength > m_buffer.size()) {
-        m_buffer = SampleBuffer(stemSampleLength);
-    }
-
     ReadableSampleFrames read(globalSampleFrames.frameIndexRange(),
             SampleBuffer::ReadableSlice(
                     globalSampleFrames.writableData(),
@@ -270,26 +273,50 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
         return read;
     }
 
-    for (std::size_t streamIdx = 0; streamIdx < stemCount; streamIdx++) {
+    // The same buffers are reused between requests tp prevent reallocation, but
+    // they will be reallocated if a larger chunk is requested and will keep the
+    // new maximum size
+    m_streamBuffers.resize(stemCount);
+    for (auto& streamBuffer : m_streamBuffers) {
+        if (stemSampleLength > streamBuffer.size()) {
+            streamBuffer = SampleBuffer(stemSampleLength);
+        }
+    }
+
+    const auto readStream = [this, &globalSampleFrames, stemSampleLength](
+                                    std::size_t streamIdx) {
         WritableSampleFrames currentStemFrame = WritableSampleFrames(
                 globalSampleFrames.frameIndexRange(),
                 SampleBuffer::WritableSlice(
-                        m_buffer.data(),
+                        m_streamBuffers[streamIdx].data(),
                         stemSampleLength));
         m_pStereoStreams[streamIdx]->readSampleFrames(currentStemFrame);
+    };
+    QSemaphore streamsRead;
+    for (std::size_t streamIdx = 1; streamIdx < stemCount; streamIdx++) {
+        stemDecoderThreadPool()->start([&readStream, &streamsRead, streamIdx] {
+            readStream(streamIdx);
+            streamsRead.release();
+        });
+    }
+    // This thread takes part instead of waiting idle
+    readStream(0);
+    streamsRead.acquire(static_cast<int>(stemCount - 1));
 
+    for (std::size_t streamIdx = 0; streamIdx < stemCount; streamIdx++) {
         // Each m_pStereoStreams[streamIdx] provides a standard stereo signal (L/R).
         // in stem mode we need to transform the data to an interleaved layout:
         // 1L1R2L2R3L3R4L4R, 1L1R2L2R3L3R4L4R ...
         if (m_requestedChannelCount != mixxx::audio::ChannelCount::stereo()) {
             // Change the sample layout to interleave all channels together
-            for (SINT i = 0; i < stemSampleLength / 2; i++) {
-                pBuffer[2 * stemCount * i + 2 * streamIdx] = m_buffer[2 * i];
-                pBuffer[2 * stemCount * i + 2 * streamIdx + 1] = m_buffer[2 * i + 1];
-            }
+            SampleUtil::insertStereoToMulti(pBuffer,
+                    m_streamBuffers[streamIdx].data(),
+                    globalSampleFrames.frameLength(),
+                    getSignalInfo().getChannelCount(),
+                    static_cast<int>(mixxx::audio::ChannelCount::stereo() * streamIdx));
         } else {
             // Change the sample layout to mix all channels together
-            SampleUtil::add(pBuffer, m_buffer.data(), stemSampleLength);
+            SampleUtil::add(pBuffer, m_streamBuffers[streamIdx].data(), stemSampleLength);
         }
     }
     return read;
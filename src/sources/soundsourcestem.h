@@ -21,7 +21,8 @@ class SoundSourceSTEM : public SoundSource {
   private:
     // Contains each stem source, or the main mix if opened in stereo mode
     std::vector<std::unique_ptr<SoundSourceFFmpeg>> m_pStereoStreams;
-    SampleBuffer m_buffer;
+    // One buffer per stream, the streams are decoded in parallel
+    std::vector<SampleBuffer> m_streamBuffers;
 
     mixxx::audio::ChannelCount m_requestedChannelCount;
 
@@ -2,10 +2,13 @@
 
 #include <QDir>
 #include <QtDebug>
+#include <cmath>
+#include <cstdlib>
 #include <vector>
 
 #include "analyzer/analyzertrack.h"
 #include "analyzer/analyzerwaveform.h"
+#include "analyzer/constants.h"
 #include "library/dao/analysisdao.h"
 #include "test/mixxxtest.h"
 #include "track/track.h"
@@ -130,4 +133,66 @@ TEST_F(AnalyzerWaveformTest, canary) {
     EXPECT_DOUBLE_EQ(pWaveformSummary->getAudioVisualRatio(), 1.0);
 }
 
+// A segment that is analyzed separately and merged afterwards results in
+// the same waveforms. The filtered bands might differ slightly, because the
+// filters of the segment are settled with a single chunk. The averages of
+// the summary are summed up in a different order.
+TEST_F(AnalyzerWaveformTest, segmentMatchesSingleAnalysis) {
+    constexpr SINT kFrameLength = 10 * 44100;
+    // Not at the boundary of a stride
+    constexpr SINT kSegmentStart = 50 * mixxx::kAnalysisFramesPerChunk;
+    std::vector<CSAMPLE> samples(kFrameLength * kChannelCount);
+    for (SINT i = 0; i < kFrameLength; ++i) {
+        const float amplitude = static_cast<float>(i % 10000) / 10000;
+        samples[i * kChannelCount] = amplitude * std::sin(static_cast<float>(i) * 0.05f);
+        samples[i * kChannelCount + 1] = amplitude * std::sin(static_cast<float>(i) * 0.3f);
+    }
+
+    ASSERT_TRUE(m_aw.initialize(AnalyzerTrack(m_pTrack),
+            m_pTrack->getSampleRate(),
+            m_pTrack->getChannels(),
+            kFrameLength));
+    m_aw.processSamples(samples.data(), kFrameLength * kChannelCount);
+    m_aw.storeResults(m_pTrack);
+    m_aw.cleanup();
+
+    TrackPointer pSegmentedTrack = Track::newTemporary();
+    AnalyzerWaveform segmentedAnalyzer(config(), QSqlDatabase());
+    ASSERT_TRUE(segmentedAnalyzer.initialize(AnalyzerTrack(pSegmentedTrack),
+            m_pTrack->getSampleRate(),
+            m_pTrack->getChannels(),
+            kFrameLength));
+    AnalyzerSegmentPtr pSegment = segmentedAnalyzer.newSegment(
+            mixxx::IndexRange::between(kSegmentStart, kFrameLength));
+    ASSERT_NE(nullptr, pSegment);
+    pSegment->prerollSamples(
+            &samples[(kSegmentStart - mixxx::kAnalysisFramesPerChunk) * kChannelCount],
+            mixxx::kAnalysisFramesPerChunk * kChannelCount);
+    ASSERT_TRUE(pSegment->processSamples(&samples[kSegmentStart * kChannelCount],
+            (kFrameLength - kSegmentStart) * kChannelCount));
+    ASSERT_TRUE(segmentedAnalyzer.processSamples(samples.data(), kSegmentStart * kChannelCount));
+    ASSERT_TRUE(segmentedAnalyzer.mergeSegment(std::move(pSegment)));
+    segmentedAnalyzer.storeResults(pSegmentedTrack);
+    segmentedAnalyzer.cleanup();
+
+    const auto compareWaveforms = [](ConstWaveformPointer pExpected,
+                                          ConstWaveformPointer pActual,
+                                          int allTolerance) {
+        ASSERT_NE(nullptr, pExpected);
+        ASSERT_NE(nullptr, pActual);
+        ASSERT_EQ(pExpected->getDataSize(), pActual->getDataSize());
+        for (int i = 0; i < pExpected->getDataSize(); ++i) {
+            const WaveformData& expected = pExpected->data()[i];
+            const WaveformData& actual = pActual->data()[i];
+            EXPECT_LE(std::abs(expected.filtered.all - actual.filtered.all), allTolerance)
+                    << "stride " << i;
+            EXPECT_LE(std::abs(expected.filtered.low - actual.filtered.low), 1) << "stride " << i;
+            EXPECT_LE(std::abs(expected.filtered.mid - actual.filtered.mid), 1) << "stride " << i;
+            EXPECT_LE(std::abs(expected.filtered.high - actual.filtered.high), 1) << "stride " << i;
+        }
+    };
+    compareWaveforms(m_pTrack->getWaveform(), pSegmentedTrack->getWaveform(), 0);
+    compareWaveforms(m_pTrack->getWaveformSummary(), pSegmentedTrack->getWaveformSummary(), 1);
+}
+
 } // namespace
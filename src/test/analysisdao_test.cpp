@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <memory>
+
+#include "library/dao/analysisdao.h"
+#include "test/librarytest.h"
+#include "track/track.h"
+#include "waveform/waveform.h"
+#include "waveform/waveformfactory.h"
+
+namespace {
+
+class AnalysisDaoTest : public LibraryTest {
+  protected:
+    static std::unique_ptr<Waveform> createWaveform() {
+        auto pWaveform = std::make_unique<Waveform>(44100, 44100 * 10, 441, -1, 0);
+        for (int i = 0; i < pWaveform->getDataSize(); ++i) {
+            WaveformData& datum = pWaveform->data()[i];
+            datum.filtered.low = static_cast<unsigned char>(i);
+            datum.filtered.mid = static_cast<unsigned char>(i * 3);
+            datum.filtered.high = static_cast<unsigned char>(i * 7);
+            datum.filtered.all = static_cast<unsigned char>(i * 11);
+        }
+        pWaveform->setCompletion(pWaveform->getDataSize());
+        return pWaveform;
+    }
+
+    static void expectEqualWaveforms(const Waveform& expected, const Waveform& actual) {
+        ASSERT_EQ(expected.getDataSize(), actual.getDataSize());
+        EXPECT_EQ(expected.getAudioVisualRatio(), actual.getAudioVisualRatio());
+        EXPECT_EQ(expected.getTextureStride(), actual.getTextureStride());
+        EXPECT_EQ(expected.getDataSize(), actual.getCompletion());
+        for (int i = 0; i < expected.getDataSize(); ++i) {
+            EXPECT_EQ(expected.getLow(i), actual.getLow(i));
+            EXPECT_EQ(expected.getMid(i), actual.getMid(i));
+            EXPECT_EQ(expected.getHigh(i), actual.getHigh(i));
+            EXPECT_EQ(expected.getAll(i), actual.getAll(i));
+        }
+    }
+
+    TrackId addTrack() {
+        const TrackPointer pTrack = getOrAddTrackByLocation(getTestDir().filePath(
+                QStringLiteral("id3-test-data/cover-test-jpg.mp3")));
+        return pTrack ? pTrack->getId() : TrackId();
+    }
+
+    AnalysisDao& analysisDao() const {
+        return internalCollection()->getAnalysisDAO();
+    }
+};
+
+TEST_F(AnalysisDaoTest, mapBinaryFile) {
+    const auto pWaveform = createWaveform();
+    const QByteArray binary = pWaveform->toBinary();
+    EXPECT_TRUE(Waveform::isBinary(binary));
+    EXPECT_FALSE(Waveform::isBinary(pWaveform->toByteArray()));
+
+    const QString fileName = getTestDataDir().filePath(QStringLiteral("waveform"));
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    ASSERT_EQ(binary.size(), file.write(binary));
+    file.close();
+
+    Waveform mappedWaveform;
+    ASSERT_TRUE(mappedWaveform.mapBinaryFile(fileName));
+    EXPECT_TRUE(mappedWaveform.isMapped());
+    EXPECT_EQ(Waveform::SaveState::Saved, mappedWaveform.saveState());
+    expectEqualWaveforms(*pWaveform, mappedWaveform);
+
+    // Modifying the mapped data must not modify the file
+    mappedWaveform.data()[0].filtered.all = 123;
+    Waveform remappedWaveform;
+    ASSERT_TRUE(remappedWaveform.mapBinaryFile(fileName));
+    expectEqualWaveforms(*pWaveform, remappedWaveform);
+}
+
+TEST_F(AnalysisDaoTest, rejectTruncatedBinaryFile) {
+    const QByteArray binary = createWaveform()->toBinary();
+    const QString fileName = getTestDataDir().filePath(QStringLiteral("waveform"));
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(binary.left(binary.size() - 1));
+    file.close();
+
+    Waveform waveform;
+    EXPECT_FALSE(waveform.mapBinaryFile(fileName));
+    EXPECT_EQ(0, waveform.getDataSize());
+}
+
+TEST_F(AnalysisDaoTest, convertProtobufOnLoad) {
+    const TrackId trackId = addTrack();
+    ASSERT_TRUE(trackId.isValid());
+    const auto pWaveform = createWaveform();
+
+    // Store the waveform in the protobuf format of previous versions
+    AnalysisDao::AnalysisInfo info;
+    info.trackId = trackId;
+    info.type = AnalysisDao::TYPE_WAVEFORM;
+    info.description = WaveformFactory::currentWaveformDescription();
+    info.version = WaveformFactory::currentWaveformVersion();
+    info.data = pWaveform->toByteArray();
+    ASSERT_TRUE(analysisDao().saveAnalysis(&info));
+
+    // Converted on the first load and mapped on all subsequent loads
+    for (int i = 0; i < 2; ++i) {
+        const auto analyses = analysisDao().getAnalysesForTrack(trackId);
+        ASSERT_EQ(1, analyses.size());
+        EXPECT_FALSE(analyses.first().binaryDataPath.isEmpty());
+        EXPECT_TRUE(analyses.first().data.isEmpty());
+
+        const std::unique_ptr<Waveform> pLoadedWaveform(
+                WaveformFactory::loadWaveformFromAnalysis(analyses.first()));
+        EXPECT_TRUE(pLoadedWaveform->isMapped());
+        expectEqualWaveforms(*pWaveform, *pLoadedWaveform);
+    }
+}
+
+} // namespace
@@ -0,0 +1,115 @@
+#include "analyzer/analyzerdecoder.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "analyzer/constants.h"
+#include "sources/audiosourcestereoproxy.h"
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+#include "util/math.h"
+
+namespace {
+
+class AnalyzerDecoderTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    mixxx::AudioSourcePointer openAudioSource() const {
+        auto pTrack = Track::newTemporary(getTestDir().filePath(
+                QStringLiteral("id3-test-data/cover-test-jpg.mp3")));
+        mixxx::AudioSource::OpenParams openParams;
+        openParams.setChannelCount(mixxx::kAnalysisChannels);
+        auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(openParams);
+        if (pAudioSource &&
+                pAudioSource->getSignalInfo().getChannelCount() !=
+                        mixxx::kAnalysisChannels) {
+            pAudioSource = std::make_shared<mixxx::AudioSourceStereoProxy>(
+                    pAudioSource,
+                    mixxx::kAnalysisFramesPerChunk);
+        }
+        return pAudioSource;
+    }
+
+    // Reads the whole audio source in chunks on the calling thread
+    static std::vector<CSAMPLE> readSequentially(
+            const mixxx::AudioSourcePointer& pAudioSource) {
+        std::vector<CSAMPLE> samples;
+        mixxx::SampleBuffer buffer(mixxx::kAnalysisSamplesPerChunk);
+        mixxx::IndexRange remainingFrameRange = pAudioSource->frameIndexRange();
+        while (!remainingFrameRange.empty()) {
+            const auto chunkFrameRange = remainingFrameRange.splitAndShrinkFront(
+                    math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
+            const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            chunkFrameRange,
+                            mixxx::SampleBuffer::WritableSlice(buffer)));
+            samples.insert(samples.end(),
+                    readableSampleFrames.readableData(),
+                    readableSampleFrames.readableData() +
+                            readableSampleFrames.readableLength());
+        }
+        return samples;
+    }
+
+    // Consumes chunks until the end of the track
+    static std::vector<CSAMPLE> readDecoded(AnalyzerDecoder* pDecoder) {
+        std::vector<CSAMPLE> samples;
+        bool endOfTrack = false;
+        while (!endOfTrack) {
+            const int numChunks = pDecoder->acquireChunks();
+            EXPECT_GT(numChunks, 0);
+            EXPECT_LE(numChunks, mixxx::kAnalysisChunksDecodedAhead);
+            for (int i = 0; i < numChunks; ++i) {
+                const auto& chunk = pDecoder->chunk(i);
+                EXPECT_FALSE(endOfTrack);
+                endOfTrack = chunk.endOfTrack;
+                const auto& readableSampleFrames = chunk.readableSampleFrames;
+                samples.insert(samples.end(),
+                        readableSampleFrames.readableData(),
+                        readableSampleFrames.readableData() +
+                                readableSampleFrames.readableLength());
+            }
+            pDecoder->releaseChunks(numChunks);
+        }
+        pDecoder->stopDecoding(false);
+        return samples;
+    }
+};
+
+TEST_F(AnalyzerDecoderTest, decodesSameSamplesAsSequentialRead) {
+    const auto pExpectedSource = openAudioSource();
+    ASSERT_TRUE(pExpectedSource);
+    const auto expectedSamples = readSequentially(pExpectedSource);
+    ASSERT_FALSE(expectedSamples.empty());
+
+    AnalyzerDecoder decoder(QStringLiteral("AnalyzerDecoderTest"));
+    // The decoder is reused for multiple tracks
+    for (int i = 0; i < 2; ++i) {
+        decoder.startDecoding(openAudioSource());
+        EXPECT_EQ(expectedSamples, readDecoded(&decoder));
+    }
+}
+
+TEST_F(AnalyzerDecoderTest, abortWhileDecoding) {
+    const auto pExpectedSource = openAudioSource();
+    ASSERT_TRUE(pExpectedSource);
+    const auto expectedSamples = readSequentially(pExpectedSource);
+
+    AnalyzerDecoder decoder(QStringLiteral("AnalyzerDecoderTest"));
+    decoder.startDecoding(openAudioSource());
+    // Don't consume anything, the decoder is blocked on a full ring
+    decoder.stopDecoding(true);
+
+    decoder.startDecoding(openAudioSource());
+    const int numChunks = decoder.acquireChunks();
+    decoder.releaseChunks(numChunks);
+    decoder.stopDecoding(true);
+
+    // Decoding restarts from the beginning after aborting
+    decoder.startDecoding(openAudioSource());
+    EXPECT_EQ(expectedSamples, readDecoded(&decoder));
+}
+
+} // namespace
@@ -169,6 +169,52 @@ TEST_F(AnalyzerSilenceTest, ToneTrackWithSilenceInTheMiddle) {
     EXPECT_DOUBLE_EQ(4 * oneFifthOfTrackLength, pOutroCue->getLengthFrames() * kChannelCount);
 }
 
+TEST_F(AnalyzerSilenceTest, segmentMatchesSingleAnalysis) {
+    double omega = 2.0 * M_PI * kTonePitchHz / pTrack->getSampleRate();
+    int oneFifthOfTrackLength = nTrackSampleDataLength / 5;
+
+    // Fill the second and the fourth fifth with 1 kHz tone
+    for (int i = 0; i < nTrackSampleDataLength; i++) {
+        if ((i >= oneFifthOfTrackLength && i < 2 * oneFifthOfTrackLength) ||
+                (i >= 3 * oneFifthOfTrackLength && i < 4 * oneFifthOfTrackLength)) {
+            pTrackSampleData[i] = static_cast<CSAMPLE>(cos(i / kChannelCount * omega));
+        } else {
+            pTrackSampleData[i] = 0.0;
+        }
+    }
+
+    analyzeTrack();
+
+    // The segment starts in the silence between the tones
+    constexpr SINT kSegmentStart = kTrackLengthFrames / 2;
+    TrackPointer pSegmentedTrack = Track::newTemporary();
+    AnalyzerSilence segmentedAnalyzer(config());
+    ASSERT_TRUE(segmentedAnalyzer.initialize(AnalyzerTrack(pSegmentedTrack),
+            pTrack->getSampleRate(),
+            mixxx::audio::ChannelCount(kChannelCount),
+            kTrackLengthFrames));
+    AnalyzerSegmentPtr pSegment = segmentedAnalyzer.newSegment(
+            mixxx::IndexRange::between(kSegmentStart, kTrackLengthFrames));
+    ASSERT_NE(nullptr, pSegment);
+    ASSERT_TRUE(pSegment->processSamples(&pTrackSampleData[kSegmentStart * kChannelCount],
+            nTrackSampleDataLength - kSegmentStart * kChannelCount));
+    ASSERT_TRUE(segmentedAnalyzer.processSamples(
+            pTrackSampleData.data(), kSegmentStart * kChannelCount));
+    ASSERT_TRUE(segmentedAnalyzer.mergeSegment(std::move(pSegment)));
+    segmentedAnalyzer.storeResults(pSegmentedTrack);
+    segmentedAnalyzer.cleanup();
+
+    EXPECT_EQ(pTrack->getMainCuePosition(), pSegmentedTrack->getMainCuePosition());
+    for (const auto cueType : {mixxx::CueType::Intro, mixxx::CueType::Outro}) {
+        CuePointer pExpectedCue = pTrack->findCueByType(cueType);
+        CuePointer pActualCue = pSegmentedTrack->findCueByType(cueType);
+        ASSERT_NE(nullptr, pExpectedCue);
+        ASSERT_NE(nullptr, pActualCue);
+        EXPECT_EQ(pExpectedCue->getPosition(), pActualCue->getPosition());
+        EXPECT_DOUBLE_EQ(pExpectedCue->getLengthFrames(), pActualCue->getLengthFrames());
+    }
+}
+
 TEST_F(AnalyzerSilenceTest, RespectUserEdits) {
     // Arbitrary values
     const auto kManualCuePosition = mixxx::audio::FramePos::fromEngineSamplePos(
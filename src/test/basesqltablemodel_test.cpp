@@ -0,0 +1,304 @@
+#include <gtest/gtest.h>
+
+#include <QCoreApplication>
+#include <QSqlQuery>
+#include <QThread>
+
+#include "library/basetrackcache.h"
+#include "library/dao/trackschema.h"
+#include "library/librarytablemodel.h"
+#include "library/queryutil.h"
+#include "test/librarytest.h"
+#include "util/db/sqltransaction.h"
+
+namespace {
+
+const QStringList kArtists = {
+        QStringLiteral("Alpha"),
+        QStringLiteral("Bravo"),
+        QStringLiteral("Charlie"),
+        QStringLiteral("Delta"),
+        QStringLiteral("Echo")};
+constexpr int kNumTracks = 500;
+constexpr int kNumTracksPerArtist = kNumTracks / 5;
+
+const QString kTrackSourceTable = QStringLiteral("test_library_cache_view");
+
+// Reads the rows from a temporary table, which is only visible on the
+// database connection of the model
+class TemporaryTableModel : public LibraryTableModel {
+  public:
+    explicit TemporaryTableModel(TrackCollectionManager* pTrackCollectionManager)
+            : LibraryTableModel(nullptr,
+                      pTrackCollectionManager,
+                      "mixxx.db.model.test") {
+        const QString tableName = QStringLiteral("test_library_copy");
+        QSqlQuery query(m_database);
+        if (!query.exec(QStringLiteral(
+                    "CREATE TEMP TABLE %1 AS SELECT * FROM library_view")
+                                .arg(tableName))) {
+            LOG_FAILED_QUERY(query);
+        }
+        setTable(tableName,
+                LIBRARYTABLE_ID,
+                {LIBRARYTABLE_ID, LIBRARYTABLE_PREVIEW, LIBRARYTABLE_COVERART},
+                pTrackCollectionManager->internalCollection()->getTrackSource());
+    }
+};
+
+// Reads the rows from a temporary view that depends on a temporary table,
+// which is only visible on the database connection of the model
+class DependentViewModel : public LibraryTableModel {
+  public:
+    explicit DependentViewModel(TrackCollectionManager* pTrackCollectionManager)
+            : LibraryTableModel(nullptr,
+                      pTrackCollectionManager,
+                      "mixxx.db.model.test") {
+        const QString tableName = QStringLiteral("test_library_filtered");
+        QSqlQuery query(m_database);
+        if (!query.exec(QStringLiteral(
+                    "CREATE TEMP TABLE test_excluded_ids (id INTEGER)"))) {
+            LOG_FAILED_QUERY(query);
+        }
+        if (!query.exec(QStringLiteral(
+                    "CREATE TEMP VIEW %1 AS SELECT * FROM library_view "
+                    "WHERE id NOT IN (SELECT id FROM test_excluded_ids)")
+                                .arg(tableName))) {
+            LOG_FAILED_QUERY(query);
+        }
+        setTable(tableName,
+                LIBRARYTABLE_ID,
+                {LIBRARYTABLE_ID, LIBRARYTABLE_PREVIEW, LIBRARYTABLE_COVERART},
+                pTrackCollectionManager->internalCollection()->getTrackSource());
+    }
+};
+
+class BaseSqlTableModelTest : public LibraryTest {
+  protected:
+    BaseSqlTableModelTest() {
+        addTracks();
+
+        QSqlQuery query(dbConnection());
+        if (!query.exec(QStringLiteral(
+                    "CREATE TEMPORARY VIEW IF NOT EXISTS %1 AS "
+                    "SELECT library.id,artist,title FROM library "
+                    "INNER JOIN track_locations "
+                    "ON library.location=track_locations.id")
+                                .arg(kTrackSourceTable))) {
+            LOG_FAILED_QUERY(query);
+        }
+        internalCollection()->connectTrackSource(
+                QSharedPointer<BaseTrackCache>::create(internalCollection(),
+                        kTrackSourceTable,
+                        LIBRARYTABLE_ID,
+                        QStringList{LIBRARYTABLE_ID, LIBRARYTABLE_ARTIST, LIBRARYTABLE_TITLE},
+                        QStringList{LIBRARYTABLE_ARTIST, LIBRARYTABLE_TITLE},
+                        true));
+    }
+
+    ~BaseSqlTableModelTest() override {
+        internalCollection()->disconnectTrackSource();
+    }
+
+    void addTracks() {
+        const QSqlDatabase database = dbConnection();
+        SqlTransaction transaction(database);
+        QSqlQuery locationQuery(database);
+        locationQuery.prepare(QStringLiteral(
+                "INSERT INTO track_locations "
+                "(id,location,directory,filename,filesize,fs_deleted,needs_verification) "
+                "VALUES (:id,:location,'/music',:filename,1,0,0)"));
+        QSqlQuery libraryQuery(database);
+        libraryQuery.prepare(QStringLiteral(
+                "INSERT INTO library "
+                "(id,artist,title,location,mixxx_deleted) "
+                "VALUES (:id,:artist,:title,:location,0)"));
+        for (int i = 1; i <= kNumTracks; ++i) {
+            const QString fileName = QStringLiteral("%1.mp3").arg(i);
+            locationQuery.bindValue(QStringLiteral(":id"), i);
+            locationQuery.bindValue(QStringLiteral(":location"),
+                    QStringLiteral("/music/") + fileName);
+            locationQuery.bindValue(QStringLiteral(":filename"), fileName);
+            libraryQuery.bindValue(QStringLiteral(":id"), i);
+            libraryQuery.bindValue(QStringLiteral(":artist"),
+                    kArtists.at(i % kArtists.size()));
+            // Sorted in reverse order of the ids
+            libraryQuery.bindValue(QStringLiteral(":title"),
+                    QStringLiteral("Title %1").arg(kNumTracks - i, 3, 10, QChar('0')));
+            libraryQuery.bindValue(QStringLiteral(":location"), i);
+            EXPECT_TRUE(locationQuery.exec());
+            EXPECT_TRUE(libraryQuery.exec());
+        }
+        transaction.commit();
+    }
+
+    std::unique_ptr<LibraryTableModel> newModel() {
+        auto pModel = std::make_unique<LibraryTableModel>(nullptr,
+                trackCollectionManager(),
+                "mixxx.db.model.test");
+        pModel->setSort(pModel->fieldIndex(LIBRARYTABLE_TITLE), Qt::AscendingOrder);
+        pModel->select();
+        return pModel;
+    }
+
+    static void waitForSelect(const BaseSqlTableModel& model) {
+        for (int i = 0; i < 5000 && model.isSelectPending(); ++i) {
+            QCoreApplication::processEvents();
+            QThread::msleep(1);
+        }
+    }
+
+    static void processEvents() {
+        for (int i = 0; i < 50; ++i) {
+            QCoreApplication::processEvents();
+            QThread::msleep(1);
+        }
+    }
+
+    static QString value(const BaseSqlTableModel& model, int row, const QString& column) {
+        return model.data(model.index(row, model.fieldIndex(column))).toString();
+    }
+
+    static void expectRowsOfArtist(const BaseSqlTableModel& model, const QString& artist) {
+        ASSERT_EQ(kNumTracksPerArtist, model.rowCount());
+        for (int row = 0; row < model.rowCount(); ++row) {
+            EXPECT_QSTRING_EQ(artist, value(model, row, LIBRARYTABLE_ARTIST));
+            if (row > 0) {
+                EXPECT_LT(value(model, row - 1, LIBRARYTABLE_TITLE),
+                        value(model, row, LIBRARYTABLE_TITLE));
+            }
+        }
+    }
+};
+
+TEST_F(BaseSqlTableModelTest, searchOnWorkerThread) {
+    const auto pModel = newModel();
+    ASSERT_EQ(kNumTracks, pModel->rowCount());
+    int selectFinishedCount = 0;
+    QObject::connect(pModel.get(),
+            &BaseSqlTableModel::selectFinished,
+            [&selectFinishedCount] { ++selectFinishedCount; });
+
+    pModel->search(QStringLiteral("Charlie"));
+    // The result is delivered by the event loop
+    EXPECT_TRUE(pModel->isSelectPending());
+    EXPECT_EQ(0, selectFinishedCount);
+
+    waitForSelect(*pModel);
+    EXPECT_FALSE(pModel->isSelectPending());
+    EXPECT_EQ(1, selectFinishedCount);
+    expectRowsOfArtist(*pModel, QStringLiteral("Charlie"));
+}
+
+TEST_F(BaseSqlTableModelTest, sortOnWorkerThread) {
+    const auto pModel = newModel();
+    int selectFinishedCount = 0;
+    QObject::connect(pModel.get(),
+            &BaseSqlTableModel::selectFinished,
+            [&selectFinishedCount] { ++selectFinishedCount; });
+
+    pModel->sort(pModel->fieldIndex(LIBRARYTABLE_TITLE), Qt::DescendingOrder);
+    EXPECT_TRUE(pModel->isSelectPending());
+
+    waitForSelect(*pModel);
+    EXPECT_EQ(1, selectFinishedCount);
+    ASSERT_EQ(kNumTracks, pModel->rowCount());
+    for (int row = 1; row < pModel->rowCount(); ++row) {
+        EXPECT_GT(value(*pModel, row - 1, LIBRARYTABLE_TITLE),
+                value(*pModel, row, LIBRARYTABLE_TITLE));
+    }
+}
+
+TEST_F(BaseSqlTableModelTest, newSearchAbortsPendingSearch) {
+    const auto pModel = newModel();
+    int selectFinishedCount = 0;
+    QObject::connect(pModel.get(),
+            &BaseSqlTableModel::selectFinished,
+            [&selectFinishedCount] { ++selectFinishedCount; });
+
+    pModel->search(QStringLiteral("Alpha"));
+    pModel->search(QStringLiteral("Bravo"));
+
+    waitForSelect(*pModel);
+    processEvents();
+    // The outdated search is never finished
+    EXPECT_EQ(1, selectFinishedCount);
+    expectRowsOfArtist(*pModel, QStringLiteral("Bravo"));
+}
+
+TEST_F(BaseSqlTableModelTest, stopModelPopulation) {
+    const auto pModel = newModel();
+    int selectFinishedCount = 0;
+    QObject::connect(pModel.get(),
+            &BaseSqlTableModel::selectFinished,
+            [&selectFinishedCount] { ++selectFinishedCount; });
+
+    pModel->search(QStringLiteral("Alpha"));
+    pModel->maybeStopModelPopulation();
+    EXPECT_FALSE(pModel->isSelectPending());
+
+    processEvents();
+    EXPECT_EQ(0, selectFinishedCount);
+    EXPECT_EQ(kNumTracks, pModel->rowCount());
+}
+
+TEST_F(BaseSqlTableModelTest, searchTemporaryTableIncrementally) {
+    // Creates library_view
+    const auto pLibraryModel = newModel();
+    TemporaryTableModel model(trackCollectionManager());
+    model.setSort(model.fieldIndex(LIBRARYTABLE_TITLE), Qt::AscendingOrder);
+    model.select();
+    ASSERT_EQ(kNumTracks, model.rowCount());
+
+    model.search(QStringLiteral("Alpha"));
+    model.search(QStringLiteral("Delta"));
+    waitForSelect(model);
+    EXPECT_FALSE(model.isSelectPending());
+    expectRowsOfArtist(model, QStringLiteral("Delta"));
+}
+
+TEST_F(BaseSqlTableModelTest, searchViewOfTemporaryTable) {
+    // Creates library_view
+    const auto pLibraryModel = newModel();
+    DependentViewModel model(trackCollectionManager());
+    model.setSort(model.fieldIndex(LIBRARYTABLE_TITLE), Qt::AscendingOrder);
+    model.select();
+    ASSERT_EQ(kNumTracks, model.rowCount());
+    int selectFinishedCount = 0;
+    QObject::connect(&model,
+            &BaseSqlTableModel::selectFinished,
+            [&selectFinishedCount] { ++selectFinishedCount; });
+
+    model.search(QStringLiteral("Delta"));
+    waitForSelect(model);
+    EXPECT_FALSE(model.isSelectPending());
+    EXPECT_EQ(1, selectFinishedCount);
+    expectRowsOfArtist(model, QStringLiteral("Delta"));
+}
+
+TEST_F(BaseSqlTableModelTest, stopIncrementalModelPopulation) {
+    const auto pLibraryModel = newModel();
+    TemporaryTableModel model(trackCollectionManager());
+    model.setSort(model.fieldIndex(LIBRARYTABLE_TITLE), Qt::AscendingOrder);
+    model.select();
+    int selectFinishedCount = 0;
+    QObject::connect(&model,
+            &BaseSqlTableModel::selectFinished,
+            [&selectFinishedCount] { ++selectFinishedCount; });
+
+    model.search(QStringLiteral("Echo"));
+    const int selectFinishedImmediately = selectFinishedCount;
+    model.maybeStopModelPopulation();
+    EXPECT_FALSE(model.isSelectPending());
+
+    processEvents();
+    EXPECT_EQ(selectFinishedImmediately, selectFinishedCount);
+    if (selectFinishedImmediately == 0) {
+        // The previous rows are kept
+        EXPECT_EQ(kNumTracks, model.rowCount());
+    } else {
+        expectRowsOfArtist(model, QStringLiteral("Echo"));
+    }
+}
+
+} // namespace
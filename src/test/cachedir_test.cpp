@@ -0,0 +1,65 @@
+#include "util/cachedir.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr qint64 kFileSize = 1000;
+
+class CacheDirTest : public MixxxTest {
+  protected:
+    QString createFile(const QString& fileName, int daysAgo) {
+        const QString filePath = getTestDataDir().filePath(fileName);
+        QDir().mkpath(QFileInfo(filePath).path());
+        QFile file(filePath);
+        EXPECT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(kFileSize, '\0'));
+        EXPECT_TRUE(file.setFileTime(
+                QDateTime::currentDateTimeUtc().addDays(-daysAgo),
+                QFileDevice::FileModificationTime));
+        return filePath;
+    }
+};
+
+TEST_F(CacheDirTest, removeLeastRecentlyUsedFiles) {
+    const QString oldest = createFile(QStringLiteral("a/oldest"), 30);
+    const QString old = createFile(QStringLiteral("b/old"), 20);
+    const QString recent = createFile(QStringLiteral("a/recent"), 10);
+    const QString newest = createFile(QStringLiteral("newest"), 0);
+
+    // Below the limit
+    EXPECT_EQ(4 * kFileSize,
+            mixxx::cachedir::removeLeastRecentlyUsedFiles(
+                    getTestDataDir().path(), 4 * kFileSize));
+    EXPECT_TRUE(QFile::exists(oldest));
+
+    // Removed until less than 90% of the limit remain
+    EXPECT_EQ(2 * kFileSize,
+            mixxx::cachedir::removeLeastRecentlyUsedFiles(
+                    getTestDataDir().path(), 3 * kFileSize));
+    EXPECT_FALSE(QFile::exists(oldest));
+    EXPECT_FALSE(QFile::exists(old));
+    EXPECT_TRUE(QFile::exists(recent));
+    EXPECT_TRUE(QFile::exists(newest));
+}
+
+TEST_F(CacheDirTest, touchFile) {
+    const QString old = createFile(QStringLiteral("old"), 20);
+    const QString recent = createFile(QStringLiteral("recent"), 10);
+
+    // The touched file is kept
+    mixxx::cachedir::touchFile(old);
+    EXPECT_EQ(kFileSize, QFileInfo(old).size());
+    mixxx::cachedir::removeLeastRecentlyUsedFiles(
+            getTestDataDir().path(), kFileSize + kFileSize / 5);
+    EXPECT_TRUE(QFile::exists(old));
+    EXPECT_FALSE(QFile::exists(recent));
+}
+
+} // namespace
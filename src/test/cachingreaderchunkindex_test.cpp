@@ -0,0 +1,165 @@
+// Tests for cachingreaderchunkindex.h
+
+#include "engine/cachingreader/cachingreaderchunkindex.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QHash>
+#include <QRandomGenerator>
+#include <map>
+#include <vector>
+
+namespace {
+
+// Same as in CachingReader
+constexpr int kMaxChunks = 80;
+
+// The capacity of CachingReader::HintVector
+constexpr int kHintsPerCallback = 512;
+
+TEST(CachingReaderChunkIndexTest, insertFindRemove) {
+    std::vector<int> values(kMaxChunks);
+    CachingReaderChunkIndex<int> index(kMaxChunks);
+    EXPECT_TRUE(index.isEmpty());
+    EXPECT_EQ(nullptr, index.find(0));
+
+    for (int i = 0; i < kMaxChunks; ++i) {
+        index.insert(i * 7, &values[i]);
+    }
+    EXPECT_EQ(kMaxChunks, index.size());
+    for (int i = 0; i < kMaxChunks; ++i) {
+        EXPECT_EQ(&values[i], index.find(i * 7));
+        EXPECT_EQ(nullptr, index.find(i * 7 + 1));
+    }
+
+    // Replace an existing entry
+    index.insert(0, &values[1]);
+    EXPECT_EQ(kMaxChunks, index.size());
+    EXPECT_EQ(&values[1], index.find(0));
+
+    EXPECT_TRUE(index.remove(7));
+    EXPECT_FALSE(index.remove(7));
+    EXPECT_EQ(nullptr, index.find(7));
+    EXPECT_EQ(kMaxChunks - 1, index.size());
+
+    index.clear();
+    EXPECT_TRUE(index.isEmpty());
+    for (int i = 0; i < kMaxChunks; ++i) {
+        EXPECT_EQ(nullptr, index.find(i * 7));
+    }
+}
+
+TEST(CachingReaderChunkIndexTest, randomOperationsMatchReference) {
+    std::vector<int> values(kMaxChunks);
+    CachingReaderChunkIndex<int> index(kMaxChunks);
+    std::map<SINT, int*> reference;
+
+    // Few distinct keys with many collisions, so that entries are
+    // shifted back frequently when removing them.
+    QRandomGenerator random(42);
+    for (int i = 0; i < 100000; ++i) {
+        const SINT chunkIndex = random.bounded(3 * kMaxChunks);
+        if (random.bounded(2) == 0) {
+            if (static_cast<int>(reference.size()) < kMaxChunks ||
+                    reference.count(chunkIndex) > 0) {
+                int* pValue = &values[random.bounded(kMaxChunks)];
+                index.insert(chunkIndex, pValue);
+                reference[chunkIndex] = pValue;
+            }
+        } else {
+            EXPECT_EQ(reference.erase(chunkIndex) > 0, index.remove(chunkIndex));
+        }
+        ASSERT_EQ(static_cast<int>(reference.size()), index.size());
+    }
+    for (SINT chunkIndex = 0; chunkIndex < 3 * kMaxChunks; ++chunkIndex) {
+        const auto it = reference.find(chunkIndex);
+        EXPECT_EQ(it == reference.end() ? nullptr : it->second, index.find(chunkIndex));
+    }
+}
+
+// Mimics the access pattern of CachingReader while juggling between
+// hot cues: Every callback looks up the chunks around all hot cues
+// and the chunks that are missing replace the least recently allocated
+// chunks. The number of hot cues controls the ratio of hits and misses,
+// all chunks around up to 8 hot cues fit into the cache.
+template<typename Index>
+class JugglingSimulation {
+  public:
+    explicit JugglingSimulation(Index* pIndex, int numHotCues)
+            : m_pIndex(pIndex),
+              m_values(kMaxChunks),
+              m_allocatedChunkIndices(kMaxChunks, -1),
+              m_nextChunk(0) {
+        QRandomGenerator random(42);
+        for (int i = 0; i < kHintsPerCallback; ++i) {
+            const SINT hotCueChunkIndex = 100 * random.bounded(numHotCues);
+            m_hints.push_back(hotCueChunkIndex + random.bounded(10));
+        }
+    }
+
+    int processCallback() {
+        int misses = 0;
+        for (const SINT chunkIndex : m_hints) {
+            if (find(chunkIndex)) {
+                continue;
+            }
+            ++misses;
+            const SINT expiredChunkIndex = m_allocatedChunkIndices[m_nextChunk];
+            if (expiredChunkIndex >= 0) {
+                m_pIndex->remove(expiredChunkIndex);
+            }
+            m_pIndex->insert(chunkIndex, &m_values[m_nextChunk]);
+            m_allocatedChunkIndices[m_nextChunk] = chunkIndex;
+            m_nextChunk = (m_nextChunk + 1) % kMaxChunks;
+        }
+        return misses;
+    }
+
+  private:
+    int* find(SINT chunkIndex) const;
+
+    Index* m_pIndex;
+    std::vector<int> m_values;
+    std::vector<SINT> m_hints;
+    std::vector<SINT> m_allocatedChunkIndices;
+    int m_nextChunk;
+};
+
+template<>
+int* JugglingSimulation<CachingReaderChunkIndex<int>>::find(SINT chunkIndex) const {
+    return m_pIndex->find(chunkIndex);
+}
+
+template<>
+int* JugglingSimulation<QHash<int, int*>>::find(SINT chunkIndex) const {
+    return m_pIndex->value(chunkIndex, nullptr);
+}
+
+template<typename Index>
+void runJugglingBenchmark(benchmark::State& state, Index* pIndex) {
+    JugglingSimulation<Index> simulation(pIndex, state.range(0));
+    std::int64_t misses = 0;
+    for (auto _ : state) {
+        misses += simulation.processCallback();
+    }
+    state.SetItemsProcessed(state.iterations() * kHintsPerCallback);
+    state.counters["misses"] = benchmark::Counter(
+            static_cast<double>(misses) / kHintsPerCallback,
+            benchmark::Counter::kAvgIterations);
+}
+
+static void BM_CachingReaderChunkIndexJuggling(benchmark::State& state) {
+    CachingReaderChunkIndex<int> index(kMaxChunks);
+    runJugglingBenchmark(state, &index);
+}
+BENCHMARK(BM_CachingReaderChunkIndexJuggling)->RangeMultiplier(2)->Range(1, 32);
+
+static void BM_QHashJuggling(benchmark::State& state) {
+    QHash<int, int*> index;
+    index.reserve(kMaxChunks);
+    runJugglingBenchmark(state, &index);
+}
+BENCHMARK(BM_QHashJuggling)->RangeMultiplier(2)->Range(1, 32);
+
+} // namespace
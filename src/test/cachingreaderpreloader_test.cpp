@@ -0,0 +1,105 @@
+#include "engine/cachingreader/cachingreaderpreloader.h"
+
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr auto kChannelCount = mixxx::audio::ChannelCount::stereo();
+
+class CachingReaderPreloaderTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    void SetUp() override {
+        m_pPreloader = CachingReaderPreloader::createInstance(kChannelCount);
+        m_pTrack = Track::newDummy(
+                getTestDir().filePath(QStringLiteral("id3-test-data/cover-test.flac")),
+                TrackId(QVariant(1)));
+    }
+
+    void TearDown() override {
+        CachingReaderPreloader::destroy();
+    }
+
+    bool waitUntilPreloaded() const {
+        QElapsedTimer timer;
+        timer.start();
+        while (!m_pPreloader->hasPreloadedTrack(m_pTrack)) {
+            if (timer.elapsed() > 5000) {
+                return false;
+            }
+            QThread::msleep(1);
+        }
+        return true;
+    }
+
+    CachingReaderPreloader* m_pPreloader;
+    TrackPointer m_pTrack;
+};
+
+TEST_F(CachingReaderPreloaderTest, preloadedChunksMatchFile) {
+    m_pPreloader->preloadTracks({m_pTrack});
+    ASSERT_TRUE(waitUntilPreloaded());
+    const auto pPreloadedTrack = m_pPreloader->takePreloadedTrack(m_pTrack, kChannelCount);
+    ASSERT_NE(nullptr, pPreloadedTrack);
+    // Only taken once
+    EXPECT_FALSE(m_pPreloader->hasPreloadedTrack(m_pTrack));
+    EXPECT_EQ(nullptr, m_pPreloader->takePreloadedTrack(m_pTrack, kChannelCount));
+
+    const CachingReaderChunk* pPreloadedChunk = pPreloadedTrack->findChunk(0);
+    ASSERT_NE(nullptr, pPreloadedChunk);
+
+    // Read the same chunk from the file like the CachingReaderWorker
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(kChannelCount);
+    const auto pAudioSource = SoundSourceProxy(m_pTrack).openAudioSource(config);
+    ASSERT_NE(nullptr, pAudioSource);
+    const SINT chunkSampleCount = CachingReaderChunk::frames2samples(
+            CachingReaderChunk::kFrames, kChannelCount);
+    auto chunkBuffer = mixxx::SampleBuffer(2 * chunkSampleCount);
+    auto tempReadBuffer = mixxx::SampleBuffer(chunkSampleCount);
+    CachingReaderChunkForPreloader readChunk(0,
+            mixxx::SampleBuffer::WritableSlice(chunkBuffer, 0, chunkSampleCount));
+    const auto frameIndexRange = readChunk.bufferSampleFrames(
+            pAudioSource, mixxx::SampleBuffer::WritableSlice(tempReadBuffer));
+    ASSERT_FALSE(frameIndexRange.empty());
+
+    // Adopted by a chunk of the cache
+    CachingReaderChunkForPreloader copiedChunk(0,
+            mixxx::SampleBuffer::WritableSlice(
+                    chunkBuffer, chunkSampleCount, chunkSampleCount));
+    EXPECT_EQ(frameIndexRange, copiedChunk.copyBufferedSampleFrames(*pPreloadedChunk));
+
+    const SINT sampleCount = CachingReaderChunk::frames2samples(
+            frameIndexRange.length(), kChannelCount);
+    auto expected = mixxx::SampleBuffer(sampleCount);
+    auto actual = mixxx::SampleBuffer(sampleCount);
+    readChunk.readBufferedSampleFrames(expected.data(), kChannelCount, frameIndexRange);
+    copiedChunk.readBufferedSampleFrames(actual.data(), kChannelCount, frameIndexRange);
+    for (SINT i = 0; i < sampleCount; ++i) {
+        ASSERT_EQ(expected[i], actual[i]) << "sample " << i;
+    }
+}
+
+TEST_F(CachingReaderPreloaderTest, differentChannelCount) {
+    m_pPreloader->preloadTracks({m_pTrack});
+    ASSERT_TRUE(waitUntilPreloaded());
+    EXPECT_EQ(nullptr,
+            m_pPreloader->takePreloadedTrack(
+                    m_pTrack, mixxx::audio::ChannelCount::stem()));
+}
+
+TEST_F(CachingReaderPreloaderTest, discardUnwantedTracks) {
+    m_pPreloader->preloadTracks({m_pTrack});
+    ASSERT_TRUE(waitUntilPreloaded());
+    m_pPreloader->preloadTracks({});
+    EXPECT_FALSE(m_pPreloader->hasPreloadedTrack(m_pTrack));
+    EXPECT_EQ(nullptr, m_pPreloader->takePreloadedTrack(m_pTrack, kChannelCount));
+}
+
+} // anonymous namespace
@@ -3,7 +3,9 @@
 #include <QtDebug>
 #include <memory>
 
+#include "control/controlnotifier.h"
 #include "control/controlobject.h"
+#include "control/controlproxy.h"
 #include "test/mixxxtest.h"
 
 namespace {
@@ -86,4 +88,45 @@ TEST_F(ControlObjectTest, Persistence_ValidValue) {
     EXPECT_DOUBLE_EQ(5.0, co.get());
 }
 
+TEST_F(ControlObjectTest, CoalescedNotifications) {
+    co1->enableCoalescedNotifications();
+    ControlProxy proxy(ck1);
+    QObject receiver;
+    QList<double> notifiedValues;
+    proxy.connectValueChanged(
+            &receiver,
+            [&notifiedValues](double value) {
+                notifiedValues.append(value);
+            },
+            Qt::DirectConnection);
+
+    {
+        ControlNotifier::ScopedEngineThread engineThread;
+        co1->set(1.0);
+        co1->set(2.0);
+        co1->set(3.0);
+    }
+    EXPECT_DOUBLE_EQ(3.0, co1->get());
+    EXPECT_TRUE(notifiedValues.isEmpty());
+
+    // Only the latest value is notified
+    EXPECT_EQ(1, ControlNotifier::drain());
+    EXPECT_EQ(QList<double>{3.0}, notifiedValues);
+    EXPECT_EQ(0, ControlNotifier::drain());
+
+    // Sets from other threads are notified immediately
+    co1->set(4.0);
+    EXPECT_EQ((QList<double>{3.0, 4.0}), notifiedValues);
+}
+
+TEST_F(ControlObjectTest, CoalescedNotificationsOfDeletedControl) {
+    co2->enableCoalescedNotifications();
+    {
+        ControlNotifier::ScopedEngineThread engineThread;
+        co2->set(1.0);
+    }
+    co2.reset();
+    EXPECT_EQ(0, ControlNotifier::drain());
+}
+
 } // namespace
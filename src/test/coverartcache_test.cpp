@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include <QFileInfo>
+#include <QTemporaryDir>
 
 #include "library/coverartcache.h"
+#include "library/coverartdiskcache.h"
 #include "library/coverartutils.h"
 #include "library/trackcollection.h"
 #include "test/librarytest.h"
@@ -88,3 +90,62 @@ TEST_F(CoverArtCacheTest, loadCoverFromFileAbsolute) {
             getTestDir().filePath(kCoverLocationTest),
             getTestDir().filePath(kCoverLocationTest));
 }
+
+TEST_F(CoverArtCacheTest, loadCoverFromDiskCache) {
+    QTemporaryDir cacheDir;
+    ASSERT_TRUE(cacheDir.isValid());
+    const auto pDiskCache = std::make_shared<const CoverArtDiskCache>(cacheDir.path());
+
+    const QString coverLocation = getTestDir().filePath(kCoverLocationTest);
+    CoverInfo info;
+    info.type = CoverInfo::FILE;
+    info.source = CoverInfo::GUESSED;
+    info.coverLocation = coverLocation;
+    info.setImageDigest(QImage(coverLocation));
+    ASSERT_FALSE(info.imageDigest().isEmpty());
+
+    constexpr int kWidth = 100;
+    const QString thumbnailPath = pDiskCache->imageFilePath(
+            info.cacheKey(), CoverArtDiskCache::bucketWidth(kWidth));
+
+    // Decoded from the original file and stored on disk
+    auto res = CoverArtCache::loadCover(TrackPointer(), info, kWidth, pDiskCache);
+    EXPECT_EQ(CoverInfo::LoadedImage::Result::Ok, res.coverArt.loadedImage.result);
+    EXPECT_QSTRING_EQ(coverLocation, res.coverArt.loadedImage.location);
+    EXPECT_EQ(kWidth, res.coverArt.loadedImage.image.width());
+    EXPECT_TRUE(QFileInfo::exists(thumbnailPath));
+
+    // Loaded from the disk cache
+    res = CoverArtCache::loadCover(TrackPointer(), info, kWidth, pDiskCache);
+    EXPECT_EQ(CoverInfo::LoadedImage::Result::Ok, res.coverArt.loadedImage.result);
+    EXPECT_QSTRING_EQ(thumbnailPath, res.coverArt.loadedImage.location);
+    EXPECT_EQ(kWidth, res.coverArt.loadedImage.image.width());
+
+    // Full size covers are not cached
+    res = CoverArtCache::loadCover(TrackPointer(), info, 0, pDiskCache);
+    EXPECT_QSTRING_EQ(coverLocation, res.coverArt.loadedImage.location);
+}
+
+TEST_F(CoverArtCacheTest, removeUnusedImagesFromDiskCache) {
+    QTemporaryDir cacheDir;
+    ASSERT_TRUE(cacheDir.isValid());
+    const CoverArtDiskCache diskCache(cacheDir.path());
+    const QImage image(getTestDir().filePath(kCoverLocationTest));
+    ASSERT_FALSE(image.isNull());
+
+    constexpr mixxx::cache_key_t kUsedCacheKey = 0x1234;
+    constexpr mixxx::cache_key_t kUnusedCacheKey = 0x5678;
+    constexpr int kWidth = 100;
+    diskCache.storeImage(kUsedCacheKey, kWidth, image);
+    diskCache.storeImage(kUnusedCacheKey, kWidth, image);
+    const QString usedPath = diskCache.imageFilePath(
+            kUsedCacheKey, CoverArtDiskCache::bucketWidth(kWidth));
+    const QString unusedPath = diskCache.imageFilePath(
+            kUnusedCacheKey, CoverArtDiskCache::bucketWidth(kWidth));
+    ASSERT_TRUE(QFileInfo::exists(usedPath));
+    ASSERT_TRUE(QFileInfo::exists(unusedPath));
+
+    diskCache.removeUnusedImages({kUsedCacheKey});
+    EXPECT_TRUE(QFileInfo::exists(usedPath));
+    EXPECT_FALSE(QFileInfo::exists(unusedPath));
+}
@@ -0,0 +1,277 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+#include "database/mixxxdb.h"
+#include "library/dao/analysisdao.h"
+#include "library/dao/cuedao.h"
+#include "library/dao/libraryhashdao.h"
+#include "library/dao/playlistdao.h"
+#include "library/dao/trackdao.h"
+#include "library/dao/tracksearchindexdao.h"
+#include "library/library_prefs.h"
+#include "test/mixxxtest.h"
+#include "util/db/dbconnection.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/db/sqltransaction.h"
+
+namespace {
+
+// A large library that doesn't fit into the default page cache
+constexpr int kNumTracks = 20000;
+
+QVariant queryPragma(const QSqlDatabase& database, const QString& pragma) {
+    QSqlQuery query(database);
+    if (!query.exec(QStringLiteral("PRAGMA ") + pragma) || !query.next()) {
+        return QVariant();
+    }
+    return query.value(0);
+}
+
+void disableSqliteProfile(const UserSettingsPointer& pConfig) {
+    pConfig->setValue(mixxx::library::prefs::kDatabaseWriteAheadLogConfigKey, false);
+    pConfig->setValue(mixxx::library::prefs::kDatabaseMmapSizeMiBConfigKey, 0);
+    pConfig->setValue(mixxx::library::prefs::kDatabaseCacheSizeMiBConfigKey, 0);
+}
+
+class DbConnectionProfileTest : public MixxxTest {
+};
+
+TEST_F(DbConnectionProfileTest, tunedProfile) {
+    config()->setValue(mixxx::library::prefs::kDatabaseWriteAheadLogConfigKey, true);
+    const MixxxDb mixxxDb(config());
+    const mixxx::DbConnectionPooler dbConnectionPooler(mixxxDb.connectionPool());
+    const QSqlDatabase database = mixxx::DbConnectionPooled(mixxxDb.connectionPool());
+
+    EXPECT_QSTRING_EQ(QStringLiteral("wal"),
+            queryPragma(database, QStringLiteral("journal_mode")).toString());
+    // NORMAL
+    EXPECT_EQ(1, queryPragma(database, QStringLiteral("synchronous")).toInt());
+    // MEMORY
+    EXPECT_EQ(2, queryPragma(database, QStringLiteral("temp_store")).toInt());
+    EXPECT_EQ(-mixxx::library::prefs::kDatabaseCacheSizeMiBDefault * 1024,
+            queryPragma(database, QStringLiteral("cache_size")).toInt());
+}
+
+TEST_F(DbConnectionProfileTest, disabledProfile) {
+    disableSqliteProfile(config());
+    const MixxxDb mixxxDb(config());
+    const mixxx::DbConnectionPooler dbConnectionPooler(mixxxDb.connectionPool());
+    const QSqlDatabase database = mixxx::DbConnectionPooled(mixxxDb.connectionPool());
+
+    EXPECT_QSTRING_EQ(QStringLiteral("delete"),
+            queryPragma(database, QStringLiteral("journal_mode")).toString());
+    // FULL
+    EXPECT_EQ(2, queryPragma(database, QStringLiteral("synchronous")).toInt());
+}
+
+TEST_F(DbConnectionProfileTest, rollbackJournalByDefault) {
+    const MixxxDb mixxxDb(config());
+    const mixxx::DbConnectionPooler dbConnectionPooler(mixxxDb.connectionPool());
+    const QSqlDatabase database = mixxx::DbConnectionPooled(mixxxDb.connectionPool());
+
+    EXPECT_QSTRING_EQ(QStringLiteral("delete"),
+            queryPragma(database, QStringLiteral("journal_mode")).toString());
+    // FULL
+    EXPECT_EQ(2, queryPragma(database, QStringLiteral("synchronous")).toInt());
+    // MEMORY
+    EXPECT_EQ(2, queryPragma(database, QStringLiteral("temp_store")).toInt());
+}
+
+TEST_F(DbConnectionProfileTest, maintainDatabase) {
+    const MixxxDb mixxxDb(config());
+    const mixxx::DbConnectionPooler dbConnectionPooler(mixxxDb.connectionPool());
+    const QSqlDatabase database = mixxx::DbConnectionPooled(mixxxDb.connectionPool());
+    ASSERT_TRUE(MixxxDb::initDatabaseSchema(database));
+
+    EXPECT_TRUE(MixxxDb::maintainDatabase(database));
+}
+
+// A library in a database file with the DAOs of the most common queries.
+// The tuned profile is compared with the default settings of SQLite.
+class BenchmarkLibrary {
+  public:
+    explicit BenchmarkLibrary(bool tunedProfile)
+            : m_pConfig(makeConfig(m_dir, tunedProfile)),
+              m_mixxxDb(m_pConfig),
+              m_dbConnectionPooler(m_mixxxDb.connectionPool()),
+              m_analysisDao(m_pConfig),
+              m_trackDao(m_cueDao,
+                      m_playlistDao,
+                      m_analysisDao,
+                      m_libraryHashDao,
+                      m_trackSearchIndexDao,
+                      m_pConfig),
+              m_playlistId(-1) {
+        const QSqlDatabase database = dbConnection();
+        VERIFY_OR_DEBUG_ASSERT(MixxxDb::initDatabaseSchema(database)) {
+            return;
+        }
+        m_trackDao.initialize(database);
+        m_playlistDao.initialize(database);
+        addTracks(database);
+        m_playlistId = m_playlistDao.createPlaylist(QStringLiteral("Benchmark"));
+        m_playlistDao.appendTracksToPlaylist(m_trackIds, m_playlistId);
+    }
+
+    QSqlDatabase dbConnection() const {
+        return mixxx::DbConnectionPooled(m_mixxxDb.connectionPool());
+    }
+
+    TrackDAO& trackDao() {
+        return m_trackDao;
+    }
+
+    PlaylistDAO& playlistDao() {
+        return m_playlistDao;
+    }
+
+    const QList<TrackId>& trackIds() const {
+        return m_trackIds;
+    }
+
+    int playlistId() const {
+        return m_playlistId;
+    }
+
+  private:
+    static UserSettingsPointer makeConfig(const QTemporaryDir& dir, bool tunedProfile) {
+        auto pConfig = UserSettingsPointer(
+                new UserSettings(QDir(dir.path()).filePath(QStringLiteral("mixxx.cfg"))));
+        if (tunedProfile) {
+            pConfig->setValue(mixxx::library::prefs::kDatabaseWriteAheadLogConfigKey, true);
+        } else {
+            disableSqliteProfile(pConfig);
+        }
+        return pConfig;
+    }
+
+    void addTracks(const QSqlDatabase& database) {
+        SqlTransaction transaction(database);
+        QSqlQuery locationQuery(database);
+        locationQuery.prepare(QStringLiteral(
+                "INSERT INTO track_locations "
+                "(id,location,directory,filename,filesize,fs_deleted,needs_verification) "
+                "VALUES (:id,:location,:directory,:filename,:filesize,0,0)"));
+        QSqlQuery libraryQuery(database);
+        libraryQuery.prepare(QStringLiteral(
+                "INSERT INTO library "
+                "(id,artist,title,album,genre,location,duration,bpm,mixxx_deleted) "
+                "VALUES (:id,:artist,:title,:album,:genre,:location,:duration,:bpm,0)"));
+        for (int i = 1; i <= kNumTracks; ++i) {
+            const QString directory = QStringLiteral("/music/Artist %1/Album %2")
+                                              .arg(i % 997)
+                                              .arg(i % 31);
+            const QString fileName = QStringLiteral("%1 - Title.mp3").arg(i);
+            locationQuery.bindValue(QStringLiteral(":id"), i);
+            locationQuery.bindValue(QStringLiteral(":location"),
+                    directory + QChar('/') + fileName);
+            locationQuery.bindValue(QStringLiteral(":directory"), directory);
+            locationQuery.bindValue(QStringLiteral(":filename"), fileName);
+            locationQuery.bindValue(QStringLiteral(":filesize"), 5000000 + i);
+            libraryQuery.bindValue(QStringLiteral(":id"), i);
+            libraryQuery.bindValue(QStringLiteral(":artist"),
+                    QStringLiteral("Artist %1").arg(i % 997));
+            libraryQuery.bindValue(QStringLiteral(":title"),
+                    QStringLiteral("Title %1").arg(i));
+            libraryQuery.bindValue(QStringLiteral(":album"),
+                    QStringLiteral("Album %1").arg(i % 31));
+            libraryQuery.bindValue(QStringLiteral(":genre"),
+                    QStringLiteral("Genre %1").arg(i % 17));
+            libraryQuery.bindValue(QStringLiteral(":location"), i);
+            libraryQuery.bindValue(QStringLiteral(":duration"), 180.0 + i % 240);
+            libraryQuery.bindValue(QStringLiteral(":bpm"), 90.0 + i % 60);
+            VERIFY_OR_DEBUG_ASSERT(locationQuery.exec() && libraryQuery.exec()) {
+                return;
+            }
+            m_trackIds.append(TrackId(QVariant(i)));
+        }
+        transaction.commit();
+    }
+
+    const QTemporaryDir m_dir;
+    const UserSettingsPointer m_pConfig;
+    const MixxxDb m_mixxxDb;
+    const mixxx::DbConnectionPooler m_dbConnectionPooler;
+    CueDAO m_cueDao;
+    PlaylistDAO m_playlistDao;
+    AnalysisDao m_analysisDao;
+    LibraryHashDAO m_libraryHashDao;
+    TrackSearchIndexDAO m_trackSearchIndexDao;
+    TrackDAO m_trackDao;
+    QList<TrackId> m_trackIds;
+    int m_playlistId;
+};
+
+static void BM_TrackDAOGetAllTrackLocations(benchmark::State& state) {
+    BenchmarkLibrary library(state.range(0) != 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(library.trackDao().getAllTrackLocations());
+    }
+    state.SetItemsProcessed(state.iterations() * kNumTracks);
+}
+BENCHMARK(BM_TrackDAOGetAllTrackLocations)->Arg(0)->Arg(1);
+
+static void BM_TrackDAOGetTrackLocation(benchmark::State& state) {
+    BenchmarkLibrary library(state.range(0) != 0);
+    int i = 0;
+    for (auto _ : state) {
+        // Stride through the whole table
+        i = (i + 7919) % kNumTracks;
+        benchmark::DoNotOptimize(library.trackDao().getTrackLocation(
+                library.trackIds().at(i)));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TrackDAOGetTrackLocation)->Arg(0)->Arg(1);
+
+static void BM_PlaylistDAOGetTrackIdsInPlaylistOrder(benchmark::State& state) {
+    BenchmarkLibrary library(state.range(0) != 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(library.playlistDao().getTrackIdsInPlaylistOrder(
+                library.playlistId()));
+    }
+    state.SetItemsProcessed(state.iterations() * kNumTracks);
+}
+BENCHMARK(BM_PlaylistDAOGetTrackIdsInPlaylistOrder)->Arg(0)->Arg(1);
+
+static void BM_PlaylistDAOAppendTrackToPlaylist(benchmark::State& state) {
+    BenchmarkLibrary library(state.range(0) != 0);
+    const int playlistId = library.playlistDao().createPlaylist(QStringLiteral("Append"));
+    int i = 0;
+    for (auto _ : state) {
+        // Each call commits a transaction, e.g. adding to Auto DJ
+        library.playlistDao().appendTrackToPlaylist(
+                library.trackIds().at(i++ % kNumTracks), playlistId);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PlaylistDAOAppendTrackToPlaylist)->Arg(0)->Arg(1);
+
+// The query of the library table when sorting by artist
+static void BM_LibraryOrderByArtist(benchmark::State& state) {
+    BenchmarkLibrary library(state.range(0) != 0);
+    QSqlQuery query(library.dbConnection());
+    query.prepare(QStringLiteral(
+                          "SELECT library.id FROM library "
+                          "INNER JOIN track_locations "
+                          "ON library.location=track_locations.id "
+                          "WHERE library.mixxx_deleted=0 ORDER BY ") +
+            mixxx::DbConnection::collateLexicographically(QStringLiteral("artist")) +
+            QStringLiteral(",title"));
+    for (auto _ : state) {
+        query.exec();
+        int numRows = 0;
+        while (query.next()) {
+            ++numRows;
+        }
+        benchmark::DoNotOptimize(numRows);
+    }
+    state.SetItemsProcessed(state.iterations() * kNumTracks);
+}
+BENCHMARK(BM_LibraryOrderByArtist)->Arg(0)->Arg(1);
+
+} // namespace
@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "engine/filters/enginefilterbessel8.h"
+#include "engine/filters/enginefilterbutterworth8.h"
+#include "engine/filters/enginefilterlinkwitzriley8.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr std::size_t kBufferSize = 1024;
+
+// Filters each channel on its own with the scalar cascade, the way
+// EngineFilterIIR did before both channels have been processed in lanes.
+template<class Filter>
+class ScalarReferenceFilter : public Filter {
+  public:
+    using Filter::Filter;
+
+    void processScalar(const CSAMPLE* pIn, CSAMPLE* pOutput, std::size_t bufferSize) {
+        for (std::size_t i = 0; i < bufferSize; i += 2) {
+            pOutput[i] = static_cast<CSAMPLE>(this->processSample(
+                    this->m_coef, m_buf1, static_cast<double>(pIn[i])));
+            pOutput[i + 1] = static_cast<CSAMPLE>(this->processSample(
+                    this->m_coef, m_buf2, static_cast<double>(pIn[i + 1])));
+        }
+    }
+
+  private:
+    // Large enough for the state of all cascades
+    static constexpr std::size_t kMaxSize = 16;
+    double m_buf1[kMaxSize]{};
+    double m_buf2[kMaxSize]{};
+};
+
+std::vector<CSAMPLE> testSignal(std::size_t size) {
+    std::vector<CSAMPLE> signal(size);
+    // Different content on both channels, with a click that excites the
+    // whole spectrum.
+    for (std::size_t i = 0; i < size; i += 2) {
+        signal[i] = static_cast<CSAMPLE>(std::sin(i * 0.01) + 0.3 * std::sin(i * 0.7));
+        signal[i + 1] = static_cast<CSAMPLE>(0.5 * std::cos(i * 0.05));
+    }
+    signal[size / 2] = 1.0f;
+    return signal;
+}
+
+template<class Filter, typename... Args>
+void expectMatchesScalarReference(Args... args) {
+    ScalarReferenceFilter<Filter> filter(args...);
+    filter.assumeSettled();
+    const auto input = testSignal(kBufferSize * 4);
+    std::vector<CSAMPLE> output(kBufferSize);
+    std::vector<CSAMPLE> expected(kBufferSize);
+    for (std::size_t offset = 0; offset < input.size(); offset += kBufferSize) {
+        filter.process(&input[offset], output.data(), kBufferSize);
+        // The reference state is separate, but the coefficients are shared
+        filter.processScalar(&input[offset], expected.data(), kBufferSize);
+        for (std::size_t i = 0; i < kBufferSize; ++i) {
+            ASSERT_NEAR(expected[i], output[i], 1e-6) << "sample " << offset + i;
+        }
+    }
+}
+
+TEST(EngineFilterIIRTest, lanesMatchScalarLinkwitzRiley8) {
+    expectMatchesScalarReference<EngineFilterLinkwitzRiley8Low>(kSampleRate, 246.0);
+    expectMatchesScalarReference<EngineFilterLinkwitzRiley8High>(kSampleRate, 2484.0);
+}
+
+TEST(EngineFilterIIRTest, lanesMatchScalarBessel8) {
+    expectMatchesScalarReference<EngineFilterBessel8Low>(kSampleRate, 246.0);
+    expectMatchesScalarReference<EngineFilterBessel8Band>(kSampleRate, 246.0, 2484.0);
+}
+
+TEST(EngineFilterIIRTest, lanesMatchScalarButterworth8) {
+    expectMatchesScalarReference<EngineFilterButterworth8High>(kSampleRate, 2484.0);
+}
+
+TEST(EngineFilterIIRTest, unchangedCornersKeepFilterState) {
+    EngineFilterLinkwitzRiley8Low updated(kSampleRate, 246.0);
+    EngineFilterLinkwitzRiley8Low untouched(kSampleRate, 246.0);
+    updated.assumeSettled();
+    untouched.assumeSettled();
+    const auto input = testSignal(kBufferSize * 2);
+    std::vector<CSAMPLE> output(kBufferSize);
+    std::vector<CSAMPLE> expected(kBufferSize);
+
+    updated.process(&input[0], output.data(), kBufferSize);
+    untouched.process(&input[0], expected.data(), kBufferSize);
+    // Would restart the filter and fade in the new one, if not skipped
+    updated.setFrequencyCorners(kSampleRate, 246.0);
+    updated.process(&input[kBufferSize], output.data(), kBufferSize);
+    untouched.process(&input[kBufferSize], expected.data(), kBufferSize);
+    EXPECT_EQ(expected, output);
+}
+
+template<class Filter>
+void BM_EngineFilterIIRLanes(benchmark::State& state, Filter* pFilter) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto input = testSignal(size);
+    std::vector<CSAMPLE> output(size);
+    pFilter->assumeSettled();
+    for (auto _ : state) {
+        pFilter->process(input.data(), output.data(), size);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template<class Filter>
+void BM_EngineFilterIIRScalar(benchmark::State& state, Filter* pFilter) {
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto input = testSignal(size);
+    std::vector<CSAMPLE> output(size);
+    for (auto _ : state) {
+        pFilter->processScalar(input.data(), output.data(), size);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+void BM_LinkwitzRiley8LowLanes(benchmark::State& state) {
+    EngineFilterLinkwitzRiley8Low filter(kSampleRate, 246.0);
+    BM_EngineFilterIIRLanes(state, &filter);
+}
+BENCHMARK(BM_LinkwitzRiley8LowLanes)->Range(64, 4096);
+
+void BM_LinkwitzRiley8LowScalar(benchmark::State& state) {
+    ScalarReferenceFilter<EngineFilterLinkwitzRiley8Low> filter(kSampleRate, 246.0);
+    BM_EngineFilterIIRScalar(state, &filter);
+}
+BENCHMARK(BM_LinkwitzRiley8LowScalar)->Range(64, 4096);
+
+void BM_Bessel8BandLanes(benchmark::State& state) {
+    EngineFilterBessel8Band filter(kSampleRate, 246.0, 2484.0);
+    BM_EngineFilterIIRLanes(state, &filter);
+}
+BENCHMARK(BM_Bessel8BandLanes)->Range(64, 4096);
+
+void BM_Bessel8BandScalar(benchmark::State& state) {
+    ScalarReferenceFilter<EngineFilterBessel8Band> filter(kSampleRate, 246.0, 2484.0);
+    BM_EngineFilterIIRScalar(state, &filter);
+}
+BENCHMARK(BM_Bessel8BandScalar)->Range(64, 4096);
+
+// The LV-Mix EQs quantize the corner to an integer group delay, so most
+// knob movements end up with the same design.
+void BM_Bessel8SetFrequencyCornersForIntDelay(benchmark::State& state) {
+    EngineFilterBessel8Low filter(kSampleRate, 246.0);
+    double corner = 246.0;
+    for (auto _ : state) {
+        corner = corner < 250.0 ? corner + 0.01 : 246.0;
+        benchmark::DoNotOptimize(filter.setFrequencyCornersForIntDelay(
+                corner / kSampleRate, 3300));
+    }
+}
+BENCHMARK(BM_Bessel8SetFrequencyCornersForIntDelay);
+
+} // namespace
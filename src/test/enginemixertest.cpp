@@ -3,11 +3,16 @@
 
 #include <QString>
 #include <QtDebug>
+#include <algorithm>
+#include <array>
 #include <memory>
 #include <tuple>
 #include <vector>
 
+#include "control/controlobject.h"
 #include "engine/channels/enginechannel.h"
+#include "engine/channels/enginedeck.h"
+#include "engine/enginebuffer.h"
 #include "engine/enginemixer.h"
 #include "gtest/gtest.h"
 #include "test/signalpathtest.h"
@@ -155,4 +160,79 @@ TEST_P(EngineMixerTest, OutputWorks) {
     assertBuffers();
 }
 
+class EngineMixerParallelTest : public SignalPathTest {
+  protected:
+    EngineMixerParallelTest()
+            : SignalPathTest(/*engineHelperThreads*/ 2) {
+    }
+
+    // Restarts all decks from the track start and returns the output of
+    // each deck for the following buffers.
+    std::vector<std::vector<CSAMPLE>> playFromStart(int bufferCount) {
+        const std::array<EngineDeck*, 3> decks{m_pChannel1, m_pChannel2, m_pChannel3};
+        for (auto* pDeck : decks) {
+            ControlObject::set(ConfigKey(pDeck->getGroup(), "play"), 0.0);
+        }
+        // Ramp down to silence before seeking to avoid a crossfade
+        ProcessBuffer();
+        ProcessBuffer();
+        for (auto* pDeck : decks) {
+            pDeck->getEngineBuffer()->queueNewPlaypos(
+                    mixxx::audio::kStartFramePos, EngineBuffer::SEEK_EXACT);
+        }
+        ProcessBuffer();
+        for (auto* pDeck : decks) {
+            ControlObject::set(ConfigKey(pDeck->getGroup(), "play"), 1.0);
+        }
+
+        std::vector<std::vector<CSAMPLE>> output(decks.size());
+        for (int i = 0; i < bufferCount; ++i) {
+            ProcessBuffer();
+            for (std::size_t j = 0; j < decks.size(); ++j) {
+                const auto buffer = m_pEngineMixer->getChannelBuffer(decks[j]->getGroup());
+                output[j].insert(output[j].end(), buffer.begin(), buffer.end());
+            }
+        }
+        return output;
+    }
+};
+
+TEST_F(EngineMixerParallelTest, OutputMatchesSequentialProcessing) {
+    if (!m_pEngineMixer->isParallelChannelProcessingEnabled()) {
+        GTEST_SKIP() << "Parallel channel processing needs at least two cores";
+    }
+
+    // None of the decks is a sync participant, so all of them are
+    // processed by the thread pool. Different rates make the outputs differ.
+    ControlObject::set(ConfigKey(m_sGroup1, "rate"), 0.05);
+    ControlObject::set(ConfigKey(m_sGroup2, "rate"), -0.1);
+    ControlObject::set(ConfigKey(m_sGroup3, "rate"), 0.2);
+    ASSERT_FALSE(m_pChannel1->getEngineBuffer()->isSyncParticipant());
+    ASSERT_FALSE(m_pChannel2->getEngineBuffer()->isSyncParticipant());
+    ASSERT_FALSE(m_pChannel3->getEngineBuffer()->isSyncParticipant());
+
+    constexpr int kBufferCount = 4;
+    m_pEngineMixer->suspendParallelChannelProcessing();
+    // The first pass only brings all decks into the same state as after
+    // the sequential pass and caches the audio data
+    playFromStart(kBufferCount);
+    const auto sequentialOutput = playFromStart(kBufferCount);
+    m_pEngineMixer->resumeParallelChannelProcessing();
+    const auto parallelOutput = playFromStart(kBufferCount);
+
+    ASSERT_EQ(sequentialOutput.size(), parallelOutput.size());
+    for (std::size_t i = 0; i < sequentialOutput.size(); ++i) {
+        SCOPED_TRACE(QStringLiteral("Deck %1").arg(i + 1).toStdString());
+        ASSERT_EQ(sequentialOutput[i].size(), parallelOutput[i].size());
+        // Make sure the deck is actually playing
+        EXPECT_TRUE(std::any_of(sequentialOutput[i].cbegin(),
+                sequentialOutput[i].cend(),
+                [](CSAMPLE sample) { return sample != 0; }));
+        EXPECT_EQ(sequentialOutput[i], parallelOutput[i]);
+    }
+    // The decks play at different rates
+    EXPECT_NE(sequentialOutput[0], sequentialOutput[1]);
+    EXPECT_NE(sequentialOutput[1], sequentialOutput[2]);
+}
+
 } // namespace
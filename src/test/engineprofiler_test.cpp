@@ -0,0 +1,113 @@
+#include "engine/engineprofiler.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <thread>
+
+namespace {
+
+// The profiler is global, all tests use their own probes
+const EngineProfiler::ProbeStats* findStats(
+        const QList<EngineProfiler::ProbeStats>& stats, const QString& name) {
+    for (const auto& probeStats : stats) {
+        if (probeStats.name == name) {
+            return &probeStats;
+        }
+    }
+    return nullptr;
+}
+
+TEST(EngineProfilerTest, registerProbe) {
+    const int probe = EngineProfiler::registerProbe(QStringLiteral("Test register"));
+    EXPECT_NE(EngineProfiler::kInvalidProbe, probe);
+    EXPECT_EQ(probe, EngineProfiler::registerProbe(QStringLiteral("Test register")));
+    EXPECT_NE(probe, EngineProfiler::registerProbe(QStringLiteral("Test register 2")));
+}
+
+TEST(EngineProfilerTest, histogramOfAllThreads) {
+    const QString name = QStringLiteral("Test histogram");
+    const int probe = EngineProfiler::registerProbe(name);
+    const auto recordDurations = [probe] {
+        EngineProfiler::record(probe, 1000, 1000);
+        EngineProfiler::record(probe, 1000, 1001);
+        EngineProfiler::record(probe, 1000, 1100);
+    };
+    recordDurations();
+    std::thread(recordDurations).join();
+    // Invalid probes are ignored
+    EngineProfiler::record(EngineProfiler::kInvalidProbe, 0, 100);
+
+    const auto stats = EngineProfiler::stats();
+    const auto* pStats = findStats(stats, name);
+    ASSERT_NE(nullptr, pStats);
+    EXPECT_EQ(6u, pStats->count);
+    EXPECT_EQ(2u, pStats->histogram[0]);
+    EXPECT_EQ(2u, pStats->histogram[1]);
+    // 100 cycles have a bit width of 7
+    EXPECT_EQ(2u, pStats->histogram[7]);
+    EXPECT_GT(pStats->maxMicros, 0);
+    EXPECT_GE(pStats->p99Micros, pStats->maxMicros);
+
+    EngineProfiler::reset();
+    const auto resetStats = EngineProfiler::stats();
+    const auto* pResetStats = findStats(resetStats, name);
+    ASSERT_NE(nullptr, pResetStats);
+    EXPECT_EQ(0u, pResetStats->count);
+}
+
+TEST(EngineProfilerTest, reuseSlotsOfFinishedThreads) {
+    const QString name = QStringLiteral("Test finished threads");
+    const int probe = EngineProfiler::registerProbe(name);
+    // More threads than slots one after another, e.g. when the sound
+    // devices are reopened repeatedly
+    constexpr int kNumThreads = 2 * EngineProfiler::kMaxThreads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        std::thread([probe] {
+            EngineProfiler::record(probe, 1000, 1001);
+        }).join();
+    }
+
+    const auto stats = EngineProfiler::stats();
+    const auto* pStats = findStats(stats, name);
+    ASSERT_NE(nullptr, pStats);
+    // None of the threads has been dropped
+    EXPECT_EQ(static_cast<quint64>(kNumThreads), pStats->count);
+}
+
+TEST(EngineProfilerTest, writeChromeTrace) {
+    const QString name = QStringLiteral("Test trace");
+    const int probe = EngineProfiler::registerProbe(name);
+    for (int i = 0; i < 2 * EngineProfiler::kTraceEventsPerThread; ++i) {
+        ScopedEngineProbe scopedProbe(probe);
+    }
+
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("trace.json"));
+    ASSERT_TRUE(EngineProfiler::writeChromeTrace(fileName));
+
+    QFile file(fileName);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+    const auto trace = QJsonDocument::fromJson(file.readAll()).object();
+    const auto traceEvents = trace.value(QStringLiteral("traceEvents")).toArray();
+    int numEvents = 0;
+    for (const auto& traceEvent : traceEvents) {
+        const auto event = traceEvent.toObject();
+        if (event.value(QStringLiteral("name")).toString() != name) {
+            continue;
+        }
+        EXPECT_EQ(QStringLiteral("X"), event.value(QStringLiteral("ph")).toString());
+        EXPECT_GE(event.value(QStringLiteral("dur")).toDouble(), 0);
+        ++numEvents;
+    }
+    // Only the most recent events are kept
+    EXPECT_GT(numEvents, 0);
+    EXPECT_LE(numEvents, EngineProfiler::kTraceEventsPerThread);
+}
+
+} // namespace
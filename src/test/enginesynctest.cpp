@@ -1779,6 +1779,55 @@ TEST_F(EngineSyncTest, ActivatingSyncDoesNotCauseDrifting) {
                     ->get());
 }
 
+TEST_F(EngineSyncTest, ParallelProcessingTwoFollowers) {
+    m_pEngineMixer->enableParallelChannelProcessing(2);
+
+    // No deck is processed before the others
+    ControlObject::set(ConfigKey(m_sInternalClockGroup, "sync_leader"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup1, "sync_mode"),
+            static_cast<double>(SyncMode::Follower));
+    ControlObject::set(ConfigKey(m_sGroup2, "sync_mode"),
+            static_cast<double>(SyncMode::Follower));
+    ProcessBuffer();
+    EXPECT_TRUE(isExplicitLeader(m_sInternalClockGroup));
+
+    mixxx::BeatsPointer pBeats1 = mixxx::Beats::fromConstTempo(
+            m_pTrack1->getSampleRate(), mixxx::audio::kStartFramePos, mixxx::Bpm(130));
+    m_pTrack1->trySetBeats(pBeats1);
+    mixxx::BeatsPointer pBeats2 = mixxx::Beats::fromConstTempo(
+            m_pTrack2->getSampleRate(), mixxx::audio::kStartFramePos, mixxx::Bpm(120));
+    m_pTrack2->trySetBeats(pBeats2);
+    mixxx::BeatsPointer pBeats3 = mixxx::Beats::fromConstTempo(
+            m_pTrack3->getSampleRate(), mixxx::audio::kStartFramePos, mixxx::Bpm(125));
+    m_pTrack3->trySetBeats(pBeats3);
+
+    // Deck 3 is not synced and processed on a helper thread
+    ControlObject::set(ConfigKey(m_sGroup1, "play"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup2, "play"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup3, "play"), 1.0);
+    for (int i = 0; i < 25; ++i) {
+        ProcessBuffer();
+    }
+
+    EXPECT_TRUE(isFollower(m_sGroup1));
+    EXPECT_TRUE(isFollower(m_sGroup2));
+    const double leaderBpm = ControlObject::get(ConfigKey(m_sInternalClockGroup, "bpm"));
+    EXPECT_DOUBLE_EQ(leaderBpm, ControlObject::get(ConfigKey(m_sGroup1, "bpm")));
+    EXPECT_DOUBLE_EQ(leaderBpm, ControlObject::get(ConfigKey(m_sGroup2, "bpm")));
+    EXPECT_DOUBLE_EQ(125.0, ControlObject::get(ConfigKey(m_sGroup3, "bpm")));
+    EXPECT_NEAR(ControlObject::get(ConfigKey(m_sGroup1, "beat_distance")),
+            ControlObject::get(ConfigKey(m_sGroup2, "beat_distance")),
+            kMaxBeatDistanceEpsilon);
+
+    // The request of a playing deck is queued and must not get lost
+    ControlObject::set(ConfigKey(m_sGroup3, "sync_enabled"), 1.0);
+    ProcessBuffer();
+    ProcessBuffer();
+
+    EXPECT_TRUE(isFollower(m_sGroup3));
+    EXPECT_DOUBLE_EQ(leaderBpm, ControlObject::get(ConfigKey(m_sGroup3, "bpm")));
+}
+
 TEST_F(EngineSyncTest, HalfDoubleBpmTest) {
     mixxx::BeatsPointer pBeats1 = mixxx::Beats::fromConstTempo(
             m_pTrack1->getSampleRate(), mixxx::audio::kStartFramePos, mixxx::Bpm(70));
@@ -0,0 +1,74 @@
+#include "engine/enginethreadpool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+namespace {
+
+struct CountingContext {
+    std::vector<std::atomic<int>> calls;
+};
+
+void countCall(void* pContext, int jobIndex) {
+    auto* pCountingContext = static_cast<CountingContext*>(pContext);
+    pCountingContext->calls[jobIndex].fetch_add(1);
+}
+
+class EngineThreadPoolTest : public testing::Test {
+  protected:
+    void runAndExpectEachJobOnce(EngineThreadPool* pPool, int jobCount) {
+        CountingContext context{std::vector<std::atomic<int>>(jobCount)};
+        pPool->run(countCall, &context, jobCount);
+        for (int i = 0; i < jobCount; ++i) {
+            EXPECT_EQ(1, context.calls[i].load()) << "job " << i;
+        }
+    }
+};
+
+TEST_F(EngineThreadPoolTest, NoHelpers) {
+    EngineThreadPool pool(QStringLiteral("Test"), 0);
+    runAndExpectEachJobOnce(&pool, 5);
+}
+
+TEST_F(EngineThreadPoolTest, MoreJobsThanThreads) {
+    EngineThreadPool pool(QStringLiteral("Test"), 3);
+    for (int i = 0; i < 100; ++i) {
+        runAndExpectEachJobOnce(&pool, 17);
+    }
+}
+
+TEST_F(EngineThreadPoolTest, FewerJobsThanThreads) {
+    EngineThreadPool pool(QStringLiteral("Test"), 4);
+    runAndExpectEachJobOnce(&pool, 0);
+    runAndExpectEachJobOnce(&pool, 1);
+    runAndExpectEachJobOnce(&pool, 2);
+}
+
+TEST_F(EngineThreadPoolTest, TryRunWhileBusy) {
+    EngineThreadPool pool(QStringLiteral("Test"), 2);
+    struct NestedContext {
+        EngineThreadPool* pPool;
+        std::atomic<int> nestedRuns;
+        std::atomic<int> calls;
+    } context{&pool, 0, 0};
+    ASSERT_TRUE(pool.tryRun(
+            [](void* pContext, int) {
+                auto* pNestedContext = static_cast<NestedContext*>(pContext);
+                pNestedContext->calls.fetch_add(1);
+                // The pool is busy with the outer batch
+                if (pNestedContext->pPool->tryRun(countCall, nullptr, 1)) {
+                    pNestedContext->nestedRuns.fetch_add(1);
+                }
+            },
+            &context,
+            3));
+    EXPECT_EQ(3, context.calls.load());
+    EXPECT_EQ(0, context.nestedRuns.load());
+    // Available again
+    CountingContext countingContext{std::vector<std::atomic<int>>(3)};
+    EXPECT_TRUE(pool.tryRun(countCall, &countingContext, 3));
+}
+
+} // namespace
@@ -1,9 +1,46 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+#include <memory>
+#include <utility>
+
 #include "test/librarytest.h"
 
+#include "library/coverartutils.h"
+#include "library/dao/libraryhashdao.h"
+#include "library/dao/settingsdao.h"
+#include "library/library_prefs.h"
 #include "library/scanner/libraryscanner.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr qint64 kMaxScanDurationMillis = 30000;
+
+const QString kJournaledUntilKey = QStringLiteral("mixxx.libraryscanner.journaleduntil");
+
+// Maps the locations of all tracks to their id and whether they are missing
+QMap<QString, std::pair<int, bool>> queryTrackStates(const QSqlDatabase& database) {
+    QMap<QString, std::pair<int, bool>> trackStates;
+    QSqlQuery query(database);
+    EXPECT_TRUE(query.exec(
+            "SELECT library.id,track_locations.location,track_locations.fs_deleted "
+            "FROM library INNER JOIN track_locations "
+            "ON library.location=track_locations.id"));
+    while (query.next()) {
+        trackStates.insert(query.value(1).toString(),
+                std::make_pair(query.value(0).toInt(), query.value(2).toBool()));
+    }
+    return trackStates;
+}
+
+} // anonymous namespace
 
 class LibraryScannerTest : public LibraryTest {
   protected:
@@ -52,3 +89,252 @@ TEST_F(LibraryScannerTest, ScannerRoundtrip) {
     m_libraryScanner.changeScannerState(LibraryScanner::IDLE);
     EXPECT_EQ(m_libraryScanner.m_state, LibraryScanner::IDLE);
 }
+
+TEST_F(LibraryScannerTest, UpdateTrackFromImportedMetadata) {
+    const auto fileAccess = mixxx::FileAccess(mixxx::FileInfo(getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3"))));
+    const SyncTrackMetadataParams syncParams;
+
+    // As imported by the worker threads of the scanner
+    CoverInfoGuesser coverInfoGuesser;
+    const auto importedMetadata = SoundSourceProxy::importMetadataFromFile(
+            fileAccess, syncParams, &coverInfoGuesser);
+    EXPECT_EQ(mixxx::MetadataSource::ImportResult::Succeeded,
+            importedMetadata.importResult);
+    EXPECT_TRUE(importedMetadata.sourceSynchronizedAt.isValid());
+    EXPECT_EQ(CoverInfo::GUESSED, importedMetadata.guessedCoverInfo.source);
+
+    auto pImportedTrack = Track::newTemporary(fileAccess);
+    EXPECT_EQ(SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pImportedTrack)
+                    .updateTrackFromSource(
+                            SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                            syncParams,
+                            &importedMetadata));
+
+    // The same result as parsing the file again
+    auto pParsedTrack = Track::newTemporary(fileAccess);
+    EXPECT_EQ(SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pParsedTrack)
+                    .updateTrackFromSource(
+                            SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                            syncParams));
+    EXPECT_EQ(pParsedTrack->getMetadata(), pImportedTrack->getMetadata());
+    EXPECT_EQ(pParsedTrack->getCoverInfo(), pImportedTrack->getCoverInfo());
+    EXPECT_EQ(pParsedTrack->getType(), pImportedTrack->getType());
+}
+
+TEST_F(LibraryScannerTest, JournalChangedDirectories) {
+    LibraryHashDAO libraryHashDao;
+    libraryHashDao.initialize(dbConnection());
+    EXPECT_TRUE(libraryHashDao.getChangedDirectories().isEmpty());
+
+    libraryHashDao.addChangedDirectory(QStringLiteral("/music/a"));
+    libraryHashDao.addChangedDirectory(QStringLiteral("/music/b"));
+    libraryHashDao.addChangedDirectory(QStringLiteral("/music/a"));
+    EXPECT_THAT(libraryHashDao.getChangedDirectories(),
+            ::testing::UnorderedElementsAre(
+                    QStringLiteral("/music/a"), QStringLiteral("/music/b")));
+
+    libraryHashDao.removeChangedDirectories();
+    EXPECT_TRUE(libraryHashDao.getChangedDirectories().isEmpty());
+}
+
+TEST_F(LibraryScannerTest, InvalidateDirectoryTrees) {
+    LibraryHashDAO libraryHashDao;
+    libraryHashDao.initialize(dbConnection());
+    libraryHashDao.saveDirectoryHash(QStringLiteral("/music/a"), 1);
+    libraryHashDao.saveDirectoryHash(QStringLiteral("/music/a/x"), 2);
+    libraryHashDao.saveDirectoryHash(QStringLiteral("/music/a_b"), 3);
+    libraryHashDao.saveDirectoryHash(QStringLiteral("/music/ab"), 4);
+
+    libraryHashDao.invalidateDirectoryTrees({QStringLiteral("/music/a")});
+    libraryHashDao.markUnverifiedDirectoriesAsDeleted();
+
+    EXPECT_THAT(libraryHashDao.getDeletedDirectories(),
+            ::testing::UnorderedElementsAre(
+                    QStringLiteral("/music/a"), QStringLiteral("/music/a/x")));
+}
+
+TEST_F(LibraryScannerTest, ScanOnlyChangedDirectories) {
+    QTemporaryDir libraryDir;
+    ASSERT_TRUE(libraryDir.isValid());
+    // Tracks are stored with their canonical location
+    const QDir dir(QDir(libraryDir.path()).canonicalPath());
+    ASSERT_TRUE(dir.mkpath(QStringLiteral("unchanged")));
+    ASSERT_TRUE(dir.mkpath(QStringLiteral("changed")));
+    ASSERT_TRUE(dir.mkpath(QStringLiteral("old/moved")));
+    ASSERT_TRUE(dir.mkpath(QStringLiteral("new")));
+    const QString sourceFilePath = getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3"));
+    for (const auto& filePath : {
+                 QStringLiteral("unchanged/unchanged.mp3"),
+                 QStringLiteral("changed/kept.mp3"),
+                 QStringLiteral("changed/removed.mp3"),
+                 QStringLiteral("old/moved/moved.mp3"),
+                 QStringLiteral("new/existing.mp3")}) {
+        ASSERT_TRUE(QFile::copy(sourceFilePath, dir.filePath(filePath)));
+    }
+    ASSERT_EQ(DirectoryDAO::AddResult::Ok,
+            internalCollection()->addDirectory(mixxx::FileInfo(dir.path())));
+
+    // The changes are journaled by the test instead of the LibraryWatcher
+    config()->setValue(mixxx::library::prefs::kWatchLibraryDirectoriesConfigKey, false);
+    int numScansFinished = 0;
+    // Disconnects before numScansFinished is destroyed
+    const QObject receiver;
+    QObject::connect(&m_libraryScanner,
+            &LibraryScanner::scanFinished,
+            &receiver,
+            [&numScansFinished] {
+                ++numScansFinished;
+            });
+    const auto waitForScansFinished = [&numScansFinished](int numScans) {
+        QElapsedTimer timer;
+        timer.start();
+        while (numScansFinished < numScans &&
+                timer.elapsed() < kMaxScanDurationMillis) {
+            QCoreApplication::processEvents();
+            QThread::msleep(10);
+        }
+        return numScansFinished >= numScans;
+    };
+    m_libraryScanner.start();
+
+    m_libraryScanner.scan();
+    ASSERT_TRUE(waitForScansFinished(1));
+    const auto trackStatesBefore = queryTrackStates(dbConnection());
+    ASSERT_EQ(5, trackStatesBefore.size());
+    for (const auto& trackState : trackStatesBefore) {
+        EXPECT_FALSE(trackState.second);
+    }
+
+    ASSERT_TRUE(QFile::copy(sourceFilePath, dir.filePath(QStringLiteral("changed/added.mp3"))));
+    ASSERT_TRUE(QFile::remove(dir.filePath(QStringLiteral("changed/removed.mp3"))));
+    ASSERT_TRUE(dir.rename(QStringLiteral("old/moved"), QStringLiteral("new/moved")));
+    // Not journaled and therefore not scanned
+    ASSERT_TRUE(QFile::copy(sourceFilePath,
+            dir.filePath(QStringLiteral("unchanged/unjournaled.mp3"))));
+
+    // As reported by the LibraryWatcher for these changes
+    const QStringList changedDirPaths = {
+            dir.filePath(QStringLiteral("changed")),
+            dir.filePath(QStringLiteral("old/moved")),
+            dir.filePath(QStringLiteral("old")),
+            dir.filePath(QStringLiteral("new"))};
+    QMetaObject::invokeMethod(
+            &m_libraryScanner,
+            [this, changedDirPaths] {
+                for (const auto& dirPath : changedDirPaths) {
+                    m_libraryScanner.slotDirectoryChanged(dirPath);
+                }
+                m_libraryScanner.slotScanChanges();
+            },
+            Qt::QueuedConnection);
+    ASSERT_TRUE(waitForScansFinished(2));
+    auto trackStatesAfter = queryTrackStates(dbConnection());
+
+    const QString addedLocation = dir.filePath(QStringLiteral("changed/added.mp3"));
+    ASSERT_TRUE(trackStatesAfter.contains(addedLocation));
+    EXPECT_FALSE(trackStatesAfter.value(addedLocation).second);
+    EXPECT_FALSE(trackStatesBefore.contains(addedLocation));
+    trackStatesAfter.remove(addedLocation);
+
+    auto expectedTrackStates = trackStatesBefore;
+    expectedTrackStates[dir.filePath(QStringLiteral("changed/removed.mp3"))].second = true;
+    // The moved track keeps its id
+    expectedTrackStates.insert(dir.filePath(QStringLiteral("new/moved/moved.mp3")),
+            expectedTrackStates.take(dir.filePath(QStringLiteral("old/moved/moved.mp3"))));
+    EXPECT_EQ(expectedTrackStates, trackStatesAfter);
+}
+
+TEST_F(LibraryScannerTest, ScanChangesOnStartup) {
+    QTemporaryDir libraryDir;
+    ASSERT_TRUE(libraryDir.isValid());
+    // Tracks are stored with their canonical location
+    const QDir dir(QDir(libraryDir.path()).canonicalPath());
+    ASSERT_TRUE(dir.mkpath(QStringLiteral("unchanged")));
+    ASSERT_TRUE(dir.mkpath(QStringLiteral("changed")));
+    const QString sourceFilePath = getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3"));
+    for (const auto& filePath : {
+                 QStringLiteral("unchanged/unchanged.mp3"),
+                 QStringLiteral("changed/kept.mp3"),
+                 QStringLiteral("changed/removed.mp3")}) {
+        ASSERT_TRUE(QFile::copy(sourceFilePath, dir.filePath(filePath)));
+    }
+    ASSERT_EQ(DirectoryDAO::AddResult::Ok,
+            internalCollection()->addDirectory(mixxx::FileInfo(dir.path())));
+
+    int numScansFinished = 0;
+    int numScanSummaries = 0;
+    // Disconnects before the counters are destroyed
+    const QObject receiver;
+    const auto startScanner = [this, &receiver, &numScansFinished, &numScanSummaries] {
+        auto pScanner = std::make_unique<LibraryScanner>(dbConnectionPooler(), config());
+        QObject::connect(pScanner.get(),
+                &LibraryScanner::scanFinished,
+                &receiver,
+                [&numScansFinished] {
+                    ++numScansFinished;
+                });
+        // Only emitted by full scans
+        QObject::connect(pScanner.get(),
+                &LibraryScanner::scanSummary,
+                &receiver,
+                [&numScanSummaries] {
+                    ++numScanSummaries;
+                });
+        pScanner->start();
+        return pScanner;
+    };
+    const auto waitForScansFinished = [&numScansFinished](int numScans) {
+        QElapsedTimer timer;
+        timer.start();
+        while (numScansFinished < numScans &&
+                timer.elapsed() < kMaxScanDurationMillis) {
+            QCoreApplication::processEvents();
+            QThread::msleep(10);
+        }
+        return numScansFinished >= numScans;
+    };
+
+    // The journal of the first run is incomplete
+    auto pScanner = startScanner();
+    pScanner->scanOnStartup();
+    ASSERT_TRUE(waitForScansFinished(1));
+    EXPECT_EQ(1, numScanSummaries);
+    const auto trackStatesBefore = queryTrackStates(dbConnection());
+    ASSERT_EQ(3, trackStatesBefore.size());
+    pScanner.reset();
+
+    const SettingsDAO settings(dbConnection());
+    if (settings.getValue(kJournaledUntilKey).isEmpty()) {
+        GTEST_SKIP() << "Library directories can't be watched on this system";
+    }
+
+    // Modified while Mixxx is not running
+    ASSERT_TRUE(QFile::copy(sourceFilePath, dir.filePath(QStringLiteral("changed/added.mp3"))));
+    ASSERT_TRUE(QFile::remove(dir.filePath(QStringLiteral("changed/removed.mp3"))));
+
+    pScanner = startScanner();
+    pScanner->scanOnStartup();
+    ASSERT_TRUE(waitForScansFinished(2));
+    // Only the changed directories have been scanned
+    EXPECT_EQ(1, numScanSummaries);
+    auto trackStatesAfter = queryTrackStates(dbConnection());
+    const QString addedLocation = dir.filePath(QStringLiteral("changed/added.mp3"));
+    ASSERT_TRUE(trackStatesAfter.contains(addedLocation));
+    EXPECT_FALSE(trackStatesAfter.take(addedLocation).second);
+    auto expectedTrackStates = trackStatesBefore;
+    expectedTrackStates[dir.filePath(QStringLiteral("changed/removed.mp3"))].second = true;
+    EXPECT_EQ(expectedTrackStates, trackStatesAfter);
+    pScanner.reset();
+
+    // The changes are unknown after a crash
+    settings.setValue(kJournaledUntilKey, QString());
+    pScanner = startScanner();
+    pScanner->scanOnStartup();
+    ASSERT_TRUE(waitForScansFinished(3));
+    EXPECT_EQ(2, numScanSummaries);
+}
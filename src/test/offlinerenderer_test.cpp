@@ -0,0 +1,150 @@
+#include "soundio/offlinerenderer.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QBuffer>
+#include <QFileInfo>
+
+#include "recording/defs_recording.h"
+#include "test/signalpathtest.h"
+#include "util/assert.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr SINT kFramesPerBuffer = 512;
+
+bool parseScript(const QByteArray& text,
+        OfflineRenderer::Script* pScript,
+        QString* pErrorMessage = nullptr) {
+    QByteArray data = text;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::ReadOnly);
+    return OfflineRenderer::parseScript(&buffer, kSampleRate, pScript, pErrorMessage);
+}
+
+class OfflineRendererTest : public SignalPathTest {
+  protected:
+    QString outputFile() const {
+        return getTestDataDir().filePath(QStringLiteral("render.wav"));
+    }
+};
+
+TEST_F(OfflineRendererTest, parseScript) {
+    OfflineRenderer::Script script;
+    ASSERT_TRUE(parseScript(
+            "# Start the second deck after the first one\n"
+            "\n"
+            "1.5 [Channel2] play 1\n"
+            "  0   [Channel1]\tplay  1\n",
+            &script));
+    ASSERT_EQ(2, script.size());
+    EXPECT_EQ(0, script[0].frame);
+    EXPECT_EQ(ConfigKey(m_sGroup1, QStringLiteral("play")), script[0].key);
+    EXPECT_EQ(1.0, script[0].value);
+    EXPECT_EQ(66150, script[1].frame);
+    EXPECT_EQ(ConfigKey(m_sGroup2, QStringLiteral("play")), script[1].key);
+
+    QString errorMessage;
+    EXPECT_FALSE(parseScript("1 [Channel1] play\n", &script, &errorMessage));
+    EXPECT_TRUE(errorMessage.contains(QStringLiteral("line 1")));
+    EXPECT_FALSE(parseScript("-1 [Channel1] play 1\n", &script));
+    EXPECT_FALSE(parseScript("1 [Channel1] play on\n", &script));
+}
+
+TEST_F(OfflineRendererTest, renderWave) {
+    OfflineRenderer::Script script;
+    ASSERT_TRUE(parseScript(
+            "0 [Channel1] play 1\n"
+            "0.5 [Channel1] play 0\n",
+            &script));
+
+    // Not a multiple of the buffer size
+    const SINT frames = kSampleRate + 100;
+    OfflineRenderer renderer(config(), m_pEngineMixer, kSampleRate, kFramesPerBuffer);
+    OfflineRenderer::Result result;
+    ASSERT_TRUE(renderer.render(script, frames, outputFile(), ENCODING_WAVE, &result))
+            << renderer.errorMessage().toStdString();
+    EXPECT_EQ(frames, result.frames);
+    EXPECT_EQ((frames + kFramesPerBuffer - 1) / kFramesPerBuffer, result.callbacks);
+    EXPECT_GT(result.realtimeFactor(kSampleRate), 0);
+
+    // All changes have been applied
+    EXPECT_EQ(0.0, ControlObject::get(ConfigKey(m_sGroup1, QStringLiteral("play"))));
+    const double playPosition = ControlObject::get(
+            ConfigKey(m_sGroup1, QStringLiteral("playposition")));
+    EXPECT_GT(playPosition, 0.0);
+
+    // At least 16 bit stereo samples for every frame
+    EXPECT_GE(QFileInfo(outputFile()).size(), frames * 4);
+}
+
+TEST_F(OfflineRendererTest, rejectUnknownControl) {
+    OfflineRenderer::Script script;
+    ASSERT_TRUE(parseScript("0 [Channel1] no_such_control 1\n", &script));
+
+    OfflineRenderer renderer(config(), m_pEngineMixer, kSampleRate, kFramesPerBuffer);
+    EXPECT_FALSE(renderer.render(script, kSampleRate, outputFile(), ENCODING_WAVE));
+    EXPECT_FALSE(renderer.errorMessage().isEmpty());
+    // Nothing has been rendered
+    EXPECT_FALSE(QFileInfo::exists(outputFile()));
+}
+
+// Drives the fixture of the signal path tests outside of gtest
+class OfflineRendererBenchmark : public SignalPathTest {
+  public:
+    OfflineRendererBenchmark() {
+        SetUp();
+    }
+    ~OfflineRendererBenchmark() override {
+        TearDown();
+    }
+
+    void TestBody() override {
+    }
+
+    void run(benchmark::State& state) {
+        OfflineRenderer::Script script;
+        VERIFY_OR_DEBUG_ASSERT(parseScript(
+                "0 [Channel1] play 1\n"
+                "0 [Channel2] play 1\n"
+                "0 [Channel3] play 1\n",
+                &script)) {
+            return;
+        }
+        // 10 s per iteration
+        const SINT frames = kSampleRate * 10;
+        const QString fileName = getTestDataDir().filePath(QStringLiteral("benchmark.wav"));
+        OfflineRenderer renderer(config(), m_pEngineMixer, kSampleRate, state.range(0));
+        double renderedSeconds = 0;
+        double elapsedSeconds = 0;
+        for (auto _ : state) {
+            OfflineRenderer::Result result;
+            if (!renderer.render(script, frames, fileName, ENCODING_WAVE, &result)) {
+                state.SkipWithError(renderer.errorMessage().toLocal8Bit().constData());
+                return;
+            }
+            renderedSeconds += result.frames / kSampleRate.toDouble();
+            elapsedSeconds += result.elapsed.toDoubleSeconds();
+        }
+        state.SetItemsProcessed(state.iterations() * frames);
+        state.counters["realtime_factor"] =
+                elapsedSeconds > 0 ? renderedSeconds / elapsedSeconds : 0;
+    }
+};
+
+// Reports how many seconds of audio the engine renders per second with
+// three playing decks, e.g. to compare the throughput of engine changes:
+// mixxx-test --benchmark --benchmark_filter=BM_OfflineRenderer
+static void BM_OfflineRenderer(benchmark::State& state) {
+    OfflineRendererBenchmark fixture;
+    fixture.run(state);
+}
+BENCHMARK(BM_OfflineRenderer)
+        ->Arg(64)
+        ->Arg(512)
+        ->Arg(2048)
+        ->Unit(benchmark::kMillisecond);
+
+} // namespace
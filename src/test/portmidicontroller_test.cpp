@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <QCoreApplication>
+#include <QElapsedTimer>
 #include <QScopedPointer>
 
 #include "controllers/midi/portmidicontroller.h"
@@ -9,6 +11,7 @@
 
 using ::testing::_;
 using ::testing::DoAll;
+using ::testing::InvokeWithoutArgs;
 using ::testing::NotNull;
 using ::testing::Return;
 using ::testing::Sequence;
@@ -43,6 +46,12 @@ class MockPortMidiController : public PortMidiController {
     // These tests are unrelated to scripting.
     MOCK_METHOD0(startEngine, void());
     MOCK_METHOD0(stopEngine, void());
+
+    bool readsInputOnThread() const override {
+        return m_readsInputOnThread;
+    }
+
+    bool m_readsInputOnThread = false;
 };
 
 class MockPortMidiDevice : public PortMidiDevice {
@@ -101,6 +110,14 @@ class PortMidiControllerTest : public MixxxTest {
         m_pController->poll();
     }
 
+    bool isPolling() const {
+        return m_pController->isPolling();
+    }
+
+    const std::shared_ptr<PortMidiInputThread>& inputThread() const {
+        return m_pController->m_pInputThread;
+    }
+
     PmDeviceInfo m_inputDeviceInfo;
     PmDeviceInfo m_outputDeviceInfo;
     MockPortMidiDevice* m_mockInput;
@@ -157,6 +174,56 @@ TEST_F(PortMidiControllerTest, OpenClose) {
     EXPECT_FALSE(m_pController->isOpen());
 };
 
+TEST_F(PortMidiControllerTest, ReadInputOnThread) {
+    m_pController->m_readsInputOnThread = true;
+    std::vector<PmEvent> messages;
+    messages.push_back(MakeEvent(0x403C90, 0x10));
+    messages.push_back(MakeEvent(0x403C80, 0x20));
+
+    EXPECT_CALL(*m_mockInput, openInput(MIXXX_PORTMIDI_BUFFER_LEN))
+            .WillOnce(Return(pmNoError));
+    EXPECT_CALL(*m_mockInput, isOpen())
+            .WillRepeatedly(Return(true));
+    EXPECT_CALL(*m_mockInput, read(NotNull(), _))
+            .WillOnce(DoAll(SetArrayArgument<0>(messages.begin(), messages.end()),
+                    Return(static_cast<int>(messages.size()))))
+            .WillRepeatedly(Return(0));
+    EXPECT_CALL(*m_mockInput, close())
+            .WillOnce(Return(pmNoError));
+    EXPECT_CALL(*m_mockOutput, openOutput())
+            .WillOnce(Return(pmNoError));
+    EXPECT_CALL(*m_mockOutput, isOpen())
+            .WillRepeatedly(Return(true));
+    EXPECT_CALL(*m_mockOutput, close())
+            .WillOnce(Return(pmNoError));
+
+    Sequence received;
+    int receivedCount = 0;
+    // The timestamps of the device are passed on
+    EXPECT_CALL(*m_pController,
+            receivedShortMessage(0x90, 0x3C, 0x40, mixxx::Duration::fromMillis(0x10)))
+            .InSequence(received)
+            .WillOnce(InvokeWithoutArgs([&receivedCount] { ++receivedCount; }));
+    EXPECT_CALL(*m_pController,
+            receivedShortMessage(0x80, 0x3C, 0x40, mixxx::Duration::fromMillis(0x20)))
+            .InSequence(received)
+            .WillOnce(InvokeWithoutArgs([&receivedCount] { ++receivedCount; }));
+
+    openDevice();
+    // Not polled by the ControllerManager
+    EXPECT_FALSE(isPolling());
+    // All inputs are read on the same thread
+    EXPECT_EQ(PortMidiInputThread::instance(), inputThread());
+    QElapsedTimer timer;
+    timer.start();
+    while (receivedCount < 2 && timer.elapsed() < 5000) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    EXPECT_EQ(2, receivedCount);
+    closeDevice();
+    EXPECT_TRUE(isPolling());
+}
+
 TEST_F(PortMidiControllerTest, WriteShort) {
     // Note that Pm_WriteShort takes an int32_t formatted as 0x00B2B1SS where SS
     // is the status byte, B1 is the first message byte and B2 is the second
@@ -3,16 +3,22 @@
 #include <gtest/gtest.h>
 
 #include <QScopedPointer>
+#include <QThread>
 #include <QtDebug>
+#include <memory>
+#include <vector>
 
 #include "control/controlobject.h"
 #include "engine/cachingreader/cachingreader.h"
+#include "engine/cachingreader/cachingreaderworker.h"
 #include "engine/controls/cuecontrol.h"
 #include "engine/controls/loopingcontrol.h"
 #include "test/mixxxtest.h"
 #include "util/assert.h"
 #include "util/defs.h"
+#include "util/fifo.h"
 #include "util/sample.h"
+#include "util/samplebuffer.h"
 
 namespace {
 const QString kGroup = "[test]";
@@ -243,3 +249,76 @@ TEST_F(ReadAheadManagerTest, FractionalFrameLoop) {
     // The rounding error must not exceed a half frame (one samples in stereo)
     EXPECT_NEAR(16, m_pReadAheadManager->getPlaypos(), 1);
 }
+
+TEST_F(ReadAheadManagerTest, HintChunksInDirectionOfPlay) {
+    constexpr SINT kFrames = CachingReaderChunk::kFrames;
+    // Frame 50000 in stereo
+    m_pReadAheadManager->notifySeek(100000);
+
+    // Normal playback keeps 2 chunks ahead
+    HintVector hints;
+    m_pReadAheadManager->hintReader(1.0, &hints, mixxx::audio::ChannelCount::stereo());
+    ASSERT_EQ(1, hints.size());
+    EXPECT_EQ(Hint::Type::CurrentPosition, hints[0].type);
+    EXPECT_EQ(50000, hints[0].frame);
+    EXPECT_EQ(2 * kFrames, hints[0].frameCount);
+
+    // Proportionally more chunks, behind the position in reverse
+    hints.clear();
+    m_pReadAheadManager->hintReader(-3.0, &hints, mixxx::audio::ChannelCount::stereo());
+    ASSERT_EQ(1, hints.size());
+    EXPECT_EQ(6 * kFrames, hints[0].frameCount);
+    EXPECT_EQ(50000 - 6 * kFrames, hints[0].frame);
+
+    // Limited when scratching very fast
+    hints.clear();
+    m_pReadAheadManager->hintReader(10.0, &hints, mixxx::audio::ChannelCount::stereo());
+    ASSERT_EQ(1, hints.size());
+    EXPECT_EQ(8 * kFrames, hints[0].frameCount);
+    EXPECT_EQ(50000, hints[0].frame);
+}
+
+TEST_F(ReadAheadManagerTest, BatchedReadRequestsInOrderOfUrgency) {
+    // Requested by priority, i.e. the current position first
+    const SINT chunkIndices[] = {10, 3, 11, 4, 20};
+    constexpr int kNumChunks = sizeof(chunkIndices) / sizeof(chunkIndices[0]);
+    mixxx::SampleBuffer sampleBuffer(kNumChunks * CachingReaderChunk::kFrames * 2);
+    std::vector<std::unique_ptr<CachingReaderChunkForOwner>> chunks;
+    FIFO<CachingReaderChunkReadRequest> requestFifo(kNumChunks);
+    FIFO<ReaderStatusUpdate> statusFifo(kNumChunks);
+    for (int i = 0; i < kNumChunks; ++i) {
+        chunks.push_back(std::make_unique<CachingReaderChunkForOwner>(
+                mixxx::SampleBuffer::WritableSlice(sampleBuffer,
+                        i * CachingReaderChunk::kFrames * 2,
+                        CachingReaderChunk::kFrames * 2)));
+        chunks.back()->init(chunkIndices[i]);
+        CachingReaderChunkReadRequest request;
+        request.giveToWorker(chunks.back().get());
+        ASSERT_EQ(1, requestFifo.write(&request, 1));
+    }
+
+    // All pending requests are read as one batch. Without a track every
+    // chunk is invalid, but the order of the results is preserved.
+    CachingReaderWorker worker(kGroup,
+            &requestFifo,
+            &statusFifo,
+            mixxx::audio::ChannelCount::stereo());
+    worker.start();
+    for (int i = 0; i < 5000 && statusFifo.readAvailable() < kNumChunks; ++i) {
+        QThread::msleep(1);
+    }
+    worker.quitWait();
+
+    // Adjacent chunks are read in ascending order when their most urgent
+    // chunk is due
+    const SINT expectedChunkIndices[] = {10, 11, 3, 4, 20};
+    ASSERT_EQ(kNumChunks, statusFifo.readAvailable());
+    for (const SINT expectedChunkIndex : expectedChunkIndices) {
+        ReaderStatusUpdate update;
+        ASSERT_EQ(1, statusFifo.read(&update, 1));
+        EXPECT_EQ(CHUNK_READ_INVALID, update.status);
+        CachingReaderChunkForOwner* pChunk = update.takeFromWorker();
+        ASSERT_NE(nullptr, pChunk);
+        EXPECT_EQ(expectedChunkIndex, pChunk->getIndex());
+    }
+}
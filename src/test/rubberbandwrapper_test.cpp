@@ -0,0 +1,189 @@
+#ifdef __RUBBERBAND__
+
+#include "engine/bufferscalers/rubberbandwrapper.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "engine/bufferscalers/rubberbandworkerpool.h"
+
+using RubberBand::RubberBandStretcher;
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr int kStemChannelCount = 8;
+// The samples per channel of a typical audio callback
+constexpr size_t kBufferSize = 1024;
+constexpr double kPitchScale = 1.05;
+constexpr RubberBandStretcher::Options kOptions = RubberBandStretcher::OptionProcessRealTime;
+
+// The deinterleaved input of a stem deck with a different tone per channel
+class StemInput {
+  public:
+    StemInput()
+            : m_samples(kStemChannelCount, std::vector<float>(kBufferSize)) {
+        for (int ch = 0; ch < kStemChannelCount; ++ch) {
+            for (size_t i = 0; i < kBufferSize; ++i) {
+                m_samples[ch][i] = 0.5f *
+                        std::sin(static_cast<float>(i) * 0.01f * (ch + 1));
+            }
+            m_channels.push_back(m_samples[ch].data());
+        }
+    }
+
+    const float* const* channels() const {
+        return m_channels.data();
+    }
+
+  private:
+    std::vector<std::vector<float>> m_samples;
+    std::vector<const float*> m_channels;
+};
+
+class StemOutput {
+  public:
+    StemOutput()
+            : m_samples(kStemChannelCount, std::vector<float>(4 * kBufferSize)) {
+        for (auto& samples : m_samples) {
+            m_channels.push_back(samples.data());
+        }
+    }
+
+    float* const* channels() const {
+        return m_channels.data();
+    }
+
+    const std::vector<float>& channel(int ch) const {
+        return m_samples[ch];
+    }
+
+    SINT size() const {
+        return static_cast<SINT>(m_samples[0].size());
+    }
+
+  private:
+    std::vector<std::vector<float>> m_samples;
+    std::vector<float*> m_channels;
+};
+
+// The channels per stretcher that the wrapper uses for a stem deck
+int channelPerStretcher() {
+    const RubberBandWorkerPool* pPool = RubberBandWorkerPool::instance();
+    const int maxStretcherCount = pPool->numThreads() + 1;
+    if (kStemChannelCount / pPool->channelPerWorker() > maxStretcherCount) {
+        return kStemChannelCount / maxStretcherCount;
+    }
+    return pPool->channelPerWorker();
+}
+
+std::unique_ptr<RubberBandWrapper> createWrapper() {
+    auto pWrapper = std::make_unique<RubberBandWrapper>();
+    pWrapper->setup(kSampleRate, mixxx::audio::ChannelCount::stem(), kOptions);
+    pWrapper->setPitchScale(kPitchScale);
+    return pWrapper;
+}
+
+class RubberBandWrapperTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        RubberBandWorkerPool::createInstance();
+    }
+
+    void TearDown() override {
+        RubberBandWorkerPool::destroy();
+    }
+};
+
+TEST_F(RubberBandWrapperTest, poolMatchesSequentialProcessing) {
+    const auto pWrapper = createWrapper();
+    const int channelPerWorker = channelPerStretcher();
+    // The same stretchers as the wrapper, processed by this thread
+    std::vector<std::unique_ptr<RubberBandStretcher>> stretchers;
+    for (int ch = 0; ch < kStemChannelCount; ch += channelPerWorker) {
+        stretchers.push_back(std::make_unique<RubberBandStretcher>(
+                kSampleRate, channelPerWorker, kOptions));
+        stretchers.back()->setPitchScale(kPitchScale);
+    }
+
+    const StemInput input;
+    StemOutput wrapperOutput;
+    StemOutput expectedOutput;
+    for (int n = 0; n < 8; ++n) {
+        pWrapper->process(input.channels(), kBufferSize, false);
+        for (size_t i = 0; i < stretchers.size(); ++i) {
+            stretchers[i]->process(input.channels() + i * channelPerWorker, kBufferSize, false);
+        }
+    }
+    const size_t retrieved = pWrapper->retrieve(
+            wrapperOutput.channels(), wrapperOutput.size(), wrapperOutput.size());
+    ASSERT_GT(retrieved, 0u);
+    for (size_t i = 0; i < stretchers.size(); ++i) {
+        EXPECT_EQ(retrieved,
+                stretchers[i]->retrieve(
+                        expectedOutput.channels() + i * channelPerWorker, retrieved));
+    }
+    for (int ch = 0; ch < kStemChannelCount; ++ch) {
+        EXPECT_EQ(expectedOutput.channel(ch), wrapperOutput.channel(ch)) << "channel " << ch;
+    }
+}
+
+// The keylock part of an audio callback with state.range(0) stem decks,
+// which are processed one after the other like the engine thread does.
+void BM_RubberBandStemKeylock(benchmark::State& state) {
+    RubberBandWorkerPool::createInstance();
+    std::vector<std::unique_ptr<RubberBandWrapper>> decks;
+    for (int i = 0; i < state.range(0); ++i) {
+        decks.push_back(createWrapper());
+    }
+    const StemInput input;
+    StemOutput output;
+    for (auto _ : state) {
+        for (const auto& pDeck : decks) {
+            pDeck->process(input.channels(), kBufferSize, false);
+            pDeck->retrieve(output.channels(), kBufferSize, output.size());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    decks.clear();
+    RubberBandWorkerPool::destroy();
+}
+BENCHMARK(BM_RubberBandStemKeylock)->DenseRange(1, 8)->Unit(benchmark::kMicrosecond);
+
+// Like BM_RubberBandStemKeylock without the helpers of the pool.
+void BM_RubberBandStemKeylockSingleThread(benchmark::State& state) {
+    RubberBandWorkerPool::createInstance();
+    const int channelPerWorker = channelPerStretcher();
+    RubberBandWorkerPool::destroy();
+    std::vector<std::unique_ptr<RubberBandStretcher>> stretchers;
+    for (int i = 0; i < state.range(0) * kStemChannelCount / channelPerWorker; ++i) {
+        stretchers.push_back(std::make_unique<RubberBandStretcher>(
+                kSampleRate, channelPerWorker, kOptions));
+        stretchers.back()->setPitchScale(kPitchScale);
+    }
+    const StemInput input;
+    StemOutput output;
+    const size_t stretchersPerDeck = kStemChannelCount / channelPerWorker;
+    for (auto _ : state) {
+        for (size_t i = 0; i < stretchers.size(); ++i) {
+            const size_t offset = (i % stretchersPerDeck) * channelPerWorker;
+            stretchers[i]->process(input.channels() + offset, kBufferSize, false);
+            stretchers[i]->retrieve(output.channels() + offset,
+                    std::min(kBufferSize,
+                            static_cast<size_t>(std::max(stretchers[i]->available(), 0))));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RubberBandStemKeylockSingleThread)
+        ->DenseRange(1, 8)
+        ->Unit(benchmark::kMicrosecond);
+
+} // anonymous namespace
+
+#endif // __RUBBERBAND__
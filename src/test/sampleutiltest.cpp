@@ -57,6 +57,31 @@ class SampleUtilTest : public testing::Test {
     QList<int> evenBuffers;
 };
 
+const SampleUtil::InstructionSet kInstructionSets[] = {
+        SampleUtil::InstructionSet::Baseline,
+        SampleUtil::InstructionSet::AVX2,
+        SampleUtil::InstructionSet::AVX512,
+};
+
+// Restores the detected instruction set when leaving the scope.
+class ScopedInstructionSet {
+  public:
+    explicit ScopedInstructionSet(SampleUtil::InstructionSet instructionSet)
+            : m_previous(SampleUtil::instructionSet()),
+              m_active(SampleUtil::setInstructionSet(instructionSet)) {
+    }
+    ~ScopedInstructionSet() {
+        SampleUtil::setInstructionSet(m_previous);
+    }
+    bool isActive() const {
+        return m_active;
+    }
+
+  private:
+    const SampleUtil::InstructionSet m_previous;
+    const bool m_active;
+};
+
 TEST_F(SampleUtilTest, allocIs16ByteAligned) {
     foreach (CSAMPLE* buffer, buffers) {
         ASSERT_EQ(0U, reinterpret_cast<quintptr>(buffer) % 16);
@@ -350,6 +375,57 @@ TEST_F(SampleUtilTest, deinterleaveBuffer) {
     }
 }
 
+TEST_F(SampleUtilTest, instructionSetsProduceSameResults) {
+    constexpr int kSize = 1026;
+    std::vector<CSAMPLE> src1(kSize);
+    std::vector<CSAMPLE> src2(kSize);
+    std::vector<CSAMPLE> src3(kSize);
+    for (int i = 0; i < kSize; ++i) {
+        src1[i] = static_cast<CSAMPLE>(i % 17) / 8.0f - 1.0f;
+        src2[i] = static_cast<CSAMPLE>(i % 5) / 4.0f - 0.5f;
+        src3[i] = static_cast<CSAMPLE>(i % 3) * 0.7f;
+    }
+
+    std::vector<CSAMPLE> reference(kSize);
+    CSAMPLE referenceSumL = 0;
+    CSAMPLE referenceSumR = 0;
+    for (const auto instructionSet : kInstructionSets) {
+        ScopedInstructionSet scopedInstructionSet(instructionSet);
+        if (!scopedInstructionSet.isActive()) {
+            continue;
+        }
+        std::vector<CSAMPLE> dest(kSize, 0.25f);
+        SampleUtil::addWithRampingGain(dest.data(), src1.data(), 0.1f, 0.9f, kSize);
+        SampleUtil::copy3WithRampingGain(dest.data(),
+                src1.data(),
+                0.3f,
+                0.6f,
+                src2.data(),
+                1.0f,
+                0.2f,
+                src3.data(),
+                0.0f,
+                0.5f,
+                kSize);
+        SampleUtil::applyRampingGain(dest.data(), 1.2f, 0.8f, kSize);
+        CSAMPLE sumL = 0;
+        CSAMPLE sumR = 0;
+        SampleUtil::sumAbsPerChannel(&sumL, &sumR, dest.data(), kSize);
+
+        if (instructionSet == SampleUtil::InstructionSet::Baseline) {
+            reference = dest;
+            referenceSumL = sumL;
+            referenceSumR = sumR;
+            continue;
+        }
+        for (int i = 0; i < kSize; ++i) {
+            EXPECT_FLOAT_EQ(reference[i], dest[i]);
+        }
+        EXPECT_NEAR(referenceSumL, sumL, referenceSumL * 1e-5f);
+        EXPECT_NEAR(referenceSumR, sumR, referenceSumR * 1e-5f);
+    }
+}
+
 TEST_F(SampleUtilTest, reverse) {
     if (buffers.size() > 0 && sizes[0] > 10) {
         CSAMPLE* buffer = buffers[1];
@@ -466,6 +542,58 @@ TEST_F(SampleUtilTest, mixMultichannelToStereo) {
     EXPECT_FLOAT_EQ(destination[3], 0.9f + 1.1f + 1.3f /* + 1.5f*/);
 }
 
+TEST_F(SampleUtilTest, copyOneStereoFromMultiWithRampingGain) {
+    constexpr int kNumFrames = 4;
+    std::vector<CSAMPLE> source(kNumFrames * mixxx::audio::ChannelCount::stem());
+    for (std::size_t i = 0; i < source.size(); ++i) {
+        source[i] = i * 0.1f;
+    }
+    std::vector<CSAMPLE> destination(kNumFrames * mixxx::audio::ChannelCount::stereo());
+
+    // Constant gain of the third stem
+    SampleUtil::copyOneStereoFromMultiWithRampingGain(destination.data(),
+            source.data(),
+            0.5f,
+            0.5f,
+            kNumFrames,
+            mixxx::audio::ChannelCount::stem(),
+            4);
+    for (int i = 0; i < kNumFrames; ++i) {
+        EXPECT_FLOAT_EQ(destination[2 * i], source[8 * i + 4] * 0.5f);
+        EXPECT_FLOAT_EQ(destination[2 * i + 1], source[8 * i + 5] * 0.5f);
+    }
+
+    // Same ramp as copyWithRampingGain()
+    std::vector<CSAMPLE> stereo(destination.size());
+    SampleUtil::copyOneStereoFromMulti(
+            stereo.data(), source.data(), kNumFrames, mixxx::audio::ChannelCount::stem(), 2);
+    std::vector<CSAMPLE> expected(destination.size());
+    SampleUtil::copyWithRampingGain(
+            expected.data(), stereo.data(), 1.0f, 0.0f, static_cast<SINT>(stereo.size()));
+    SampleUtil::copyOneStereoFromMultiWithRampingGain(destination.data(),
+            source.data(),
+            1.0f,
+            0.0f,
+            kNumFrames,
+            mixxx::audio::ChannelCount::stem(),
+            2);
+    for (std::size_t i = 0; i < destination.size(); ++i) {
+        EXPECT_FLOAT_EQ(expected[i], destination[i]);
+    }
+
+    // Muted
+    SampleUtil::copyOneStereoFromMultiWithRampingGain(destination.data(),
+            source.data(),
+            0.0f,
+            0.0f,
+            kNumFrames,
+            mixxx::audio::ChannelCount::stem(),
+            6);
+    for (const auto sample : destination) {
+        EXPECT_FLOAT_EQ(0.0f, sample);
+    }
+}
+
 static void BM_MemCpy(benchmark::State& state) {
     SINT size = static_cast<SINT>(state.range(0));
     CSAMPLE* buffer = SampleUtil::alloc(size);
@@ -652,4 +780,106 @@ static void BM_Copy2WithRampingGain(benchmark::State& state) {
 }
 BENCHMARK(BM_Copy2WithRampingGain)->Range(64, 4096);
 
+// The following benchmarks compare the variants of the dispatched kernels.
+// The second argument selects the SampleUtil::InstructionSet.
+void applyInstructionSetArgs(benchmark::internal::Benchmark* pBenchmark) {
+    pBenchmark->ArgNames({"size", "isa"});
+    pBenchmark->ArgsProduct({benchmark::CreateRange(64, 4096, 4), {0, 1, 2}});
+}
+
+#define INSTRUCTION_SET_OR_SKIP(state)                              \
+    const auto instructionSet =                                     \
+            static_cast<SampleUtil::InstructionSet>(state.range(1)); \
+    ScopedInstructionSet scopedInstructionSet(instructionSet);      \
+    if (!scopedInstructionSet.isActive()) {                         \
+        state.SkipWithError("Instruction set not supported");       \
+        return;                                                     \
+    }
+
+static void BM_AddWithGain(benchmark::State& state) {
+    INSTRUCTION_SET_OR_SKIP(state);
+    const auto size = static_cast<SINT>(state.range(0));
+    std::vector<CSAMPLE> dest(size, 0.0f);
+    std::vector<CSAMPLE> src(size, 0.5f);
+    for (auto _ : state) {
+        SampleUtil::addWithGain(dest.data(), src.data(), 0.9f, size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_AddWithGain)->Apply(applyInstructionSetArgs);
+
+static void BM_ApplyRampingGain(benchmark::State& state) {
+    INSTRUCTION_SET_OR_SKIP(state);
+    const auto size = static_cast<SINT>(state.range(0));
+    std::vector<CSAMPLE> buffer(size, 0.5f);
+    for (auto _ : state) {
+        SampleUtil::applyRampingGain(buffer.data(), 1.0f, 1.0001f, size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_ApplyRampingGain)->Apply(applyInstructionSetArgs);
+
+static void BM_Copy3WithRampingGain(benchmark::State& state) {
+    INSTRUCTION_SET_OR_SKIP(state);
+    const auto size = static_cast<SINT>(state.range(0));
+    std::vector<CSAMPLE> dest(size, 0.0f);
+    std::vector<CSAMPLE> src1(size, 0.1f);
+    std::vector<CSAMPLE> src2(size, 0.2f);
+    std::vector<CSAMPLE> src3(size, 0.3f);
+    for (auto _ : state) {
+        SampleUtil::copy3WithRampingGain(dest.data(),
+                src1.data(),
+                1.1f,
+                1.2f,
+                src2.data(),
+                1.1f,
+                1.2f,
+                src3.data(),
+                1.1f,
+                1.2f,
+                static_cast<int>(size));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_Copy3WithRampingGain)->Apply(applyInstructionSetArgs);
+
+static void BM_InterleaveBuffer(benchmark::State& state) {
+    INSTRUCTION_SET_OR_SKIP(state);
+    const auto size = static_cast<SINT>(state.range(0));
+    std::vector<CSAMPLE> dest(size * 2, 0.0f);
+    std::vector<CSAMPLE> src1(size, 0.1f);
+    std::vector<CSAMPLE> src2(size, 0.2f);
+    for (auto _ : state) {
+        SampleUtil::interleaveBuffer(dest.data(), src1.data(), src2.data(), size);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_InterleaveBuffer)->Apply(applyInstructionSetArgs);
+
+static void BM_MixMultichannelToStereo(benchmark::State& state) {
+    INSTRUCTION_SET_OR_SKIP(state);
+    const auto numFrames = static_cast<SINT>(state.range(0)) / 2;
+    const auto numChannels = mixxx::audio::ChannelCount(8);
+    std::vector<CSAMPLE> dest(numFrames * 2, 0.0f);
+    std::vector<CSAMPLE> src(numFrames * numChannels, 0.1f);
+    for (auto _ : state) {
+        SampleUtil::mixMultichannelToStereo(dest.data(), src.data(), numFrames, numChannels);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_MixMultichannelToStereo)->Apply(applyInstructionSetArgs);
+
+static void BM_SumAbsPerChannel(benchmark::State& state) {
+    INSTRUCTION_SET_OR_SKIP(state);
+    const auto size = static_cast<SINT>(state.range(0));
+    std::vector<CSAMPLE> buffer(size, 0.5f);
+    for (auto _ : state) {
+        CSAMPLE sumL = 0;
+        CSAMPLE sumR = 0;
+        benchmark::DoNotOptimize(SampleUtil::sumAbsPerChannel(
+                &sumL, &sumR, buffer.data(), size));
+    }
+}
+BENCHMARK(BM_SumAbsPerChannel)->Apply(applyInstructionSetArgs);
+
 }  // namespace
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <QDir>
+#include <QSqlQuery>
 #include <QtDebug>
 
 #include "library/searchquery.h"
@@ -1391,3 +1392,133 @@ TEST_F(SearchQueryParserTest, QuotedOrOperator) {
     pTrackI->setComment("house");
     EXPECT_TRUE(pQuery->match(pTrackI));
 }
+
+TEST_F(SearchQueryParserTest, SearchIndex) {
+    const TrackSearchIndexDAO& searchIndex =
+            internalCollection()->getTrackSearchIndexDAO();
+    if (!searchIndex.isAvailable()) {
+        GTEST_SKIP() << "SQLite has been built without FTS5 trigram support";
+    }
+    m_parser.setSearchIndex(&searchIndex);
+    m_parser.setSearchColumns({"artist", "title"});
+
+    const TrackId trackAId = addTrackToCollection(getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3")));
+    const TrackId trackBId = addTrackToCollection(getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-png.mp3")));
+    ASSERT_TRUE(trackAId.isValid());
+    ASSERT_TRUE(trackBId.isValid());
+
+    const QSqlDatabase database = internalCollection()->database();
+    const auto setArtistAndTitle = [&database](TrackId trackId,
+                                           const QString& artist,
+                                           const QString& title) {
+        QSqlQuery query(database);
+        query.prepare("UPDATE library SET artist=:artist, title=:title WHERE id=:id");
+        query.bindValue(":artist", artist);
+        query.bindValue(":title", title);
+        query.bindValue(":id", trackId.toVariant());
+        ASSERT_TRUE(query.exec());
+    };
+    setArtistAndTitle(trackAId, QString::fromUtf8("S\xC3\xA9" "bastien Tellier"), "Roche");
+    setArtistAndTitle(trackBId, "Someone", "Tellurian \"Live\"");
+    searchIndex.updateTracks({trackAId, trackBId});
+
+    const auto queryTrackIds = [&database](const QueryNode& node) {
+        QSet<TrackId> trackIds;
+        QSqlQuery query(database);
+        EXPECT_TRUE(query.exec("SELECT id FROM library WHERE " + node.toSql()));
+        while (query.next()) {
+            trackIds.insert(TrackId(query.value(0)));
+        }
+        return trackIds;
+    };
+
+    // Decorations and case are ignored like with LIKE
+    auto pQuery = m_parser.parseQuery("SEBAS", QString());
+    EXPECT_TRUE(pQuery->toSql().contains("MATCH"));
+    EXPECT_EQ(QSet<TrackId>{trackAId}, queryTrackIds(*pQuery));
+
+    pQuery = m_parser.parseQuery("tell", QString());
+    EXPECT_EQ((QSet<TrackId>{trackAId, trackBId}), queryTrackIds(*pQuery));
+
+    pQuery = m_parser.parseQuery("artist:tell", QString());
+    EXPECT_TRUE(pQuery->toSql().contains("MATCH"));
+    EXPECT_EQ(QSet<TrackId>{trackAId}, queryTrackIds(*pQuery));
+
+    // Quotes inside the argument are escaped
+    pQuery = m_parser.parseQuery("title:live\"", QString());
+    EXPECT_TRUE(pQuery->toSql().contains("MATCH"));
+    EXPECT_EQ(QSet<TrackId>{trackBId}, queryTrackIds(*pQuery));
+
+    // Too short for trigrams
+    pQuery = m_parser.parseQuery("t:te", QString());
+    EXPECT_FALSE(pQuery->toSql().contains("MATCH"));
+    EXPECT_EQ(QSet<TrackId>{trackBId}, queryTrackIds(*pQuery));
+
+    // Not indexed
+    pQuery = m_parser.parseQuery("type:mp3", QString());
+    EXPECT_FALSE(pQuery->toSql().contains("MATCH"));
+
+    // Exact matches are not answered by the index
+    pQuery = m_parser.parseQuery("title:=roche", QString());
+    EXPECT_FALSE(pQuery->toSql().contains("MATCH"));
+    EXPECT_EQ(QSet<TrackId>{trackAId}, queryTrackIds(*pQuery));
+
+    searchIndex.removeTracks({trackAId});
+    pQuery = m_parser.parseQuery("sebas", QString());
+    EXPECT_TRUE(queryTrackIds(*pQuery).isEmpty());
+}
+
+TEST_F(SearchQueryParserTest, SearchIndexOutdatedTracks) {
+    const TrackSearchIndexDAO& searchIndex =
+            internalCollection()->getTrackSearchIndexDAO();
+    if (!searchIndex.isAvailable()) {
+        GTEST_SKIP() << "SQLite has been built without FTS5 trigram support";
+    }
+    m_parser.setSearchIndex(&searchIndex);
+    m_parser.setSearchColumns({"title", "location"});
+
+    const TrackId trackAId = addTrackToCollection(getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-jpg.mp3")));
+    const TrackId trackBId = addTrackToCollection(getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-png.mp3")));
+    ASSERT_TRUE(trackAId.isValid());
+    ASSERT_TRUE(trackBId.isValid());
+    searchIndex.updateOutdatedTracks();
+
+    const QSqlDatabase database = internalCollection()->database();
+    const auto queryTrackIds = [&database, this](const QString& search) {
+        const auto pQuery = m_parser.parseQuery(search, QString());
+        EXPECT_TRUE(pQuery->toSql().contains("MATCH"));
+        QSet<TrackId> trackIds;
+        QSqlQuery query(database);
+        EXPECT_TRUE(query.exec("SELECT id FROM library WHERE " + pQuery->toSql()));
+        while (query.next()) {
+            trackIds.insert(TrackId(query.value(0)));
+        }
+        return trackIds;
+    };
+
+    // Modifications that bypass TrackDAO, e.g. bulk updates or another
+    // version of Mixxx
+    QSqlQuery query(database);
+    ASSERT_TRUE(query.exec(QStringLiteral(
+            "UPDATE library SET title='Bulk Update' WHERE id=%1")
+                                   .arg(trackAId.toString())));
+    ASSERT_TRUE(query.exec(QStringLiteral(
+            "UPDATE track_locations SET location='/renamed/moved.mp3' "
+            "WHERE id=(SELECT location FROM library WHERE id=%1)")
+                                   .arg(trackBId.toString())));
+    EXPECT_TRUE(queryTrackIds("bulk").isEmpty());
+    EXPECT_TRUE(queryTrackIds("renamed").isEmpty());
+
+    searchIndex.updateOutdatedTracks();
+    EXPECT_EQ(QSet<TrackId>{trackAId}, queryTrackIds("bulk"));
+    EXPECT_EQ(QSet<TrackId>{trackBId}, queryTrackIds("renamed"));
+
+    ASSERT_TRUE(query.exec(QStringLiteral("DELETE FROM library WHERE id=%1")
+                                   .arg(trackAId.toString())));
+    searchIndex.updateOutdatedTracks();
+    EXPECT_TRUE(queryTrackIds("bulk").isEmpty());
+}
@@ -0,0 +1,193 @@
+#include "engine/sidechain/sharedencoder.h"
+
+#include <gtest/gtest.h>
+
+#include <QList>
+#include <utility>
+
+#include "recording/defs_recording.h"
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+
+// Writes the number of encoded samples as packet and counts the calls
+class FakeEncoder : public Encoder {
+  public:
+    FakeEncoder(EncoderCallback* pCallback, int* pEncodeCount)
+            : m_pCallback(pCallback),
+              m_pEncodeCount(pEncodeCount) {
+    }
+
+    int initEncoder(mixxx::audio::SampleRate sampleRate,
+            QString* pUserErrorMessage) override {
+        Q_UNUSED(sampleRate);
+        Q_UNUSED(pUserErrorMessage);
+        return 0;
+    }
+    void encodeBuffer(const CSAMPLE* samples, const std::size_t bufferSize) override {
+        Q_UNUSED(samples);
+        ++*m_pEncodeCount;
+        const QByteArray body = QByteArray::number(static_cast<qulonglong>(bufferSize));
+        m_pCallback->write(nullptr,
+                reinterpret_cast<const unsigned char*>(body.constData()),
+                0,
+                static_cast<int>(body.size()));
+    }
+    void updateMetaData(const QString& artist,
+            const QString& title,
+            const QString& album,
+            std::chrono::seconds timestamp) override {
+        Q_UNUSED(artist);
+        Q_UNUSED(title);
+        Q_UNUSED(album);
+        Q_UNUSED(timestamp);
+    }
+    void flush() override {
+    }
+    void setEncoderSettings(const EncoderSettings& settings) override {
+        Q_UNUSED(settings);
+    }
+
+  private:
+    EncoderCallback* const m_pCallback;
+    int* const m_pEncodeCount;
+};
+
+class FakeSettings : public EncoderSettings {
+  public:
+    FakeSettings(QString format, int quality)
+            : m_format(std::move(format)),
+              m_quality(quality) {
+    }
+
+    int getQuality() const override {
+        return m_quality;
+    }
+    ChannelMode getChannelMode() const override {
+        return ChannelMode::STEREO;
+    }
+    QString getFormat() const override {
+        return m_format;
+    }
+
+  private:
+    const QString m_format;
+    const int m_quality;
+};
+
+class PacketSink : public SharedEncoder::Sink {
+  public:
+    void receivePacket(const QByteArray& packet) override {
+        m_packets.append(packet);
+    }
+
+    QList<QByteArray> m_packets;
+};
+
+class SharedEncoderTest : public testing::Test {
+  protected:
+    std::shared_ptr<SharedEncoder> getOrCreate(const QString& key) {
+        return SharedEncoder::getOrCreate(
+                key,
+                [this](EncoderCallback* pCallback) {
+                    ++m_createCount;
+                    return std::make_shared<FakeEncoder>(pCallback, &m_encodeCount);
+                },
+                kSampleRate,
+                nullptr);
+    }
+
+    int m_createCount = 0;
+    int m_encodeCount = 0;
+    const CSAMPLE m_samples[4] = {};
+};
+
+TEST_F(SharedEncoderTest, encodeOnceForAllSinks) {
+    const auto pEncoder1 = getOrCreate(QStringLiteral("MP3 128"));
+    const auto pEncoder2 = getOrCreate(QStringLiteral("MP3 128"));
+    ASSERT_EQ(pEncoder1, pEncoder2);
+    EXPECT_EQ(1, m_createCount);
+
+    PacketSink sink1;
+    PacketSink sink2;
+    pEncoder1->attach(&sink1);
+    pEncoder2->attach(&sink2);
+    SharedEncoderStage stage;
+    stage.process(m_samples, 4);
+    EXPECT_EQ(1, m_encodeCount);
+    ASSERT_EQ(1, sink1.m_packets.size());
+    ASSERT_EQ(1, sink2.m_packets.size());
+    EXPECT_EQ(QByteArray("4"), sink1.m_packets.first());
+    // Not copied
+    EXPECT_EQ(sink1.m_packets.first().constData(), sink2.m_packets.first().constData());
+
+    // The encoder keeps running for the second sink
+    pEncoder1->detach(&sink1);
+    stage.process(m_samples, 2);
+    EXPECT_EQ(2, m_encodeCount);
+    EXPECT_EQ(1, sink1.m_packets.size());
+    ASSERT_EQ(2, sink2.m_packets.size());
+    EXPECT_EQ(QByteArray("2"), sink2.m_packets.last());
+    pEncoder2->detach(&sink2);
+}
+
+TEST_F(SharedEncoderTest, stageOnlyEncodesSharedEncodersWithSinks) {
+    const auto pSharedEncoder = getOrCreate(QStringLiteral("MP3 128"));
+    const auto pPrivateEncoder = getOrCreate(QString());
+    PacketSink sink;
+    pPrivateEncoder->attach(&sink);
+    EXPECT_FALSE(pPrivateEncoder->isShared());
+
+    SharedEncoderStage stage;
+    stage.process(m_samples, 4);
+    EXPECT_EQ(0, m_encodeCount);
+
+    // Fed by its only sink
+    pPrivateEncoder->encodeBuffer(m_samples, 4);
+    EXPECT_EQ(1, m_encodeCount);
+    EXPECT_EQ(1, sink.m_packets.size());
+    pPrivateEncoder->detach(&sink);
+}
+
+TEST_F(SharedEncoderTest, findRunningEncoder) {
+    EXPECT_EQ(nullptr, SharedEncoder::find(QStringLiteral("MP3 128")));
+    const auto pEncoder = getOrCreate(QStringLiteral("MP3 128"));
+    EXPECT_EQ(pEncoder, SharedEncoder::find(QStringLiteral("MP3 128")));
+    EXPECT_EQ(nullptr, SharedEncoder::find(QString()));
+}
+
+TEST_F(SharedEncoderTest, keyForSettings) {
+    const FakeSettings mp3Settings(QStringLiteral(ENCODING_MP3), 128);
+    const FakeSettings oggSettings(QStringLiteral(ENCODING_OGG), 128);
+    EXPECT_FALSE(SharedEncoder::keyFor(mp3Settings, kSampleRate).isEmpty());
+    EXPECT_EQ(SharedEncoder::keyFor(mp3Settings, kSampleRate),
+            SharedEncoder::keyFor(FakeSettings(QStringLiteral(ENCODING_MP3), 128),
+                    kSampleRate));
+    EXPECT_NE(SharedEncoder::keyFor(mp3Settings, kSampleRate),
+            SharedEncoder::keyFor(FakeSettings(QStringLiteral(ENCODING_MP3), 192),
+                    kSampleRate));
+    EXPECT_NE(SharedEncoder::keyFor(mp3Settings, kSampleRate),
+            SharedEncoder::keyFor(mp3Settings, mixxx::audio::SampleRate(48000)));
+    // Needs the headers at the start of the stream
+    EXPECT_TRUE(SharedEncoder::keyFor(oggSettings, kSampleRate).isEmpty());
+}
+
+TEST_F(SharedEncoderTest, differentKeysAreNotShared) {
+    const auto pEncoder1 = getOrCreate(QStringLiteral("MP3 128"));
+    const auto pEncoder2 = getOrCreate(QStringLiteral("MP3 192"));
+    const auto pEncoder3 = getOrCreate(QString());
+    const auto pEncoder4 = getOrCreate(QString());
+    EXPECT_NE(pEncoder1, pEncoder2);
+    EXPECT_NE(pEncoder3, pEncoder4);
+    EXPECT_EQ(4, m_createCount);
+}
+
+TEST_F(SharedEncoderTest, recreateAfterRelease) {
+    auto pEncoder = getOrCreate(QStringLiteral("MP3 128"));
+    pEncoder.reset();
+    pEncoder = getOrCreate(QStringLiteral("MP3 128"));
+    EXPECT_EQ(2, m_createCount);
+}
+
+} // anonymous namespace
@@ -16,6 +16,7 @@
 #include "engine/controls/ratecontrol.h"
 #include "engine/enginebuffer.h"
 #include "engine/enginemixer.h"
+#include "engine/enginethreadpool.h"
 #include "engine/sync/enginesync.h"
 #include "mixer/deck.h"
 #include "mixer/playerinfo.h"
@@ -65,11 +66,40 @@ class TestEngineMixer : public EngineMixer {
         m_pHeadphoneEnabled->forceSet(1);
         m_pBoothEnabled->forceSet(1);
     }
+
+    void enableParallelChannelProcessing(int numThreads) {
+        m_pChannelThreadPool = std::make_unique<EngineThreadPool>(
+                QStringLiteral("EngineHelper"), numThreads);
+    }
+
+    bool isParallelChannelProcessingEnabled() const {
+        return m_pChannelThreadPool != nullptr;
+    }
+
+    // Processes all channels on the engine thread until resumed, e.g. to
+    // compare the output with the one of the helper threads.
+    void suspendParallelChannelProcessing() {
+        DEBUG_ASSERT(!m_pSuspendedChannelThreadPool);
+        m_pSuspendedChannelThreadPool = std::move(m_pChannelThreadPool);
+    }
+
+    void resumeParallelChannelProcessing() {
+        DEBUG_ASSERT(!m_pChannelThreadPool);
+        m_pChannelThreadPool = std::move(m_pSuspendedChannelThreadPool);
+    }
+
+  private:
+    std::unique_ptr<EngineThreadPool> m_pSuspendedChannelThreadPool;
 };
 
 class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
   protected:
-    BaseSignalPathTest() {
+    explicit BaseSignalPathTest(int engineHelperThreads = 0) {
+        if (engineHelperThreads > 0) {
+            m_pConfig->setValue(ConfigKey(QStringLiteral("[App]"),
+                                        QStringLiteral("engine_helper_threads")),
+                    engineHelperThreads);
+        }
         m_pControlIndicatorTimer = std::make_unique<mixxx::ControlIndicatorTimer>();
         m_pChannelHandleFactory = std::make_shared<ChannelHandleFactory>();
         m_pNumDecks = new ControlObject(ConfigKey(
@@ -292,6 +322,8 @@ class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
 
 class SignalPathTest : public BaseSignalPathTest {
   protected:
+    using BaseSignalPathTest::BaseSignalPathTest;
+
     void SetUp() override {
         BaseSignalPathTest::SetUp();
         const QString kTrackLocationTest = getTestDir().filePath(QStringLiteral("sine-30.wav"));
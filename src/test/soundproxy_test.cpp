@@ -1,9 +1,13 @@
+#include <QDir>
 #include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QtDebug>
 
 #include "analyzer/analyzersilence.h"
 #include "sources/audiosourcestereoproxy.h"
+#ifdef __MAD__
+#include "sources/soundsourcemp3.h"
+#endif
 #include "sources/soundsourceproxy.h"
 #include "test/mixxxtest.h"
 #include "test/soundsourceproviderregistration.h"
@@ -1123,6 +1127,64 @@ TEST_F(SoundSourceProxyTest, freeModeGarbage) {
     }
 }
 
+#ifdef __MAD__
+TEST_F(SoundSourceProxyTest, mp3SeekIndexCache) {
+    QTemporaryDir cacheDir;
+    ASSERT_TRUE(cacheDir.isValid());
+    mixxx::SoundSourceMp3::setSeekIndexCacheDir(cacheDir.path());
+    const QString filePath = getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-vbr.mp3"));
+    const auto pProvider = std::make_shared<mixxx::SoundSourceProviderMp3>();
+
+    // The first source scans the frame headers and stores the seek
+    // frames, the second one loads them from the cache.
+    mixxx::AudioSourcePointer pScannedSource = openAudioSource(filePath, pProvider);
+    ASSERT_TRUE(pScannedSource != nullptr);
+    ASSERT_EQ(1, QDir(cacheDir.path()).entryList(QDir::Files).size());
+    mixxx::AudioSourcePointer pCachedSource = openAudioSource(filePath, pProvider);
+    mixxx::SoundSourceMp3::setSeekIndexCacheDir(QString());
+    ASSERT_TRUE(pCachedSource != nullptr);
+    EXPECT_EQ(pScannedSource->getSignalInfo(), pCachedSource->getSignalInfo());
+    EXPECT_EQ(pScannedSource->getBitrate(), pCachedSource->getBitrate());
+    ASSERT_EQ(pScannedSource->frameIndexRange(), pCachedSource->frameIndexRange());
+
+    // Seek to the middle and to the end of the file, which includes the
+    // last MP3 frame that might need to be padded.
+    constexpr SINT kReadFrameCount = 10000;
+    const mixxx::IndexRange readRanges[] = {
+            mixxx::IndexRange::forward(
+                    pScannedSource->frameIndexRange().start() +
+                            pScannedSource->frameLength() / 2,
+                    kReadFrameCount),
+            mixxx::IndexRange::between(
+                    pScannedSource->frameIndexMax() - kReadFrameCount,
+                    pScannedSource->frameIndexMax()),
+    };
+    mixxx::SampleBuffer scannedData(
+            pScannedSource->getSignalInfo().frames2samples(kReadFrameCount));
+    mixxx::SampleBuffer cachedData(
+            pCachedSource->getSignalInfo().frames2samples(kReadFrameCount));
+    for (const auto& readRange : readRanges) {
+        const auto scannedFrames = pScannedSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        readRange,
+                        mixxx::SampleBuffer::WritableSlice(scannedData)));
+        const auto cachedFrames = pCachedSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        readRange,
+                        mixxx::SampleBuffer::WritableSlice(cachedData)));
+        ASSERT_FALSE(scannedFrames.frameIndexRange().empty());
+        ASSERT_EQ(scannedFrames.frameIndexRange(), cachedFrames.frameIndexRange());
+        expectDecodedSamplesEqual(
+                pScannedSource->getSignalInfo().frames2samples(
+                        scannedFrames.frameLength()),
+                &scannedData[0],
+                &cachedData[0],
+                "Decoding mismatch with cached seek frames");
+    }
+}
+#endif
+
 TEST_F(SoundSourceProxyTest, taglibStringToEnumFileType) {
     const QStringList fileTypes = SoundSourceProxy::getSupportedFileTypes();
     for (const auto& fileType : fileTypes) {
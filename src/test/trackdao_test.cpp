@@ -56,3 +56,23 @@ TEST_F(TrackDAOTest, detectMovedTracks) {
     QSet<QString> trackLocations = trackDAO.getAllTrackLocations();
     EXPECT_THAT(trackLocations, UnorderedElementsAre(newFile.location(), otherFile.location()));
 }
+
+TEST_F(TrackDAOTest, trackFileFingerprints) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+
+    // The file doesn't exist
+    mixxx::FileInfo file(QDir(QDir::tempPath() + QStringLiteral("/dir1")),
+            QStringLiteral("file.mp3"));
+    TrackPointer pTrack = Track::newTemporary(mixxx::FileAccess(file));
+    internalCollection()->addTrack(pTrack, false);
+
+    auto fingerprints = trackDAO.getAllTrackFileFingerprints();
+    ASSERT_TRUE(fingerprints.contains(file.location()));
+    EXPECT_FALSE(fingerprints.value(file.location()).isValid());
+
+    const auto fingerprint = TrackFileFingerprint(1234, 1700000000000);
+    trackDAO.updateTrackFileFingerprint(file.location(), fingerprint);
+
+    fingerprints = trackDAO.getAllTrackFileFingerprints();
+    EXPECT_EQ(fingerprint, fingerprints.value(file.location()));
+}
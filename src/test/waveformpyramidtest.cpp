@@ -0,0 +1,132 @@
+#include "waveform/waveformpyramid.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+
+namespace {
+
+constexpr int kAudioSampleRate = 44100;
+constexpr int kVisualSampleRate = 441;
+constexpr int kPixelCount = 1000;
+
+// A complete waveform with random content
+std::unique_ptr<Waveform> createWaveform(SINT visualFrameCount) {
+    auto pWaveform = std::make_unique<Waveform>(kAudioSampleRate,
+            visualFrameCount * (kAudioSampleRate / kVisualSampleRate),
+            kVisualSampleRate,
+            -1,
+            0);
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    WaveformData* pData = pWaveform->data();
+    for (int i = 0; i < pWaveform->getDataSize(); ++i) {
+        pData[i].filtered.low = static_cast<unsigned char>(distribution(generator));
+        pData[i].filtered.mid = static_cast<unsigned char>(distribution(generator));
+        pData[i].filtered.high = static_cast<unsigned char>(distribution(generator));
+        pData[i].filtered.all = static_cast<unsigned char>(distribution(generator));
+    }
+    pWaveform->setCompletion(pWaveform->getDataSize());
+    return pWaveform;
+}
+
+void expectEqualMaxima(const WaveformFilteredData& expected, const WaveformFilteredData& actual) {
+    EXPECT_EQ(expected.low, actual.low);
+    EXPECT_EQ(expected.mid, actual.mid);
+    EXPECT_EQ(expected.high, actual.high);
+    EXPECT_EQ(expected.all, actual.all);
+}
+
+TEST(WaveformPyramidTest, maximaMatchScan) {
+    const auto pWaveform = createWaveform(1001);
+    const int dataSize = pWaveform->getDataSize();
+    const WaveformPyramid pyramid(pWaveform->data(), dataSize);
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<int> distribution(0, dataSize - 1);
+    for (int n = 0; n < 10000; ++n) {
+        // The renderers start at even indices and clip the stop index
+        const int visualIndexStart = distribution(generator) & ~1;
+        const int visualIndexStop = distribution(generator);
+        WaveformFilteredData expected[ChannelCount];
+        WaveformPyramid::scanMaxima(
+                pWaveform->data(), visualIndexStart, visualIndexStop, expected);
+        WaveformFilteredData actual[ChannelCount];
+        pyramid.getMaxima(visualIndexStart, visualIndexStop, actual);
+        SCOPED_TRACE(QStringLiteral("[%1, %2)")
+                             .arg(visualIndexStart)
+                             .arg(visualIndexStop)
+                             .toStdString());
+        expectEqualMaxima(expected[Left], actual[Left]);
+        expectEqualMaxima(expected[Right], actual[Right]);
+    }
+}
+
+TEST(WaveformPyramidTest, completeRangeAndEdges) {
+    const auto pWaveform = createWaveform(100);
+    const int dataSize = pWaveform->getDataSize();
+    for (const auto& range : {std::pair{0, dataSize - 1},
+                 std::pair{0, 0},
+                 std::pair{0, 2},
+                 std::pair{dataSize - 2, dataSize - 1},
+                 std::pair{10, 4}}) {
+        WaveformFilteredData expected[ChannelCount];
+        WaveformPyramid::scanMaxima(
+                pWaveform->data(), range.first, range.second, expected);
+        WaveformFilteredData actual[ChannelCount];
+        // Built on demand
+        pWaveform->getMaxima(range.first, range.second, actual);
+        expectEqualMaxima(expected[Left], actual[Left]);
+        expectEqualMaxima(expected[Right], actual[Right]);
+    }
+}
+
+// Finds the maxima for every pixel like the renderers, with
+// state.range(0) visual frames per pixel
+template<typename GetMaxima>
+void BM_WaveformMaxima(benchmark::State& state, GetMaxima getMaxima) {
+    const int framesPerPixel = static_cast<int>(state.range(0));
+    const auto pWaveform = createWaveform(static_cast<SINT>(framesPerPixel) * kPixelCount);
+    const int dataSize = pWaveform->getDataSize();
+    const WaveformPyramid pyramid(pWaveform->data(), dataSize);
+    for (auto _ : state) {
+        for (int pos = 0; pos < kPixelCount; ++pos) {
+            const int visualIndexStart = pos * framesPerPixel * 2;
+            const int visualIndexStop = std::min(
+                    (pos + 1) * framesPerPixel * 2, dataSize - 1);
+            WaveformFilteredData maxima[ChannelCount];
+            getMaxima(*pWaveform, pyramid, visualIndexStart, visualIndexStop, maxima);
+            benchmark::DoNotOptimize(maxima);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kPixelCount);
+}
+
+void BM_WaveformMaximaScan(benchmark::State& state) {
+    BM_WaveformMaxima(state,
+            [](const Waveform& waveform,
+                    const WaveformPyramid&,
+                    int visualIndexStart,
+                    int visualIndexStop,
+                    WaveformFilteredData* pMaxima) {
+                WaveformPyramid::scanMaxima(
+                        waveform.data(), visualIndexStart, visualIndexStop, pMaxima);
+            });
+}
+BENCHMARK(BM_WaveformMaximaScan)->RangeMultiplier(4)->Range(1, 1024);
+
+void BM_WaveformMaximaPyramid(benchmark::State& state) {
+    BM_WaveformMaxima(state,
+            [](const Waveform&,
+                    const WaveformPyramid& pyramid,
+                    int visualIndexStart,
+                    int visualIndexStop,
+                    WaveformFilteredData* pMaxima) {
+                pyramid.getMaxima(visualIndexStart, visualIndexStop, pMaxima);
+            });
+}
+BENCHMARK(BM_WaveformMaximaPyramid)->RangeMultiplier(4)->Range(1, 1024);
+
+} // namespace
@@ -0,0 +1,79 @@
+#include "util/cachedir.h"
+
+#include <QDateTime>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+#include <vector>
+
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace cachedir {
+
+namespace {
+
+const Logger kLogger("cachedir");
+
+constexpr qint64 kTouchIntervalSecs = 24 * 60 * 60;
+
+struct CacheFile {
+    QString filePath;
+    QDateTime lastModified;
+    qint64 size;
+};
+
+} // anonymous namespace
+
+void touchFile(const QString& filePath) {
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    if (QFileInfo(filePath).lastModified().secsTo(now) < kTouchIntervalSecs) {
+        return;
+    }
+    // Opened for writing, because changing the time needs write access
+    // on Windows. Appending doesn't truncate the file.
+    QFile file(filePath);
+    if (!file.open(QIODevice::Append) ||
+            !file.setFileTime(now, QFileDevice::FileModificationTime)) {
+        kLogger.debug() << "Failed to touch" << filePath;
+    }
+}
+
+qint64 removeLeastRecentlyUsedFiles(const QString& dirPath, qint64 maxSizeBytes) {
+    std::vector<CacheFile> files;
+    qint64 totalSize = 0;
+    QDirIterator it(dirPath, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fileInfo = it.fileInfo();
+        files.push_back(CacheFile{fileInfo.filePath(), fileInfo.lastModified(), fileInfo.size()});
+        totalSize += fileInfo.size();
+    }
+    if (totalSize <= maxSizeBytes) {
+        return totalSize;
+    }
+    std::sort(files.begin(), files.end(), [](const CacheFile& lhs, const CacheFile& rhs) {
+        return lhs.lastModified < rhs.lastModified;
+    });
+    const qint64 targetSize = maxSizeBytes / 10 * 9;
+    int removedCount = 0;
+    for (const auto& file : files) {
+        if (totalSize <= targetSize) {
+            break;
+        }
+        // Might fail if the file is currently open on Windows
+        if (QFile::remove(file.filePath)) {
+            totalSize -= file.size;
+            ++removedCount;
+        }
+    }
+    kLogger.info() << "Removed" << removedCount << "least recently used files from"
+                   << dirPath;
+    return totalSize;
+}
+
+} // namespace cachedir
+
+} // namespace mixxx
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QString>
+
+namespace mixxx {
+
+/// Helpers for directories with cache files that can be recreated at any
+/// time. The modification time of a file is used as the time of its last
+/// use, so that the least recently used files can be removed.
+namespace cachedir {
+
+/// Marks the file as recently used. The modification time is only updated
+/// once a day to not write to the disk for every access.
+void touchFile(const QString& filePath);
+
+/// Removes the least recently used files from the directory and its
+/// subdirectories if they take more than maxSizeBytes. The files are
+/// removed until they take less than 90% of maxSizeBytes so that not every
+/// new file triggers a removal. Returns the size of the remaining files.
+qint64 removeLeastRecentlyUsedFiles(const QString& dirPath, qint64 maxSizeBytes);
+
+} // namespace cachedir
+
+} // namespace mixxx
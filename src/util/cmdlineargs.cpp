@@ -52,6 +52,7 @@ CmdlineArgs::CmdlineArgs()
         : m_startInFullscreen(false), // Initialize vars
           m_startAutoDJ(false),
           m_rescanLibrary(false),
+          m_maintainDatabase(false),
           m_controllerDebug(false),
           m_controllerAbortOnWarning(false),
           m_developer(false),
@@ -199,6 +200,14 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
                             : QString());
     parser.addOption(rescanLibrary);
 
+    const QCommandLineOption maintainDatabase(QStringLiteral("maintain-database"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Compacts the library database and updates its "
+                                      "statistics before Mixxx is launched. This "
+                                      "might take a while for large libraries.")
+                            : QString());
+    parser.addOption(maintainDatabase);
+
     // An option with a value
     const QCommandLineOption settingsPath(QStringLiteral("settings-path"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
@@ -446,6 +455,10 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
         m_rescanLibrary = true;
     }
 
+    if (parser.isSet(maintainDatabase)) {
+        m_maintainDatabase = true;
+    }
+
     if (parser.isSet(settingsPath)) {
         m_settingsPath = parser.value(settingsPath);
         if (!m_settingsPath.endsWith("/")) {
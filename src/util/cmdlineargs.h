@@ -36,6 +36,9 @@ class CmdlineArgs final {
     bool getRescanLibrary() const {
         return m_rescanLibrary;
     }
+    bool getMaintainDatabase() const {
+        return m_maintainDatabase;
+    }
     bool getControllerDebug() const {
         return m_controllerDebug;
     }
@@ -103,6 +106,7 @@ class CmdlineArgs final {
     bool m_startInFullscreen;       // Start in fullscreen mode
     bool m_startAutoDJ;
     bool m_rescanLibrary;
+    bool m_maintainDatabase;
     bool m_controllerDebug;
     bool m_controllerPreviewScreens;
     bool m_controllerAbortOnWarning; // Controller Engine will be stricter
@@ -1,5 +1,6 @@
 #include <QSqlDriver>
 #include <QSqlError>
+#include <QSqlQuery>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -21,6 +22,10 @@ namespace {
 
 const mixxx::Logger kLogger("DbConnection");
 
+// Connections that have been open for a shorter time are closed
+// without updating the statistics of the query planner
+constexpr Duration kOptimizeOnCloseMinLifetime = Duration::fromSeconds(10 * 60);
+
 QSqlDatabase createDatabase(
         const DbConnection::Params& params,
         const QString& connectionName) {
@@ -230,6 +235,30 @@ void sqliteLikeUtf8(sqlite3_context* context,
     return;
 }
 
+// This implements the mixxx_latin_low() SQL function that normalizes a
+// string in the same way as the custom LIKE function, see
+// TrackSearchIndexDAO.
+//static
+void sqliteLatinLowUtf8(sqlite3_context* context,
+        int aArgc,
+        sqlite3_value** aArgv) {
+    VERIFY_OR_DEBUG_ASSERT(aArgc == 1) {
+        return;
+    }
+
+    const char* a = reinterpret_cast<const char*>(
+            sqlite3_value_text(aArgv[0]));
+    if (!a) {
+        sqlite3_result_null(context);
+        return;
+    }
+
+    QString stringA = QString::fromUtf8(a);
+    DbConnection::makeStringLatinLow(&stringA);
+    const QByteArray utf8 = stringA.toUtf8();
+    sqlite3_result_text(context, utf8.constData(), utf8.size(), SQLITE_TRANSIENT);
+}
+
 #endif // __SQLITE3__
 
 bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator) {
@@ -304,6 +333,21 @@ bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator
                 << "Failed to install custom 3-arg LIKE function for SQLite3:"
                 << result;
     }
+
+    result = sqlite3_create_function(
+            handle,
+            "mixxx_latin_low",
+            1,
+            SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+            nullptr,
+            sqliteLatinLowUtf8,
+            nullptr,
+            nullptr);
+    VERIFY_OR_DEBUG_ASSERT(result == SQLITE_OK) {
+        kLogger.warning()
+                << "Failed to install custom mixxx_latin_low function for SQLite3:"
+                << result;
+    }
 #else
     Q_UNUSED(database);
     Q_UNUSED(pCollator);
@@ -311,18 +355,98 @@ bool initDatabase(const QSqlDatabase& database, mixxx::StringCollator* pCollator
     return true;
 }
 
+#ifdef __SQLITE3__
+
+QVariant execPragma(const QSqlDatabase& database, const QString& statement) {
+    QSqlQuery query(database);
+    if (!query.exec(QStringLiteral("PRAGMA ") + statement)) {
+        kLogger.warning()
+                << "Failed to execute PRAGMA"
+                << statement
+                << query.lastError();
+        return QVariant();
+    }
+    if (!query.next()) {
+        // Most pragmas don't return a result
+        return QVariant();
+    }
+    return query.value(0);
+}
+
+// Failures are only logged, the connection is still usable
+// with the default settings of SQLite.
+void applySqliteProfile(
+        const QSqlDatabase& database,
+        const DbConnection::SqliteProfile& profile) {
+    // The journal mode is stored persistently in the database file.
+    // Switching back from WAL requires that no other connections are
+    // open, i.e. it happens when opening the first connection. In-memory
+    // databases keep their own journal mode.
+    QString journalMode =
+            execPragma(database,
+                    profile.writeAheadLog
+                            ? QStringLiteral("journal_mode=WAL")
+                            : QStringLiteral("journal_mode=DELETE"))
+                    .toString();
+    const bool walMode =
+            journalMode.compare(QStringLiteral("wal"), Qt::CaseInsensitive) == 0;
+    if (profile.writeAheadLog && !walMode) {
+        kLogger.info()
+                << "Write-ahead log is not supported, using journal mode"
+                << journalMode;
+    } else if (walMode) {
+        // WAL needs shared memory next to the database file, which is
+        // not available on most network file systems. The first read
+        // fails in this case.
+        QSqlQuery query(database);
+        if (!query.exec(QStringLiteral("SELECT COUNT(*) FROM sqlite_master"))) {
+            kLogger.warning()
+                    << "Write-ahead log is not usable, falling back to a rollback journal"
+                    << query.lastError();
+            journalMode = execPragma(database,
+                    QStringLiteral("journal_mode=DELETE"))
+                                  .toString();
+        }
+    }
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Journal mode:"
+                << journalMode;
+    }
+    execPragma(database,
+            journalMode.compare(QStringLiteral("wal"), Qt::CaseInsensitive) == 0
+                    ? QStringLiteral("synchronous=NORMAL")
+                    : QStringLiteral("synchronous=FULL"));
+    if (profile.mmapSizeBytes > 0) {
+        execPragma(database,
+                QStringLiteral("mmap_size=%1").arg(profile.mmapSizeBytes));
+    }
+    if (profile.cacheSizeKiB > 0) {
+        // Negative values are interpreted as KiB instead of pages
+        execPragma(database,
+                QStringLiteral("cache_size=-%1").arg(profile.cacheSizeKiB));
+    }
+    if (profile.tempStoreInMemory) {
+        execPragma(database, QStringLiteral("temp_store=MEMORY"));
+    }
+}
+
+#endif // __SQLITE3__
+
 } // anonymous namespace
 
 DbConnection::DbConnection(
         const Params& params,
         const QString& connectionName)
-    : m_sqlDatabase(createDatabase(params, connectionName)) {
+    : m_sqlDatabase(createDatabase(params, connectionName)),
+      m_sqliteProfile(params.sqliteProfile) {
 }
 
 DbConnection::DbConnection(
         const DbConnection& prototype,
         const QString& connectionName)
-    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)) {
+    : m_sqlDatabase(cloneDatabase(prototype.m_sqlDatabase, connectionName)),
+      m_sqliteProfile(prototype.m_sqliteProfile) {
 }
 
 DbConnection::~DbConnection() {
@@ -350,6 +474,10 @@ bool DbConnection::open() {
         m_sqlDatabase.close();
         return false; // abort
     }
+#ifdef __SQLITE3__
+    applySqliteProfile(m_sqlDatabase, m_sqliteProfile);
+#endif // __SQLITE3__
+    m_openedTimer.start();
     return true;
 }
 
@@ -363,6 +491,17 @@ void DbConnection::close() {
                 << "Rolled back open transaction before closing database connection:"
                 << *this;
         }
+#ifdef __SQLITE3__
+        // Updates the statistics of the query planner if the queries
+        // of this connection would benefit from it. Only for long-lived
+        // connections, e.g. of the GUI thread, because short-lived
+        // connections only run a few queries.
+        // https://www.sqlite.org/pragma.html#pragma_optimize
+        if (m_openedTimer.isValid() &&
+                m_openedTimer.elapsed() >= kOptimizeOnCloseMinLifetime) {
+            execPragma(m_sqlDatabase, QStringLiteral("optimize"));
+        }
+#endif // __SQLITE3__
         if (kLogger.debugEnabled()) {
             kLogger.debug()
                     << "Closing database connection:"
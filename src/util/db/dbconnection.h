@@ -3,6 +3,7 @@
 #include <QSqlDatabase>
 #include <QtDebug>
 
+#include "util/performancetimer.h"
 #include "util/string.h"
 
 namespace mixxx {
@@ -22,6 +23,22 @@ class DbConnection final {
 
     static void makeStringLatinLow(QString* string);
 
+    // Tuning of SQLite connections that is applied after opening
+    // each connection. The defaults keep the settings of SQLite.
+    struct SqliteProfile {
+        // Readers and the single writer don't block each other.
+        // Also relaxes the synchronous mode to NORMAL, which is
+        // only safe in WAL mode. Falls back to a rollback journal
+        // if the file system doesn't support WAL.
+        bool writeAheadLog = false;
+        // 0 = no memory-mapped I/O
+        qint64 mmapSizeBytes = 0;
+        // 0 = default size of the page cache
+        qint64 cacheSizeKiB = 0;
+        // For temporary tables and indices, e.g. for sorting
+        bool tempStoreInMemory = false;
+    };
+
     struct Params {
         QString type;
         QString connectOptions;
@@ -29,6 +46,7 @@ class DbConnection final {
         QString filePath;
         QString userName;
         QString password;
+        SqliteProfile sqliteProfile;
     };
 
     // All constructors are reserved for DbConnectionPool!!
@@ -62,6 +80,8 @@ class DbConnection final {
     DbConnection(const DbConnection&&) = delete;
 
     QSqlDatabase m_sqlDatabase;
+    SqliteProfile m_sqliteProfile;
+    PerformanceTimer m_openedTimer;
     mixxx::StringCollator m_collator;
 };
 
@@ -1,5 +1,6 @@
 #include "util/sample.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdlib>
 
@@ -38,6 +39,334 @@ constexpr bool useAlignedAlloc() {
             sizeof(CSAMPLE*) == sizeof(size_t);
 }
 
+// The hot loops of the mixing path are compiled once per instruction set and
+// the best variant supported by the CPU is picked at runtime. All variants are
+// generated from the same scalar kernels below, which the compiler inlines and
+// vectorizes for the target of each wrapper. Note that the AVX2 and AVX-512
+// variants may contract multiply-add into FMA instructions, so their results
+// can differ from the Baseline in the last bit.
+#if (defined(__GNUC__) || defined(__clang__)) && \
+        (defined(__x86_64__) || defined(__i386__)) && !defined(__EMSCRIPTEN__)
+#define MIXXX_SAMPLE_DISPATCH
+#define MIXXX_SAMPLE_KERNEL inline __attribute__((always_inline))
+#define MIXXX_SAMPLE_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define MIXXX_SAMPLE_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define MIXXX_SAMPLE_KERNEL inline
+#endif
+
+namespace kernel {
+
+MIXXX_SAMPLE_KERNEL void applyGain(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pBuffer[i] *= gain;
+    }
+}
+
+MIXXX_SAMPLE_KERNEL void applyRampingGain(CSAMPLE* pBuffer,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numSamples / 2; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        // a loop counter i += 2 prevents vectorizing.
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+    }
+}
+
+MIXXX_SAMPLE_KERNEL void addWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] += pSrc[i] * gain;
+    }
+}
+
+MIXXX_SAMPLE_KERNEL void addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numSamples / 2; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+MIXXX_SAMPLE_KERNEL void copyWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = pSrc[i] * gain;
+    }
+}
+
+MIXXX_SAMPLE_KERNEL void copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        SINT numSamples) {
+    // note: LOOP VECTORIZED only with "int i" (not SINT i).
+    for (int i = 0; i < numSamples / 2; ++i) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+MIXXX_SAMPLE_KERNEL void copy2WithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc0,
+        CSAMPLE_GAIN startGain0,
+        CSAMPLE_GAIN gainDelta0,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        int iNumSamples) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < iNumSamples / 2; ++i) {
+        const CSAMPLE_GAIN gain0 = startGain0 + gainDelta0 * i;
+        const CSAMPLE_GAIN gain1 = startGain1 + gainDelta1 * i;
+        pDest[i * 2] = pSrc0[i * 2] * gain0 +
+                pSrc1[i * 2] * gain1;
+        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0 +
+                pSrc1[i * 2 + 1] * gain1;
+    }
+}
+
+MIXXX_SAMPLE_KERNEL void copy3WithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc0,
+        CSAMPLE_GAIN startGain0,
+        CSAMPLE_GAIN gainDelta0,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        CSAMPLE_GAIN startGain1,
+        CSAMPLE_GAIN gainDelta1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        CSAMPLE_GAIN startGain2,
+        CSAMPLE_GAIN gainDelta2,
+        int iNumSamples) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < iNumSamples / 2; ++i) {
+        const CSAMPLE_GAIN gain0 = startGain0 + gainDelta0 * i;
+        const CSAMPLE_GAIN gain1 = startGain1 + gainDelta1 * i;
+        const CSAMPLE_GAIN gain2 = startGain2 + gainDelta2 * i;
+        pDest[i * 2] = pSrc0[i * 2] * gain0 +
+                pSrc1[i * 2] * gain1 +
+                pSrc2[i * 2] * gain2;
+        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0 +
+                pSrc1[i * 2 + 1] * gain1 +
+                pSrc2[i * 2 + 1] * gain2;
+    }
+}
+
+MIXXX_SAMPLE_KERNEL void interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+MIXXX_SAMPLE_KERNEL void deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+// Adds the stereo pair at stereoOffset of each multichannel frame to pDest.
+MIXXX_SAMPLE_KERNEL void addStereoFromMultichannel(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        int numFrames,
+        int numChannels,
+        int stereoOffset) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; i++) {
+        const int srcIdx = numChannels * i + stereoOffset;
+        const int destIdx = 2 * i;
+        pDest[destIdx] += pSrc[srcIdx];
+        pDest[destIdx + 1] += pSrc[srcIdx + 1];
+    }
+}
+
+// Copies the stereo pair at stereoOffset of each multichannel frame to pDest
+// and applies a ramping gain.
+MIXXX_SAMPLE_KERNEL void copyStereoFromMultichannelWithRampingGain(
+        CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN startGain,
+        CSAMPLE_GAIN gainDelta,
+        int numFrames,
+        int numChannels,
+        int stereoOffset) {
+    for (int i = 0; i < numFrames; i++) {
+        const CSAMPLE_GAIN gain = startGain + gainDelta * i;
+        const int srcIdx = numChannels * i + stereoOffset;
+        pDest[2 * i] = pSrc[srcIdx] * gain;
+        pDest[2 * i + 1] = pSrc[srcIdx + 1] * gain;
+    }
+}
+
+MIXXX_SAMPLE_KERNEL void sumAbsPerChannel(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR,
+        CSAMPLE* pClippedL,
+        CSAMPLE* pClippedR,
+        const CSAMPLE* pBuffer,
+        SINT numSamples) {
+    CSAMPLE fAbsL = CSAMPLE_ZERO;
+    CSAMPLE fAbsR = CSAMPLE_ZERO;
+    CSAMPLE clippedL = 0;
+    CSAMPLE clippedR = 0;
+
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples / 2; ++i) {
+        CSAMPLE absl = fabs(pBuffer[i * 2]);
+        fAbsL += absl;
+        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
+        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
+        fAbsR += absr;
+        // Replacing the code with a bool clipped will prevent vetorizing
+        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
+    }
+
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    *pClippedL = clippedL;
+    *pClippedR = clippedR;
+}
+
+} // namespace kernel
+
+// One entry per kernel, filled with the variants of one instruction set.
+struct SampleKernels {
+    decltype(&kernel::applyGain) applyGain;
+    decltype(&kernel::applyRampingGain) applyRampingGain;
+    decltype(&kernel::addWithGain) addWithGain;
+    decltype(&kernel::addWithRampingGain) addWithRampingGain;
+    decltype(&kernel::copyWithGain) copyWithGain;
+    decltype(&kernel::copyWithRampingGain) copyWithRampingGain;
+    decltype(&kernel::copy2WithRampingGain) copy2WithRampingGain;
+    decltype(&kernel::copy3WithRampingGain) copy3WithRampingGain;
+    decltype(&kernel::interleaveBuffer) interleaveBuffer;
+    decltype(&kernel::deinterleaveBuffer) deinterleaveBuffer;
+    decltype(&kernel::addStereoFromMultichannel) addStereoFromMultichannel;
+    decltype(&kernel::copyStereoFromMultichannelWithRampingGain)
+            copyStereoFromMultichannelWithRampingGain;
+    decltype(&kernel::sumAbsPerChannel) sumAbsPerChannel;
+};
+
+// Instantiates a kernel for each instruction set. The kernel is inlined into
+// each variant and vectorized for the target of that variant.
+template<auto kKernel>
+struct KernelVariants;
+
+template<typename... Args, void (*kKernel)(Args...)>
+struct KernelVariants<kKernel> {
+    static void baseline(Args... args) {
+        kKernel(args...);
+    }
+#ifdef MIXXX_SAMPLE_DISPATCH
+    MIXXX_SAMPLE_TARGET_AVX2 static void avx2(Args... args) {
+        kKernel(args...);
+    }
+    MIXXX_SAMPLE_TARGET_AVX512 static void avx512(Args... args) {
+        kKernel(args...);
+    }
+#endif
+};
+
+#define MIXXX_SAMPLE_KERNEL_TABLE(variant)                                   \
+    SampleKernels {                                                          \
+        &KernelVariants<&kernel::applyGain>::variant,                        \
+                &KernelVariants<&kernel::applyRampingGain>::variant,         \
+                &KernelVariants<&kernel::addWithGain>::variant,              \
+                &KernelVariants<&kernel::addWithRampingGain>::variant,       \
+                &KernelVariants<&kernel::copyWithGain>::variant,             \
+                &KernelVariants<&kernel::copyWithRampingGain>::variant,      \
+                &KernelVariants<&kernel::copy2WithRampingGain>::variant,     \
+                &KernelVariants<&kernel::copy3WithRampingGain>::variant,     \
+                &KernelVariants<&kernel::interleaveBuffer>::variant,         \
+                &KernelVariants<&kernel::deinterleaveBuffer>::variant,       \
+                &KernelVariants<&kernel::addStereoFromMultichannel>::variant, \
+                &KernelVariants<                                             \
+                        &kernel::copyStereoFromMultichannelWithRampingGain>::variant, \
+                &KernelVariants<&kernel::sumAbsPerChannel>::variant,         \
+    }
+
+constexpr SampleKernels kBaselineKernels = MIXXX_SAMPLE_KERNEL_TABLE(baseline);
+#ifdef MIXXX_SAMPLE_DISPATCH
+constexpr SampleKernels kAvx2Kernels = MIXXX_SAMPLE_KERNEL_TABLE(avx2);
+constexpr SampleKernels kAvx512Kernels = MIXXX_SAMPLE_KERNEL_TABLE(avx512);
+#endif
+
+const SampleKernels* kernelsForInstructionSet(SampleUtil::InstructionSet instructionSet) {
+    switch (instructionSet) {
+#ifdef MIXXX_SAMPLE_DISPATCH
+    case SampleUtil::InstructionSet::AVX2:
+        return &kAvx2Kernels;
+    case SampleUtil::InstructionSet::AVX512:
+        return &kAvx512Kernels;
+#endif
+    default:
+        return &kBaselineKernels;
+    }
+}
+
+SampleUtil::InstructionSet detectInstructionSet() {
+#ifdef MIXXX_SAMPLE_DISPATCH
+    // May run before the constructors that initialize the CPU model
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SampleUtil::InstructionSet::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SampleUtil::InstructionSet::AVX2;
+    }
+#endif
+    return SampleUtil::InstructionSet::Baseline;
+}
+
+// Detected on first use instead of by a static initializer, so SampleUtil can
+// safely be used from other static initializers and an instruction set that
+// has been set before is never overridden. The pointer is constant
+// initialized and the tables are immutable, so relaxed ordering suffices.
+std::atomic<const SampleKernels*> s_pKernels{nullptr};
+
+const SampleKernels* detectKernels() {
+    const SampleKernels* pKernels = kernelsForInstructionSet(detectInstructionSet());
+    const SampleKernels* pExpected = nullptr;
+    if (!s_pKernels.compare_exchange_strong(pExpected, pKernels, std::memory_order_relaxed)) {
+        // Set concurrently
+        return pExpected;
+    }
+    return pKernels;
+}
+
+inline const SampleKernels& kernels() {
+    const SampleKernels* pKernels = s_pKernels.load(std::memory_order_relaxed);
+    if (!pKernels) [[unlikely]] {
+        pKernels = detectKernels();
+    }
+    return *pKernels;
+}
+
 } // anonymous namespace
 
 // static
@@ -91,6 +420,47 @@ CSAMPLE* SampleUtil::alloc(SINT size) {
     }
 }
 
+// static
+SampleUtil::InstructionSet SampleUtil::instructionSet() {
+    [[maybe_unused]] const SampleKernels* pKernels = &kernels();
+#ifdef MIXXX_SAMPLE_DISPATCH
+    if (pKernels == &kAvx512Kernels) {
+        return InstructionSet::AVX512;
+    }
+    if (pKernels == &kAvx2Kernels) {
+        return InstructionSet::AVX2;
+    }
+#endif
+    return InstructionSet::Baseline;
+}
+
+// static
+bool SampleUtil::isInstructionSetSupported(InstructionSet instructionSet) {
+    switch (instructionSet) {
+    case InstructionSet::Baseline:
+        return true;
+#ifdef MIXXX_SAMPLE_DISPATCH
+    case InstructionSet::AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case InstructionSet::AVX512:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    }
+}
+
+// static
+bool SampleUtil::setInstructionSet(InstructionSet instructionSet) {
+    if (!isInstructionSetSupported(instructionSet)) {
+        return false;
+    }
+    s_pKernels.store(kernelsForInstructionSet(instructionSet), std::memory_order_relaxed);
+    return true;
+}
+
 void SampleUtil::free(CSAMPLE* pBuffer) {
     // See SampleUtil::alloc() for details
     if (useAlignedAlloc()) {
@@ -121,10 +491,7 @@ void SampleUtil::applyGain(CSAMPLE* pBuffer, CSAMPLE_GAIN gain,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pBuffer[i] *= gain;
-    }
+    kernels().applyGain(pBuffer, gain, numSamples);
 }
 
 // static
@@ -142,18 +509,9 @@ void SampleUtil::applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            // a loop counter i += 2 prevents vectorizing.
-            pBuffer[i * 2] *= gain;
-            pBuffer[i * 2 + 1] *= gain;
-        }
+        kernels().applyRampingGain(pBuffer, start_gain, gain_delta, numSamples);
     } else {
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples; ++i) {
-            pBuffer[i] *= old_gain;
-        }
+        kernels().applyGain(pBuffer, old_gain, numSamples);
     }
 }
 
@@ -249,10 +607,7 @@ void SampleUtil::addWithGain(CSAMPLE* M_RESTRICT pDest,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] += pSrc[i] * gain;
-    }
+    kernels().addWithGain(pDest, pSrc, gain, numSamples);
 }
 
 void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
@@ -267,17 +622,9 @@ void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] += pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
-        }
+        kernels().addWithRampingGain(pDest, pSrc, start_gain, gain_delta, numSamples);
     } else {
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples; ++i) {
-            pDest[i] += pSrc[i] * old_gain;
-        }
+        kernels().addWithGain(pDest, pSrc, old_gain, numSamples);
     }
 }
 
@@ -336,10 +683,7 @@ void SampleUtil::copyWithGain(CSAMPLE* M_RESTRICT pDest,
         return;
     }
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] = pSrc[i] * gain;
-    }
+    kernels().copyWithGain(pDest, pSrc, gain, numSamples);
 
     // OR! need to test which fares better
     // copy(pDest, pSrc, iNumSamples);
@@ -365,17 +709,9 @@ void SampleUtil::copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
             / CSAMPLE_GAIN(numSamples / 2);
     if (gain_delta != 0) {
         const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED only with "int i" (not SINT i).
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] = pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
-        }
+        kernels().copyWithRampingGain(pDest, pSrc, start_gain, gain_delta, numSamples);
     } else {
-        // note: LOOP VECTORIZED.
-        for (SINT i = 0; i < numSamples; ++i) {
-            pDest[i] = pSrc[i] * old_gain;
-        }
+        kernels().copyWithGain(pDest, pSrc, old_gain, numSamples);
     }
 
     // OR! need to test which fares better
@@ -415,24 +751,10 @@ void SampleUtil::convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
 // static
 SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
         CSAMPLE* pfAbsR, const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE fAbsL = CSAMPLE_ZERO;
-    CSAMPLE fAbsR = CSAMPLE_ZERO;
     CSAMPLE clippedL = 0;
     CSAMPLE clippedR = 0;
+    kernels().sumAbsPerChannel(pfAbsL, pfAbsR, &clippedL, &clippedR, pBuffer, numSamples);
 
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples / 2; ++i) {
-        CSAMPLE absl = fabs(pBuffer[i * 2]);
-        fAbsL += absl;
-        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
-        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
-        fAbsR += absr;
-        // Replacing the code with a bool clipped will prevent vetorizing
-        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
-    }
-
-    *pfAbsL = fAbsL;
-    *pfAbsR = fAbsR;
     SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
     if (clippedL > 0) {
         clipping |= SampleUtil::CLIPPING_LEFT;
@@ -486,11 +808,7 @@ void SampleUtil::interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc1,
         const CSAMPLE* M_RESTRICT pSrc2,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest[2 * i] = pSrc1[i];
-        pDest[2 * i + 1] = pSrc2[i];
-    }
+    kernels().interleaveBuffer(pDest, pSrc1, pSrc2, numFrames);
 }
 
 // static
@@ -522,11 +840,7 @@ void SampleUtil::deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
         CSAMPLE* M_RESTRICT pDest2,
         const CSAMPLE* M_RESTRICT pSrc,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest1[i] = pSrc[i * 2];
-        pDest2[i] = pSrc[i * 2 + 1];
-    }
+    kernels().deinterleaveBuffer(pDest1, pDest2, pSrc, numFrames);
 }
 
 // static
@@ -782,16 +1096,11 @@ void SampleUtil::mixMultichannelToStereo(CSAMPLE* pDest,
         if (excludeChannelMask >> stemIdx & 0b1) {
             continue;
         }
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numFrames; i++) {
-            const int srcIdx = numChannels * i +
-                    stemIdx * mixxx::audio::ChannelCount::stereo();
-            const int destIdx = mixxx::audio::ChannelCount::stereo() * i;
-            pDest[destIdx] +=
-                    pSrc[srcIdx];
-            pDest[destIdx + 1] +=
-                    pSrc[srcIdx + 1];
-        }
+        kernels().addStereoFromMultichannel(pDest,
+                pSrc,
+                static_cast<int>(numFrames),
+                numChannels,
+                stemIdx * mixxx::audio::ChannelCount::stereo());
     }
 }
 
@@ -804,16 +1113,11 @@ void SampleUtil::mixMultichannelToStereo(CSAMPLE* pDest,
     int stereoChCount = numChannels / mixxx::audio::ChannelCount::stereo();
     SampleUtil::clear(pDest, numFrames * mixxx::audio::ChannelCount::stereo());
     for (int stemIdx = 0; stemIdx < stereoChCount; stemIdx++) {
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numFrames; i++) {
-            const int srcIdx = numChannels * i +
-                    stemIdx * mixxx::audio::ChannelCount::stereo();
-            const int destIdx = mixxx::audio::ChannelCount::stereo() * i;
-            pDest[destIdx] +=
-                    pSrc[srcIdx];
-            pDest[destIdx + 1] +=
-                    pSrc[srcIdx + 1];
-        }
+        kernels().addStereoFromMultichannel(pDest,
+                pSrc,
+                static_cast<int>(numFrames),
+                numChannels,
+                stemIdx * mixxx::audio::ChannelCount::stereo());
     }
 }
 
@@ -896,6 +1200,32 @@ void SampleUtil::copyOneStereoFromMulti(
     }
 }
 
+// static
+void SampleUtil::copyOneStereoFromMultiWithRampingGain(
+        CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numFrames,
+        mixxx::audio::ChannelCount numChannels,
+        int sourceChannel) {
+    DEBUG_ASSERT(numChannels > mixxx::audio::ChannelCount::stereo());
+    if (old_gain == CSAMPLE_GAIN_ZERO && new_gain == CSAMPLE_GAIN_ZERO) {
+        clear(pDest, numFrames * mixxx::audio::ChannelCount::stereo());
+        return;
+    }
+    // The same ramp as copyWithRampingGain()
+    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain) / CSAMPLE_GAIN(numFrames);
+    const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+    kernels().copyStereoFromMultichannelWithRampingGain(pDest,
+            pSrc,
+            start_gain,
+            gain_delta,
+            static_cast<int>(numFrames),
+            numChannels,
+            sourceChannel);
+}
+
 // static
 void SampleUtil::insertStereoToMulti(
         CSAMPLE* M_RESTRICT pDest,
@@ -1015,15 +1345,14 @@ void SampleUtil::copy2WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain0 = gain0in + gain_delta0;
     const CSAMPLE_GAIN gain_delta1 = (gain1out - gain1in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain1 = gain1in + gain_delta1;
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < iNumSamples / 2; ++i) {
-        const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
-        const CSAMPLE_GAIN gain1 = start_gain1 + gain_delta1 * i;
-        pDest[i * 2] = pSrc0[i * 2] * gain0 +
-                pSrc1[i * 2] * gain1;
-        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0 +
-                pSrc1[i * 2 + 1] * gain1;
-    }
+    kernels().copy2WithRampingGain(pDest,
+            pSrc0,
+            start_gain0,
+            gain_delta0,
+            pSrc1,
+            start_gain1,
+            gain_delta1,
+            iNumSamples);
 }
 // static
 void SampleUtil::copy3WithGain(CSAMPLE* M_RESTRICT pDest,
@@ -1104,16 +1433,15 @@ void SampleUtil::copy3WithRampingGain(CSAMPLE* M_RESTRICT pDest,
     const CSAMPLE_GAIN start_gain1 = gain1in + gain_delta1;
     const CSAMPLE_GAIN gain_delta2 = (gain2out - gain2in) / (iNumSamples / 2);
     const CSAMPLE_GAIN start_gain2 = gain2in + gain_delta2;
-    // note: LOOP VECTORIZED.
-    for (int i = 0; i < iNumSamples / 2; ++i) {
-        const CSAMPLE_GAIN gain0 = start_gain0 + gain_delta0 * i;
-        const CSAMPLE_GAIN gain1 = start_gain1 + gain_delta1 * i;
-        const CSAMPLE_GAIN gain2 = start_gain2 + gain_delta2 * i;
-        pDest[i * 2] = pSrc0[i * 2] * gain0 +
-                pSrc1[i * 2] * gain1 +
-                pSrc2[i * 2] * gain2;
-        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0 +
-                pSrc1[i * 2 + 1] * gain1 +
-                pSrc2[i * 2 + 1] * gain2;
-    }
+    kernels().copy3WithRampingGain(pDest,
+            pSrc0,
+            start_gain0,
+            gain_delta0,
+            pSrc1,
+            start_gain1,
+            gain_delta1,
+            pSrc2,
+            start_gain2,
+            gain_delta2,
+            iNumSamples);
 }
@@ -25,6 +25,23 @@ class SampleUtil {
     // This is some legacy, we cannot easily revert.
     static constexpr double kPlayPositionChannels = 2.0;
 
+    // The instruction set used by the hot mixing kernels. The best set
+    // supported by the CPU is detected on first use. Only x86 builds with
+    // GCC or Clang provide variants beyond Baseline, the Baseline of
+    // aarch64 builds already uses NEON.
+    enum class InstructionSet {
+        Baseline,
+        AVX2,
+        AVX512,
+    };
+
+    static InstructionSet instructionSet();
+    static bool isInstructionSetSupported(InstructionSet instructionSet);
+    // Switches the kernels to the given instruction set. This is meant for
+    // tests and benchmarks and must not be called while the engine is
+    // running. Returns false if the CPU does not support it.
+    static bool setInstructionSet(InstructionSet instructionSet);
+
     // Allocated a buffer of CSAMPLE's with length size. Ensures that the buffer
     // is 16-byte aligned for SSE enhancement.
     [[nodiscard]] static CSAMPLE* alloc(SINT size);
@@ -391,6 +408,17 @@ class SampleUtil {
             mixxx::audio::ChannelCount numChannels,
             int sourceChannel = 0);
 
+    // Like copyOneStereoFromMulti() and applies a gain that ramps from
+    // old_gain to new_gain like copyWithRampingGain(). This extracts a
+    // stem with its volume in a single pass.
+    static void copyOneStereoFromMultiWithRampingGain(CSAMPLE* pDest,
+            const CSAMPLE* pSrc,
+            CSAMPLE_GAIN old_gain,
+            CSAMPLE_GAIN new_gain,
+            SINT numFrames,
+            mixxx::audio::ChannelCount numChannels,
+            int sourceChannel);
+
     // Copies and strips interleaved stereo sample data in pSrc with
     // down to multi-channel samples into pDest. Samples will be written at the
     // channel pointed by channelOffset. Samples from all other channels will be
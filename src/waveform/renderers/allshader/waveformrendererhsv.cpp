@@ -130,27 +130,15 @@ bool WaveformRendererHSV::preprocessInner() {
         float maxAll[2]{};
         float eqGain[2] = {1.0f, 1.0f};
 
+        // Find the max values for low, mid, high and all in the waveform data
+        WaveformFilteredData maxima[ChannelCount];
+        waveform->getMaxima(visualIndexStart, visualIndexStop, maxima);
+
         for (int chn = 0; chn < 2; chn++) {
-            // Find the max values for low, mid, high and all in the waveform data
-            float maxLowU = 0.0f;
-            float maxMidU = 0.0f;
-            float maxHighU = 0.0f;
-            float maxAllU = 0.0f;
-            // data is interleaved left / right
-            for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                const WaveformData& waveformData = data[i];
-
-                maxLowU = math_max(maxLowU,
-                        static_cast<float>(
-                                waveformData.filtered.low));
-                maxMidU = math_max(maxMidU,
-                        static_cast<float>(
-                                waveformData.filtered.mid));
-                maxHighU = math_max(maxHighU,
-                        static_cast<float>(
-                                waveformData.filtered.high));
-                maxAllU = math_max(maxAllU, static_cast<float>(waveformData.filtered.all));
-            }
+            const float maxLowU = static_cast<float>(maxima[chn].low);
+            const float maxMidU = static_cast<float>(maxima[chn].mid);
+            const float maxHighU = static_cast<float>(maxima[chn].high);
+            const float maxAllU = static_cast<float>(maxima[chn].all);
 
             maxLow[chn] = maxLowU * lowGain;
             maxMid[chn] = maxMidU * midGain;
@@ -154,20 +154,16 @@ bool WaveformRendererRGB::preprocessInner() {
         uchar u8maxHigh[2]{};
         // - Per channel
         uchar u8maxAllChn[2]{};
+        WaveformFilteredData maxima[ChannelCount];
+        waveform->getMaxima(visualIndexStart, visualIndexStop, maxima);
         for (int chn = 0; chn < 2; chn++) {
             // In case we don't render individual color per channel, we use only
             // the first field of the arrays to perform signal max
             int signalChn = splitLeftRight ? chn : 0;
-            // data is interleaved left / right
-            for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                const WaveformData& waveformData = data[i];
-
-                u8maxLow[signalChn] = math_max(u8maxLow[signalChn], waveformData.filtered.low);
-                u8maxMid[signalChn] = math_max(u8maxMid[signalChn], waveformData.filtered.mid);
-                u8maxHigh[signalChn] = math_max(u8maxHigh[signalChn], waveformData.filtered.high);
-                u8maxAllChn[signalChn] = math_max(
-                        u8maxAllChn[signalChn], waveformData.filtered.all);
-            }
+            u8maxLow[signalChn] = math_max(u8maxLow[signalChn], maxima[chn].low);
+            u8maxMid[signalChn] = math_max(u8maxMid[signalChn], maxima[chn].mid);
+            u8maxHigh[signalChn] = math_max(u8maxHigh[signalChn], maxima[chn].high);
+            u8maxAllChn[signalChn] = math_max(u8maxAllChn[signalChn], maxima[chn].all);
         }
         float maxAllChn[2]{static_cast<float>(u8maxAllChn[0]), static_cast<float>(u8maxAllChn[1])};
 
@@ -128,16 +128,10 @@ bool WaveformRendererSimple::preprocessInner() {
         const float fpos = static_cast<float>(pos) * invDevicePixelRatio;
 
         // - Per channel
-        uchar u8maxAllChn[2]{};
-        for (int chn = 0; chn < 2; chn++) {
-            // data is interleaved left / right
-            for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
-                const WaveformData& waveformData = data[i];
-
-                u8maxAllChn[chn] = math_max(u8maxAllChn[chn], waveformData.filtered.all);
-            }
-        }
-        float maxAllChn[2]{static_cast<float>(u8maxAllChn[0]), static_cast<float>(u8maxAllChn[1])};
+        WaveformFilteredData maxima[ChannelCount];
+        waveform->getMaxima(visualIndexStart, visualIndexStop, maxima);
+        float maxAllChn[2]{static_cast<float>(maxima[Left].all),
+                static_cast<float>(maxima[Right].all)};
 
         // TODO: use two geometrynodes, with uniform material,
         // one for the axis, one for the signal
@@ -1,13 +1,55 @@
 #include "waveform/waveform.h"
 
+#include <QFile>
 #include <QtDebug>
+#include <QtEndian>
+#include <cstring>
+#include <limits>
 
 #include "analyzer/constants.h"
 #include "engine/engine.h"
 #include "proto/waveform.pb.h"
+#include "util/assert.h"
+#include "waveform/waveformpyramid.h"
 
 using namespace mixxx::track;
 
+namespace {
+
+// Layout of the header of the binary format. All numbers are stored
+// in little-endian byte order, the remaining bytes are reserved and
+// filled with zeros.
+constexpr char kBinaryMagic[4] = {'M', 'X', 'W', 'F'};
+constexpr quint32 kBinaryFormatVersion = 1;
+constexpr int kBinaryMagicOffset = 0;
+constexpr int kBinaryFormatVersionOffset = 4;
+constexpr int kBinaryHeaderSizeOffset = 8;
+constexpr int kBinaryDataSizeOffset = 12;
+constexpr int kBinaryStemCountOffset = 16;
+constexpr int kBinaryBytesPerElementOffset = 20;
+constexpr int kBinaryVisualSampleRateOffset = 24;
+constexpr int kBinaryAudioVisualRatioOffset = 32;
+static_assert(kBinaryAudioVisualRatioOffset + 8 <= Waveform::kBinaryHeaderSize);
+
+// WaveformData only consists of bytes, i.e. its layout does not depend on
+// the byte order and it can be mapped into memory as is.
+static_assert(alignof(WaveformData) == 1);
+
+void writeBinaryDouble(uchar* pDest, double value) {
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    qToLittleEndian(bits, pDest);
+}
+
+double readBinaryDouble(const uchar* pSrc) {
+    const auto bits = qFromLittleEndian<quint64>(pSrc);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // anonymous namespace
+
 // Return the smallest power of 2 which is greater than the desired size when
 // squared.
 int computeTextureStride(int size) {
@@ -22,10 +64,12 @@ Waveform::Waveform(const QByteArray& data)
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
           m_dataSize(0),
+          m_pData(nullptr),
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(computeTextureStride(0)),
-          m_completion(-1) {
+          m_completion(-1),
+          m_stemCount(0) {
     readByteArray(data);
 }
 
@@ -38,6 +82,7 @@ Waveform::Waveform(
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
           m_dataSize(0),
+          m_pData(nullptr),
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(1024),
@@ -76,6 +121,20 @@ Waveform::Waveform(
 Waveform::~Waveform() {
 }
 
+void Waveform::getMaxima(int visualIndexStart,
+        int visualIndexStop,
+        WaveformFilteredData* pMaxima) const {
+    // The data is not modified after the analysis has completed it
+    if (m_dataSize <= 0 || getCompletion() < m_dataSize) {
+        WaveformPyramid::scanMaxima(m_pData, visualIndexStart, visualIndexStop, pMaxima);
+        return;
+    }
+    std::call_once(m_pyramidOnceFlag, [this] {
+        m_pPyramid = std::make_unique<WaveformPyramid>(m_pData, m_dataSize);
+    });
+    m_pPyramid->getMaxima(visualIndexStart, visualIndexStop, pMaxima);
+}
+
 QByteArray Waveform::toByteArray() const {
     io::Waveform waveform;
     waveform.set_visual_sample_rate(m_visualSampleRate);
@@ -121,7 +180,7 @@ QByteArray Waveform::toByteArray() const {
 
     int dataSize = getDataSize();
     for (int i = 0; i < dataSize; ++i) {
-        const WaveformData& datum = m_data.at(i);
+        const WaveformData& datum = m_pData[i];
         all->add_value(datum.filtered.all);
         low->add_value(datum.filtered.low);
         mid->add_value(datum.filtered.mid);
@@ -133,7 +192,7 @@ QByteArray Waveform::toByteArray() const {
         stem->set_units(io::Waveform::RMS);
         stem->set_channels(mixxx::kEngineChannelOutputCount);
         for (int i = 0; i < dataSize; ++i) {
-            const WaveformData& datum = m_data.at(i);
+            const WaveformData& datum = m_pData[i];
             stem->add_value(datum.stems[stemIdx]);
         }
         stemIdx++;
@@ -151,6 +210,101 @@ QByteArray Waveform::toByteArray() const {
     return QByteArray(output.data(), static_cast<int>(output.length()));
 }
 
+QByteArray Waveform::toBinary() const {
+    const int dataSize = getDataSize();
+    QByteArray binary(kBinaryHeaderSize + dataSize * static_cast<int>(sizeof(WaveformData)),
+            '\0');
+    auto* pHeader = reinterpret_cast<uchar*>(binary.data());
+    std::memcpy(pHeader + kBinaryMagicOffset, kBinaryMagic, sizeof(kBinaryMagic));
+    qToLittleEndian(kBinaryFormatVersion, pHeader + kBinaryFormatVersionOffset);
+    qToLittleEndian<quint32>(kBinaryHeaderSize, pHeader + kBinaryHeaderSizeOffset);
+    qToLittleEndian<quint32>(dataSize, pHeader + kBinaryDataSizeOffset);
+    qToLittleEndian<quint32>(m_stemCount, pHeader + kBinaryStemCountOffset);
+    qToLittleEndian<quint32>(sizeof(WaveformData), pHeader + kBinaryBytesPerElementOffset);
+    writeBinaryDouble(pHeader + kBinaryVisualSampleRateOffset, m_visualSampleRate);
+    writeBinaryDouble(pHeader + kBinaryAudioVisualRatioOffset, m_audioVisualRatio);
+    if (dataSize > 0) {
+        std::memcpy(pHeader + kBinaryHeaderSize, m_pData, dataSize * sizeof(WaveformData));
+    }
+    return binary;
+}
+
+// static
+bool Waveform::isBinary(const QByteArray& data) {
+    // The first 4 bytes of compressed data contain the uncompressed size
+    // in big-endian byte order, which would be more than 1 GB for the magic
+    // number. Both formats can safely be distinguished.
+    return data.size() >= kBinaryHeaderSize &&
+            std::memcmp(data.constData() + kBinaryMagicOffset,
+                    kBinaryMagic,
+                    sizeof(kBinaryMagic)) == 0;
+}
+
+bool Waveform::mapBinaryFile(const QString& fileName) {
+    VERIFY_OR_DEBUG_ASSERT(!m_pData) {
+        return false;
+    }
+    auto pFile = std::make_unique<QFile>(fileName);
+    if (!pFile->open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open waveform file" << fileName;
+        return false;
+    }
+    const QByteArray header = pFile->read(kBinaryHeaderSize);
+    if (!isBinary(header)) {
+        qWarning() << "Unsupported waveform file format" << fileName;
+        return false;
+    }
+    const auto* pHeader = reinterpret_cast<const uchar*>(header.constData());
+    const auto formatVersion = qFromLittleEndian<quint32>(
+            pHeader + kBinaryFormatVersionOffset);
+    const auto headerSize = qFromLittleEndian<quint32>(
+            pHeader + kBinaryHeaderSizeOffset);
+    const auto dataSize = qFromLittleEndian<quint32>(
+            pHeader + kBinaryDataSizeOffset);
+    const auto stemCount = qFromLittleEndian<quint32>(
+            pHeader + kBinaryStemCountOffset);
+    const auto bytesPerElement = qFromLittleEndian<quint32>(
+            pHeader + kBinaryBytesPerElementOffset);
+    const qint64 dataBytes = static_cast<qint64>(dataSize) * bytesPerElement;
+    if (formatVersion != kBinaryFormatVersion ||
+            headerSize != kBinaryHeaderSize ||
+            bytesPerElement != sizeof(WaveformData) ||
+            stemCount > static_cast<quint32>(mixxx::kMaxSupportedStems) ||
+            dataSize > static_cast<quint32>(std::numeric_limits<int>::max() /
+                               sizeof(WaveformData)) ||
+            pFile->size() != kBinaryHeaderSize + dataBytes) {
+        qWarning() << "Invalid or corrupt waveform file" << fileName
+                   << "version" << formatVersion
+                   << "dataSize" << dataSize
+                   << "fileSize" << pFile->size();
+        return false;
+    }
+
+    if (dataSize > 0) {
+        // The private mapping is copy-on-write and never modifies the file
+        uchar* pMappedData = pFile->map(
+                kBinaryHeaderSize, dataBytes, QFileDevice::MapPrivateOption);
+        if (!pMappedData) {
+            qWarning() << "Failed to map waveform file" << fileName
+                       << pFile->errorString();
+            return false;
+        }
+        m_pData = reinterpret_cast<WaveformData*>(pMappedData);
+        // The mapping remains valid until the file is destroyed
+        pFile->close();
+        m_pMappedFile = std::move(pFile);
+    }
+
+    m_dataSize = static_cast<int>(dataSize);
+    m_textureStride = computeTextureStride(m_dataSize);
+    m_stemCount = static_cast<int>(stemCount);
+    m_visualSampleRate = readBinaryDouble(pHeader + kBinaryVisualSampleRateOffset);
+    m_audioVisualRatio = readBinaryDouble(pHeader + kBinaryAudioVisualRatioOffset);
+    m_completion = m_dataSize;
+    m_saveState = SaveState::Saved;
+    return true;
+}
+
 void Waveform::readByteArray(const QByteArray& data) {
     if (data.isNull()) {
         return;
@@ -242,12 +396,14 @@ void Waveform::resize(int size) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.resize(m_textureStride * m_textureStride);
+    m_pData = m_data.data();
 }
 
 void Waveform::assign(int size) {
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.assign(m_textureStride * m_textureStride, {});
+    m_pData = m_data.data();
     m_saveState = SaveState::SavePending;
 }
 
@@ -256,6 +412,7 @@ void Waveform::dump() const {
              << "size(" + QString::number(getDataSize()) + ")"
              << "stems(" + QString::number(m_stemCount) + ")"
              << "textureStride(" + QString::number(m_textureStride) + ")"
+             << "mapped(" + QString::number(isMapped()) + ")"
              << "completion(" + QString::number(getCompletion()) + ")"
              << "visualSampleRate(" + QString::number(m_visualSampleRate) + ")"
              << "audioVisualRatio(" + QString::number(m_audioVisualRatio) + ")";
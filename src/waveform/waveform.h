@@ -5,6 +5,8 @@
 #include <QMutex>
 #include <QSharedPointer>
 #include <QString>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 #include "analyzer/constants.h"
@@ -12,6 +14,9 @@
 #include "util/class.h"
 #include "util/compatibility/qmutex.h"
 
+class QFile;
+class WaveformPyramid;
+
 enum BandIndex { AllBand = 0,
     Low = 1,
     Mid = 2,
@@ -79,8 +84,34 @@ class Waveform {
         m_description = description;
     }
 
+    // Serializes the waveform as protobuf, see proto/waveform.proto
     QByteArray toByteArray() const;
 
+    // The size of the header of the binary format that precedes the
+    // waveform data.
+    static constexpr int kBinaryHeaderSize = 64;
+
+    // Serializes the waveform in the binary format that can be mapped
+    // into memory by mapBinaryFile(). The fixed-size header is followed
+    // by the raw WaveformData of all getDataSize() elements.
+    QByteArray toBinary() const;
+
+    // Checks if the data starts with the header of the binary format.
+    static bool isBinary(const QByteArray& data);
+
+    // Maps the waveform data from a file in the binary format into memory
+    // without copying or converting it. The mapping is private, i.e. the
+    // file is never modified. Must only be invoked on an empty waveform.
+    //
+    // The file must not be truncated or overwritten in place while it is
+    // mapped. A new version of the file must replace the old one by
+    // renaming it.
+    bool mapBinaryFile(const QString& fileName);
+
+    bool isMapped() const {
+        return static_cast<bool>(m_pMappedFile);
+    }
+
     SaveState saveState() const {
         return m_saveState;
     }
@@ -110,33 +141,43 @@ class Waveform {
     // the constructor runs.
     inline int getTextureStride() const { return m_textureStride; }
 
-    // We do not lock the mutex since m_data is not resized after the
-    // constructor runs.
-    inline int getTextureSize() const { return static_cast<int>(m_data.size()); }
+    // We do not lock the mutex since m_textureStride is not changed after
+    // the constructor runs. The data of a mapped waveform only covers
+    // getDataSize() elements instead of the whole texture.
+    inline int getTextureSize() const { return m_textureStride * m_textureStride; }
 
     // Atomically get the number of data elements in this Waveform. We do not
     // lock the mutex since m_dataSize is not changed after the constructor
     // runs.
     inline int getDataSize() const { return m_dataSize; }
 
-    inline const WaveformData& get(int i) const { return m_data[i];}
-    inline unsigned char getLow(int i) const { return m_data[i].filtered.low;}
-    inline unsigned char getMid(int i) const { return m_data[i].filtered.mid;}
-    inline unsigned char getHigh(int i) const { return m_data[i].filtered.high;}
-    inline unsigned char getAll(int i) const { return m_data[i].filtered.all;}
+    inline const WaveformData& get(int i) const { return m_pData[i];}
+    inline unsigned char getLow(int i) const { return m_pData[i].filtered.low;}
+    inline unsigned char getMid(int i) const { return m_pData[i].filtered.mid;}
+    inline unsigned char getHigh(int i) const { return m_pData[i].filtered.high;}
+    inline unsigned char getAll(int i) const { return m_pData[i].filtered.all;}
 
-    // We do not lock the mutex since m_data is not resized after the
+    // We do not lock the mutex since m_pData is not changed after the
     // constructor runs.
-    WaveformData* data() { return &m_data[0];}
+    WaveformData* data() { return m_pData;}
 
-    // We do not lock the mutex since m_data is not resized after the
+    // We do not lock the mutex since m_pData is not changed after the
     // constructor runs.
-    const WaveformData* data() const { return &m_data[0];}
+    const WaveformData* data() const { return m_pData;}
 
     bool hasStem() const {
         return m_stemCount > 0;
     }
 
+    // Finds the maximum of each band per channel in the interleaved data
+    // elements [visualIndexStart, visualIndexStop) and writes them to
+    // pMaxima[Left] and pMaxima[Right]. Once the waveform is complete this
+    // only reads O(log n) elements from a pyramid of maxima that is built
+    // on the first call, see WaveformPyramid.
+    void getMaxima(int visualIndexStart,
+            int visualIndexStop,
+            WaveformFilteredData* pMaxima) const;
+
     void dump() const;
 
   private:
@@ -144,11 +185,11 @@ class Waveform {
     void resize(int size);
     void assign(int size);
 
-    inline WaveformData& at(int i) { return m_data[i];}
-    inline unsigned char& low(int i) { return m_data[i].filtered.low;}
-    inline unsigned char& mid(int i) { return m_data[i].filtered.mid;}
-    inline unsigned char& high(int i) { return m_data[i].filtered.high;}
-    inline unsigned char& all(int i) { return m_data[i].filtered.all;}
+    inline WaveformData& at(int i) { return m_pData[i];}
+    inline unsigned char& low(int i) { return m_pData[i].filtered.low;}
+    inline unsigned char& mid(int i) { return m_pData[i].filtered.mid;}
+    inline unsigned char& high(int i) { return m_pData[i].filtered.high;}
+    inline unsigned char& all(int i) { return m_pData[i].filtered.all;}
     double getVisualSampleRate() const { return m_visualSampleRate; }
 
     // If stored in the database, the ID of the waveform.
@@ -169,6 +210,11 @@ class Waveform {
     // TODO(XXX): In the future we should switch to QVector and use the raw data
     // pointer when performance matters.
     std::vector<WaveformData> m_data;
+    // The file that has been mapped into memory instead of allocating
+    // m_data, see mapBinaryFile().
+    std::unique_ptr<QFile> m_pMappedFile;
+    // Points to either the contents of m_data or the mapped file.
+    WaveformData* m_pData;
     // Not allowed to change after the constructor runs.
     double m_visualSampleRate;
     // Not allowed to change after the constructor runs.
@@ -185,6 +231,10 @@ class Waveform {
     // The number of stem contained in waveform samples. 0 if not a stem waveform
     int m_stemCount;
 
+    // Built by getMaxima() from the complete data
+    mutable std::once_flag m_pyramidOnceFlag;
+    mutable std::unique_ptr<WaveformPyramid> m_pPyramid;
+
     mutable QMutex m_mutex;
 
     DISALLOW_COPY_AND_ASSIGN(Waveform);
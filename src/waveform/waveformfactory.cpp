@@ -4,7 +4,13 @@
 // static
 Waveform* WaveformFactory::loadWaveformFromAnalysis(
         const AnalysisDao::AnalysisInfo& analysis) {
-    Waveform* pWaveform = new Waveform(analysis.data);
+    Waveform* pWaveform;
+    if (analysis.binaryDataPath.isEmpty()) {
+        pWaveform = new Waveform(analysis.data);
+    } else {
+        pWaveform = new Waveform();
+        pWaveform->mapBinaryFile(analysis.binaryDataPath);
+    }
     pWaveform->setId(analysis.analysisId);
     pWaveform->setVersion(analysis.version);
     pWaveform->setDescription(analysis.description);
@@ -0,0 +1,88 @@
+#include "waveform/waveformpyramid.h"
+
+#include "util/assert.h"
+#include "util/math.h"
+
+namespace {
+
+inline void maxInPlace(WaveformFilteredData* pMax, const WaveformFilteredData& data) {
+    pMax->low = math_max(pMax->low, data.low);
+    pMax->mid = math_max(pMax->mid, data.mid);
+    pMax->high = math_max(pMax->high, data.high);
+    pMax->all = math_max(pMax->all, data.all);
+}
+
+} // anonymous namespace
+
+WaveformPyramid::WaveformPyramid(const WaveformData* pData, int dataSize)
+        : m_pData(pData),
+          m_frameCount(dataSize / ChannelCount) {
+    DEBUG_ASSERT(m_pData || m_frameCount == 0);
+    int frameCount = m_frameCount;
+    while (frameCount > 1) {
+        const int prevFrameCount = frameCount;
+        frameCount = (prevFrameCount + 1) / 2;
+        std::vector<WaveformFilteredData> level(frameCount * ChannelCount);
+        for (int frame = 0; frame < prevFrameCount; ++frame) {
+            for (int chn = 0; chn < ChannelCount; ++chn) {
+                const WaveformFilteredData& data = m_levels.empty()
+                        ? m_pData[frame * ChannelCount + chn].filtered
+                        : m_levels.back()[frame * ChannelCount + chn];
+                maxInPlace(&level[(frame / 2) * ChannelCount + chn], data);
+            }
+        }
+        m_levels.push_back(std::move(level));
+    }
+}
+
+void WaveformPyramid::getMaxima(int visualIndexStart,
+        int visualIndexStop,
+        WaveformFilteredData* pMaxima) const {
+    pMaxima[Left] = {};
+    pMaxima[Right] = {};
+    // The scan of the renderers visits the same frames for both channels,
+    // see scanMaxima()
+    int frameStart = math_max(visualIndexStart, 0) / ChannelCount;
+    int frameStop = math_min((visualIndexStop + 1) / ChannelCount, m_frameCount);
+    // Compose the range from the largest aligned blocks, starting at the
+    // edges of the range at level 0
+    int level = 0;
+    while (frameStart < frameStop) {
+        const WaveformFilteredData* pLevelData =
+                level > 0 ? m_levels[level - 1].data() : nullptr;
+        const auto maxFrame = [&](int frame) {
+            for (int chn = 0; chn < ChannelCount; ++chn) {
+                maxInPlace(&pMaxima[chn],
+                        pLevelData
+                                ? pLevelData[frame * ChannelCount + chn]
+                                : m_pData[frame * ChannelCount + chn].filtered);
+            }
+        };
+        if (frameStart & 1) {
+            maxFrame(frameStart);
+            ++frameStart;
+        }
+        if (frameStop & 1) {
+            --frameStop;
+            maxFrame(frameStop);
+        }
+        frameStart /= 2;
+        frameStop /= 2;
+        ++level;
+    }
+}
+
+// static
+void WaveformPyramid::scanMaxima(const WaveformData* pData,
+        int visualIndexStart,
+        int visualIndexStop,
+        WaveformFilteredData* pMaxima) {
+    for (int chn = 0; chn < ChannelCount; ++chn) {
+        WaveformFilteredData max{};
+        // data is interleaved left / right
+        for (int i = visualIndexStart + chn; i < visualIndexStop + chn; i += 2) {
+            maxInPlace(&max, pData[i].filtered);
+        }
+        pMaxima[chn] = max;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+
+#include "waveform/waveform.h"
+
+/// Precomputed maxima of the filtered bands of a waveform for the
+/// renderers.
+///
+/// Level k stores the maximum of 2^k consecutive visual frames per
+/// channel, i.e. each level has half the size of the previous one and
+/// level 0 is the waveform data itself. A maximum over any range of
+/// frames is composed of at most two entries per level, so the renderers
+/// read O(log n) instead of n elements per pixel when zoomed out.
+///
+/// The waveform data must be complete and must not change afterwards.
+class WaveformPyramid {
+  public:
+    /// The interleaved data is referenced, not copied.
+    WaveformPyramid(const WaveformData* pData, int dataSize);
+
+    /// Finds the maximum of each band per channel in the interleaved data
+    /// elements [visualIndexStart, visualIndexStop), with the same result
+    /// as scanMaxima().
+    void getMaxima(int visualIndexStart,
+            int visualIndexStop,
+            WaveformFilteredData* pMaxima) const;
+
+    /// Finds the maxima like getMaxima() by scanning every data element.
+    /// The maxima are written to pMaxima[Left] and pMaxima[Right].
+    static void scanMaxima(const WaveformData* pData,
+            int visualIndexStart,
+            int visualIndexStop,
+            WaveformFilteredData* pMaxima);
+
+    int levelCount() const {
+        return static_cast<int>(m_levels.size()) + 1;
+    }
+
+  private:
+    const WaveformData* const m_pData;
+    const int m_frameCount;
+    // The interleaved maxima of level 1 and above
+    std::vector<std::vector<WaveformFilteredData>> m_levels;
+};
@@ -219,6 +219,8 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* pNewModel, bool restore
     } else if (pCurrModel) {
         pCurrModel->maybeStopModelPopulation();
     }
+    m_pendingSearchViewState.reset();
+    m_pendingSortViewState.reset();
 
     setVisible(false);
 
@@ -260,6 +262,13 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* pNewModel, bool restore
     setHorizontalHeader(tempHeader);
 
     setModel(pNewModel);
+    if (auto* pSqlTableModel = qobject_cast<BaseSqlTableModel*>(pNewModel)) {
+        connect(pSqlTableModel,
+                &BaseSqlTableModel::selectFinished,
+                this,
+                &WTrackTableView::slotSelectFinished,
+                Qt::UniqueConnection);
+    }
     setHorizontalHeader(pHeader);
     pHeader->setSectionsMovable(true);
     pHeader->setSectionsClickable(true);
@@ -649,7 +658,41 @@ void WTrackTableView::onSearch(const QString& text) {
     QList<TrackId> selectedTracks = getSelectedTrackIds();
     TrackId prevTrack = getCurrentTrackId();
     saveCurrentIndex();
+    // The selection before sorting is outdated
+    m_pendingSortViewState.reset();
     pTrackModel->search(text);
+    // Large search results are read incrementally, in that case the view
+    // state is restored when the rows have been replaced
+    const auto* pSqlTableModel = qobject_cast<BaseSqlTableModel*>(model());
+    if (pSqlTableModel && pSqlTableModel->isSelectPending()) {
+        m_pendingSearchViewState = PendingSearchViewState{
+                queryIsLessSpecific, selectedTracks, prevTrack};
+        return;
+    }
+    m_pendingSearchViewState.reset();
+    restoreViewStateAfterSearch(queryIsLessSpecific, selectedTracks, prevTrack);
+}
+
+void WTrackTableView::slotSelectFinished() {
+    if (sender() != model()) {
+        return;
+    }
+    if (m_pendingSearchViewState) {
+        const PendingSearchViewState state = std::move(*m_pendingSearchViewState);
+        m_pendingSearchViewState.reset();
+        restoreViewStateAfterSearch(
+                state.queryIsLessSpecific, state.selectedTracks, state.prevTrack);
+    }
+    if (m_pendingSortViewState) {
+        const SortViewState state = std::move(*m_pendingSortViewState);
+        m_pendingSortViewState.reset();
+        restoreViewStateAfterSort(state);
+    }
+}
+
+void WTrackTableView::restoreViewStateAfterSearch(bool queryIsLessSpecific,
+        const QList<TrackId>& selectedTracks,
+        TrackId prevTrack) {
     if (queryIsLessSpecific) {
         // If the user removed query terms, we try to select the same
         // tracks as before
@@ -1728,37 +1771,48 @@ void WTrackTableView::doSortByColumn(int headerSection, Qt::SortOrder sortOrder)
     // If this is a track model that may contain a track multiple times (a playlist),
     // we store the positions in order to reselect only the current selection,
     // not all occurrences of selected tracks.
-    QList<TrackId> selectedTrackIds;
-    QList<int> selectedTrackPositions;
-    bool usePositions = pTrackModel->hasCapabilities(TrackModel::Capability::Reorder);
-    if (usePositions) {
+    SortViewState state;
+    state.usePositions = pTrackModel->hasCapabilities(TrackModel::Capability::Reorder);
+    if (state.usePositions) {
         const QModelIndexList indices = selectionModel()->selectedRows();
-        selectedTrackPositions = pTrackModel->getSelectedPositions(indices);
+        state.selectedTrackPositions = pTrackModel->getSelectedPositions(indices);
     } else {
-        selectedTrackIds = getSelectedTrackIds();
+        state.selectedTrackIds = getSelectedTrackIds();
     }
 
-    int savedHScrollBarPos = horizontalScrollBar()->value();
+    state.hScrollBarPos = horizontalScrollBar()->value();
     // Save the column of focused table cell.
     // The cell is not necessarily part of the selection, but even if it's
     // focused after deselecting a row we may assume the user clicked onto the
     // column that will be used for sorting.
-    int prevColumn = 0;
+    state.prevColumn = 0;
     if (currentIndex().isValid()) {
-        prevColumn = currentIndex().column();
+        state.prevColumn = currentIndex().column();
     }
 
     sortByColumn(headerSection, sortOrder);
 
-    if (usePositions) {
-        selectTracksByPosition(selectedTrackPositions, prevColumn);
+    // Large libraries are sorted on a worker thread, in that case the
+    // selection is restored when the rows have been replaced
+    const auto* pSqlTableModel = qobject_cast<BaseSqlTableModel*>(pItemModel);
+    if (pSqlTableModel && pSqlTableModel->isSelectPending()) {
+        m_pendingSortViewState = std::move(state);
+        return;
+    }
+    m_pendingSortViewState.reset();
+    restoreViewStateAfterSort(state);
+}
+
+void WTrackTableView::restoreViewStateAfterSort(const SortViewState& state) {
+    if (state.usePositions) {
+        selectTracksByPosition(state.selectedTrackPositions, state.prevColumn);
     } else {
-        selectTracksById(selectedTrackIds, prevColumn);
+        selectTracksById(state.selectedTrackIds, state.prevColumn);
     }
 
     // This seems to be broken since at least Qt 5.12: no scrolling is issued
     // scrollTo(first, QAbstractItemView::EnsureVisible);
-    horizontalScrollBar()->setValue(savedHScrollBarPos);
+    horizontalScrollBar()->setValue(state.hScrollBarPos);
 }
 
 void WTrackTableView::selectTracksByPosition(const QList<int>& positions, int prevColumn) {
@@ -2,6 +2,7 @@
 
 #include <QAbstractItemModel>
 #include <QSortFilterProxyModel>
+#include <optional>
 
 #include "control/controlproxy.h"
 #include "control/pollingcontrolproxy.h"
@@ -157,6 +158,7 @@ class WTrackTableView : public WLibraryTableView {
     void slotSortingChanged(int headerSection, Qt::SortOrder order);
     void slotRandomSorting();
     void keyNotationChanged();
+    void slotSelectFinished();
 
   protected:
     QString getModelStateKey() const override;
@@ -192,6 +194,10 @@ class WTrackTableView : public WLibraryTableView {
 
     void hideOrRemoveSelectedTracks();
 
+    void restoreViewStateAfterSearch(bool queryIsLessSpecific,
+            const QList<TrackId>& selectedTracks,
+            TrackId prevTrack);
+
     const UserSettingsPointer m_pConfig;
     Library* const m_pLibrary;
 
@@ -216,4 +222,23 @@ class WTrackTableView : public WLibraryTableView {
     ControlProxy* m_pSortOrder;
 
     int m_dropRow;
+
+    // The view state of a search that is still pending in the model
+    struct PendingSearchViewState {
+        bool queryIsLessSpecific;
+        QList<TrackId> selectedTracks;
+        TrackId prevTrack;
+    };
+    std::optional<PendingSearchViewState> m_pendingSearchViewState;
+
+    // The view state of a sorting that is still pending in the model
+    struct SortViewState {
+        bool usePositions;
+        QList<TrackId> selectedTrackIds;
+        QList<int> selectedTrackPositions;
+        int prevColumn;
+        int hScrollBarPos;
+    };
+    void restoreViewStateAfterSort(const SortViewState& state);
+    std::optional<SortViewState> m_pendingSortViewState;
 };